@@ -0,0 +1,395 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iomanip>
+#include <istream>
+#include <new>
+#include <numeric>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    // Relaxed atomics are enough, the counters only being read by the thread measuring them; the engine's worker threads may still allocate concurrently
+    std::atomic<uint64_t> allocationCount = 0;
+    std::atomic<uint64_t> allocatedBytes = 0;
+    volatile double optimizationSink = 0.0;
+
+    void* allocate(std::size_t size)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+        void* memory = std::malloc(size == 0 ? 1 : size);
+
+        if (memory == nullptr)
+            throw std::bad_alloc();
+
+        return memory;
+    }
+
+    void* allocateAligned(std::size_t size, std::size_t alignment)
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+#if defined(_MSC_VER)
+        void* memory = _aligned_malloc(size == 0 ? 1 : size, alignment);
+#else
+        // aligned_alloc() requires the size to be a multiple of the alignment
+        void* memory = std::aligned_alloc(alignment, std::max((size + alignment - 1) / alignment * alignment, alignment));
+#endif
+
+        if (memory == nullptr)
+            throw std::bad_alloc();
+
+        return memory;
+    }
+
+    void deallocateAligned(void* memory) noexcept
+    {
+#if defined(_MSC_VER)
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+
+    /// Size of the buffer walked through to evict the benchmarks' data from the caches, larger than any last-level cache it is run on.
+    constexpr std::size_t FlushBufferSize = 64 * 1024 * 1024;
+    constexpr std::size_t CacheLineSize = 64;
+
+    /// Evicts all the caches' lines by writing over a buffer larger than them.
+    void flushCaches()
+    {
+        static std::vector<uint8_t> buffer(FlushBufferSize);
+        uint64_t sum = 0;
+
+        for (std::size_t byteIndex = 0; byteIndex < buffer.size(); byteIndex += CacheLineSize)
+        {
+            ++buffer[byteIndex];
+            sum += buffer[byteIndex];
+        }
+
+        Rei::preventOptimization(static_cast<double>(sum));
+    }
+
+    /// Measures the latency of an access to the main memory, by chasing pointers in a random cycle which makes each access miss all the caches.
+    /// \return Average latency of an access, in nanoseconds.
+    double calibrateMemoryLatency()
+    {
+        constexpr std::size_t NodeCount = FlushBufferSize / CacheLineSize;
+        constexpr std::size_t AccessCount = 4 * 1024 * 1024;
+
+        struct alignas(CacheLineSize) Node
+        {
+            Node* next{};
+        };
+
+        std::vector<Node> nodes(NodeCount);
+        std::vector<std::size_t> order(NodeCount);
+        std::iota(order.begin(), order.end(), 0);
+
+        // Sattolo's algorithm, giving a random permutation made of a single cycle through all the nodes
+        std::mt19937_64 randomEngine(42);
+
+        for (std::size_t nodeIndex = NodeCount - 1; nodeIndex > 0; --nodeIndex)
+            std::swap(order[nodeIndex], order[std::uniform_int_distribution<std::size_t>(0, nodeIndex - 1)(randomEngine)]);
+
+        for (std::size_t nodeIndex = 0; nodeIndex < NodeCount; ++nodeIndex)
+            nodes[nodeIndex].next = &nodes[order[nodeIndex]];
+
+        const Node* node = &nodes.front();
+
+        const auto startTime = std::chrono::steady_clock::now();
+
+        for (std::size_t accessIndex = 0; accessIndex < AccessCount; ++accessIndex)
+            node = node->next;
+
+        const auto endTime = std::chrono::steady_clock::now();
+
+        Rei::preventOptimization(static_cast<double>(reinterpret_cast<uintptr_t>(node)));
+
+        return std::chrono::duration<double, std::nano>(endTime - startTime).count() / AccessCount;
+    }
+
+    double computeMedian(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        const std::size_t middleIndex = values.size() / 2;
+
+        return (values.size() % 2 != 0 ? values[middleIndex] : (values[middleIndex - 1] + values[middleIndex]) * 0.5);
+    }
+
+    void writeString(std::ostream& stream, const std::string& string)
+    {
+        stream << '"';
+
+        for (const char character : string)
+        {
+            if (character == '"' || character == '\\')
+                stream << '\\';
+
+            stream << character;
+        }
+
+        stream << '"';
+    }
+
+    /// Finds the position of a key's value in a line of JSON.
+    /// \return Position of the value's first character, or std::string::npos if the key isn't in the line.
+    std::size_t findValue(const std::string& line, const char* key)
+    {
+        const std::size_t keyPos = line.find('"' + std::string(key) + "\":");
+
+        if (keyPos == std::string::npos)
+            return std::string::npos;
+
+        return line.find_first_not_of(' ', keyPos + std::char_traits<char>::length(key) + 3);
+    }
+
+    double readNumber(const std::string& line, const char* key)
+    {
+        const std::size_t valuePos = findValue(line, key);
+        return (valuePos == std::string::npos ? 0.0 : std::strtod(line.c_str() + valuePos, nullptr));
+    }
+
+    std::string readString(const std::string& line, const char* key)
+    {
+        std::size_t valuePos = findValue(line, key);
+        std::string string;
+
+        if (valuePos == std::string::npos || line[valuePos] != '"')
+            return string;
+
+        for (++valuePos; valuePos < line.size() && line[valuePos] != '"'; ++valuePos)
+        {
+            if (line[valuePos] == '\\')
+                ++valuePos;
+
+            string += line[valuePos];
+        }
+
+        return string;
+    }
+
+} // namespace
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, static_cast<std::size_t>(alignment)); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { deallocateAligned(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { deallocateAligned(memory); }
+
+namespace Rei
+{
+
+    void BenchmarkContext::beginMeasure()
+    {
+        if (m_isMeasured)
+            throw std::logic_error("Error: A benchmark must only measure once per run");
+
+        if (m_isCold)
+            flushCaches();
+
+        m_startAllocationCount = allocationCount.load(std::memory_order_relaxed);
+        m_startAllocatedBytes = allocatedBytes.load(std::memory_order_relaxed);
+        m_startTime = std::chrono::steady_clock::now();
+    }
+
+    void BenchmarkContext::endMeasure()
+    {
+        const auto endTime = std::chrono::steady_clock::now();
+
+        m_elapsedNs = std::chrono::duration<double, std::nano>(endTime - m_startTime).count();
+        m_allocationCount = allocationCount.load(std::memory_order_relaxed) - m_startAllocationCount;
+        m_allocatedBytes = allocatedBytes.load(std::memory_order_relaxed) - m_startAllocatedBytes;
+        m_isMeasured = true;
+    }
+
+    void BenchmarkSuite::add(std::string name, std::size_t operationCount, BenchmarkFunc func)
+    {
+        assert("Error: A benchmark must perform at least one operation." && operationCount > 0);
+        m_benchmarks.emplace_back(Benchmark{ std::move(name), operationCount, std::move(func) });
+    }
+
+    std::vector<BenchmarkResult> BenchmarkSuite::run(const BenchmarkOptions& options, std::ostream& log)
+    {
+        const std::size_t repetitionCount = std::max<std::size_t>(options.repetitionCount, 1);
+
+        m_memoryLatencyNs = calibrateMemoryLatency();
+        log << "[BenchmarkSuite] Memory latency: " << std::fixed << std::setprecision(1) << m_memoryLatencyNs << " ns" << std::endl;
+
+        std::vector<BenchmarkResult> results;
+
+        for (const Benchmark& benchmark : m_benchmarks)
+        {
+            if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos)
+                continue;
+
+            const auto runOnce = [&benchmark] (bool isCold)
+            {
+                BenchmarkContext context(benchmark.operationCount, isCold);
+                benchmark.func(context);
+
+                if (!context.m_isMeasured)
+                    throw std::logic_error("Error: The benchmark '" + benchmark.name + "' has not measured anything");
+
+                return context;
+            };
+
+            // A first untimed run warms up the code & the allocator
+            runOnce(false);
+
+            std::vector<double> warmTimes;
+            std::vector<double> coldTimes;
+            uint64_t allocationCount = 0;
+            uint64_t allocatedBytes = 0;
+
+            for (std::size_t repetitionIndex = 0; repetitionIndex < repetitionCount; ++repetitionIndex)
+            {
+                const BenchmarkContext warmContext = runOnce(false);
+                warmTimes.emplace_back(warmContext.m_elapsedNs);
+                allocationCount = std::max(allocationCount, warmContext.m_allocationCount);
+                allocatedBytes = std::max(allocatedBytes, warmContext.m_allocatedBytes);
+
+                coldTimes.emplace_back(runOnce(true).m_elapsedNs);
+            }
+
+            const auto operationCount = static_cast<double>(benchmark.operationCount);
+
+            BenchmarkResult& result = results.emplace_back();
+            result.name = benchmark.name;
+            result.operationCount = benchmark.operationCount;
+            result.nsPerOp = computeMedian(warmTimes) / operationCount;
+            result.minNsPerOp = *std::min_element(warmTimes.cbegin(), warmTimes.cend()) / operationCount;
+            result.coldNsPerOp = computeMedian(coldTimes) / operationCount;
+            result.allocationsPerOp = static_cast<double>(allocationCount) / operationCount;
+            result.allocatedBytesPerOp = static_cast<double>(allocatedBytes) / operationCount;
+            result.estimatedCacheMissesPerOp = std::max(result.coldNsPerOp - result.nsPerOp, 0.0) / m_memoryLatencyNs;
+
+            log << "[BenchmarkSuite] " << std::left << std::setw(56) << result.name << std::right << std::fixed << std::setprecision(2)
+                << std::setw(12) << result.nsPerOp << " ns/op" << std::setw(10) << result.allocationsPerOp << " allocs/op"
+                << std::setw(10) << result.estimatedCacheMissesPerOp << " misses/op" << std::endl;
+        }
+
+        return results;
+    }
+
+    void preventOptimization(double value) noexcept
+    {
+        optimizationSink = value;
+    }
+
+    void writeBenchmarkResults(const std::vector<BenchmarkResult>& results, double memoryLatencyNs, std::size_t repetitionCount, std::ostream& stream)
+    {
+        stream << std::fixed << std::setprecision(3);
+        stream << "{\n";
+        stream << "  \"memoryLatencyNs\": " << memoryLatencyNs << ",\n";
+        stream << "  \"repetitionCount\": " << repetitionCount << ",\n";
+        stream << "  \"results\": [\n";
+
+        for (std::size_t resultIndex = 0; resultIndex < results.size(); ++resultIndex)
+        {
+            const BenchmarkResult& result = results[resultIndex];
+
+            stream << "    { \"name\": ";
+            writeString(stream, result.name);
+            stream << ", \"operationCount\": " << result.operationCount
+                   << ", \"nsPerOp\": " << result.nsPerOp
+                   << ", \"minNsPerOp\": " << result.minNsPerOp
+                   << ", \"coldNsPerOp\": " << result.coldNsPerOp
+                   << ", \"allocationsPerOp\": " << result.allocationsPerOp
+                   << ", \"allocatedBytesPerOp\": " << result.allocatedBytesPerOp
+                   << ", \"estimatedCacheMissesPerOp\": " << result.estimatedCacheMissesPerOp << " }"
+                   << (resultIndex + 1 < results.size() ? ",\n" : "\n");
+        }
+
+        stream << "  ]\n";
+        stream << "}\n";
+    }
+
+    std::vector<BenchmarkResult> readBenchmarkResults(std::istream& stream)
+    {
+        std::vector<BenchmarkResult> results;
+        std::string line;
+
+        while (std::getline(stream, line))
+        {
+            if (findValue(line, "name") == std::string::npos)
+                continue;
+
+            BenchmarkResult& result = results.emplace_back();
+            result.name = readString(line, "name");
+            result.operationCount = static_cast<std::size_t>(readNumber(line, "operationCount"));
+            result.nsPerOp = readNumber(line, "nsPerOp");
+            result.minNsPerOp = readNumber(line, "minNsPerOp");
+            result.coldNsPerOp = readNumber(line, "coldNsPerOp");
+            result.allocationsPerOp = readNumber(line, "allocationsPerOp");
+            result.allocatedBytesPerOp = readNumber(line, "allocatedBytesPerOp");
+            result.estimatedCacheMissesPerOp = readNumber(line, "estimatedCacheMissesPerOp");
+        }
+
+        return results;
+    }
+
+    bool compareBenchmarkResults(const std::vector<BenchmarkResult>& results, const std::vector<BenchmarkResult>& baseline, double thresholdPercent,
+                                 std::ostream& stream)
+    {
+        // Allocation counts are deterministic, but may vary slightly with the containers' growth; only a noticeable increase is reported
+        constexpr double AllocationTolerance = 0.01;
+
+        bool hasRegressed = false;
+
+        stream << std::left << std::setw(56) << "Benchmark" << std::right << std::setw(14) << "Baseline ns" << std::setw(14) << "Current ns"
+               << std::setw(10) << "Delta" << std::setw(20) << "Allocs/op" << std::setw(20) << "Misses/op" << '\n';
+
+        for (const BenchmarkResult& result : results)
+        {
+            const auto baselineIt = std::find_if(baseline.cbegin(), baseline.cend(), [&result] (const BenchmarkResult& baselineResult)
+            {
+                return (baselineResult.name == result.name);
+            });
+
+            if (baselineIt == baseline.cend())
+            {
+                stream << std::left << std::setw(56) << result.name << std::right << std::setw(14) << "-" << std::setw(14) << result.nsPerOp << "  (new)\n";
+                continue;
+            }
+
+            const double deltaPercent = (baselineIt->nsPerOp > 0.0 ? (result.nsPerOp / baselineIt->nsPerOp - 1.0) * 100.0 : 0.0);
+            const bool isSlower = (deltaPercent > thresholdPercent);
+            const bool allocatesMore = (result.allocationsPerOp > baselineIt->allocationsPerOp * (1.0 + AllocationTolerance) + 1e-6);
+
+            std::string status;
+
+            if (isSlower || allocatesMore)
+            {
+                status = (isSlower ? (allocatesMore ? "  SLOWER, MORE ALLOCATIONS" : "  SLOWER") : "  MORE ALLOCATIONS");
+                hasRegressed = true;
+            }
+            else if (deltaPercent < -thresholdPercent)
+            {
+                status = "  faster";
+            }
+
+            std::ostringstream allocations;
+            allocations << std::fixed << std::setprecision(2) << baselineIt->allocationsPerOp << " -> " << result.allocationsPerOp;
+            std::ostringstream misses;
+            misses << std::fixed << std::setprecision(2) << baselineIt->estimatedCacheMissesPerOp << " -> " << result.estimatedCacheMissesPerOp;
+
+            stream << std::left << std::setw(56) << result.name << std::right << std::fixed << std::setprecision(2)
+                   << std::setw(14) << baselineIt->nsPerOp << std::setw(14) << result.nsPerOp << std::setw(9) << std::showpos << deltaPercent
+                   << std::noshowpos << '%' << std::setw(20) << allocations.str() << std::setw(20) << misses.str() << status << '\n';
+        }
+
+        return hasRegressed;
+    }
+
+} // namespace Rei
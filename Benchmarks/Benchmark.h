@@ -0,0 +1,140 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Rei
+{
+    class BenchmarkSuite;
+
+    /// Measurements of a benchmark, all given per operation.
+    struct BenchmarkResult
+    {
+        std::string name{};
+        /// Number of operations performed by each measured run.
+        std::size_t operationCount = 0;
+        /// Median time over the warm repetitions, in nanoseconds.
+        double nsPerOp = 0.0;
+        /// Fastest time over the warm repetitions, in nanoseconds.
+        double minNsPerOp = 0.0;
+        /// Median time over the repetitions run right after flushing the caches, in nanoseconds.
+        double coldNsPerOp = 0.0;
+        double allocationsPerOp = 0.0;
+        double allocatedBytesPerOp = 0.0;
+        /// Estimated number of cache misses, from the time the cold runs take over the warm ones divided by the memory's latency.
+        /// \note This is a lower bound: it only counts the misses a warm cache avoids, & misses overlapping each other are counted once.
+        double estimatedCacheMissesPerOp = 0.0;
+    };
+
+    struct BenchmarkOptions
+    {
+        /// Only the benchmarks whose name contains this are run; all are if empty.
+        std::string filter{};
+        /// Number of warm & of cold repetitions of each benchmark, of which the median is taken.
+        std::size_t repetitionCount = 7;
+    };
+
+    /// Context given to a benchmark's function, which must prepare its data, then call measure() exactly once with the code to be measured.
+    class BenchmarkContext
+    {
+        friend BenchmarkSuite;
+
+    public:
+        /// Gets the number of operations the measured code must perform.
+        std::size_t getOperationCount() const noexcept { return m_operationCount; }
+
+        /// Measures the time & allocations of a function performing getOperationCount() operations.
+        /// \tparam FuncT Type of the function to be measured.
+        /// \param func Function to be measured.
+        template <typename FuncT>
+        void measure(FuncT&& func)
+        {
+            beginMeasure();
+            func();
+            endMeasure();
+        }
+
+    private:
+        explicit BenchmarkContext(std::size_t operationCount, bool isCold) noexcept : m_operationCount{ operationCount }, m_isCold{ isCold } {}
+
+        void beginMeasure();
+        void endMeasure();
+
+        std::size_t m_operationCount = 0;
+        /// Whether the caches must be flushed before measuring.
+        bool m_isCold = false;
+        bool m_isMeasured = false;
+        std::chrono::steady_clock::time_point m_startTime{};
+        double m_elapsedNs = 0.0;
+        uint64_t m_startAllocationCount = 0;
+        uint64_t m_startAllocatedBytes = 0;
+        uint64_t m_allocationCount = 0;
+        uint64_t m_allocatedBytes = 0;
+    };
+
+    /// Set of benchmarks, each run a number of times with warm caches & as many with cold ones.
+    class BenchmarkSuite
+    {
+    public:
+        /// Function of a benchmark, called once per repetition.
+        using BenchmarkFunc = std::function<void(BenchmarkContext&)>;
+
+        /// Gets the latency of an access to the main memory, in nanoseconds, as calibrated by the last run.
+        double getMemoryLatencyNs() const noexcept { return m_memoryLatencyNs; }
+
+        /// Adds a benchmark.
+        /// \param name Name of the benchmark, unique in the suite; by convention the measured function followed by its parameters, as in
+        ///   "World::refresh/10000/3".
+        /// \param operationCount Number of operations the measured code performs, by which the measurements are divided.
+        /// \param func Function preparing the benchmark's data & measuring it through the given context.
+        void add(std::string name, std::size_t operationCount, BenchmarkFunc func);
+        /// Runs the benchmarks, printing their progress into the given stream.
+        /// \param options Options of the run.
+        /// \param log Stream to print the progress into.
+        /// \return Results of the benchmarks run, in the order they have been added.
+        std::vector<BenchmarkResult> run(const BenchmarkOptions& options, std::ostream& log);
+
+    private:
+        struct Benchmark
+        {
+            std::string name{};
+            std::size_t operationCount = 0;
+            BenchmarkFunc func{};
+        };
+
+        std::vector<Benchmark> m_benchmarks{};
+        double m_memoryLatencyNs = 0.0;
+    };
+
+    /// Prevents the compiler from optimizing away the computation of a value, by storing it into a volatile variable.
+    void preventOptimization(double value) noexcept;
+
+    /// Writes results as JSON, each result on its own line so that runs can also be compared with text tools.
+    /// \param results Results to be written.
+    /// \param memoryLatencyNs Memory latency the cache misses have been estimated with.
+    /// \param repetitionCount Number of repetitions of each benchmark.
+    /// \param stream Stream to write into.
+    void writeBenchmarkResults(const std::vector<BenchmarkResult>& results, double memoryLatencyNs, std::size_t repetitionCount, std::ostream& stream);
+    /// Reads results written by writeBenchmarkResults().
+    /// \param stream Stream to read from.
+    /// \return Results read, empty if none could be.
+    std::vector<BenchmarkResult> readBenchmarkResults(std::istream& stream);
+    /// Compares results against a baseline, printing the difference of each benchmark present in both.
+    /// A benchmark regresses if its median time exceeds the baseline's by more than the threshold, or if it allocates more.
+    /// \param results Results of the current run.
+    /// \param baseline Results to compare against.
+    /// \param thresholdPercent Tolerated slowdown, in percent of the baseline's time.
+    /// \param stream Stream to print the comparison into.
+    /// \return True if any benchmark regressed, false otherwise.
+    bool compareBenchmarkResults(const std::vector<BenchmarkResult>& results, const std::vector<BenchmarkResult>& baseline, double thresholdPercent,
+                                 std::ostream& stream);
+
+    void registerWorldBenchmarks(BenchmarkSuite& suite);
+    void registerCoreBenchmarks(BenchmarkSuite& suite);
+
+} // namespace Rei
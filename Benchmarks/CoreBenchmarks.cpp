@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Bitset.h"
+#include "Component.h"
+#include "Graph.h"
+#include "MatrixSimd.h"
+#include "TransformGraph.h"
+#include "VectorSimd.h"
+
+namespace Rei
+{
+
+    namespace
+    {
+        constexpr std::size_t BitsetSize = 1024;
+        constexpr std::size_t BitsetOperationCount = 10000;
+        constexpr std::size_t BitWriteCount = 100000;
+        constexpr std::size_t MaskOperationCount = 1000000;
+        /// Number of different operands cycled through, so that the results cannot be computed once & reused.
+        constexpr std::size_t OperandCount = 64;
+        /// Node removal searching linearly through the graph, its benchmarks are limited to moderate sizes.
+        constexpr std::array<std::size_t, 2> NodeCounts = { 1000, 10000 };
+        /// A batch fitting in the L1 & L2 caches, & one streamed from the main memory.
+        constexpr std::array<std::size_t, 2> VectorCounts = { 4096, 1048576 };
+
+        std::vector<Bitset> createBitsets(std::mt19937& randomEngine)
+        {
+            std::bernoulli_distribution bitDistribution(0.5);
+            std::vector<Bitset> bitsets(OperandCount, Bitset(BitsetSize));
+
+            for (Bitset& bitset : bitsets)
+            {
+                for (std::size_t bitIndex = 0; bitIndex < BitsetSize; ++bitIndex)
+                    bitset.setBit(bitIndex, bitDistribution(randomEngine));
+            }
+
+            return bitsets;
+        }
+
+        /// Creates component masks as entities & systems have, with a few bits enabled each.
+        std::vector<ComponentMask> createMasks(std::mt19937& randomEngine)
+        {
+            std::uniform_int_distribution<std::size_t> bitDistribution(0, MaxComponentCount - 1);
+            std::vector<ComponentMask> masks(OperandCount);
+
+            for (ComponentMask& mask : masks)
+            {
+                for (std::size_t bitIndex = 0; bitIndex < 4; ++bitIndex)
+                    mask.setBit(bitDistribution(randomEngine));
+            }
+
+            return masks;
+        }
+
+        /// Registers a benchmark applying a binary operation to pairs of bitsets.
+        template <typename OperationT>
+        void addBitsetBenchmark(BenchmarkSuite& suite, const std::string& name, OperationT operation)
+        {
+            suite.add(name + '/' + std::to_string(BitsetSize), BitsetOperationCount, [operation] (BenchmarkContext& context)
+            {
+                std::mt19937 randomEngine(42);
+                const std::vector<Bitset> bitsets = createBitsets(randomEngine);
+
+                context.measure([&bitsets, &operation] ()
+                {
+                    std::size_t checksum = 0;
+
+                    for (std::size_t operationIndex = 0; operationIndex < BitsetOperationCount; ++operationIndex)
+                        checksum += operation(bitsets[operationIndex % OperandCount], bitsets[(operationIndex * 7 + 1) % OperandCount]);
+
+                    preventOptimization(static_cast<double>(checksum));
+                });
+            });
+        }
+
+        /// Registers a benchmark applying a binary operation to pairs of component masks.
+        template <typename OperationT>
+        void addMaskBenchmark(BenchmarkSuite& suite, const std::string& name, OperationT operation)
+        {
+            suite.add(name, MaskOperationCount, [operation] (BenchmarkContext& context)
+            {
+                std::mt19937 randomEngine(42);
+                const std::vector<ComponentMask> masks = createMasks(randomEngine);
+
+                context.measure([&masks, &operation] ()
+                {
+                    std::size_t checksum = 0;
+
+                    for (std::size_t operationIndex = 0; operationIndex < MaskOperationCount; ++operationIndex)
+                        checksum += operation(masks[operationIndex % OperandCount], masks[(operationIndex * 7 + 1) % OperandCount]);
+
+                    preventOptimization(static_cast<double>(checksum));
+                });
+            });
+        }
+
+        void registerBitsetBenchmarks(BenchmarkSuite& suite)
+        {
+            suite.add("Bitset::setBit/" + std::to_string(BitsetSize), BitWriteCount, [] (BenchmarkContext& context)
+            {
+                Bitset bitset(BitsetSize);
+
+                context.measure([&bitset] ()
+                {
+                    for (std::size_t operationIndex = 0; operationIndex < BitWriteCount; ++operationIndex)
+                        bitset.setBit((operationIndex * 37) % BitsetSize, (operationIndex & 1) != 0);
+                });
+
+                preventOptimization(static_cast<double>(bitset.getEnabledBitCount()));
+            });
+
+            // The results' bits are counted so that they cannot be optimized away; getEnabledBitCount is measured on its own below
+            addBitsetBenchmark(suite, "Bitset::operator&", [] (const Bitset& bitset1, const Bitset& bitset2) { return (bitset1 & bitset2).getEnabledBitCount(); });
+            addBitsetBenchmark(suite, "Bitset::operator|", [] (const Bitset& bitset1, const Bitset& bitset2) { return (bitset1 | bitset2).getEnabledBitCount(); });
+            addBitsetBenchmark(suite, "Bitset::operator^", [] (const Bitset& bitset1, const Bitset& bitset2) { return (bitset1 ^ bitset2).getEnabledBitCount(); });
+            addBitsetBenchmark(suite, "Bitset::operator==", [] (const Bitset& bitset1, const Bitset& bitset2) { return static_cast<std::size_t>(bitset1 == bitset2); });
+            addBitsetBenchmark(suite, "Bitset::getEnabledBitCount", [] (const Bitset& bitset, const Bitset&) { return bitset.getEnabledBitCount(); });
+
+            // The masks the world & its systems match entities with
+            addMaskBenchmark(suite, "ComponentMask::intersects", [] (const ComponentMask& mask1, const ComponentMask& mask2) { return static_cast<std::size_t>(mask1.intersects(mask2)); });
+            addMaskBenchmark(suite, "ComponentMask::contains", [] (const ComponentMask& mask1, const ComponentMask& mask2) { return static_cast<std::size_t>(mask1.contains(mask2)); });
+            addMaskBenchmark(suite, "ComponentMask::operator&", [] (const ComponentMask& mask1, const ComponentMask& mask2) { return (mask1 & mask2).getWords()[0]; });
+            addMaskBenchmark(suite, "ComponentMask::getEnabledBitCount", [] (const ComponentMask& mask, const ComponentMask&) { return mask.getEnabledBitCount(); });
+        }
+
+        void registerGraphBenchmarks(BenchmarkSuite& suite, std::size_t nodeCount)
+        {
+            const std::string countSuffix = '/' + std::to_string(nodeCount);
+
+            // Each node gets 4 children, as in a skeleton or a scene hierarchy
+            const auto linkTree = [] (Graph<TransformNode>& graph)
+            {
+                for (std::size_t nodeIndex = 1; nodeIndex < graph.getNodeCount(); ++nodeIndex)
+                    graph.getNode((nodeIndex - 1) / 4).addChildren(graph.getNode(nodeIndex));
+            };
+
+            suite.add("Graph::addNode" + countSuffix, nodeCount, [nodeCount] (BenchmarkContext& context)
+            {
+                Graph<TransformNode> graph;
+
+                context.measure([&graph, nodeCount] ()
+                {
+                    for (std::size_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex)
+                        graph.addNode();
+                });
+            });
+
+            suite.add("Graph::addChildren" + countSuffix, nodeCount - 1, [nodeCount, linkTree] (BenchmarkContext& context)
+            {
+                Graph<TransformNode> graph(nodeCount);
+
+                for (std::size_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex)
+                    graph.addNode();
+
+                context.measure([&graph, &linkTree] () { linkTree(graph); });
+            });
+
+            suite.add("Graph::removeNode" + countSuffix, nodeCount, [nodeCount, linkTree] (BenchmarkContext& context)
+            {
+                Graph<TransformNode> graph(nodeCount);
+                std::vector<TransformNode*> nodes;
+
+                for (std::size_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex)
+                    nodes.emplace_back(&graph.addNode());
+
+                linkTree(graph);
+                std::shuffle(nodes.begin(), nodes.end(), std::mt19937(42));
+
+                context.measure([&graph, &nodes] ()
+                {
+                    for (TransformNode* node : nodes)
+                        graph.removeNode(*node);
+                });
+            });
+        }
+
+        /// Vectors stored as a structure of arrays, with random components.
+        class VectorBatch
+        {
+        public:
+            VectorBatch(std::size_t vectorCount, std::mt19937& randomEngine) : m_x(vectorCount), m_y(vectorCount), m_z(vectorCount)
+            {
+                std::uniform_real_distribution<float> componentDistribution(-10.f, 10.f);
+
+                for (std::size_t vectorIndex = 0; vectorIndex < vectorCount; ++vectorIndex)
+                {
+                    m_x[vectorIndex] = componentDistribution(randomEngine);
+                    m_y[vectorIndex] = componentDistribution(randomEngine);
+                    m_z[vectorIndex] = componentDistribution(randomEngine);
+                }
+            }
+
+            Vec3fSoaView getView() noexcept { return Vec3fSoaView{ m_x.data(), m_y.data(), m_z.data(), m_x.size() }; }
+            float getChecksum() const noexcept { return m_x.front() + m_y[m_y.size() / 2] + m_z.back(); }
+
+        private:
+            std::vector<float> m_x;
+            std::vector<float> m_y;
+            std::vector<float> m_z;
+        };
+
+        Mat4f createTransform() noexcept
+        {
+            return Mat4f::fromColumns({ Vec4f(0.8f, 0.6f, 0.f, 0.f), Vec4f(-0.6f, 0.8f, 0.f, 0.f), Vec4f(0.f, 0.f, 1.f, 0.f), Vec4f(1.f, 2.f, 3.f, 1.f) });
+        }
+
+        void registerVectorBenchmarks(BenchmarkSuite& suite, std::size_t vectorCount)
+        {
+            const std::string countSuffix = '/' + std::to_string(vectorCount);
+
+            suite.add("Simd::computeDots" + countSuffix, vectorCount, [vectorCount] (BenchmarkContext& context)
+            {
+                std::mt19937 randomEngine(42);
+                VectorBatch vecs1(vectorCount, randomEngine);
+                VectorBatch vecs2(vectorCount, randomEngine);
+                std::vector<float> results(vectorCount);
+
+                context.measure([&] () { Simd::computeDots(vecs1.getView(), vecs2.getView(), results.data()); });
+                preventOptimization(results.front() + results.back());
+            });
+
+            // Same computation on an array of structures with Vector's scalar functions, as a reference for the SIMD ones
+            suite.add("Vec3f::dot" + countSuffix, vectorCount, [vectorCount] (BenchmarkContext& context)
+            {
+                std::mt19937 randomEngine(42);
+                std::uniform_real_distribution<float> componentDistribution(-10.f, 10.f);
+                std::vector<Vec3f> vecs1(vectorCount);
+                std::vector<Vec3f> vecs2(vectorCount);
+                std::vector<float> results(vectorCount);
+
+                for (std::size_t vectorIndex = 0; vectorIndex < vectorCount; ++vectorIndex)
+                {
+                    vecs1[vectorIndex] = Vec3f(componentDistribution(randomEngine), componentDistribution(randomEngine), componentDistribution(randomEngine));
+                    vecs2[vectorIndex] = Vec3f(componentDistribution(randomEngine), componentDistribution(randomEngine), componentDistribution(randomEngine));
+                }
+
+                context.measure([&] ()
+                {
+                    for (std::size_t vectorIndex = 0; vectorIndex < vectorCount; ++vectorIndex)
+                        results[vectorIndex] = vecs1[vectorIndex].dot(vecs2[vectorIndex]);
+                });
+                preventOptimization(results.front() + results.back());
+            });
+
+            suite.add("Simd::normalize" + countSuffix, vectorCount, [vectorCount] (BenchmarkContext& context)
+            {
+                std::mt19937 randomEngine(42);
+                VectorBatch vecs(vectorCount, randomEngine);
+
+                context.measure([&vecs] () { Simd::normalize(vecs.getView()); });
+                preventOptimization(vecs.getChecksum());
+            });
+
+            suite.add("Simd::lerp" + countSuffix, vectorCount, [vectorCount] (BenchmarkContext& context)
+            {
+                std::mt19937 randomEngine(42);
+                VectorBatch vecs1(vectorCount, randomEngine);
+                VectorBatch vecs2(vectorCount, randomEngine);
+                VectorBatch results(vectorCount, randomEngine);
+
+                context.measure([&] () { Simd::lerp(vecs1.getView(), vecs2.getView(), 0.25f, results.getView()); });
+                preventOptimization(results.getChecksum());
+            });
+
+            suite.add("Simd::transformPoints" + countSuffix, vectorCount, [vectorCount] (BenchmarkContext& context)
+            {
+                std::mt19937 randomEngine(42);
+                VectorBatch points(vectorCount, randomEngine);
+                VectorBatch results(vectorCount, randomEngine);
+                const Mat4f transform = createTransform();
+
+                context.measure([&] () { Simd::transformPoints(transform, points.getView(), results.getView()); });
+                preventOptimization(results.getChecksum());
+            });
+
+            suite.add("Simd::transform" + countSuffix, vectorCount, [vectorCount] (BenchmarkContext& context)
+            {
+                std::mt19937 randomEngine(42);
+                std::uniform_real_distribution<float> componentDistribution(-10.f, 10.f);
+                std::vector<Vec4f> vecs(vectorCount);
+                std::vector<Vec4f> results(vectorCount);
+                const Mat4f transform = createTransform();
+
+                for (Vec4f& vec : vecs)
+                    vec = Vec4f(componentDistribution(randomEngine), componentDistribution(randomEngine), componentDistribution(randomEngine), 1.f);
+
+                context.measure([&] () { Simd::transform(transform, vecs.data(), results.data(), vectorCount); });
+                preventOptimization(results.front().x() + results.back().w());
+            });
+        }
+
+    } // namespace
+
+    void registerCoreBenchmarks(BenchmarkSuite& suite)
+    {
+        registerBitsetBenchmarks(suite);
+
+        for (const std::size_t nodeCount : NodeCounts)
+            registerGraphBenchmarks(suite, nodeCount);
+
+        for (const std::size_t vectorCount : VectorCounts)
+            registerVectorBenchmarks(suite, vectorCount);
+    }
+
+} // namespace Rei
@@ -0,0 +1,243 @@
+#include <array>
+#include <random>
+#include <string>
+
+#include "Benchmark.h"
+#include "Bounds.h"
+#include "BroadphaseSystem.h"
+#include "Hitbox.h"
+#include "HitDetectionSystem.h"
+#include "MeshRenderer.h"
+#include "RenderSystem.h"
+#include "TransformGraph.h"
+#include "World.h"
+
+namespace Rei
+{
+
+    namespace
+    {
+        constexpr std::array<std::size_t, 3> EntityCounts = { 1000, 10000, 100000 };
+        /// Numbers of systems the entities are linked to, each accepting one of their components.
+        constexpr std::array<std::size_t, 3> SystemCounts = { 1, 2, 3 };
+        /// Number of entities replaced by each churn benchmark, as a fraction of the world's entities.
+        constexpr std::size_t ChurnDivisor = 10;
+        constexpr std::size_t QueryRecoveryCount = 100000;
+
+        /// Transform nodes laid out on a grid, so that the entities' bounds are spread as in a real map instead of all overlapping.
+        class EntityLayout
+        {
+        public:
+            explicit EntityLayout(std::size_t nodeCount) : m_graph(nodeCount)
+            {
+                constexpr std::size_t RowSize = 256;
+                constexpr float Spacing = 2.f;
+
+                for (std::size_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex)
+                {
+                    m_graph.addNode(Vec3f(static_cast<float>(nodeIndex % RowSize) * Spacing, 0.f,
+                                          static_cast<float>(nodeIndex / RowSize) * Spacing));
+                }
+
+                m_graph.update();
+            }
+
+            const TransformNode& getNode(std::size_t index) const noexcept { return m_graph.getNode(index % m_graph.getNodeCount()); }
+
+        private:
+            TransformGraph m_graph;
+        };
+
+        /// Gives an entity the components of a player: a mesh, a hitbox & bounds.
+        void addPlayerComponents(Entity& entity, const TransformNode& transform)
+        {
+            MeshRenderer& meshRenderer = entity.addComponent<MeshRenderer>(0, 0, 0, transform);
+            meshRenderer.setBoundingRadius(1.f);
+
+            Hitbox& hitbox = entity.addComponent<Hitbox>();
+            hitbox.addCapsule(transform, Vec3f(0.f, 0.3f, 0.f), Vec3f(0.f, 1.5f, 0.f), 0.3f);
+
+            entity.addComponent<Bounds>(transform, Aabb{ Vec3f(-0.5f, 0.f, -0.5f), Vec3f(0.5f, 1.8f, 0.5f) });
+        }
+
+        void addPlayers(World& world, const EntityLayout& layout, std::size_t entityCount)
+        {
+            for (std::size_t entityIndex = 0; entityIndex < entityCount; ++entityIndex)
+                addPlayerComponents(world.addEntity(), layout.getNode(entityIndex));
+        }
+
+        /// Adds systems to a world, each accepting a different component of the players.
+        /// \param systemCount Number of systems to be added, between 1 & 3.
+        void addSystems(World& world, std::size_t systemCount)
+        {
+            world.addSystem<RenderSystem>();
+
+            if (systemCount >= 2)
+                world.addSystem<HitDetectionSystem>();
+
+            if (systemCount >= 3)
+                world.addSystem<BroadphaseSystem>();
+        }
+
+        void registerEntityBenchmarks(BenchmarkSuite& suite, std::size_t entityCount)
+        {
+            const std::string countSuffix = '/' + std::to_string(entityCount);
+
+            suite.add("World::addEntity" + countSuffix, entityCount, [entityCount] (BenchmarkContext& context)
+            {
+                World world;
+
+                context.measure([&world, entityCount] ()
+                {
+                    for (std::size_t entityIndex = 0; entityIndex < entityCount; ++entityIndex)
+                        world.addEntity();
+                });
+            });
+
+            suite.add("World::addEntity+components" + countSuffix, entityCount, [entityCount] (BenchmarkContext& context)
+            {
+                const EntityLayout layout(entityCount);
+                World world;
+
+                context.measure([&world, &layout, entityCount] () { addPlayers(world, layout, entityCount); });
+            });
+
+            suite.add("World::removeEntity" + countSuffix, entityCount, [entityCount] (BenchmarkContext& context)
+            {
+                const EntityLayout layout(entityCount);
+                World world;
+                addSystems(world, SystemCounts.back());
+                addPlayers(world, layout, entityCount);
+                world.refresh();
+
+                context.measure([&world] ()
+                {
+                    while (!world.getEntities().empty())
+                        world.removeEntity(*world.getEntities().back());
+                });
+            });
+
+            // Players leaving & joining, or projectiles being fired & destroyed: random entities are replaced by new ones, taking their indices
+            const std::size_t churnCount = entityCount / ChurnDivisor;
+
+            suite.add("World::entityChurn" + countSuffix, churnCount, [entityCount, churnCount] (BenchmarkContext& context)
+            {
+                const EntityLayout layout(entityCount);
+                World world;
+                addSystems(world, SystemCounts.back());
+                addPlayers(world, layout, entityCount);
+                world.refresh();
+
+                std::mt19937 randomEngine(42);
+                std::uniform_int_distribution<std::size_t> entityDistribution(0, entityCount - 1);
+
+                context.measure([&] ()
+                {
+                    for (std::size_t churnIndex = 0; churnIndex < churnCount; ++churnIndex)
+                    {
+                        world.removeEntity(*world.getEntities()[entityDistribution(randomEngine)]);
+                        addPlayerComponents(world.addEntity(), layout.getNode(churnIndex));
+                    }
+
+                    world.refresh();
+                });
+            });
+
+            for (const std::size_t systemCount : SystemCounts)
+            {
+                const std::string systemSuffix = countSuffix + '/' + std::to_string(systemCount);
+
+                // First refresh after the entities have all been added, every one of them being dirty
+                suite.add("World::refresh/first" + systemSuffix, entityCount, [entityCount, systemCount] (BenchmarkContext& context)
+                {
+                    const EntityLayout layout(entityCount);
+                    World world;
+                    addSystems(world, systemCount);
+                    addPlayers(world, layout, entityCount);
+
+                    context.measure([&world] () { world.refresh(); });
+                });
+
+                // Steady state of a frame in which nothing changed
+                suite.add("World::refresh/clean" + systemSuffix, entityCount, [entityCount, systemCount] (BenchmarkContext& context)
+                {
+                    const EntityLayout layout(entityCount);
+                    World world;
+                    addSystems(world, systemCount);
+                    addPlayers(world, layout, entityCount);
+                    world.refresh();
+
+                    context.measure([&world] () { world.refresh(); });
+                });
+
+                // Steady state of a frame in which a few entities have been disabled, such as players being killed
+                suite.add("World::refresh/dirty" + systemSuffix, entityCount, [entityCount, systemCount] (BenchmarkContext& context)
+                {
+                    const EntityLayout layout(entityCount);
+                    World world;
+                    addSystems(world, systemCount);
+                    addPlayers(world, layout, entityCount);
+                    world.refresh();
+
+                    const std::size_t dirtyCount = entityCount / ChurnDivisor;
+
+                    for (std::size_t dirtyIndex = 0; dirtyIndex < dirtyCount; ++dirtyIndex)
+                        world.getEntities()[dirtyIndex * ChurnDivisor]->disable();
+
+                    context.measure([&world] () { world.refresh(); });
+                });
+            }
+
+            // Half of the entities have no hitbox, so that the query has to filter them out
+            suite.add("World::recoverEntitiesWithComponents/first" + countSuffix, entityCount, [entityCount] (BenchmarkContext& context)
+            {
+                const EntityLayout layout(entityCount);
+                World world;
+
+                for (std::size_t entityIndex = 0; entityIndex < entityCount; ++entityIndex)
+                {
+                    Entity& entity = world.addEntity();
+                    addPlayerComponents(entity, layout.getNode(entityIndex));
+
+                    if (entityIndex % 2 != 0)
+                        entity.removeComponent<Hitbox>();
+                }
+
+                world.refresh();
+
+                context.measure([&world] ()
+                {
+                    preventOptimization(static_cast<double>(world.recoverEntitiesWithComponents<MeshRenderer, Hitbox>().getSize()));
+                });
+            });
+        }
+
+    } // namespace
+
+    void registerWorldBenchmarks(BenchmarkSuite& suite)
+    {
+        for (const std::size_t entityCount : EntityCounts)
+            registerEntityBenchmarks(suite, entityCount);
+
+        // Once created, a query is kept up to date by the world; recovering it again must only be a lookup
+        suite.add("World::recoverEntitiesWithComponents/cached", QueryRecoveryCount, [] (BenchmarkContext& context)
+        {
+            const EntityLayout layout(EntityCounts.front());
+            World world;
+            addPlayers(world, layout, EntityCounts.front());
+            world.refresh();
+            world.recoverEntitiesWithComponents<MeshRenderer, Hitbox>();
+
+            context.measure([&world] ()
+            {
+                std::size_t entityCount = 0;
+
+                for (std::size_t recoveryIndex = 0; recoveryIndex < QueryRecoveryCount; ++recoveryIndex)
+                    entityCount += world.recoverEntitiesWithComponents<MeshRenderer, Hitbox>().getSize();
+
+                preventOptimization(static_cast<double>(entityCount));
+            });
+        });
+    }
+
+} // namespace Rei
@@ -0,0 +1,117 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "Benchmark.h"
+#include "Logger.h"
+
+namespace
+{
+    constexpr double DefaultThresholdPercent = 10.0;
+
+    void printUsage()
+    {
+        std::cout << "Usage: Benchmarks [options]\n"
+                     "  --filter <text>       Only runs the benchmarks whose name contains the text\n"
+                     "  --repetitions <count> Number of warm & of cold runs of each benchmark (default 7)\n"
+                     "  --output <file>       Writes the results as JSON into the file instead of the standard output\n"
+                     "  --baseline <file>     Compares the results against those of a previous run, failing on regressions\n"
+                     "  --threshold <percent> Slowdown tolerated against the baseline before failing (default 10)\n";
+    }
+
+} // namespace
+
+/// Runs the benchmarks, writing their results as JSON; the progress is printed into the standard error.
+/// To track a change, save the results of a run without it (--output baseline.json), then run again with it (--baseline baseline.json):
+///   the exit code is non-zero if any benchmark got slower than the threshold or allocates more.
+/// \note Timings are only meaningful in Release, preferably with a fixed CPU frequency & nothing else running.
+int main(int argc, char* argv[])
+{
+    Rei::Logger::setLoggingLevel(Rei::LoggingLevel::ERROR);
+
+    Rei::BenchmarkOptions options;
+    std::string outputPath;
+    std::string baselinePath;
+    double thresholdPercent = DefaultThresholdPercent;
+
+    for (int argIndex = 1; argIndex < argc; ++argIndex)
+    {
+        const std::string arg = argv[argIndex];
+
+        if (arg == "--help" || argIndex + 1 >= argc)
+        {
+            printUsage();
+            return (arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+
+        const std::string value = argv[++argIndex];
+
+        if (arg == "--filter")
+        {
+            options.filter = value;
+        }
+        else if (arg == "--repetitions")
+        {
+            options.repetitionCount = std::stoul(value);
+        }
+        else if (arg == "--output")
+        {
+            outputPath = value;
+        }
+        else if (arg == "--baseline")
+        {
+            baselinePath = value;
+        }
+        else if (arg == "--threshold")
+        {
+            thresholdPercent = std::stod(value);
+        }
+        else
+        {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<Rei::BenchmarkResult> baseline;
+
+    if (!baselinePath.empty())
+    {
+        std::ifstream baselineFile(baselinePath);
+        baseline = Rei::readBenchmarkResults(baselineFile);
+
+        if (baseline.empty())
+        {
+            std::cerr << "[Benchmarks] Error: No result could be read from the baseline '" << baselinePath << "'" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    Rei::BenchmarkSuite suite;
+    Rei::registerWorldBenchmarks(suite);
+    Rei::registerCoreBenchmarks(suite);
+
+    const std::vector<Rei::BenchmarkResult> results = suite.run(options, std::cerr);
+
+    if (outputPath.empty())
+    {
+        Rei::writeBenchmarkResults(results, suite.getMemoryLatencyNs(), options.repetitionCount, std::cout);
+    }
+    else
+    {
+        std::ofstream outputFile(outputPath);
+        Rei::writeBenchmarkResults(results, suite.getMemoryLatencyNs(), options.repetitionCount, outputFile);
+
+        if (!outputFile)
+        {
+            std::cerr << "[Benchmarks] Error: The results couldn't be written into '" << outputPath << "'" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!baseline.empty() && Rei::compareBenchmarkResults(results, baseline, thresholdPercent, std::cerr))
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+
+#include "Vector.h"
+
+namespace Rei
+{
+
+    /// Axis-aligned bounding box, defined by its minimum & maximum corners.
+    struct Aabb
+    {
+        static Aabb fromCenter(const Vec3f& center, const Vec3f& halfExtents) noexcept { return Aabb{ center - halfExtents, center + halfExtents }; }
+
+        Vec3f computeCenter() const noexcept { return (minCorner + maxCorner) * 0.5f; }
+        Vec3f computeHalfExtents() const noexcept { return (maxCorner - minCorner) * 0.5f; }
+        /// Computes the box's surface area, used as the cost of a node when building bounding volume hierarchies.
+        float computeSurfaceArea() const noexcept
+        {
+            const Vec3f extents = maxCorner - minCorner;
+            return 2.f * (extents.x() * extents.y() + extents.y() * extents.z() + extents.z() * extents.x());
+        }
+
+        bool contains(const Aabb& box) const noexcept
+        {
+            return (minCorner.x() <= box.minCorner.x() && minCorner.y() <= box.minCorner.y() && minCorner.z() <= box.minCorner.z()
+                 && maxCorner.x() >= box.maxCorner.x() && maxCorner.y() >= box.maxCorner.y() && maxCorner.z() >= box.maxCorner.z());
+        }
+
+        bool intersects(const Aabb& box) const noexcept
+        {
+            return (minCorner.x() <= box.maxCorner.x() && minCorner.y() <= box.maxCorner.y() && minCorner.z() <= box.maxCorner.z()
+                 && maxCorner.x() >= box.minCorner.x() && maxCorner.y() >= box.minCorner.y() && maxCorner.z() >= box.minCorner.z());
+        }
+
+        /// Computes the squared distance between a point & the box, 0 if the point is inside.
+        float computeSqDistance(const Vec3f& point) const noexcept
+        {
+            float sqDistance = 0.f;
+
+            for (std::size_t axisIndex = 0; axisIndex < 3; ++axisIndex)
+            {
+                const float distance = std::max(0.f, std::max(minCorner[axisIndex] - point[axisIndex], point[axisIndex] - maxCorner[axisIndex]));
+                sqDistance += distance * distance;
+            }
+
+            return sqDistance;
+        }
+
+        bool intersectsSphere(const Vec3f& center, float radius) const noexcept { return (computeSqDistance(center) <= radius * radius); }
+
+        /// Computes the distance at which a ray enters the box.
+        /// \param origin Origin of the ray.
+        /// \param invDirection Inverse of each component of the ray's direction.
+        /// \param maxDistance Maximum distance along the ray.
+        /// \return Entry distance, 0 if the origin is inside the box, & infinite if the box isn't hit before the maximum distance.
+        float intersectRay(const Vec3f& origin, const Vec3f& invDirection, float maxDistance) const noexcept
+        {
+            float entryDistance = 0.f;
+            float exitDistance = maxDistance;
+
+            for (std::size_t axisIndex = 0; axisIndex < 3; ++axisIndex)
+            {
+                const float distance1 = (minCorner[axisIndex] - origin[axisIndex]) * invDirection[axisIndex];
+                const float distance2 = (maxCorner[axisIndex] - origin[axisIndex]) * invDirection[axisIndex];
+
+                entryDistance = std::max(entryDistance, std::min(distance1, distance2));
+                exitDistance = std::min(exitDistance, std::max(distance1, distance2));
+            }
+
+            return (entryDistance <= exitDistance ? entryDistance : std::numeric_limits<float>::infinity());
+        }
+
+        Aabb merge(const Aabb& box) const noexcept
+        {
+            return Aabb{ Vec3f(std::min(minCorner.x(), box.minCorner.x()), std::min(minCorner.y(), box.minCorner.y()), std::min(minCorner.z(), box.minCorner.z())),
+                         Vec3f(std::max(maxCorner.x(), box.maxCorner.x()), std::max(maxCorner.y(), box.maxCorner.y()), std::max(maxCorner.z(), box.maxCorner.z())) };
+        }
+
+        Aabb expand(float margin) const noexcept { return Aabb{ minCorner - margin, maxCorner + margin }; }
+
+        Vec3f minCorner{};
+        Vec3f maxCorner{};
+    };
+
+} // namespace Rei
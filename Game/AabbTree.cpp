@@ -0,0 +1,243 @@
+#include "AabbTree.h"
+
+#include <algorithm>
+
+namespace Rei
+{
+
+    uint32_t AabbTree::insert(const Aabb& bounds, uint32_t layers, float margin)
+    {
+        const uint32_t leafIndex = allocateNode();
+
+        Node& leaf = m_nodes[leafIndex];
+        leaf.bounds = bounds;
+        leaf.fatBounds = bounds.expand(margin);
+        leaf.layers = layers;
+        leaf.height = 0;
+
+        insertLeaf(leafIndex);
+        ++m_proxyCount;
+
+        return leafIndex;
+    }
+
+    void AabbTree::remove(uint32_t proxyId)
+    {
+        assert("Error: The removed proxy is not a leaf of the tree." && proxyId < m_nodes.size() && m_nodes[proxyId].height == 0);
+
+        removeLeaf(proxyId);
+        freeNode(proxyId);
+        --m_proxyCount;
+    }
+
+    bool AabbTree::move(uint32_t proxyId, const Aabb& bounds, uint32_t layers, float margin)
+    {
+        assert("Error: The moved proxy is not a leaf of the tree." && proxyId < m_nodes.size() && m_nodes[proxyId].height == 0);
+
+        Node& leaf = m_nodes[proxyId];
+        leaf.bounds = bounds;
+        leaf.layers = layers;
+
+        if (leaf.fatBounds.contains(bounds))
+            return false;
+
+        removeLeaf(proxyId);
+        m_nodes[proxyId].fatBounds = bounds.expand(margin);
+        insertLeaf(proxyId);
+
+        return true;
+    }
+
+    void AabbTree::clear() noexcept
+    {
+        m_nodes.clear();
+        m_rootIndex = InvalidProxy;
+        m_freeListHead = InvalidProxy;
+        m_proxyCount = 0;
+    }
+
+    uint32_t AabbTree::allocateNode()
+    {
+        if (m_freeListHead == InvalidProxy)
+        {
+            m_nodes.emplace_back();
+            return static_cast<uint32_t>(m_nodes.size() - 1);
+        }
+
+        const uint32_t nodeIndex = m_freeListHead;
+        m_freeListHead = m_nodes[nodeIndex].parent;
+        m_nodes[nodeIndex] = Node{};
+
+        return nodeIndex;
+    }
+
+    void AabbTree::freeNode(uint32_t nodeIndex) noexcept
+    {
+        m_nodes[nodeIndex].parent = m_freeListHead;
+        m_nodes[nodeIndex].height = -1;
+        m_freeListHead = nodeIndex;
+    }
+
+    void AabbTree::insertLeaf(uint32_t leafIndex)
+    {
+        if (m_rootIndex == InvalidProxy)
+        {
+            m_rootIndex = leafIndex;
+            m_nodes[leafIndex].parent = InvalidProxy;
+            return;
+        }
+
+        // The sibling is searched by descending into the child whose box would grow the least, until creating a new parent
+        //   at the current node is cheaper; whatever the path taken, every ancestor's box grows by the same inherited cost
+        const Aabb leafBounds = m_nodes[leafIndex].fatBounds;
+        uint32_t siblingIndex = m_rootIndex;
+
+        while (!m_nodes[siblingIndex].isLeaf())
+        {
+            const Node& node = m_nodes[siblingIndex];
+            const float area = node.fatBounds.computeSurfaceArea();
+            const float combinedArea = node.fatBounds.merge(leafBounds).computeSurfaceArea();
+
+            const float parentCost = 2.f * combinedArea;
+            const float inheritedCost = 2.f * (combinedArea - area);
+
+            const auto computeChildCost = [this, &leafBounds, inheritedCost] (uint32_t childIndex)
+            {
+                const Node& child = m_nodes[childIndex];
+                const float mergedArea = child.fatBounds.merge(leafBounds).computeSurfaceArea();
+
+                return (child.isLeaf() ? mergedArea : mergedArea - child.fatBounds.computeSurfaceArea()) + inheritedCost;
+            };
+
+            const float firstCost = computeChildCost(node.firstChild);
+            const float secondCost = computeChildCost(node.secondChild);
+
+            if (parentCost < firstCost && parentCost < secondCost)
+                break;
+
+            siblingIndex = (firstCost < secondCost ? node.firstChild : node.secondChild);
+        }
+
+        const uint32_t oldParentIndex = m_nodes[siblingIndex].parent;
+        const uint32_t newParentIndex = allocateNode();
+
+        Node& newParent = m_nodes[newParentIndex];
+        newParent.parent = oldParentIndex;
+        newParent.fatBounds = leafBounds.merge(m_nodes[siblingIndex].fatBounds);
+        newParent.firstChild = siblingIndex;
+        newParent.secondChild = leafIndex;
+        newParent.height = m_nodes[siblingIndex].height + 1;
+
+        if (oldParentIndex == InvalidProxy)
+            m_rootIndex = newParentIndex;
+        else if (m_nodes[oldParentIndex].firstChild == siblingIndex)
+            m_nodes[oldParentIndex].firstChild = newParentIndex;
+        else
+            m_nodes[oldParentIndex].secondChild = newParentIndex;
+
+        m_nodes[siblingIndex].parent = newParentIndex;
+        m_nodes[leafIndex].parent = newParentIndex;
+
+        refitAncestors(newParentIndex);
+    }
+
+    void AabbTree::removeLeaf(uint32_t leafIndex) noexcept
+    {
+        if (leafIndex == m_rootIndex)
+        {
+            m_rootIndex = InvalidProxy;
+            return;
+        }
+
+        // The leaf's parent is removed as well, its other child taking its place
+        const uint32_t parentIndex = m_nodes[leafIndex].parent;
+        const uint32_t grandParentIndex = m_nodes[parentIndex].parent;
+        const uint32_t siblingIndex = (m_nodes[parentIndex].firstChild == leafIndex ? m_nodes[parentIndex].secondChild : m_nodes[parentIndex].firstChild);
+
+        freeNode(parentIndex);
+        m_nodes[siblingIndex].parent = grandParentIndex;
+
+        if (grandParentIndex == InvalidProxy)
+        {
+            m_rootIndex = siblingIndex;
+            return;
+        }
+
+        if (m_nodes[grandParentIndex].firstChild == parentIndex)
+            m_nodes[grandParentIndex].firstChild = siblingIndex;
+        else
+            m_nodes[grandParentIndex].secondChild = siblingIndex;
+
+        refitAncestors(grandParentIndex);
+    }
+
+    uint32_t AabbTree::balance(uint32_t nodeIndex) noexcept
+    {
+        Node& node = m_nodes[nodeIndex];
+
+        if (node.isLeaf() || node.height < 2)
+            return nodeIndex;
+
+        const uint32_t firstIndex = node.firstChild;
+        const uint32_t secondIndex = node.secondChild;
+        const int heightDifference = m_nodes[secondIndex].height - m_nodes[firstIndex].height;
+
+        if (heightDifference >= -1 && heightDifference <= 1)
+            return nodeIndex;
+
+        // The highest child is raised in place of the node, which takes the child's lowest child in exchange for it
+        const bool isSecondRaised = (heightDifference > 1);
+        const uint32_t raisedIndex = (isSecondRaised ? secondIndex : firstIndex);
+        const uint32_t keptIndex = (isSecondRaised ? firstIndex : secondIndex);
+        Node& raised = m_nodes[raisedIndex];
+
+        const uint32_t raisedFirstIndex = raised.firstChild;
+        const uint32_t raisedSecondIndex = raised.secondChild;
+
+        raised.firstChild = nodeIndex;
+        raised.parent = node.parent;
+        node.parent = raisedIndex;
+
+        if (raised.parent == InvalidProxy)
+            m_rootIndex = raisedIndex;
+        else if (m_nodes[raised.parent].firstChild == nodeIndex)
+            m_nodes[raised.parent].firstChild = raisedIndex;
+        else
+            m_nodes[raised.parent].secondChild = raisedIndex;
+
+        const bool isFirstHigher = (m_nodes[raisedFirstIndex].height > m_nodes[raisedSecondIndex].height);
+        const uint32_t higherIndex = (isFirstHigher ? raisedFirstIndex : raisedSecondIndex);
+        const uint32_t lowerIndex = (isFirstHigher ? raisedSecondIndex : raisedFirstIndex);
+
+        raised.secondChild = higherIndex;
+
+        if (isSecondRaised)
+            node.secondChild = lowerIndex;
+        else
+            node.firstChild = lowerIndex;
+
+        m_nodes[lowerIndex].parent = nodeIndex;
+
+        node.fatBounds = m_nodes[keptIndex].fatBounds.merge(m_nodes[lowerIndex].fatBounds);
+        node.height = 1 + std::max(m_nodes[keptIndex].height, m_nodes[lowerIndex].height);
+        raised.fatBounds = node.fatBounds.merge(m_nodes[higherIndex].fatBounds);
+        raised.height = 1 + std::max(node.height, m_nodes[higherIndex].height);
+
+        return raisedIndex;
+    }
+
+    void AabbTree::refitAncestors(uint32_t nodeIndex) noexcept
+    {
+        while (nodeIndex != InvalidProxy)
+        {
+            nodeIndex = balance(nodeIndex);
+
+            Node& node = m_nodes[nodeIndex];
+            node.fatBounds = m_nodes[node.firstChild].fatBounds.merge(m_nodes[node.secondChild].fatBounds);
+            node.height = 1 + std::max(m_nodes[node.firstChild].height, m_nodes[node.secondChild].height);
+
+            nodeIndex = node.parent;
+        }
+    }
+
+} // namespace Rei
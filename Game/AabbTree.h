@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Aabb.h"
+
+namespace Rei
+{
+
+    /// Dynamic bounding volume hierarchy of boxes, which can be inserted, moved & removed at any time.
+    /// Each leaf, or proxy, stores both the box it was given & a fat box enlarged by a margin; as long as its box stays inside the fat one,
+    ///   moving a proxy doesn't change the tree. Leaves are inserted where they increase the tree's surface area the least, & the tree is kept
+    ///   balanced by rotations, so that it doesn't degrade however the proxies move.
+    /// \note A proxy's identifier stays the same until it is removed; identifiers of removed proxies are reused.
+    class AabbTree
+    {
+    public:
+        static constexpr uint32_t InvalidProxy = std::numeric_limits<uint32_t>::max();
+        /// Maximum height of the tree for it to be traversed, which would take way more proxies than could ever fit in memory.
+        static constexpr std::size_t MaxHeight = 128;
+
+        std::size_t getProxyCount() const noexcept { return m_proxyCount; }
+        /// Gets the height of the tree, 0 if it only holds a single leaf; its traversals use as many stack entries, & must not exceed MaxHeight.
+        int getHeight() const noexcept { return (m_rootIndex == InvalidProxy ? 0 : m_nodes[m_rootIndex].height); }
+        const Aabb& getBounds(uint32_t proxyId) const noexcept { return m_nodes[proxyId].bounds; }
+        const Aabb& getFatBounds(uint32_t proxyId) const noexcept { return m_nodes[proxyId].fatBounds; }
+        uint32_t getLayers(uint32_t proxyId) const noexcept { return m_nodes[proxyId].layers; }
+
+        /// Adds a box into the tree.
+        /// \param bounds Box to be added.
+        /// \param layers Mask of the layers the proxy belongs to, against which queries are filtered.
+        /// \param margin Distance by which the proxy's fat box is enlarged on each side.
+        /// \return Identifier of the new proxy.
+        uint32_t insert(const Aabb& bounds, uint32_t layers, float margin);
+        /// Removes a proxy from the tree.
+        void remove(uint32_t proxyId);
+        /// Changes a proxy's box, reinserting it only if its new box gets out of its fat one.
+        /// \param proxyId Proxy to be moved.
+        /// \param bounds New box of the proxy.
+        /// \param layers New mask of the layers the proxy belongs to.
+        /// \param margin Distance by which the proxy's fat box is enlarged on each side, if it is reinserted.
+        /// \return True if the proxy has been reinserted, false if only its box has changed.
+        bool move(uint32_t proxyId, const Aabb& bounds, uint32_t layers, float margin);
+        void clear() noexcept;
+
+        /// Calls a function on every proxy whose fat box passes a test, as well as the boxes of all its ancestors.
+        /// \tparam NodeTestT Type of the test; must be callable as bool(const Aabb& fatBounds).
+        /// \tparam ProxyFuncT Type of the function to call; must be callable as bool(uint32_t proxyId), returning false to stop the traversal.
+        /// \param testNode Test of a node's fat box, none of whose descendants are visited if it fails.
+        /// \param processProxy Function to be called on each proxy passing the test.
+        template <typename NodeTestT, typename ProxyFuncT>
+        void traverse(NodeTestT&& testNode, ProxyFuncT&& processProxy) const
+        {
+            if (m_rootIndex == InvalidProxy)
+                return;
+
+            // The tree being balanced, its height never exceeds about 1.44 times the log2 of its proxy count
+            std::array<uint32_t, MaxHeight + 1> stack{};
+            std::size_t stackSize = 0;
+            stack[stackSize++] = m_rootIndex;
+
+            while (stackSize > 0)
+            {
+                const Node& node = m_nodes[stack[--stackSize]];
+
+                if (!testNode(node.fatBounds))
+                    continue;
+
+                if (node.isLeaf())
+                {
+                    if (!processProxy(static_cast<uint32_t>(&node - m_nodes.data())))
+                        return;
+
+                    continue;
+                }
+
+                assert("Error: The tree is too high to be traversed." && stackSize + 2 <= stack.size());
+
+                stack[stackSize++] = node.secondChild;
+                stack[stackSize++] = node.firstChild;
+            }
+        }
+
+    private:
+        struct Node
+        {
+            bool isLeaf() const noexcept { return (firstChild == InvalidProxy); }
+
+            Aabb fatBounds{};
+            Aabb bounds{};
+            uint32_t parent = InvalidProxy; // Or next free node, if the node is free
+            uint32_t firstChild = InvalidProxy;
+            uint32_t secondChild = InvalidProxy;
+            uint32_t layers = 0;
+            int height = -1; // 0 for a leaf, -1 if the node is free
+        };
+
+        uint32_t allocateNode();
+        void freeNode(uint32_t nodeIndex) noexcept;
+        void insertLeaf(uint32_t leafIndex);
+        void removeLeaf(uint32_t leafIndex) noexcept;
+        /// Rotates the given node with one of its children if their heights differ by more than 1.
+        /// \return Index of the node now at the given node's place.
+        uint32_t balance(uint32_t nodeIndex) noexcept;
+        /// Recomputes the boxes & heights of a node's ancestors, balancing them along the way.
+        void refitAncestors(uint32_t nodeIndex) noexcept;
+
+        std::vector<Node> m_nodes{};
+        uint32_t m_rootIndex = InvalidProxy;
+        uint32_t m_freeListHead = InvalidProxy;
+        std::size_t m_proxyCount = 0;
+    };
+
+} // namespace Rei
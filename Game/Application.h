@@ -1,27 +1,29 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <chrono>
+#include <functional>
 #include <memory>
 
 #include "World.h"
 #include "Bitset.h"
+#include "FrameTimer.h"
 #include "Logger.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
 
 
 namespace Rei
 {
-    struct FrameTimeInfo
-    {
-        float deltaTime{};
-        float globalTime{};
-        int substepCount{};
-        float substepTime{};
-    };
-
+    /// Application holding & updating worlds.
+    /// Worlds are independent by default, & can then be updated concurrently if a thread pool is given. Worlds exchanging data must either
+    ///   be linked, to always be updated one after the other, or do so from a sync point, called once no world is being updated.
     class Application
     {
     public:
+        using SyncFunction = std::function<void(const FrameTimeInfo&)>;
+
         explicit Application(std::size_t worldCount = 1)
         {
             m_worlds.reserve(worldCount);
@@ -29,26 +31,66 @@ namespace Rei
 
         const std::vector<WorldPtr>& getWorlds() const { return m_worlds; }
         std::vector<WorldPtr>& getWorlds() { return m_worlds; }
-        const FrameTimeInfo& getTimeInfo() const { return m_timeInfo; }
-
-        void setFixedTimeStep(float fixedTimeStep) {
-            assert("Error: Fixed time step must be positive." && fixedTimeStep > 0.f);
-            m_timeInfo.substepTime = fixedTimeStep;
+        const FrameTimeInfo& getTimeInfo() const { return m_timer.getTimeInfo(); }
+        const FrameTimer& getTimer() const { return m_timer; }
+        /// Checks if two worlds are linked, & can thus never be updated concurrently.
+        bool areWorldsLinked(const World& firstWorld, const World& secondWorld) const
+        {
+            return (m_worldGroups[recoverWorldIndex(firstWorld)] == m_worldGroups[recoverWorldIndex(secondWorld)]);
         }
 
+        /// Sets the thread pool to update the worlds on; if null, they are all updated one after the other on the calling thread.
+        /// \note The pool can also be given to the worlds themselves, in which case their systems are updated on it as well.
+        /// \param threadPool Pool to update the worlds on.
+        void setThreadPool(ThreadPool* threadPool) noexcept { m_threadPool = threadPool; }
+
+        void setFixedTimeStep(float fixedTimeStep) { m_timer.setFixedTimeStep(fixedTimeStep); }
+        /// Sets the maximum number of fixed steps simulated in a frame, beyond which the remaining time is dropped.
+        /// \param maxSubstepCount Maximum substep count; must be strictly positive.
+        void setMaxSubstepCount(int maxSubstepCount) { m_timer.setMaxSubstepCount(maxSubstepCount); }
+
         template <typename... Args>
         World& addWorld(Args&&... args)
         {
             m_worlds.emplace_back(std::make_unique<World>(std::forward<Args>(args)...));
             m_activeWorlds.setBit(m_worlds.size() - 1);
 
+            // Each world is in a group of its own until it is linked to another
+            m_worldGroups.emplace_back(m_worlds.size() - 1);
+            m_updateResults.emplace_back(true);
+            m_areGroupsDirty = true;
+
             return *m_worlds.back();
         }
 
+        /// Links two worlds which exchange data during their updates, so that they are always updated one after the other, in the order
+        ///   they have been added in; linking is transitive.
+        /// \param firstWorld First world to be linked.
+        /// \param secondWorld Second world to be linked.
+        void linkWorlds(const World& firstWorld, const World& secondWorld)
+        {
+            const std::size_t firstGroup  = m_worldGroups[recoverWorldIndex(firstWorld)];
+            const std::size_t secondGroup = m_worldGroups[recoverWorldIndex(secondWorld)];
+
+            if (firstGroup == secondGroup)
+                return;
+
+            std::replace(m_worldGroups.begin(), m_worldGroups.end(), secondGroup, firstGroup);
+            m_areGroupsDirty = true;
+        }
+
+        /// Adds a function called once per frame after all the worlds have been updated, on the calling thread; since no world is being
+        ///   updated at that point, it can safely exchange data between any of them.
+        /// \param syncFunc Function to be called, given the frame's time information.
+        void addSyncPoint(SyncFunction syncFunc) { m_syncPoints.emplace_back(std::move(syncFunc)); }
+
         void run()
         {
             Logger::debug("[Application] Running...");
 
+            // The time spent before running, for instance setting up the worlds, must not be simulated
+            m_timer.resetClock();
+
             while (runOnce());
 
             Logger::debug("[Application] Exiting...");
@@ -56,52 +98,114 @@ namespace Rei
 
         template <typename FuncT> void run(FuncT&& callback)
         {
+            m_timer.resetClock();
+
             while (runOnce())
-                callback(m_timeInfo);
+                callback(m_timer.getTimeInfo());
         }
 
         bool runOnce()
         {
-            // ZoneScopedN("Application::runOnce");
-
-            const auto currentTime = std::chrono::system_clock::now();
-            m_timeInfo.deltaTime = std::chrono::duration<float>(currentTime - m_lastFrameTime).count();
-            m_timeInfo.globalTime += m_timeInfo.deltaTime;
-            m_lastFrameTime = currentTime;
+            REI_PROFILE_ZONE("Application::runOnce");
 
-            m_timeInfo.substepCount = 0;
-            m_remainingTime += m_timeInfo.deltaTime;
+            const FrameTimeInfo& timeInfo = m_timer.tick();
 
-            while (m_remainingTime >= m_timeInfo.substepTime)
+            if (m_threadPool == nullptr || m_threadPool->getThreadCount() == 0 || m_worlds.size() <= 1)
+            {
+                for (std::size_t worldIndex = 0; worldIndex < m_worlds.size(); ++worldIndex)
+                {
+                    if (m_activeWorlds[worldIndex])
+                        m_updateResults[worldIndex] = m_worlds[worldIndex]->update(timeInfo);
+                }
+            }
+            else
             {
-                ++m_timeInfo.substepCount;
-                m_remainingTime -= m_timeInfo.substepTime;
+                if (m_areGroupsDirty)
+                    rebuildGroups();
+
+                // Each group is updated as a single job, its worlds being linked & thus updated in order
+                m_threadPool->parallelFor(m_groupOffsets.size() - 1, 1, [this, &timeInfo](std::size_t groupBegin, std::size_t groupEnd)
+                {
+                    for (std::size_t groupIndex = groupBegin; groupIndex < groupEnd; ++groupIndex)
+                    {
+                        for (std::size_t offset = m_groupOffsets[groupIndex]; offset < m_groupOffsets[groupIndex + 1]; ++offset)
+                        {
+                            const std::size_t worldIndex = m_groupedWorlds[offset];
+
+                            if (m_activeWorlds[worldIndex])
+                                m_updateResults[worldIndex] = m_worlds[worldIndex]->update(timeInfo);
+                        }
+                    }
+                });
             }
 
             for (std::size_t worldIndex = 0; worldIndex < m_worlds.size(); ++worldIndex)
             {
-                if (!m_activeWorlds[worldIndex])
-                    continue;
-
-                if (!m_worlds[worldIndex]->update(m_timeInfo))
+                if (m_activeWorlds[worldIndex] && !m_updateResults[worldIndex])
                     m_activeWorlds.setBit(worldIndex, false);
             }
 
-            // FrameMark;
+            for (const SyncFunction& syncFunc : m_syncPoints)
+                syncFunc(timeInfo);
+
+            REI_PROFILE_FRAME();
 
-            return (m_isRunning && !m_activeWorlds.isEmpty());
+            return (m_isRunning.load(std::memory_order_relaxed) && !m_activeWorlds.isEmpty());
         }
 
-        void quit() { m_isRunning = false; }
+        /// Requests the application to stop after the current frame; can be called from any world, even when updated concurrently.
+        void quit() noexcept { m_isRunning.store(false, std::memory_order_relaxed); }
     private:
+        std::size_t recoverWorldIndex(const World& world) const
+        {
+            const auto worldIt = std::find_if(m_worlds.cbegin(), m_worlds.cend(), [&world](const WorldPtr& worldPtr) { return (worldPtr.get() == &world); });
+            assert("Error: The given world does not belong to the application." && worldIt != m_worlds.cend());
+
+            return static_cast<std::size_t>(worldIt - m_worlds.cbegin());
+        }
+
+        /// Sorts the worlds by group, keeping their order within each, & computes where each group starts.
+        void rebuildGroups()
+        {
+            m_groupedWorlds.resize(m_worlds.size());
+
+            for (std::size_t worldIndex = 0; worldIndex < m_worlds.size(); ++worldIndex)
+                m_groupedWorlds[worldIndex] = worldIndex;
+
+            std::stable_sort(m_groupedWorlds.begin(), m_groupedWorlds.end(), [this](std::size_t firstIndex, std::size_t secondIndex)
+            {
+                return (m_worldGroups[firstIndex] < m_worldGroups[secondIndex]);
+            });
+
+            m_groupOffsets.clear();
+
+            for (std::size_t offset = 0; offset < m_groupedWorlds.size(); ++offset)
+            {
+                if (offset == 0 || m_worldGroups[m_groupedWorlds[offset]] != m_worldGroups[m_groupedWorlds[offset - 1]])
+                    m_groupOffsets.emplace_back(offset);
+            }
+
+            m_groupOffsets.emplace_back(m_groupedWorlds.size());
+            m_areGroupsDirty = false;
+        }
+
         std::vector<WorldPtr> m_worlds{};
         Bitset m_activeWorlds{};
 
-        FrameTimeInfo m_timeInfo{ 0.f, 0.f, 0, 0.016666f };
-        std::chrono::time_point<std::chrono::system_clock> m_lastFrameTime = std::chrono::system_clock::now();
-        float m_remainingTime{};
+        // Group of each world, indexed by world; linked worlds share the same group
+        std::vector<std::size_t> m_worldGroups{};
+        // Indices of the worlds sorted by group, the worlds of each group lying between two consecutive offsets
+        std::vector<std::size_t> m_groupedWorlds{};
+        std::vector<std::size_t> m_groupOffsets{};
+        bool m_areGroupsDirty = true;
+        // Indexed by world; not a vector<bool>, since its elements are written concurrently
+        std::vector<char> m_updateResults{};
+        std::vector<SyncFunction> m_syncPoints{};
+        ThreadPool* m_threadPool{};
+
+        FrameTimer m_timer{};
 
-        bool m_isRunning = true;
+        std::atomic<bool> m_isRunning = true;
     };
 
 } // namespace Rei
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "Archetype.h"
+
+namespace Rei
+{
+
+    void Archetype::reserve(std::size_t entityCount)
+    {
+        m_entities.reserve(entityCount);
+
+        for (const ComponentColumnPtr& column : m_columns)
+        {
+            if (column)
+                column->reserve(entityCount);
+        }
+    }
+
+    void Archetype::copyLayout(const Archetype& archetype)
+    {
+        for (std::size_t compId = 0; compId < ComponentCount; ++compId)
+        {
+            if (!archetype.m_columns[compId] || !m_signature[compId])
+                continue;
+
+            m_columns[compId] = archetype.m_columns[compId]->cloneEmpty();
+        }
+    }
+
+    Entity* Archetype::moveRowTo(std::size_t row, Archetype& archetype)
+    {
+        assert("Error: The entity row to be moved is out of bounds." && row < m_entities.size());
+
+        for (std::size_t compId = 0; compId < ComponentCount; ++compId)
+        {
+            if (m_columns[compId] && archetype.hasColumn(compId))
+                m_columns[compId]->moveRowTo(row, *archetype.m_columns[compId]);
+        }
+
+        archetype.m_entities.emplace_back(m_entities[row]);
+
+        return swapRemoveRow(row);
+    }
+
+    Entity* Archetype::swapRemoveRow(std::size_t row)
+    {
+        assert("Error: The entity row to be removed is out of bounds." && row < m_entities.size());
+
+        for (const ComponentColumnPtr& column : m_columns)
+        {
+            if (column)
+                column->swapRemove(row);
+        }
+
+        Entity* movedEntity = nullptr;
+
+        if (row != m_entities.size() - 1)
+        {
+            m_entities[row] = m_entities.back();
+            movedEntity = m_entities[row];
+        }
+
+        m_entities.pop_back();
+
+        return movedEntity;
+    }
+
+    void Archetype::clear() noexcept
+    {
+        for (const ComponentColumnPtr& column : m_columns)
+        {
+            if (column)
+                column->clear();
+        }
+
+        m_entities.clear();
+    }
+
+} // namespace Rei
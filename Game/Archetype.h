@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+#include "Component.h"
+
+namespace Rei
+{
+    class Entity;
+
+    /// Type-erased contiguous array holding every component of a single type within an archetype.
+    class ComponentColumn
+    {
+    public:
+        virtual std::size_t getSize() const noexcept = 0;
+
+        /// Creates an empty column holding the same component type.
+        /// \return Newly created column.
+        virtual std::unique_ptr<ComponentColumn> cloneEmpty() const = 0;
+        /// Moves the component at the given row to the end of another column, which must hold the same component type.
+        /// \note The moved-from element is left in place; it must be removed afterward with swapRemove().
+        /// \param row Row of the component to be moved.
+        /// \param column Column to move the component into.
+        virtual void moveRowTo(std::size_t row, ComponentColumn& column) = 0;
+        /// Removes the component at the given row, replacing it by the last one of the column.
+        /// \param row Row of the component to be removed.
+        virtual void swapRemove(std::size_t row) = 0;
+        virtual void reserve(std::size_t count) = 0;
+        virtual void clear() noexcept = 0;
+
+        virtual ~ComponentColumn() = default;
+    };
+
+    template <typename CompT>
+    class TypedComponentColumn final : public ComponentColumn
+    {
+    public:
+        std::size_t getSize() const noexcept override { return m_components.size(); }
+        const std::vector<CompT>& getComponents() const noexcept { return m_components; }
+        std::vector<CompT>& getComponents() noexcept { return m_components; }
+
+        std::unique_ptr<ComponentColumn> cloneEmpty() const override { return std::make_unique<TypedComponentColumn>(); }
+
+        void moveRowTo(std::size_t row, ComponentColumn& column) override
+        {
+            assert("Error: The component row to be moved is out of bounds." && row < m_components.size());
+            static_cast<TypedComponentColumn&>(column).m_components.emplace_back(std::move(m_components[row]));
+        }
+
+        void swapRemove(std::size_t row) override
+        {
+            assert("Error: The component row to be removed is out of bounds." && row < m_components.size());
+
+            if (row != m_components.size() - 1)
+                m_components[row] = std::move(m_components.back());
+
+            m_components.pop_back();
+        }
+
+        void reserve(std::size_t count) override { m_components.reserve(count); }
+        void clear() noexcept override { m_components.clear(); }
+
+    private:
+        std::vector<CompT> m_components{};
+    };
+
+    using ComponentColumnPtr = std::unique_ptr<ComponentColumn>;
+
+    /// Table of all the entities sharing the exact same set of components.
+    /// Each component type is stored in its own contiguous column, all columns being indexed by the same row.
+    class Archetype
+    {
+        friend class ComponentStorage;
+
+    public:
+        explicit Archetype(const ComponentMask& signature) : m_signature{ signature } {}
+        Archetype(const Archetype&) = delete;
+        Archetype(Archetype&&) noexcept = default;
+
+        const ComponentMask& getSignature() const noexcept { return m_signature; }
+        std::size_t getEntityCount() const noexcept { return m_entities.size(); }
+        const std::vector<Entity*>& getEntities() const noexcept { return m_entities; }
+        bool isEmpty() const noexcept { return m_entities.empty(); }
+        bool hasColumn(std::size_t compId) const noexcept { return (compId < ComponentCount && m_columns[compId]); }
+
+        /// Gets the packed array of components of the given type.
+        /// \tparam CompT Type of the components to be fetched; must be part of the archetype.
+        /// \return Components of the given type, indexed by entity row.
+        template <typename CompT>
+        const std::vector<CompT>& getColumn() const noexcept
+        {
+            constexpr std::size_t compId = Component::getId<CompT>();
+            assert("Error: The archetype doesn't hold the requested component type." && hasColumn(compId));
+
+            return static_cast<const TypedComponentColumn<CompT>&>(*m_columns[compId]).getComponents();
+        }
+
+        template <typename CompT>
+        std::vector<CompT>& getColumn() noexcept
+        {
+            return const_cast<std::vector<CompT>&>(static_cast<const Archetype*>(this)->getColumn<CompT>());
+        }
+
+        /// Reserves memory in every column for the given amount of entities.
+        /// \param entityCount Amount of entities to reserve.
+        void reserve(std::size_t entityCount);
+
+        Archetype& operator=(const Archetype&) = delete;
+        Archetype& operator=(Archetype&&) noexcept = default;
+
+    private:
+        template <typename CompT>
+        std::vector<CompT>& addColumn()
+        {
+            constexpr std::size_t compId = Component::getId<CompT>();
+
+            if (!m_columns[compId])
+                m_columns[compId] = std::make_unique<TypedComponentColumn<CompT>>();
+
+            return static_cast<TypedComponentColumn<CompT>&>(*m_columns[compId]).getComponents();
+        }
+
+        /// Creates the columns of the given archetype which are part of the current signature.
+        /// \param archetype Archetype to copy the layout of.
+        void copyLayout(const Archetype& archetype);
+        /// Moves the entity at the given row, along with all the components both archetypes have in common, to the end of another archetype.
+        /// \note The components not held by the target archetype are destroyed.
+        /// \param row Row of the entity to be moved.
+        /// \param archetype Archetype to move the entity into.
+        /// \return Entity which has been moved in place of the removed row, if any.
+        Entity* moveRowTo(std::size_t row, Archetype& archetype);
+        /// Removes the entity & its components at the given row, replacing them by the last ones.
+        /// \param row Row of the entity to be removed.
+        /// \return Entity which has been moved in place of the removed row, if any.
+        Entity* swapRemoveRow(std::size_t row);
+        void clear() noexcept;
+
+        ComponentMask m_signature{};
+        std::array<ComponentColumnPtr, ComponentCount> m_columns{}; // Indexed by component ID
+        std::vector<Entity*> m_entities{};
+
+        // Archetypes obtained by adding or removing a component, indexed by the component's ID
+        std::array<Archetype*, ComponentCount> m_addEdges{};
+        std::array<Archetype*, ComponentCount> m_removeEdges{};
+    };
+
+    using ArchetypePtr = std::unique_ptr<Archetype>;
+
+} // namespace Rei
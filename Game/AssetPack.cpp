@@ -0,0 +1,359 @@
+#include "AssetPack.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace Rei
+{
+
+    namespace
+    {
+
+        static_assert(std::is_trivially_copyable_v<AssetFormat::MeshHeader> && std::is_trivially_copyable_v<Mat4f>,
+                      "Error: The pack's structures must be trivially copyable, to be read directly from the mapped file.");
+        static_assert(sizeof(AssetFormat::PackHeader) == 24 && sizeof(AssetFormat::Entry) == 32 && sizeof(AssetFormat::MeshHeader) == 56
+                   && sizeof(AssetFormat::SkeletonHeader) == 24 && sizeof(AssetFormat::TextureHeader) == 12 && sizeof(AssetFormat::TextureMip) == 16,
+                      "Error: The pack's structures must have the same layout on all platforms.");
+
+        /// Checks that a range is contained in an asset; offsets & sizes come from the file, & may be anything.
+        bool isRangeValid(const AssetFormat::Entry& entry, uint64_t offset, uint64_t size) noexcept
+        {
+            return (offset <= entry.size && size <= entry.size - offset);
+        }
+
+        constexpr uint32_t computeMipSize(uint32_t size, std::size_t mipIndex) noexcept
+        {
+            return std::max(size >> mipIndex, 1u);
+        }
+
+        /// Checks that a texture's properties are valid, its mipmaps never going below a single pixel.
+        bool isTextureHeaderValid(const AssetFormat::TextureHeader& header) noexcept
+        {
+            if (header.width == 0 || header.height == 0 || header.mipCount == 0 || header.mipCount > AssetFormat::MaxMipCount || isDepthFormat(header.format))
+                return false;
+
+            const uint32_t largestSize = std::max(header.width, header.height);
+            return ((largestSize >> (header.mipCount - 1)) > 0);
+        }
+
+    } // namespace
+
+    bool AssetPack::open(const std::string& filePath)
+    {
+        close();
+
+        if (!m_file.open(filePath))
+            return false;
+
+        const uint8_t* data = m_file.getData();
+        const std::size_t size = m_file.getSize();
+
+        const auto* header = reinterpret_cast<const AssetFormat::PackHeader*>(data);
+
+        if (size < sizeof(AssetFormat::PackHeader) || header->magic != AssetFormat::Magic || header->version != AssetFormat::Version)
+        {
+            Logger::error("[AssetPack] The file '" + filePath + "' is not a valid asset pack.");
+            close();
+            return false;
+        }
+
+        const uint64_t tableSize = static_cast<uint64_t>(header->entryCount) * sizeof(AssetFormat::Entry);
+
+        if (header->entryTableOffset % alignof(AssetFormat::Entry) != 0 || header->entryTableOffset > size || tableSize > size - header->entryTableOffset)
+        {
+            Logger::error("[AssetPack] The asset table of the pack '" + filePath + "' is corrupted.");
+            close();
+            return false;
+        }
+
+        const auto* entries = reinterpret_cast<const AssetFormat::Entry*>(data + header->entryTableOffset);
+
+        for (uint32_t entryIndex = 0; entryIndex < header->entryCount; ++entryIndex)
+        {
+            const AssetFormat::Entry& entry = entries[entryIndex];
+
+            // Entries must be sorted to be searched, & aligned for their headers to be read in place
+            const bool isValid = (entry.offset % AssetFormat::DataAlignment == 0 && entry.offset <= header->entryTableOffset
+                               && entry.size <= header->entryTableOffset - entry.offset && (entryIndex == 0 || entries[entryIndex - 1].id < entry.id));
+
+            if (!isValid)
+            {
+                Logger::error("[AssetPack] The asset " + std::to_string(entryIndex) + " of the pack '" + filePath + "' is corrupted.");
+                close();
+                return false;
+            }
+        }
+
+        m_entries = entries;
+        m_entryCount = header->entryCount;
+
+        return true;
+    }
+
+    void AssetPack::close() noexcept
+    {
+        m_file.close();
+        m_entries = nullptr;
+        m_entryCount = 0;
+    }
+
+    const AssetFormat::Entry* AssetPack::findEntry(AssetId id) const noexcept
+    {
+        const AssetFormat::Entry* entriesEnd = m_entries + m_entryCount;
+        const AssetFormat::Entry* entry = std::lower_bound(m_entries, entriesEnd, id, [] (const AssetFormat::Entry& candidate, AssetId searchedId)
+        {
+            return (candidate.id < searchedId);
+        });
+
+        return (entry != entriesEnd && entry->id == id ? entry : nullptr);
+    }
+
+    bool AssetPack::recoverMesh(const AssetFormat::Entry& entry, MeshView& view) const
+    {
+        if (entry.type != AssetType::MESH || !isRangeValid(entry, 0, sizeof(AssetFormat::MeshHeader)))
+            return false;
+
+        const uint8_t* assetData = m_file.getData() + entry.offset;
+        const auto* header = reinterpret_cast<const AssetFormat::MeshHeader*>(assetData);
+
+        if (header->vertexStride == 0 || (header->indexSize != 2 && header->indexSize != 4)
+         || !isRangeValid(entry, header->vertexOffset, static_cast<uint64_t>(header->vertexCount) * header->vertexStride)
+         || !isRangeValid(entry, header->indexOffset, static_cast<uint64_t>(header->indexCount) * header->indexSize))
+        {
+            Logger::error("[AssetPack] The mesh " + std::to_string(entry.id) + " is corrupted.");
+            return false;
+        }
+
+        view.header = header;
+        view.vertices = assetData + header->vertexOffset;
+        view.indices = assetData + header->indexOffset;
+
+        return true;
+    }
+
+    bool AssetPack::recoverSkeleton(const AssetFormat::Entry& entry, SkeletonView& view) const
+    {
+        if (entry.type != AssetType::SKELETON || !isRangeValid(entry, 0, sizeof(AssetFormat::SkeletonHeader)))
+            return false;
+
+        const uint8_t* assetData = m_file.getData() + entry.offset;
+        const auto* header = reinterpret_cast<const AssetFormat::SkeletonHeader*>(assetData);
+
+        if (header->inverseBindMatrixOffset % alignof(Mat4f) != 0 || header->parentOffset % alignof(uint16_t) != 0
+         || !isRangeValid(entry, header->parentOffset, static_cast<uint64_t>(header->boneCount) * sizeof(uint16_t))
+         || !isRangeValid(entry, header->inverseBindMatrixOffset, static_cast<uint64_t>(header->boneCount) * sizeof(Mat4f)))
+        {
+            Logger::error("[AssetPack] The skeleton " + std::to_string(entry.id) + " is corrupted.");
+            return false;
+        }
+
+        const auto* parents = reinterpret_cast<const uint16_t*>(assetData + header->parentOffset);
+
+        // Parents coming before their children, bones can be processed in order & their parents indexed without further checks
+        for (uint32_t boneIndex = 0; boneIndex < header->boneCount; ++boneIndex)
+        {
+            if (parents[boneIndex] != AssetFormat::InvalidBone && parents[boneIndex] >= boneIndex)
+            {
+                Logger::error("[AssetPack] The skeleton " + std::to_string(entry.id) + " has a bone whose parent doesn't come before it.");
+                return false;
+            }
+        }
+
+        view.boneCount = header->boneCount;
+        view.parents = parents;
+        view.inverseBindMatrices = reinterpret_cast<const Mat4f*>(assetData + header->inverseBindMatrixOffset);
+
+        return true;
+    }
+
+    bool AssetPack::recoverTexture(const AssetFormat::Entry& entry, TextureView& view) const
+    {
+        if (entry.type != AssetType::TEXTURE || !isRangeValid(entry, 0, sizeof(AssetFormat::TextureHeader)))
+            return false;
+
+        const uint8_t* assetData = m_file.getData() + entry.offset;
+        const auto* header = reinterpret_cast<const AssetFormat::TextureHeader*>(assetData);
+        const uint64_t mipTableOffset = sizeof(AssetFormat::TextureHeader) + sizeof(uint32_t); // Padded to align the 64-bit offsets
+
+        bool isValid = (isTextureHeaderValid(*header) && isRangeValid(entry, mipTableOffset, header->mipCount * sizeof(AssetFormat::TextureMip)));
+        const auto* mips = reinterpret_cast<const AssetFormat::TextureMip*>(assetData + mipTableOffset);
+
+        for (std::size_t mipIndex = 0; isValid && mipIndex < header->mipCount; ++mipIndex)
+        {
+            const AssetFormat::TextureMip& mip = mips[mipIndex];
+            // Rows must hold all their pixels, so that uploading the mipmap from its rows never reads past it
+            isValid = (isRangeValid(entry, mip.offset, mip.size)
+                    && mip.rowPitch >= static_cast<uint64_t>(computeMipSize(header->width, mipIndex)) * recoverPixelSize(header->format)
+                    && static_cast<uint64_t>(mip.rowPitch) * computeMipSize(header->height, mipIndex) <= mip.size);
+        }
+
+        if (!isValid)
+        {
+            Logger::error("[AssetPack] The texture " + std::to_string(entry.id) + " is corrupted.");
+            return false;
+        }
+
+        view.header = header;
+        view.mips = mips;
+        view.data = assetData;
+
+        return true;
+    }
+
+    AssetPackWriter::AssetPackWriter() : m_data(sizeof(AssetFormat::PackHeader)) {}
+
+    bool AssetPackWriter::addMesh(std::string_view name, const AssetFormat::MeshHeader& header, const void* vertices, const void* indices)
+    {
+        const uint64_t assetOffset = beginAsset(computeAssetId(name), AssetType::MESH);
+
+        if (assetOffset == 0)
+            return false;
+
+        AssetFormat::MeshHeader assetHeader = header;
+        appendData(assetOffset, &assetHeader, sizeof(assetHeader));
+        assetHeader.vertexOffset = appendData(assetOffset, vertices, static_cast<std::size_t>(header.vertexCount) * header.vertexStride);
+        assetHeader.indexOffset = appendData(assetOffset, indices, static_cast<std::size_t>(header.indexCount) * header.indexSize);
+        std::memcpy(m_data.data() + assetOffset, &assetHeader, sizeof(assetHeader));
+
+        endAsset();
+        return true;
+    }
+
+    bool AssetPackWriter::addSkeleton(std::string_view name, const uint16_t* parents, const Mat4f* inverseBindMatrices, uint32_t boneCount)
+    {
+        const uint64_t assetOffset = beginAsset(computeAssetId(name), AssetType::SKELETON);
+
+        if (assetOffset == 0)
+            return false;
+
+        AssetFormat::SkeletonHeader assetHeader {};
+        assetHeader.boneCount = boneCount;
+        appendData(assetOffset, &assetHeader, sizeof(assetHeader));
+        assetHeader.parentOffset = appendData(assetOffset, parents, boneCount * sizeof(uint16_t));
+        assetHeader.inverseBindMatrixOffset = appendData(assetOffset, inverseBindMatrices, boneCount * sizeof(Mat4f));
+        std::memcpy(m_data.data() + assetOffset, &assetHeader, sizeof(assetHeader));
+
+        endAsset();
+        return true;
+    }
+
+    bool AssetPackWriter::addTexture(std::string_view name, const AssetFormat::TextureHeader& header, const void* pixels)
+    {
+        if (!isTextureHeaderValid(header))
+        {
+            Logger::error("[AssetPackWriter] The texture '" + std::string(name) + "' has invalid properties.");
+            return false;
+        }
+
+        const uint64_t assetOffset = beginAsset(computeAssetId(name), AssetType::TEXTURE);
+
+        if (assetOffset == 0)
+            return false;
+
+        std::array<AssetFormat::TextureMip, AssetFormat::MaxMipCount> mips {};
+        const uint8_t padding[sizeof(uint32_t)] {};
+
+        appendData(assetOffset, &header, sizeof(header));
+        m_data.insert(m_data.end(), padding, padding + sizeof(padding));
+
+        const std::size_t mipTableOffset = m_data.size();
+        m_data.resize(mipTableOffset + header.mipCount * sizeof(AssetFormat::TextureMip));
+
+        const auto* mipPixels = static_cast<const uint8_t*>(pixels);
+
+        for (std::size_t mipIndex = 0; mipIndex < header.mipCount; ++mipIndex)
+        {
+            AssetFormat::TextureMip& mip = mips[mipIndex];
+            mip.rowPitch = static_cast<uint32_t>(computeMipSize(header.width, mipIndex) * recoverPixelSize(header.format));
+            mip.size = mip.rowPitch * computeMipSize(header.height, mipIndex);
+            mip.offset = appendData(assetOffset, mipPixels, mip.size);
+
+            mipPixels += mip.size;
+        }
+
+        std::memcpy(m_data.data() + mipTableOffset, mips.data(), header.mipCount * sizeof(AssetFormat::TextureMip));
+
+        endAsset();
+        return true;
+    }
+
+    std::vector<uint8_t> AssetPackWriter::build() const
+    {
+        std::vector<AssetFormat::Entry> entries = m_entries;
+        std::sort(entries.begin(), entries.end(), [] (const AssetFormat::Entry& entry1, const AssetFormat::Entry& entry2) { return (entry1.id < entry2.id); });
+
+        std::vector<uint8_t> data = m_data;
+        data.resize((data.size() + AssetFormat::DataAlignment - 1) / AssetFormat::DataAlignment * AssetFormat::DataAlignment);
+
+        AssetFormat::PackHeader header {};
+        header.entryCount = static_cast<uint32_t>(entries.size());
+        header.entryTableOffset = data.size();
+        std::memcpy(data.data(), &header, sizeof(header));
+
+        const auto* entryData = reinterpret_cast<const uint8_t*>(entries.data());
+        data.insert(data.end(), entryData, entryData + entries.size() * sizeof(AssetFormat::Entry));
+
+        return data;
+    }
+
+    bool AssetPackWriter::save(const std::string& filePath) const
+    {
+        std::ofstream file(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+
+        if (!file)
+        {
+            Logger::error("[AssetPackWriter] Couldn't open the file '" + filePath + "'.");
+            return false;
+        }
+
+        const std::vector<uint8_t> data = build();
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+        return static_cast<bool>(file);
+    }
+
+    uint64_t AssetPackWriter::beginAsset(AssetId id, AssetType type)
+    {
+        const bool isDuplicate = std::any_of(m_entries.cbegin(), m_entries.cend(), [id] (const AssetFormat::Entry& entry) { return (entry.id == id); });
+
+        if (isDuplicate)
+        {
+            Logger::error("[AssetPackWriter] An asset of identifier " + std::to_string(id) + " has already been added.");
+            return 0;
+        }
+
+        m_data.resize((m_data.size() + AssetFormat::DataAlignment - 1) / AssetFormat::DataAlignment * AssetFormat::DataAlignment);
+
+        AssetFormat::Entry& entry = m_entries.emplace_back();
+        entry.id = id;
+        entry.offset = m_data.size();
+        entry.type = type;
+
+        return entry.offset;
+    }
+
+    uint64_t AssetPackWriter::appendData(uint64_t assetOffset, const void* data, std::size_t size)
+    {
+        // Even empty data is aligned, so that its offset is always valid
+        m_data.resize((m_data.size() + AssetFormat::DataAlignment - 1) / AssetFormat::DataAlignment * AssetFormat::DataAlignment);
+
+        const std::size_t dataOffset = m_data.size();
+        m_data.resize(dataOffset + size);
+
+        if (size > 0)
+            std::memcpy(m_data.data() + dataOffset, data, size);
+
+        return dataOffset - assetOffset;
+    }
+
+    void AssetPackWriter::endAsset()
+    {
+        AssetFormat::Entry& entry = m_entries.back();
+        entry.size = m_data.size() - entry.offset;
+    }
+
+} // namespace Rei
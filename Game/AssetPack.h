@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Aabb.h"
+#include "MappedFile.h"
+#include "Matrix.h"
+#include "RenderPass.h"
+
+namespace Rei
+{
+
+    /// Identifier of an asset, computed from its name.
+    using AssetId = uint64_t;
+
+    /// Computes the identifier of an asset from its name (64-bit FNV-1a hash), so that assets can be referenced by name without storing it.
+    constexpr AssetId computeAssetId(std::string_view name) noexcept
+    {
+        AssetId hash = 14695981039346656037ull;
+
+        for (const char character : name)
+        {
+            hash ^= static_cast<uint8_t>(character);
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    enum class AssetType : uint8_t
+    {
+        MESH,     ///< Vertex & index buffers.
+        SKELETON, ///< Bone hierarchy & inverse bind matrices.
+        TEXTURE   ///< Image & its mipmaps.
+    };
+
+    /// Binary layout of asset packs. A pack is a header, followed by the assets' data, & ends with a table of its assets sorted by identifier.
+    /// Each asset starts with a header of its type, all offsets of which are relative to the asset's start; all data is aligned, & laid out
+    ///   exactly as the graphics API expects it, so that it can be given to it directly from the mapped file without any copy nor decoding.
+    /// \note Values are stored in the platform's byte order; all the supported platforms are little-endian.
+    namespace AssetFormat
+    {
+
+        constexpr uint32_t Magic = 0x41494552; // "REIA"
+        constexpr uint16_t Version = 1;
+        /// Alignment of every asset & of the data inside them, large enough for any vector or matrix & to give each asset its own cache lines.
+        constexpr std::size_t DataAlignment = 64;
+        constexpr uint16_t InvalidBone = 0xFFFF;
+        constexpr std::size_t MaxMipCount = 16;
+
+        struct PackHeader
+        {
+            uint32_t magic = Magic;
+            uint16_t version = Version;
+            uint16_t padding = 0;
+            uint32_t entryCount = 0;
+            uint32_t padding2 = 0;
+            uint64_t entryTableOffset = 0;
+        };
+
+        struct Entry
+        {
+            AssetId id = 0;
+            uint64_t offset = 0;
+            uint64_t size = 0;
+            AssetType type = AssetType::MESH;
+            uint8_t padding[7]{};
+        };
+
+        /// Flags telling which attributes a mesh's vertices are made of, stored interleaved & in this order.
+        enum VertexAttribute : uint8_t
+        {
+            POSITION     = 1 << 0, ///< 3 floats.
+            NORMAL       = 1 << 1, ///< 3 floats.
+            TEXCOORDS    = 1 << 2, ///< 2 floats.
+            TANGENT      = 1 << 3, ///< 4 floats, the last giving the bitangent's direction.
+            BONE_INDICES = 1 << 4, ///< 4 unsigned bytes.
+            BONE_WEIGHTS = 1 << 5  ///< 4 unsigned normalized bytes.
+        };
+
+        struct MeshHeader
+        {
+            uint32_t vertexCount = 0;
+            uint32_t indexCount = 0;
+            uint16_t vertexStride = 0;
+            /// Size of an index, either 2 or 4 bytes.
+            uint8_t indexSize = 0;
+            /// Combination of VertexAttribute flags.
+            uint8_t attributes = 0;
+            /// Radius of the local-space bounding sphere centered on the origin, as given to MeshRenderer.
+            float boundingRadius = 0.f;
+            Aabb bounds{};
+            uint64_t vertexOffset = 0;
+            uint64_t indexOffset = 0;
+        };
+
+        struct SkeletonHeader
+        {
+            uint32_t boneCount = 0;
+            uint32_t padding = 0;
+            /// Offset of the index of each bone's parent, InvalidBone for roots; parents always come before their children.
+            uint64_t parentOffset = 0;
+            uint64_t inverseBindMatrixOffset = 0;
+        };
+
+        struct TextureHeader
+        {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            TextureFormat format = TextureFormat::RGBA8;
+            uint8_t mipCount = 0;
+            uint16_t padding = 0;
+        };
+
+        /// Location of a mipmap, the mipmaps following the texture's header from the largest to the smallest.
+        struct TextureMip
+        {
+            uint64_t offset = 0;
+            uint32_t size = 0;
+            /// Size of a row of pixels, in bytes.
+            uint32_t rowPitch = 0;
+        };
+
+    } // namespace AssetFormat
+
+    /// Mesh stored in a mapped pack, whose data can be directly uploaded to vertex & index buffers.
+    struct MeshView
+    {
+        std::size_t getVertexDataSize() const noexcept { return static_cast<std::size_t>(header->vertexCount) * header->vertexStride; }
+        std::size_t getIndexDataSize() const noexcept { return static_cast<std::size_t>(header->indexCount) * header->indexSize; }
+
+        const AssetFormat::MeshHeader* header{};
+        const uint8_t* vertices{};
+        const uint8_t* indices{};
+    };
+
+    struct SkeletonView
+    {
+        uint32_t boneCount = 0;
+        const uint16_t* parents{};
+        const Mat4f* inverseBindMatrices{};
+    };
+
+    /// Texture stored in a mapped pack, whose mipmaps can be directly uploaded as the texture's subresources.
+    struct TextureView
+    {
+        const uint8_t* getMipData(std::size_t mipIndex) const noexcept { return data + mips[mipIndex].offset; }
+
+        const AssetFormat::TextureHeader* header{};
+        const AssetFormat::TextureMip* mips{};
+        /// Start of the texture's asset, from which the mipmaps' offsets are given.
+        const uint8_t* data{};
+    };
+
+    /// Pack of assets read from a memory-mapped file.
+    /// Opening a pack only validates its header & table; the assets' data is only read from the disk when accessed, & the views given point
+    ///   directly into the mapping, staying valid as long as the pack is open.
+    /// \note Once opened, a pack can be read from any number of threads at once.
+    class AssetPack
+    {
+    public:
+        bool isOpen() const noexcept { return m_file.isOpen(); }
+        std::size_t getEntryCount() const noexcept { return m_entryCount; }
+        const AssetFormat::Entry& getEntry(std::size_t entryIndex) const noexcept { return m_entries[entryIndex]; }
+
+        /// Opens a pack, closing any previously opened one.
+        /// \param filePath Path to the pack file.
+        /// \return True if the pack has been opened, false if the file cannot be mapped or isn't a valid pack.
+        bool open(const std::string& filePath);
+        void close() noexcept;
+        /// Finds an asset in the pack.
+        /// \param id Identifier of the asset to be found.
+        /// \return Entry of the asset, or nullptr if the pack doesn't contain it.
+        const AssetFormat::Entry* findEntry(AssetId id) const noexcept;
+        /// Reads an asset's data from the disk, so that accessing it afterward doesn't wait on I/O.
+        void prefetch(const AssetFormat::Entry& entry) const noexcept { m_file.prefetch(static_cast<std::size_t>(entry.offset), static_cast<std::size_t>(entry.size)); }
+        /// Gives a view of a mesh, after checking that all its data lies inside the asset.
+        /// \return True if the view has been filled, false if the asset isn't a valid mesh.
+        bool recoverMesh(const AssetFormat::Entry& entry, MeshView& view) const;
+        /// Gives a view of a skeleton, after checking that all its data lies inside the asset.
+        /// \return True if the view has been filled, false if the asset isn't a valid skeleton.
+        bool recoverSkeleton(const AssetFormat::Entry& entry, SkeletonView& view) const;
+        /// Gives a view of a texture, after checking that all its mipmaps lie inside the asset.
+        /// \return True if the view has been filled, false if the asset isn't a valid texture.
+        bool recoverTexture(const AssetFormat::Entry& entry, TextureView& view) const;
+
+    private:
+        MappedFile m_file{};
+        const AssetFormat::Entry* m_entries{};
+        std::size_t m_entryCount = 0;
+    };
+
+    /// Builds asset packs, for the tools converting source assets.
+    class AssetPackWriter
+    {
+    public:
+        AssetPackWriter();
+
+        std::size_t getAssetCount() const noexcept { return m_entries.size(); }
+
+        /// Adds a mesh to the pack.
+        /// \param name Name of the mesh, from which its identifier is computed.
+        /// \param header Properties of the mesh; its offsets are ignored.
+        /// \param vertices Interleaved vertex data, of header.vertexCount * header.vertexStride bytes.
+        /// \param indices Index data, of header.indexCount * header.indexSize bytes.
+        /// \return True if the mesh has been added, false if an asset of the same identifier already exists.
+        bool addMesh(std::string_view name, const AssetFormat::MeshHeader& header, const void* vertices, const void* indices);
+        /// Adds a skeleton to the pack.
+        /// \param name Name of the skeleton, from which its identifier is computed.
+        /// \param parents Index of each bone's parent, AssetFormat::InvalidBone for roots.
+        /// \param inverseBindMatrices Inverse bind matrix of each bone.
+        /// \param boneCount Number of bones.
+        /// \return True if the skeleton has been added, false if an asset of the same identifier already exists.
+        bool addSkeleton(std::string_view name, const uint16_t* parents, const Mat4f* inverseBindMatrices, uint32_t boneCount);
+        /// Adds a texture to the pack.
+        /// \param name Name of the texture, from which its identifier is computed.
+        /// \param header Properties of the texture.
+        /// \param pixels Tightly packed pixels of all the mipmaps, from the largest to the smallest, each halving the previous one's size.
+        /// \return True if the texture has been added, false if an asset of the same identifier already exists or the header is invalid.
+        bool addTexture(std::string_view name, const AssetFormat::TextureHeader& header, const void* pixels);
+        /// Gives the pack's data, ready to be written into a file.
+        std::vector<uint8_t> build() const;
+        /// Writes the pack into a file.
+        /// \param filePath Path to the file to write into, replacing its content.
+        /// \return True if the file has been written, false otherwise.
+        bool save(const std::string& filePath) const;
+
+    private:
+        /// Starts a new asset, aligning the data on DataAlignment.
+        /// \return Offset of the asset in the pack, or 0 if an asset of the same identifier already exists.
+        uint64_t beginAsset(AssetId id, AssetType type);
+        /// Appends data aligned on DataAlignment.
+        /// \return Offset of the data relative to the given asset's start.
+        uint64_t appendData(uint64_t assetOffset, const void* data, std::size_t size);
+        void endAsset();
+
+        std::vector<uint8_t> m_data{};
+        std::vector<AssetFormat::Entry> m_entries{};
+    };
+
+} // namespace Rei
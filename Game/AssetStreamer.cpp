@@ -0,0 +1,426 @@
+#include "AssetStreamer.h"
+#include "Logger.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Rei
+{
+
+    AssetHandle::AssetHandle(const AssetHandle& handle) noexcept : m_streamer{ handle.m_streamer }, m_index{ handle.m_index }
+    {
+        if (m_streamer != nullptr)
+            m_streamer->acquire(m_index);
+    }
+
+    void AssetHandle::reset() noexcept
+    {
+        if (m_streamer == nullptr)
+            return;
+
+        m_streamer->release(m_index);
+        m_streamer = nullptr;
+    }
+
+    AssetHandle& AssetHandle::operator=(const AssetHandle& handle) noexcept
+    {
+        // Acquiring first keeps the asset alive if both handles already refer to it
+        if (handle.m_streamer != nullptr)
+            handle.m_streamer->acquire(handle.m_index);
+
+        reset();
+
+        m_streamer = handle.m_streamer;
+        m_index = handle.m_index;
+
+        return *this;
+    }
+
+    AssetHandle& AssetHandle::operator=(AssetHandle&& handle) noexcept
+    {
+        if (this == &handle)
+            return *this;
+
+        reset();
+
+        m_streamer = handle.m_streamer;
+        m_index = handle.m_index;
+        handle.m_streamer = nullptr;
+
+        return *this;
+    }
+
+    AssetStreamer::AssetStreamer(MeshFactory meshFactory, TextureFactory textureFactory, std::size_t threadCount, std::size_t maxAssetCount)
+        : m_meshFactory{ std::move(meshFactory) }, m_textureFactory{ std::move(textureFactory) }, m_slots(maxAssetCount)
+    {
+        assert("Error: An asset streamer needs at least one I/O thread." && threadCount > 0);
+
+        // Slots are taken from the back, the lowest indices being used first
+        m_freeSlots.resize(maxAssetCount);
+        for (std::size_t slotIndex = 0; slotIndex < maxAssetCount; ++slotIndex)
+            m_freeSlots[slotIndex] = static_cast<uint32_t>(maxAssetCount - slotIndex - 1);
+
+        m_slotIndices.reserve(maxAssetCount);
+        m_requests.reserve(maxAssetCount);
+        m_releasedSlots.reserve(maxAssetCount);
+
+        m_threads.reserve(threadCount);
+        for (std::size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+            m_threads.emplace_back(&AssetStreamer::processRequests, this);
+    }
+
+    std::size_t AssetStreamer::getPendingCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pendingCount;
+    }
+
+    std::size_t AssetStreamer::getAssetCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_slotIndices.size();
+    }
+
+    bool AssetStreamer::mountPack(const std::string& filePath)
+    {
+        auto pack = std::make_unique<AssetPack>();
+
+        if (!pack->open(filePath))
+            return false;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_packs.emplace_back(std::move(pack));
+
+        return true;
+    }
+
+    AssetHandle AssetStreamer::load(AssetId id, uint8_t priority)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const auto slotIt = m_slotIndices.find(id);
+
+        if (slotIt != m_slotIndices.cend())
+        {
+            // The asset may have been released but not yet unloaded; referencing it again keeps it from being unloaded
+            const uint32_t slotIndex = slotIt->second;
+            Slot& slot = m_slots[slotIndex];
+            slot.refCount.fetch_add(1, std::memory_order_relaxed);
+
+            if (slot.state.load(std::memory_order_relaxed) == AssetState::CANCELLED)
+            {
+                slot.state.store(AssetState::QUEUED, std::memory_order_relaxed);
+                slot.priority = priority;
+                ++m_pendingCount;
+                pushRequest(slotIndex);
+            }
+            else if (priority > slot.priority && slot.state.load(std::memory_order_relaxed) == AssetState::QUEUED)
+            {
+                slot.priority = priority;
+                pushRequest(slotIndex);
+            }
+
+            return AssetHandle(*this, slotIndex);
+        }
+
+        const AssetPack* pack = nullptr;
+        const AssetFormat::Entry* entry = nullptr;
+
+        for (auto packIt = m_packs.crbegin(); packIt != m_packs.crend() && entry == nullptr; ++packIt)
+        {
+            pack = packIt->get();
+            entry = pack->findEntry(id);
+        }
+
+        if (entry == nullptr)
+        {
+            Logger::error("[AssetStreamer] No mounted pack contains the asset " + std::to_string(id) + '.');
+            return AssetHandle();
+        }
+
+        if (m_freeSlots.empty())
+        {
+            Logger::error("[AssetStreamer] Too many assets are referenced to load the asset " + std::to_string(id) + '.');
+            return AssetHandle();
+        }
+
+        const uint32_t slotIndex = m_freeSlots.back();
+        m_freeSlots.pop_back();
+
+        Slot& slot = m_slots[slotIndex];
+        slot.refCount.store(1, std::memory_order_relaxed);
+        slot.state.store(AssetState::QUEUED, std::memory_order_relaxed);
+        slot.priority = priority;
+        slot.id = id;
+        slot.pack = pack;
+        slot.entry = entry;
+
+        m_slotIndices.emplace(id, slotIndex);
+        ++m_pendingCount;
+        pushRequest(slotIndex);
+
+        return AssetHandle(*this, slotIndex);
+    }
+
+    void AssetStreamer::setPriority(const AssetHandle& handle, uint8_t priority)
+    {
+        if (handle.m_streamer != this)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Slot& slot = m_slots[handle.m_index];
+
+        if (slot.priority == priority || slot.state.load(std::memory_order_relaxed) != AssetState::QUEUED)
+            return;
+
+        // The previous request stays in the queue, & is skipped once its priority is found not to be the slot's anymore
+        slot.priority = priority;
+        pushRequest(handle.m_index);
+    }
+
+    AssetState AssetStreamer::getState(const AssetHandle& handle) const noexcept
+    {
+        if (handle.m_streamer != this)
+            return AssetState::FAILED;
+
+        return m_slots[handle.m_index].state.load(std::memory_order_acquire);
+    }
+
+    MeshBuffers* AssetStreamer::getMesh(const AssetHandle& handle) const noexcept
+    {
+        const Slot* slot = recoverLoadedSlot(handle, AssetType::MESH);
+        return (slot != nullptr ? slot->mesh.get() : nullptr);
+    }
+
+    const MeshView* AssetStreamer::getMeshView(const AssetHandle& handle) const noexcept
+    {
+        const Slot* slot = recoverLoadedSlot(handle, AssetType::MESH);
+        return (slot != nullptr ? &slot->meshView : nullptr);
+    }
+
+    const SkeletonView* AssetStreamer::getSkeleton(const AssetHandle& handle) const noexcept
+    {
+        const Slot* slot = recoverLoadedSlot(handle, AssetType::SKELETON);
+        return (slot != nullptr ? &slot->skeletonView : nullptr);
+    }
+
+    Texture2D* AssetStreamer::getTexture(const AssetHandle& handle) const noexcept
+    {
+        const Slot* slot = recoverLoadedSlot(handle, AssetType::TEXTURE);
+        return (slot != nullptr ? slot->texture.get() : nullptr);
+    }
+
+    const TextureView* AssetStreamer::getTextureView(const AssetHandle& handle) const noexcept
+    {
+        const Slot* slot = recoverLoadedSlot(handle, AssetType::TEXTURE);
+        return (slot != nullptr ? &slot->textureView : nullptr);
+    }
+
+    void AssetStreamer::update()
+    {
+        REI_PROFILE_ZONE("AssetStreamer::update");
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::size_t keptSlotCount = 0;
+
+        for (const uint32_t slotIndex : m_releasedSlots)
+        {
+            Slot& slot = m_slots[slotIndex];
+
+            // An asset referenced again since is kept; it may also have been released again, its slot then being listed twice
+            const auto slotIt = m_slotIndices.find(slot.id);
+
+            if (slot.refCount.load(std::memory_order_relaxed) != 0 || slotIt == m_slotIndices.cend() || slotIt->second != slotIndex)
+                continue;
+
+            const AssetState state = slot.state.load(std::memory_order_relaxed);
+
+            // An asset being loaded can't be unloaded until its thread is done with it
+            if (state == AssetState::LOADING)
+            {
+                m_releasedSlots[keptSlotCount++] = slotIndex;
+                continue;
+            }
+
+            if (state == AssetState::QUEUED)
+                --m_pendingCount;
+
+            slot.mesh.reset();
+            slot.texture.reset();
+            slot.meshView = MeshView();
+            slot.skeletonView = SkeletonView();
+            slot.textureView = TextureView();
+            slot.state.store(AssetState::FAILED, std::memory_order_relaxed);
+            ++slot.generation;
+
+            m_slotIndices.erase(slotIt);
+            m_freeSlots.emplace_back(slotIndex);
+        }
+
+        m_releasedSlots.resize(keptSlotCount);
+
+        if (m_pendingCount == 0)
+            m_idleCondition.notify_all();
+    }
+
+    void AssetStreamer::waitUntilIdle()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idleCondition.wait(lock, [this] () { return (m_pendingCount == 0); });
+    }
+
+    AssetStreamer::~AssetStreamer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_isStopping = true;
+        }
+
+        m_requestCondition.notify_all();
+
+        for (std::thread& thread : m_threads)
+            thread.join();
+
+        assert("Error: Handles to the streamer's assets are still alive."
+            && std::none_of(m_slots.cbegin(), m_slots.cend(), [] (const Slot& slot) { return (slot.refCount.load(std::memory_order_relaxed) != 0); }));
+    }
+
+    const AssetStreamer::Slot* AssetStreamer::recoverLoadedSlot(const AssetHandle& handle, AssetType type) const noexcept
+    {
+        if (handle.m_streamer != this)
+            return nullptr;
+
+        const Slot& slot = m_slots[handle.m_index];
+
+        // The acquire load makes the resources written by the I/O thread visible
+        if (slot.state.load(std::memory_order_acquire) != AssetState::LOADED || slot.entry->type != type)
+            return nullptr;
+
+        return &slot;
+    }
+
+    void AssetStreamer::pushRequest(uint32_t slotIndex)
+    {
+        const Slot& slot = m_slots[slotIndex];
+
+        m_requests.emplace_back(Request{ slot.priority, m_nextSequence++, slotIndex, slot.generation });
+        std::push_heap(m_requests.begin(), m_requests.end());
+
+        m_requestCondition.notify_one();
+    }
+
+    void AssetStreamer::acquire(uint32_t slotIndex) noexcept
+    {
+        m_slots[slotIndex].refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void AssetStreamer::release(uint32_t slotIndex) noexcept
+    {
+        if (m_slots[slotIndex].refCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_releasedSlots.emplace_back(slotIndex);
+    }
+
+    void AssetStreamer::processRequests()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (true)
+        {
+            m_requestCondition.wait(lock, [this] () { return (m_isStopping || !m_requests.empty()); });
+
+            if (m_isStopping)
+                return;
+
+            std::pop_heap(m_requests.begin(), m_requests.end());
+            const Request request = m_requests.back();
+            m_requests.pop_back();
+
+            Slot& slot = m_slots[request.slotIndex];
+
+            // Requests of unloaded slots, or superseded by a change of priority, are outdated
+            if (slot.generation != request.generation || slot.priority != request.priority || slot.state.load(std::memory_order_relaxed) != AssetState::QUEUED)
+                continue;
+
+            if (slot.refCount.load(std::memory_order_relaxed) == 0)
+            {
+                slot.state.store(AssetState::CANCELLED, std::memory_order_relaxed);
+                --m_pendingCount;
+
+                if (m_pendingCount == 0)
+                    m_idleCondition.notify_all();
+
+                continue;
+            }
+
+            slot.state.store(AssetState::LOADING, std::memory_order_relaxed);
+
+            lock.unlock();
+            const bool isLoaded = loadSlot(slot);
+            lock.lock();
+
+            slot.state.store((isLoaded ? AssetState::LOADED : AssetState::FAILED), std::memory_order_release);
+            --m_pendingCount;
+
+            if (m_pendingCount == 0)
+                m_idleCondition.notify_all();
+        }
+    }
+
+    bool AssetStreamer::loadSlot(Slot& slot) const
+    {
+        REI_PROFILE_ZONE("AssetStreamer::loadSlot");
+
+        const AssetPack& pack = *slot.pack;
+        const AssetFormat::Entry& entry = *slot.entry;
+
+        // Faulting the pages in here keeps the factories, & whoever accesses the data afterward, from waiting on the disk
+        pack.prefetch(entry);
+
+        switch (entry.type)
+        {
+            case AssetType::MESH:
+                if (!pack.recoverMesh(entry, slot.meshView))
+                    break;
+
+                if (!m_meshFactory)
+                    return true;
+
+                slot.mesh = m_meshFactory(slot.meshView);
+
+                if (slot.mesh != nullptr)
+                    return true;
+
+                break;
+
+            case AssetType::SKELETON:
+                if (pack.recoverSkeleton(entry, slot.skeletonView))
+                    return true;
+
+                break;
+
+            case AssetType::TEXTURE:
+                if (!pack.recoverTexture(entry, slot.textureView))
+                    break;
+
+                if (!m_textureFactory)
+                    return true;
+
+                slot.texture = m_textureFactory(slot.textureView);
+
+                if (slot.texture != nullptr)
+                    return true;
+
+                break;
+        }
+
+        Logger::error("[AssetStreamer] The asset " + std::to_string(slot.id) + " couldn't be loaded.");
+        return false;
+    }
+
+} // namespace Rei
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "AssetPack.h"
+
+namespace Rei
+{
+    class AssetStreamer;
+    class MeshBuffers;
+    using MeshBuffersPtr = std::shared_ptr<MeshBuffers>;
+    class Texture2D;
+    using Texture2DPtr = std::shared_ptr<Texture2D>;
+
+    enum class AssetState : uint8_t
+    {
+        QUEUED,    ///< Waiting for an I/O thread to load it.
+        LOADING,   ///< Being read & uploaded by an I/O thread.
+        LOADED,    ///< Ready to be used.
+        FAILED,    ///< Couldn't be loaded, or the handle is invalid.
+        CANCELLED  ///< All its handles have been released before it was loaded.
+    };
+
+    /// Reference-counted handle to an asset of an AssetStreamer; the asset is kept loaded as long as a handle refers to it.
+    /// Copying a handle only increments an atomic counter, & handles can be copied & released from any thread.
+    /// \note Handles must not outlive their streamer.
+    class AssetHandle
+    {
+        friend AssetStreamer;
+
+    public:
+        AssetHandle() = default;
+        AssetHandle(const AssetHandle& handle) noexcept;
+        AssetHandle(AssetHandle&& handle) noexcept : m_streamer{ handle.m_streamer }, m_index{ handle.m_index } { handle.m_streamer = nullptr; }
+
+        bool isValid() const noexcept { return (m_streamer != nullptr); }
+        /// Gets the index of the asset in its streamer, which stays the same as long as the asset is referenced; it can thus be used to index
+        ///   resource tables, such as the renderer's meshes & textures.
+        uint32_t getIndex() const noexcept { return m_index; }
+
+        void reset() noexcept;
+
+        AssetHandle& operator=(const AssetHandle& handle) noexcept;
+        AssetHandle& operator=(AssetHandle&& handle) noexcept;
+        bool operator==(const AssetHandle& handle) const noexcept { return (m_streamer == handle.m_streamer && m_index == handle.m_index); }
+        bool operator!=(const AssetHandle& handle) const noexcept { return !(*this == handle); }
+
+        ~AssetHandle() { reset(); }
+
+    private:
+        /// Creates a handle, taking over a reference already counted.
+        AssetHandle(AssetStreamer& streamer, uint32_t index) noexcept : m_streamer{ &streamer }, m_index{ index } {}
+
+        AssetStreamer* m_streamer{};
+        uint32_t m_index = 0;
+    };
+
+    /// Loads the meshes, skeletons & textures of memory-mapped asset packs on background I/O threads.
+    /// Loads are queued by priority, & requesting an already requested asset gives another handle to it. The I/O threads read the assets'
+    ///   pages from the disk, then hand their views to the given factories to create the graphics resources right from the mapped data. Once
+    ///   all the handles of an asset are released, its pending load is cancelled, & the asset is unloaded by the next update.
+    /// To avoid hitching when an asset is first needed (for instance a weapon skin appearing), request it beforehand at a low priority, then
+    ///   raise its priority when it becomes urgent; until it is loaded, the getters return nullptr so that a fallback can be used instead.
+    /// \note Packs must be mounted, & assets requested & unloaded, from a single thread (usually the main one); the loaded resources can be
+    ///   fetched from any thread holding a handle to them.
+    class AssetStreamer
+    {
+        friend AssetHandle;
+
+    public:
+        /// Creates the vertex & index buffers of a mesh.
+        /// \note Called from the I/O threads, possibly concurrently; D3D11 devices can create resources from any thread.
+        using MeshFactory = std::function<MeshBuffersPtr(const MeshView&)>;
+        /// Creates a texture & uploads its mipmaps.
+        /// \note Called from the I/O threads, possibly concurrently; D3D11 devices can create resources from any thread.
+        using TextureFactory = std::function<Texture2DPtr(const TextureView&)>;
+
+        static constexpr uint8_t LowPriority = 0;
+        static constexpr uint8_t DefaultPriority = 128;
+        /// Priority of assets needed right away, for instance while the map is loading.
+        static constexpr uint8_t HighPriority = 255;
+        static constexpr std::size_t DefaultThreadCount = 2;
+        static constexpr std::size_t DefaultMaxAssetCount = 4096;
+
+        /// Creates an asset streamer.
+        /// \param meshFactory Function creating the meshes' resources; if empty, meshes only have their views, like a dedicated server needs.
+        /// \param textureFactory Function creating the textures; if empty, textures only have their views.
+        /// \param threadCount Number of I/O threads; several help hiding the disk's latency & parallelizing the uploads.
+        /// \param maxAssetCount Maximum number of assets referenced at once.
+        AssetStreamer(MeshFactory meshFactory, TextureFactory textureFactory, std::size_t threadCount = DefaultThreadCount,
+                      std::size_t maxAssetCount = DefaultMaxAssetCount);
+        AssetStreamer(const AssetStreamer&) = delete;
+        AssetStreamer(AssetStreamer&&) = delete;
+
+        /// Gets the number of assets waiting to be loaded or being loaded.
+        std::size_t getPendingCount() const;
+        std::size_t getAssetCount() const;
+
+        /// Maps a pack, whose assets can be requested from then on; they take precedence over those of the same identifier in the packs
+        ///   mounted before, so that patches or downloaded content can replace assets.
+        /// \param filePath Path to the pack file.
+        /// \return True if the pack has been mounted, false if it is invalid.
+        bool mountPack(const std::string& filePath);
+        /// Requests an asset to be loaded, or gives another handle to it if it has already been requested.
+        /// \param id Identifier of the asset.
+        /// \param priority Priority of the load, the highest being loaded first; an already requested asset takes the highest of both priorities.
+        /// \return Handle to the asset, invalid if no mounted pack contains it or if too many assets are referenced.
+        AssetHandle load(AssetId id, uint8_t priority = DefaultPriority);
+        AssetHandle load(std::string_view name, uint8_t priority = DefaultPriority) { return load(computeAssetId(name), priority); }
+        /// Changes the priority of an asset, if it is still waiting to be loaded.
+        void setPriority(const AssetHandle& handle, uint8_t priority);
+        AssetState getState(const AssetHandle& handle) const noexcept;
+        bool isLoaded(const AssetHandle& handle) const noexcept { return (getState(handle) == AssetState::LOADED); }
+        /// Gets a mesh's resources.
+        /// \return Mesh's buffers, or nullptr if the asset isn't a loaded mesh or has no resources.
+        MeshBuffers* getMesh(const AssetHandle& handle) const noexcept;
+        /// Gets a mesh's data, pointing into its pack.
+        /// \return Mesh's view, or nullptr if the asset isn't a loaded mesh.
+        const MeshView* getMeshView(const AssetHandle& handle) const noexcept;
+        /// Gets a skeleton's data, pointing into its pack.
+        /// \return Skeleton's view, or nullptr if the asset isn't a loaded skeleton.
+        const SkeletonView* getSkeleton(const AssetHandle& handle) const noexcept;
+        /// Gets a texture.
+        /// \return Texture, or nullptr if the asset isn't a loaded texture or has no resource.
+        Texture2D* getTexture(const AssetHandle& handle) const noexcept;
+        /// Gets a texture's data, pointing into its pack.
+        /// \return Texture's view, or nullptr if the asset isn't a loaded texture.
+        const TextureView* getTextureView(const AssetHandle& handle) const noexcept;
+        /// Unloads the assets whose handles have all been released, destroying their resources; to be called once a frame.
+        /// Unloading here rather than when the last handle is released ensures that resources are destroyed from a single thread, outside any
+        ///   frame using them.
+        void update();
+        /// Waits for all the requested assets to be loaded, for instance at the end of a map's loading.
+        void waitUntilIdle();
+
+        AssetStreamer& operator=(const AssetStreamer&) = delete;
+        AssetStreamer& operator=(AssetStreamer&&) = delete;
+
+        /// Stops the I/O threads, cancelling the pending loads.
+        /// \note All the handles must have been released beforehand.
+        ~AssetStreamer();
+
+    private:
+        struct Slot
+        {
+            std::atomic<uint32_t> refCount = 0;
+            std::atomic<AssetState> state = AssetState::FAILED;
+            /// Incremented each time the slot is reused, to detect outdated requests.
+            uint32_t generation = 0;
+            uint8_t priority = 0;
+            AssetId id = 0;
+            const AssetPack* pack{};
+            const AssetFormat::Entry* entry{};
+            MeshBuffersPtr mesh{};
+            Texture2DPtr texture{};
+            MeshView meshView{};
+            SkeletonView skeletonView{};
+            TextureView textureView{};
+        };
+
+        struct Request
+        {
+            /// Checks if the request is to be processed after another one: of a lower priority, or of the same but issued later.
+            bool operator<(const Request& request) const noexcept
+            {
+                return (priority < request.priority || (priority == request.priority && sequence > request.sequence));
+            }
+
+            uint8_t priority = 0;
+            uint64_t sequence = 0;
+            uint32_t slotIndex = 0;
+            uint32_t generation = 0;
+        };
+
+        const Slot* recoverLoadedSlot(const AssetHandle& handle, AssetType type) const noexcept;
+        /// Queues a slot's load at its current priority; requires the mutex to be locked.
+        void pushRequest(uint32_t slotIndex);
+        /// Adds a reference to an asset.
+        void acquire(uint32_t slotIndex) noexcept;
+        /// Removes a reference to an asset, marking it to be unloaded if it was the last one.
+        void release(uint32_t slotIndex) noexcept;
+        void processRequests();
+        /// Reads an asset & creates its resources, from an I/O thread.
+        /// \return True if the asset has been loaded, false otherwise.
+        bool loadSlot(Slot& slot) const;
+
+        MeshFactory m_meshFactory{};
+        TextureFactory m_textureFactory{};
+        std::vector<std::unique_ptr<AssetPack>> m_packs{};
+        std::vector<Slot> m_slots;
+        std::vector<uint32_t> m_freeSlots{};
+        std::unordered_map<AssetId, uint32_t> m_slotIndices{};
+
+        mutable std::mutex m_mutex{};
+        std::condition_variable m_requestCondition{};
+        std::condition_variable m_idleCondition{};
+        /// Requests sorted as a heap, the next one to process at the front; outdated requests are skipped when popped.
+        std::vector<Request> m_requests{};
+        uint64_t m_nextSequence = 0;
+        std::size_t m_pendingCount = 0;
+        /// Slots whose last reference has been released, to be unloaded by the next update.
+        std::vector<uint32_t> m_releasedSlots{};
+        bool m_isStopping = false;
+        std::vector<std::thread> m_threads{};
+    };
+
+} // namespace Rei
@@ -89,6 +89,18 @@ namespace Rei
         return *this;
     }
 
+    bool Bitset::operator==(const Bitset& bitset) const noexcept
+    {
+        const std::size_t commonSize = std::min(m_bits.size(), bitset.getSize());
+
+        if (!std::equal(m_bits.cbegin(), m_bits.cbegin() + static_cast<std::ptrdiff_t>(commonSize), bitset.m_bits.cbegin()))
+            return false;
+
+        // Bitsets of different sizes are considered equal if the extra bits of the largest one are all disabled
+        const std::vector<bool>& largestBits = (m_bits.size() > commonSize ? m_bits : bitset.m_bits);
+        return (std::find(largestBits.cbegin() + static_cast<std::ptrdiff_t>(commonSize), largestBits.cend(), true) == largestBits.cend());
+    }
+
     std::ostream& operator<<(std::ostream& stream, const Bitset& bitset)
     {
         stream << "[ " << bitset[0];
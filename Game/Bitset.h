@@ -43,7 +43,7 @@ namespace Rei
         Bitset& operator<<=(std::size_t shift);
         Bitset& operator>>=(std::size_t shift);
         bool operator[](std::size_t index) const noexcept { return m_bits[index]; }
-        bool operator==(const Bitset& bitset) const noexcept { return std::equal(m_bits.cbegin(), m_bits.cend(), bitset.m_bits.cbegin()); }
+        bool operator==(const Bitset& bitset) const noexcept;
         bool operator!=(const Bitset& bitset) const noexcept { return !(*this == bitset); }
         friend std::ostream& operator<<(std::ostream& stream, const Bitset& bitset);
 
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Aabb.h"
+#include "Component.h"
+
+namespace Rei
+{
+    class BroadphaseSystem;
+    class TransformNode;
+
+    /// Component giving an entity a box following a transform node, indexed by the BroadphaseSystem for collision & proximity queries.
+    /// The box is given relative to the transform; its world-space box, enclosing the transformed one, is only recomputed when the transform's
+    ///   world matrix or the local box changes.
+    class Bounds final : public Component
+    {
+        friend BroadphaseSystem;
+
+    public:
+        /// Mask of all the layers, accepting any entity when used to filter queries.
+        static constexpr uint32_t AllLayers = ~0u;
+
+        /// Creates bounds.
+        /// \param transform Transform node the box follows; must outlive the component.
+        /// \param localBounds Box relative to the transform.
+        /// \param layers Mask of the layers the entity belongs to (for instance players, projectiles or triggers), against which queries are filtered.
+        Bounds(const TransformNode& transform, const Aabb& localBounds, uint32_t layers = 1) noexcept
+            : m_transform{ &transform }, m_localBounds{ localBounds }, m_layers{ layers } {}
+
+        const TransformNode& getTransform() const noexcept { return *m_transform; }
+        const Aabb& getLocalBounds() const noexcept { return m_localBounds; }
+        uint32_t getLayers() const noexcept { return m_layers; }
+        /// Gets the world-space box, as of the last broadphase update.
+        const Aabb& getWorldBounds() const noexcept { return m_worldBounds; }
+
+        void setTransform(const TransformNode& transform) noexcept
+        {
+            m_transform = &transform;
+            m_isDirty = true;
+        }
+
+        void setLocalBounds(const Aabb& localBounds) noexcept
+        {
+            m_localBounds = localBounds;
+            m_isDirty = true;
+        }
+
+        void setLayers(uint32_t layers) noexcept
+        {
+            m_layers = layers;
+            m_isDirty = true;
+        }
+
+    private:
+        const TransformNode* m_transform{};
+        Aabb m_localBounds{};
+        uint32_t m_layers = 1;
+        Aabb m_worldBounds{};
+        /// Version of the transform's world matrix the world-space box has been computed from.
+        uint32_t m_transformVersion = 0;
+        bool m_isDirty = true;
+    };
+} // namespace Rei
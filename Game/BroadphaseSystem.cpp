@@ -0,0 +1,329 @@
+#include "BroadphaseSystem.h"
+#include "FrameTimer.h"
+#include "MatrixSimd.h"
+#include "Profiler.h"
+#include "TransformGraph.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Rei
+{
+
+    namespace
+    {
+
+        Vec3f computeInverseDirection(const Vec3f& direction) noexcept
+        {
+            // Null components give infinite inverses, making the slabs along their axis either always or never crossed
+            return Vec3f(1.f / direction.x(), 1.f / direction.y(), 1.f / direction.z());
+        }
+
+    } // namespace
+
+    BroadphaseSystem::BroadphaseSystem(float margin) : m_margin{ margin }
+    {
+        registerComponents<Bounds>();
+        registerWrittenComponents<Bounds>();
+
+        m_isFixedStep = true;
+    }
+
+    std::size_t BroadphaseSystem::queryBox(const Aabb& box, Entity** results, std::size_t maxResultCount, uint32_t layerMask) const
+    {
+        std::size_t resultCount = 0;
+
+        if (maxResultCount == 0)
+            return resultCount;
+
+        m_tree.traverse([&box] (const Aabb& fatBounds) { return box.intersects(fatBounds); },
+                        [&] (uint32_t proxyId)
+        {
+            if ((m_tree.getLayers(proxyId) & layerMask) == 0 || !box.intersects(m_tree.getBounds(proxyId)))
+                return true;
+
+            results[resultCount++] = m_proxyEntities[proxyId];
+            return (resultCount < maxResultCount);
+        });
+
+        return resultCount;
+    }
+
+    std::size_t BroadphaseSystem::queryRadius(const Vec3f& center, float radius, Entity** results, std::size_t maxResultCount, uint32_t layerMask) const
+    {
+        std::size_t resultCount = 0;
+
+        if (maxResultCount == 0)
+            return resultCount;
+
+        m_tree.traverse([&center, radius] (const Aabb& fatBounds) { return fatBounds.intersectsSphere(center, radius); },
+                        [&] (uint32_t proxyId)
+        {
+            if ((m_tree.getLayers(proxyId) & layerMask) == 0 || !m_tree.getBounds(proxyId).intersectsSphere(center, radius))
+                return true;
+
+            results[resultCount++] = m_proxyEntities[proxyId];
+            return (resultCount < maxResultCount);
+        });
+
+        return resultCount;
+    }
+
+    std::size_t BroadphaseSystem::queryRay(const Vec3f& origin, const Vec3f& direction, float maxDistance, BroadphaseRayHit* results,
+                                           std::size_t maxResultCount, uint32_t layerMask) const
+    {
+        std::size_t resultCount = 0;
+
+        if (maxResultCount == 0)
+            return resultCount;
+
+        const Vec3f invDirection = computeInverseDirection(direction);
+
+        // Once the results are full, nodes farther than the farthest hit kept can't give any closer one
+        float farthestDistance = maxDistance;
+
+        m_tree.traverse([&] (const Aabb& fatBounds) { return (fatBounds.intersectRay(origin, invDirection, farthestDistance) <= farthestDistance); },
+                        [&] (uint32_t proxyId)
+        {
+            if ((m_tree.getLayers(proxyId) & layerMask) == 0)
+                return true;
+
+            const float distance = m_tree.getBounds(proxyId).intersectRay(origin, invDirection, farthestDistance);
+
+            if (distance > farthestDistance)
+                return true;
+
+            // The results are kept sorted by distance, the farthest one being discarded if they are full
+            std::size_t hitIndex = (resultCount < maxResultCount ? resultCount++ : resultCount - 1);
+
+            for (; hitIndex > 0 && results[hitIndex - 1].distance > distance; --hitIndex)
+                results[hitIndex] = results[hitIndex - 1];
+
+            results[hitIndex] = BroadphaseRayHit{ m_proxyEntities[proxyId], distance };
+
+            if (resultCount == maxResultCount)
+                farthestDistance = results[resultCount - 1].distance;
+
+            return true;
+        });
+
+        return resultCount;
+    }
+
+    Entity* BroadphaseSystem::findNearest(const Vec3f& point, float maxDistance, uint32_t layerMask, const Entity* ignoredEntity) const
+    {
+        Entity* nearestEntity = nullptr;
+        float nearestSqDistance = maxDistance * maxDistance;
+
+        m_tree.traverse([&] (const Aabb& fatBounds) { return (fatBounds.computeSqDistance(point) <= nearestSqDistance); },
+                        [&] (uint32_t proxyId)
+        {
+            Entity* entity = m_proxyEntities[proxyId];
+
+            if ((m_tree.getLayers(proxyId) & layerMask) == 0 || entity == ignoredEntity)
+                return true;
+
+            const float sqDistance = m_tree.getBounds(proxyId).computeSqDistance(point);
+
+            if (sqDistance <= nearestSqDistance)
+            {
+                nearestEntity = entity;
+                nearestSqDistance = sqDistance;
+            }
+
+            return true;
+        });
+
+        return nearestEntity;
+    }
+
+    void BroadphaseSystem::queryBoxes(const Aabb* boxes, std::size_t queryCount, Entity** results, std::size_t maxResultCountPerQuery,
+                                      std::size_t* resultCounts, uint32_t layerMask) const
+    {
+        REI_PROFILE_ZONE("BroadphaseSystem::queryBoxes");
+
+        runBatch(queryCount, [&] (std::size_t queryIndex)
+        {
+            resultCounts[queryIndex] = queryBox(boxes[queryIndex], results + queryIndex * maxResultCountPerQuery, maxResultCountPerQuery, layerMask);
+        });
+    }
+
+    void BroadphaseSystem::queryRadii(const Vec3f* centers, const float* radii, std::size_t queryCount, Entity** results,
+                                      std::size_t maxResultCountPerQuery, std::size_t* resultCounts, uint32_t layerMask) const
+    {
+        REI_PROFILE_ZONE("BroadphaseSystem::queryRadii");
+
+        runBatch(queryCount, [&] (std::size_t queryIndex)
+        {
+            resultCounts[queryIndex] = queryRadius(centers[queryIndex], radii[queryIndex], results + queryIndex * maxResultCountPerQuery,
+                                                   maxResultCountPerQuery, layerMask);
+        });
+    }
+
+    void BroadphaseSystem::queryRays(const Vec3f* origins, const Vec3f* directions, float maxDistance, std::size_t queryCount, BroadphaseRayHit* results,
+                                     std::size_t maxResultCountPerQuery, std::size_t* resultCounts, uint32_t layerMask) const
+    {
+        REI_PROFILE_ZONE("BroadphaseSystem::queryRays");
+
+        runBatch(queryCount, [&] (std::size_t queryIndex)
+        {
+            resultCounts[queryIndex] = queryRay(origins[queryIndex], directions[queryIndex], maxDistance, results + queryIndex * maxResultCountPerQuery,
+                                                maxResultCountPerQuery, layerMask);
+        });
+    }
+
+    void BroadphaseSystem::findPairs(std::vector<EntityPair>& pairs, uint32_t layerMask)
+    {
+        REI_PROFILE_ZONE("BroadphaseSystem::findPairs");
+
+        pairs.clear();
+
+        // Each thread gathers its pairs separately, any thread not belonging to the pool using the last buffer
+        m_threadPairs.resize((m_threadPool != nullptr ? m_threadPool->getThreadCount() : 0) + 1);
+
+        for (std::vector<EntityPair>& threadPairs : m_threadPairs)
+            threadPairs.clear();
+
+        const auto findProxyPairs = [this, layerMask] (std::size_t beginIndex, std::size_t endIndex)
+        {
+            std::vector<EntityPair>& threadPairs = m_threadPairs[m_threadPool != nullptr ? m_threadPool->getCurrentThreadIndex() : 0];
+
+            for (std::size_t proxyIndex = beginIndex; proxyIndex < endIndex; ++proxyIndex)
+            {
+                const auto proxyId = static_cast<uint32_t>(proxyIndex);
+                Entity* entity = m_proxyEntities[proxyId];
+
+                if (entity == nullptr || (m_tree.getLayers(proxyId) & layerMask) == 0)
+                    continue;
+
+                const Aabb& bounds = m_tree.getBounds(proxyId);
+
+                m_tree.traverse([&bounds] (const Aabb& fatBounds) { return bounds.intersects(fatBounds); },
+                                [&] (uint32_t otherProxyId)
+                {
+                    // Each pair is found from both of its proxies; only the one with the lowest identifier keeps it
+                    if (otherProxyId <= proxyId || (m_tree.getLayers(otherProxyId) & layerMask) == 0 || !bounds.intersects(m_tree.getBounds(otherProxyId)))
+                        return true;
+
+                    Entity* otherEntity = m_proxyEntities[otherProxyId];
+
+                    if (entity->getId() < otherEntity->getId())
+                        threadPairs.push_back(EntityPair{ entity, otherEntity });
+                    else
+                        threadPairs.push_back(EntityPair{ otherEntity, entity });
+
+                    return true;
+                });
+            }
+        };
+
+        if (m_threadPool != nullptr)
+            m_threadPool->parallelFor(m_proxyEntities.size(), ParallelGrainSize, findProxyPairs);
+        else
+            findProxyPairs(0, m_proxyEntities.size());
+
+        std::size_t pairCount = 0;
+        for (const std::vector<EntityPair>& threadPairs : m_threadPairs)
+            pairCount += threadPairs.size();
+
+        pairs.reserve(pairCount);
+
+        for (const std::vector<EntityPair>& threadPairs : m_threadPairs)
+            pairs.insert(pairs.end(), threadPairs.begin(), threadPairs.end());
+
+        // The jobs' distribution between threads varying from a call to another, the pairs are sorted not to depend on it
+        std::sort(pairs.begin(), pairs.end(), [] (const EntityPair& pair1, const EntityPair& pair2)
+        {
+            return (pair1.first->getId() < pair2.first->getId()
+                 || (pair1.first->getId() == pair2.first->getId() && pair1.second->getId() < pair2.second->getId()));
+        });
+    }
+
+    bool BroadphaseSystem::update(const FrameTimeInfo&)
+    {
+        REI_PROFILE_ZONE("BroadphaseSystem::update");
+
+        // This scans every entity's transform version rather than being fed the moved nodes: bounds may follow nodes of any graph, & those
+        //   versions stay correct however many times the graphs have been updated since
+        forEach<Bounds>([this] (const Entity& entity, Bounds& bounds)
+        {
+            const uint32_t transformVersion = bounds.m_transform->getWorldMatrixVersion();
+
+            if (!bounds.m_isDirty && bounds.m_transformVersion == transformVersion)
+                return;
+
+            bounds.m_worldBounds = computeWorldBounds(bounds);
+            bounds.m_transformVersion = transformVersion;
+            bounds.m_isDirty = false;
+
+            m_tree.move(m_proxyIds[entity.getId()], bounds.m_worldBounds, bounds.m_layers, m_margin);
+        });
+
+        return true;
+    }
+
+    void BroadphaseSystem::destroy()
+    {
+        m_tree.clear();
+        m_proxyIds.clear();
+        m_proxyEntities.clear();
+        m_threadPairs.clear();
+    }
+
+    void BroadphaseSystem::linkEntity(Entity& entity)
+    {
+        System::linkEntity(entity);
+
+        Bounds& bounds = entity.getComponent<Bounds>();
+        bounds.m_worldBounds = computeWorldBounds(bounds);
+        bounds.m_transformVersion = bounds.m_transform->getWorldMatrixVersion();
+        bounds.m_isDirty = false;
+
+        const uint32_t proxyId = m_tree.insert(bounds.m_worldBounds, bounds.m_layers, m_margin);
+
+        if (entity.getId() >= m_proxyIds.size())
+            m_proxyIds.resize(entity.getId() + 1, AabbTree::InvalidProxy);
+
+        if (proxyId >= m_proxyEntities.size())
+            m_proxyEntities.resize(proxyId + 1, nullptr);
+
+        m_proxyIds[entity.getId()] = proxyId;
+        m_proxyEntities[proxyId] = &entity;
+    }
+
+    void BroadphaseSystem::unlinkEntity(const Entity& entity)
+    {
+        System::unlinkEntity(entity);
+
+        // The entity's component may already have been removed, its proxy being found from its identifier instead
+        if (entity.getId() >= m_proxyIds.size() || m_proxyIds[entity.getId()] == AabbTree::InvalidProxy)
+            return;
+
+        const uint32_t proxyId = m_proxyIds[entity.getId()];
+        m_tree.remove(proxyId);
+
+        m_proxyIds[entity.getId()] = AabbTree::InvalidProxy;
+        m_proxyEntities[proxyId] = nullptr;
+    }
+
+    Aabb BroadphaseSystem::computeWorldBounds(const Bounds& bounds) noexcept
+    {
+        const Mat4f& worldMatrix = bounds.m_transform->getWorldMatrix();
+
+        // The transformed box's extent along each world axis is the sum of the local extents projected onto it
+        const Vec3f halfExtents = bounds.m_localBounds.computeHalfExtents();
+        const Vec3f center(Simd::multiply(worldMatrix, Vec4f(bounds.m_localBounds.computeCenter(), 1.f)));
+        const Vec3f xAxis(worldMatrix.recoverColumn(0));
+        const Vec3f yAxis(worldMatrix.recoverColumn(1));
+        const Vec3f zAxis(worldMatrix.recoverColumn(2));
+
+        const Vec3f worldHalfExtents(
+            std::abs(xAxis.x()) * halfExtents.x() + std::abs(yAxis.x()) * halfExtents.y() + std::abs(zAxis.x()) * halfExtents.z(),
+            std::abs(xAxis.y()) * halfExtents.x() + std::abs(yAxis.y()) * halfExtents.y() + std::abs(zAxis.y()) * halfExtents.z(),
+            std::abs(xAxis.z()) * halfExtents.x() + std::abs(yAxis.z()) * halfExtents.y() + std::abs(zAxis.z()) * halfExtents.z()
+        );
+
+        return Aabb::fromCenter(center, worldHalfExtents);
+    }
+
+} // namespace Rei
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <vector>
+
+#include "AabbTree.h"
+#include "Bounds.h"
+#include "System.h"
+
+namespace Rei
+{
+
+    struct EntityPair
+    {
+        Entity* first{};
+        Entity* second{};
+    };
+
+    struct BroadphaseRayHit
+    {
+        Entity* entity{};
+        /// Distance at which the ray enters the entity's box, 0 if it starts inside.
+        float distance{};
+    };
+
+    /// Fixed-step system indexing the boxes of every entity holding Bounds into a dynamic AABB tree, for collision & proximity queries.
+    /// Only the entities whose transform or bounds changed since the last update have their box recomputed, & only those whose box got
+    ///   out of their tree proxy's fat box are reinserted into the tree. Finding them still visits every entity holding Bounds, comparing
+    ///   a version & a flag each.
+    /// All queries write their results into buffers given by the caller, without allocating; they test the entities' exact world-space boxes,
+    ///   & are filtered by a mask of layers to accept any entity belonging to.
+    /// \note As Bounds is declared as written, systems querying the broadphase during their update must declare reading it, for them not to be
+    ///   updated concurrently with the tree's update; several of them may then query it at the same time.
+    class BroadphaseSystem final : public System
+    {
+    public:
+        /// Default distance by which the tree's fat boxes are enlarged, in world units.
+        static constexpr float DefaultMargin = 0.1f;
+
+        /// Creates the system.
+        /// \param margin Distance by which the boxes are enlarged in the tree; larger margins make moving entities less often reinserted,
+        ///   at the cost of testing more of them in queries.
+        explicit BroadphaseSystem(float margin = DefaultMargin);
+
+        const AabbTree& getTree() const noexcept { return m_tree; }
+
+        /// Finds the entities whose box intersects the given one.
+        /// \param box World-space box to be tested.
+        /// \param results Array to be filled with the entities found.
+        /// \param maxResultCount Maximum number of entities to be found, the query stopping once reached.
+        /// \param layerMask Mask of the layers of the entities to be found.
+        /// \return Number of entities found.
+        std::size_t queryBox(const Aabb& box, Entity** results, std::size_t maxResultCount, uint32_t layerMask = Bounds::AllLayers) const;
+        /// Finds the entities whose box intersects the given sphere, such as the ones in an explosion's radius.
+        /// \param center World-space center of the sphere.
+        /// \param radius Radius of the sphere.
+        /// \param results Array to be filled with the entities found.
+        /// \param maxResultCount Maximum number of entities to be found, the query stopping once reached.
+        /// \param layerMask Mask of the layers of the entities to be found.
+        /// \return Number of entities found.
+        std::size_t queryRadius(const Vec3f& center, float radius, Entity** results, std::size_t maxResultCount, uint32_t layerMask = Bounds::AllLayers) const;
+        /// Finds the closest entities whose box is crossed by a ray, sorted by distance.
+        /// \param origin Origin of the ray.
+        /// \param direction Direction of the ray; must be normalized.
+        /// \param maxDistance Maximum distance along the ray.
+        /// \param results Array to be filled with the closest entities hit.
+        /// \param maxResultCount Maximum number of entities to be found; farther hits are discarded once reached.
+        /// \param layerMask Mask of the layers of the entities to be found.
+        /// \return Number of entities found.
+        std::size_t queryRay(const Vec3f& origin, const Vec3f& direction, float maxDistance, BroadphaseRayHit* results, std::size_t maxResultCount,
+                             uint32_t layerMask = Bounds::AllLayers) const;
+        /// Finds the entity whose box is the closest to a point, such as the nearest enemy.
+        /// \param point World-space point to find the nearest entity of.
+        /// \param maxDistance Maximum distance between the point & the entity's box.
+        /// \param layerMask Mask of the layers of the entity to be found.
+        /// \param ignoredEntity Entity never to be found, usually the one searching.
+        /// \return Nearest entity, or nullptr if none is closer than the maximum distance.
+        Entity* findNearest(const Vec3f& point, float maxDistance, uint32_t layerMask = Bounds::AllLayers, const Entity* ignoredEntity = nullptr) const;
+
+        /// Runs several box queries, split over the thread pool if any.
+        /// \param boxes World-space boxes to be tested.
+        /// \param queryCount Number of queries.
+        /// \param results Array to be filled with the entities found, maxResultCountPerQuery consecutive elements being reserved for each query.
+        /// \param maxResultCountPerQuery Maximum number of entities to be found by each query.
+        /// \param resultCounts Array to be filled with the number of entities found by each query.
+        /// \param layerMask Mask of the layers of the entities to be found.
+        void queryBoxes(const Aabb* boxes, std::size_t queryCount, Entity** results, std::size_t maxResultCountPerQuery, std::size_t* resultCounts,
+                        uint32_t layerMask = Bounds::AllLayers) const;
+        /// Runs several sphere queries, split over the thread pool if any.
+        /// \param centers World-space centers of the spheres.
+        /// \param radii Radii of the spheres.
+        /// \param queryCount Number of queries.
+        /// \param results Array to be filled with the entities found, maxResultCountPerQuery consecutive elements being reserved for each query.
+        /// \param maxResultCountPerQuery Maximum number of entities to be found by each query.
+        /// \param resultCounts Array to be filled with the number of entities found by each query.
+        /// \param layerMask Mask of the layers of the entities to be found.
+        void queryRadii(const Vec3f* centers, const float* radii, std::size_t queryCount, Entity** results, std::size_t maxResultCountPerQuery,
+                        std::size_t* resultCounts, uint32_t layerMask = Bounds::AllLayers) const;
+        /// Runs several ray queries, split over the thread pool if any.
+        /// \param origins Origins of the rays.
+        /// \param directions Directions of the rays; must be normalized.
+        /// \param maxDistance Maximum distance along all the rays.
+        /// \param queryCount Number of queries.
+        /// \param results Array to be filled with the closest entities hit, maxResultCountPerQuery consecutive elements being reserved for each query.
+        /// \param maxResultCountPerQuery Maximum number of entities to be found by each query.
+        /// \param resultCounts Array to be filled with the number of entities found by each query.
+        /// \param layerMask Mask of the layers of the entities to be found.
+        void queryRays(const Vec3f* origins, const Vec3f* directions, float maxDistance, std::size_t queryCount, BroadphaseRayHit* results,
+                       std::size_t maxResultCountPerQuery, std::size_t* resultCounts, uint32_t layerMask = Bounds::AllLayers) const;
+
+        /// Finds all the pairs of entities whose boxes intersect, for the physics step to test them precisely.
+        /// The entities are split over the thread pool if any; the pairs are then sorted by entity identifiers, so that they are always found
+        ///   in the same order for the same world.
+        /// \note Must not be called concurrently with itself, as it reuses the same temporary buffers.
+        /// \param pairs Vector to be filled with the pairs found, its first entity having the lowest identifier; it is cleared first, & only
+        ///   allocates if its capacity isn't large enough.
+        /// \param layerMask Mask of the layers of the entities to be paired.
+        void findPairs(std::vector<EntityPair>& pairs, uint32_t layerMask = Bounds::AllLayers);
+
+        bool update(const FrameTimeInfo& timeInfo) override;
+
+        void destroy() override;
+
+    protected:
+        void linkEntity(Entity& entity) override;
+        void unlinkEntity(const Entity& entity) override;
+
+    private:
+        /// Number of queries or entities processed by a single job.
+        static constexpr std::size_t ParallelGrainSize = 64;
+
+        /// Runs a function for each query index, split over the thread pool if any.
+        template <typename FuncT>
+        void runBatch(std::size_t queryCount, FuncT&& runQuery) const
+        {
+            if (m_threadPool == nullptr || queryCount <= ParallelGrainSize)
+            {
+                for (std::size_t queryIndex = 0; queryIndex < queryCount; ++queryIndex)
+                    runQuery(queryIndex);
+
+                return;
+            }
+
+            m_threadPool->parallelFor(queryCount, ParallelGrainSize, [&runQuery] (std::size_t beginIndex, std::size_t endIndex)
+            {
+                for (std::size_t queryIndex = beginIndex; queryIndex < endIndex; ++queryIndex)
+                    runQuery(queryIndex);
+            });
+        }
+
+        static Aabb computeWorldBounds(const Bounds& bounds) noexcept;
+
+        AabbTree m_tree{};
+        float m_margin = DefaultMargin;
+        /// Tree proxy of each linked entity, indexed by the entity's identifier.
+        std::vector<uint32_t> m_proxyIds{};
+        /// Entity of each tree proxy, indexed by the proxy's identifier.
+        std::vector<Entity*> m_proxyEntities{};
+        /// Pairs found by each thread of the pool, & by any other.
+        std::vector<std::vector<EntityPair>> m_threadPairs{};
+    };
+
+} // namespace Rei
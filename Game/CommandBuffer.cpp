@@ -0,0 +1,51 @@
+#include "CommandBuffer.h"
+#include "World.h"
+
+namespace Rei
+{
+
+    void CommandBuffer::apply(World& world, std::vector<EntityHandle>& destroyedEntities)
+    {
+        // Commands may record others in this very buffer while being applied, which are then applied in turn
+        for (std::size_t commandIndex = 0; commandIndex < m_commands.size(); ++commandIndex)
+        {
+            Command command = std::move(m_commands[commandIndex]);
+
+            switch (command.type)
+            {
+                case CommandType::SPAWN_ENTITY:
+                {
+                    Entity& entity = world.addEntity(command.enabled);
+
+                    if (command.operation)
+                        command.operation(entity);
+
+                    break;
+                }
+
+                case CommandType::DESTROY_ENTITY:
+                    destroyedEntities.emplace_back(command.entity);
+                    break;
+
+                case CommandType::ENABLE_ENTITY:
+                    if (Entity* entity = world.recoverEntity(command.entity))
+                        entity->enable(command.enabled);
+
+                    break;
+
+                case CommandType::EDIT_ENTITY:
+                    if (Entity* entity = world.recoverEntity(command.entity))
+                        command.operation(*entity);
+
+                    break;
+
+                case CommandType::EDIT_WORLD:
+                    command.worldOperation(world);
+                    break;
+            }
+        }
+
+        m_commands.clear();
+    }
+
+} // namespace Rei
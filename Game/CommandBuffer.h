@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "Entity.h"
+
+namespace Rei
+{
+    class World;
+
+    /// Records structural changes (entity spawning & destruction, component addition & removal, enabling & disabling) to be applied later by a World.
+    /// Systems must write into a command buffer instead of modifying the world directly while it is being updated, since doing so would alter
+    ///   the entity & component arrays being iterated over.
+    /// \note A command buffer is not thread-safe; a World holds one per thread able to update its systems.
+    /// \note Entities are referred to by their handle; the commands targeting an entity destroyed in the meantime are ignored.
+    class CommandBuffer
+    {
+        friend class World;
+
+    public:
+        CommandBuffer() = default;
+        CommandBuffer(const CommandBuffer&) = delete;
+        CommandBuffer(CommandBuffer&&) noexcept = default;
+
+        std::size_t getCommandCount() const noexcept { return m_commands.size(); }
+        bool isEmpty() const noexcept { return m_commands.empty(); }
+
+        /// Records the creation of an entity.
+        /// \param initializer Function to be called with the newly created entity once it has been spawned, typically to add its components.
+        /// \param enabled True if the entity must be created enabled, false otherwise.
+        void spawnEntity(std::function<void(Entity&)> initializer = {}, bool enabled = true)
+        {
+            m_commands.emplace_back(Command{ CommandType::SPAWN_ENTITY, EntityHandle{}, enabled, std::move(initializer), {} });
+        }
+
+        /// Records the destruction of an entity. Destructions are applied after all other commands, and an entity may safely be destroyed several times.
+        /// \param entity Entity to be destroyed.
+        void destroyEntity(const Entity& entity) { m_commands.emplace_back(Command{ CommandType::DESTROY_ENTITY, entity.getHandle(), false, {}, {} }); }
+
+        void enableEntity(const Entity& entity, bool enabled = true) { m_commands.emplace_back(Command{ CommandType::ENABLE_ENTITY, entity.getHandle(), enabled, {}, {} }); }
+        void disableEntity(const Entity& entity) { enableEntity(entity, false); }
+
+        /// Records the addition of a component to an entity.
+        /// \tparam CompT Type of the component to be added.
+        /// \tparam Args Types of the arguments to be forwarded to the component's constructor.
+        /// \param entity Entity to add the component to.
+        /// \param args Arguments to be forwarded to the component's constructor; they are copied or moved into the buffer until the command is applied.
+        template <typename CompT, typename... Args>
+        void addComponent(const Entity& entity, Args&&... args)
+        {
+            static_assert(std::is_base_of_v<Component, CompT>, "Error: The added component must be derived from Component.");
+
+            editEntity(entity, [arguments = std::make_tuple(std::forward<Args>(args)...)](Entity& editedEntity) mutable
+            {
+                std::apply([&editedEntity](auto&&... componentArgs) { editedEntity.addComponent<CompT>(std::move(componentArgs)...); }, arguments);
+            });
+        }
+
+        /// Records the removal of a component from an entity.
+        /// \tparam CompT Type of the component to be removed.
+        /// \param entity Entity to remove the component from.
+        template <typename CompT>
+        void removeComponent(const Entity& entity)
+        {
+            static_assert(std::is_base_of_v<Component, CompT>, "Error: The removed component must be derived from Component.");
+
+            editEntity(entity, [](Entity& editedEntity) { editedEntity.removeComponent<CompT>(); });
+        }
+
+        /// Records an arbitrary modification of an entity.
+        /// \param entity Entity to be modified.
+        /// \param operation Function to be called with the entity when the command is applied.
+        void editEntity(const Entity& entity, std::function<void(Entity&)> operation)
+        {
+            m_commands.emplace_back(Command{ CommandType::EDIT_ENTITY, entity.getHandle(), false, std::move(operation), {} });
+        }
+
+        /// Records an arbitrary operation on the whole world, applied in order with the other commands; for changes that cannot be expressed
+        ///   per entity, such as restoring a snapshot.
+        /// \param operation Function to be called with the world when the command is applied.
+        void editWorld(std::function<void(World&)> operation)
+        {
+            m_commands.emplace_back(Command{ CommandType::EDIT_WORLD, EntityHandle{}, false, {}, std::move(operation) });
+        }
+
+        /// Discards all recorded commands, keeping the allocated memory to be reused.
+        void clear() noexcept { m_commands.clear(); }
+
+        CommandBuffer& operator=(const CommandBuffer&) = delete;
+        CommandBuffer& operator=(CommandBuffer&&) noexcept = default;
+
+    private:
+        enum class CommandType : uint8_t
+        {
+            SPAWN_ENTITY,
+            DESTROY_ENTITY,
+            ENABLE_ENTITY,
+            EDIT_ENTITY,
+            EDIT_WORLD
+        };
+
+        struct Command
+        {
+            CommandType type{};
+            EntityHandle entity{};
+            bool enabled{};
+            std::function<void(Entity&)> operation{};
+            std::function<void(World&)> worldOperation{};
+        };
+
+        /// Applies all the recorded commands but the destructions, which are appended to the given list, then clears the buffer.
+        /// \param world World to apply the commands to.
+        /// \param destroyedEntities List of the entities to be destroyed once all buffers have been applied.
+        void apply(World& world, std::vector<EntityHandle>& destroyedEntities);
+
+        std::vector<Command> m_commands{};
+    };
+
+} // namespace Rei
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Rei
+{
+    class DrawSubmitter;
+
+    /// Interface of the graphics backend recording rendering commands on several contexts concurrently, then executing them in order.
+    /// With Direct3D 11, each context is expected to be a deferred context: endRecording() calls FinishCommandList(), & execute() calls
+    ///   ExecuteCommandList() on the immediate context. As command lists do not inherit any state, bindState() is always called at the start of a recording.
+    class CommandRecorder
+    {
+    public:
+        /// Gets the number of contexts which can be recorded on at once.
+        virtual std::size_t getContextCount() const noexcept = 0;
+        /// Starts recording commands on a context; may be called from any thread, a given context only being used by one thread at a time.
+        /// \param contextIndex Index of the context to record on, between 0 & getContextCount() - 1.
+        /// \return Submitter recording the draws on the context.
+        virtual DrawSubmitter& beginRecording(std::size_t contextIndex) = 0;
+        /// Records the binding of a pipeline state on a context.
+        /// \param contextIndex Index of the context being recorded on.
+        /// \param stateKey Key of the state to be bound.
+        virtual void bindState(std::size_t contextIndex, uint64_t stateKey) = 0;
+        /// Finishes recording on a context, turning its commands into a command list.
+        /// \param contextIndex Index of the context being recorded on.
+        virtual void endRecording(std::size_t contextIndex) = 0;
+        /// Executes the command list recorded on a context; always called from the thread owning the immediate context, in the order of the contexts.
+        /// \param contextIndex Index of the context whose commands are to be executed.
+        virtual void execute(std::size_t contextIndex) = 0;
+
+        virtual ~CommandRecorder() = default;
+    };
+
+} // namespace Rei
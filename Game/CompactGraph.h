@@ -0,0 +1,458 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "ThreadPool.h"
+
+namespace Rei
+{
+
+    /// Generational handle to a node of a CompactGraph; a handle to a removed node is detected as such, even if its slot has been reused since.
+    struct GraphNodeHandle
+    {
+        static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+        bool isNull() const noexcept { return (index == InvalidIndex); }
+
+        bool operator==(const GraphNodeHandle& handle) const noexcept { return (index == handle.index && generation == handle.generation); }
+        bool operator!=(const GraphNodeHandle& handle) const noexcept { return !(*this == handle); }
+
+        uint32_t index = InvalidIndex;
+        uint32_t generation = 0;
+    };
+
+    /// Directed graph storing its nodes contiguously & its links in compressed sparse row (CSR) arrays, as a compact alternative to Graph
+    ///   for large graphs: adding & removing nodes or links are constant-time operations, and traversals read contiguous memory.
+    /// Links are recorded in a hash set, from which the CSR arrays are rebuilt in linear time on the first traversal following any modification.
+    /// \note Const traversals may rebuild the arrays, and must thus not be called concurrently with each other after the graph has been modified.
+    /// \tparam T Type of the data held by each node.
+    template <typename T>
+    class CompactGraph
+    {
+    public:
+        /// Default constructor.
+        CompactGraph() = default;
+        /// Creates a graph while preallocating the given amount of nodes.
+        /// \param nodeCount Amount of nodes to reserve.
+        explicit CompactGraph(std::size_t nodeCount) { m_slots.reserve(nodeCount); }
+        CompactGraph(const CompactGraph&) = delete;
+        CompactGraph(CompactGraph&&) noexcept = default;
+
+        std::size_t getNodeCount() const noexcept { return m_nodeCount; }
+        /// Gets the number of links, those of removed nodes excluded; this may rebuild the CSR arrays, & thus allocate.
+        std::size_t getEdgeCount() const { rebuildAdjacency(); return m_edges.size(); }
+
+        bool isValid(const GraphNodeHandle& handle) const noexcept
+        {
+            return (handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation && m_slots[handle.index].value.has_value());
+        }
+
+        const T& getNode(const GraphNodeHandle& handle) const noexcept
+        {
+            assert("Error: The requested graph node does not exist." && isValid(handle));
+            return *m_slots[handle.index].value;
+        }
+
+        T& getNode(const GraphNodeHandle& handle) noexcept
+        {
+            assert("Error: The requested graph node does not exist." && isValid(handle));
+            return *m_slots[handle.index].value;
+        }
+
+        /// Adds a node into the graph, reusing the slot of a previously removed one if available.
+        /// \tparam Args Types of the arguments to be forwarded to the node's constructor.
+        /// \param args Arguments to be forwarded to the node's constructor.
+        /// \return Handle to the newly added node.
+        template <typename... Args>
+        GraphNodeHandle addNode(Args&&... args)
+        {
+            uint32_t index {};
+
+            if (!m_freeIndices.empty())
+            {
+                index = m_freeIndices.back();
+                m_freeIndices.pop_back();
+            }
+            else
+            {
+                index = static_cast<uint32_t>(m_slots.size());
+                m_slots.emplace_back();
+            }
+
+            m_slots[index].value.emplace(std::forward<Args>(args)...);
+            ++m_nodeCount;
+            m_isAdjacencyDirty = true;
+
+            return GraphNodeHandle{ index, m_slots[index].generation };
+        }
+        /// Removes a node from the graph; its links are discarded on the next adjacency rebuild.
+        /// \param handle Handle to the node to be removed.
+        /// \return True if the node has been removed, false if the handle was already invalid.
+        bool removeNode(const GraphNodeHandle& handle)
+        {
+            if (!isValid(handle))
+                return false;
+
+            Slot& slot = m_slots[handle.index];
+            slot.value.reset();
+            ++slot.generation;
+            --m_nodeCount;
+
+            // The slot cannot be reused before its stale links have been purged, lest the next node inherits them
+            m_removedIndices.emplace_back(handle.index);
+            m_isAdjacencyDirty = true;
+
+            return true;
+        }
+        /// Links two nodes, the first one becoming a parent of the second.
+        /// \param parent Handle to the parent node.
+        /// \param child Handle to the child node.
+        /// \return True if the link has been added, false if it already existed.
+        bool addEdge(const GraphNodeHandle& parent, const GraphNodeHandle& child)
+        {
+            if (!isValid(parent) || !isValid(child))
+                throw std::invalid_argument("Error: Both graph nodes to be linked must exist");
+
+            if (parent.index == child.index)
+                throw std::invalid_argument("Error: A graph node cannot be linked to itself");
+
+            const bool isInserted = m_edges.insert(computeEdgeKey(parent.index, child.index)).second;
+            m_isAdjacencyDirty |= isInserted;
+
+            return isInserted;
+        }
+        /// Unlinks two nodes.
+        /// \param parent Handle to the parent node.
+        /// \param child Handle to the child node.
+        /// \return True if the link has been removed, false if it did not exist.
+        bool removeEdge(const GraphNodeHandle& parent, const GraphNodeHandle& child)
+        {
+            if (!isValid(parent) || !isValid(child))
+                return false;
+
+            const bool isErased = (m_edges.erase(computeEdgeKey(parent.index, child.index)) > 0);
+            m_isAdjacencyDirty |= isErased;
+
+            return isErased;
+        }
+
+        bool hasEdge(const GraphNodeHandle& parent, const GraphNodeHandle& child) const
+        {
+            return (isValid(parent) && isValid(child) && m_edges.find(computeEdgeKey(parent.index, child.index)) != m_edges.cend());
+        }
+
+        std::size_t getChildCount(const GraphNodeHandle& handle) const
+        {
+            assert("Error: The requested graph node does not exist." && isValid(handle));
+
+            rebuildAdjacency();
+            return m_childOffsets[handle.index + 1] - m_childOffsets[handle.index];
+        }
+
+        std::size_t getParentCount(const GraphNodeHandle& handle) const
+        {
+            assert("Error: The requested graph node does not exist." && isValid(handle));
+
+            rebuildAdjacency();
+            return m_parentOffsets[handle.index + 1] - m_parentOffsets[handle.index];
+        }
+
+        /// Calls a function on each child of a node, in the order of their slots.
+        /// \tparam FuncT Type of the function to be called.
+        /// \param handle Handle to the node whose children are to be iterated.
+        /// \param func Function to be called, taking the child's handle.
+        template <typename FuncT>
+        void forEachChild(const GraphNodeHandle& handle, FuncT&& func) const
+        {
+            assert("Error: The requested graph node does not exist." && isValid(handle));
+
+            rebuildAdjacency();
+
+            for (std::size_t linkIndex = m_childOffsets[handle.index]; linkIndex < m_childOffsets[handle.index + 1]; ++linkIndex)
+                func(recoverHandle(m_childIndices[linkIndex]));
+        }
+
+        /// Calls a function on each parent of a node, in the order of their slots.
+        /// \tparam FuncT Type of the function to be called.
+        /// \param handle Handle to the node whose parents are to be iterated.
+        /// \param func Function to be called, taking the parent's handle.
+        template <typename FuncT>
+        void forEachParent(const GraphNodeHandle& handle, FuncT&& func) const
+        {
+            assert("Error: The requested graph node does not exist." && isValid(handle));
+
+            rebuildAdjacency();
+
+            for (std::size_t linkIndex = m_parentOffsets[handle.index]; linkIndex < m_parentOffsets[handle.index + 1]; ++linkIndex)
+                func(recoverHandle(m_parentIndices[linkIndex]));
+        }
+
+        /// Visits every node reachable from the given one in breadth-first order, the starting node included.
+        /// \tparam FuncT Type of the function to be called.
+        /// \param start Handle to the node to start from.
+        /// \param func Function to be called on each visited node, taking its handle.
+        template <typename FuncT>
+        void breadthFirst(const GraphNodeHandle& start, FuncT&& func) const
+        {
+            assert("Error: The starting graph node does not exist." && isValid(start));
+
+            rebuildAdjacency();
+
+            std::vector<uint8_t> visitedNodes(m_slots.size(), false);
+            std::vector<uint32_t> queue;
+            queue.reserve(m_nodeCount);
+
+            queue.emplace_back(start.index);
+            visitedNodes[start.index] = true;
+
+            // The queue is never popped; the nodes already visited simply stay before the read index
+            for (std::size_t queueIndex = 0; queueIndex < queue.size(); ++queueIndex)
+            {
+                const uint32_t nodeIndex = queue[queueIndex];
+                func(recoverHandle(nodeIndex));
+
+                for (std::size_t linkIndex = m_childOffsets[nodeIndex]; linkIndex < m_childOffsets[nodeIndex + 1]; ++linkIndex)
+                {
+                    const uint32_t childIndex = m_childIndices[linkIndex];
+
+                    if (visitedNodes[childIndex])
+                        continue;
+
+                    visitedNodes[childIndex] = true;
+                    queue.emplace_back(childIndex);
+                }
+            }
+        }
+
+        /// Visits every node reachable from the given one in depth-first preorder, the starting node included.
+        /// \tparam FuncT Type of the function to be called.
+        /// \param start Handle to the node to start from.
+        /// \param func Function to be called on each visited node, taking its handle.
+        template <typename FuncT>
+        void depthFirst(const GraphNodeHandle& start, FuncT&& func) const
+        {
+            assert("Error: The starting graph node does not exist." && isValid(start));
+
+            rebuildAdjacency();
+
+            std::vector<uint8_t> visitedNodes(m_slots.size(), false);
+            std::vector<uint32_t> stack;
+            stack.emplace_back(start.index);
+
+            while (!stack.empty())
+            {
+                const uint32_t nodeIndex = stack.back();
+                stack.pop_back();
+
+                if (visitedNodes[nodeIndex])
+                    continue;
+
+                visitedNodes[nodeIndex] = true;
+                func(recoverHandle(nodeIndex));
+
+                // Children are pushed in reverse so that the first one is visited first
+                for (std::size_t linkIndex = m_childOffsets[nodeIndex + 1]; linkIndex > m_childOffsets[nodeIndex]; --linkIndex)
+                {
+                    if (!visitedNodes[m_childIndices[linkIndex - 1]])
+                        stack.emplace_back(m_childIndices[linkIndex - 1]);
+                }
+            }
+        }
+
+        /// Splits the nodes into successive levels, each node being placed right after the deepest of its parents.
+        /// A node's parents all belong to previous levels, so that the nodes of a single level can be processed concurrently once the previous ones are done.
+        /// \note Throws if the graph contains a cycle.
+        /// \return Node batches, from the roots to the deepest nodes.
+        std::vector<std::vector<GraphNodeHandle>> computeLevels() const
+        {
+            rebuildAdjacency();
+
+            std::vector<std::vector<GraphNodeHandle>> levels;
+            std::vector<std::size_t> remainingParentCounts(m_slots.size(), 0);
+            std::vector<uint32_t> currentLevel;
+            std::vector<uint32_t> nextLevel;
+            std::size_t processedCount = 0;
+
+            for (uint32_t nodeIndex = 0; nodeIndex < m_slots.size(); ++nodeIndex)
+            {
+                if (!m_slots[nodeIndex].value.has_value())
+                    continue;
+
+                remainingParentCounts[nodeIndex] = m_parentOffsets[nodeIndex + 1] - m_parentOffsets[nodeIndex];
+
+                if (remainingParentCounts[nodeIndex] == 0)
+                    currentLevel.emplace_back(nodeIndex);
+            }
+
+            // Kahn's algorithm, processed a whole level at a time
+            while (!currentLevel.empty())
+            {
+                std::vector<GraphNodeHandle>& level = levels.emplace_back();
+                level.reserve(currentLevel.size());
+
+                for (const uint32_t nodeIndex : currentLevel)
+                {
+                    level.emplace_back(recoverHandle(nodeIndex));
+
+                    for (std::size_t linkIndex = m_childOffsets[nodeIndex]; linkIndex < m_childOffsets[nodeIndex + 1]; ++linkIndex)
+                    {
+                        const uint32_t childIndex = m_childIndices[linkIndex];
+
+                        if (--remainingParentCounts[childIndex] == 0)
+                            nextLevel.emplace_back(childIndex);
+                    }
+                }
+
+                processedCount += currentLevel.size();
+                std::swap(currentLevel, nextLevel);
+                nextLevel.clear();
+            }
+
+            if (processedCount != m_nodeCount)
+                throw std::logic_error("Error: The graph contains a cycle, and cannot be sorted");
+
+            return levels;
+        }
+
+        /// Sorts the nodes so that every node comes after all its parents.
+        /// \note Throws if the graph contains a cycle.
+        /// \return Handles to all the nodes, in topological order.
+        std::vector<GraphNodeHandle> computeTopologicalOrder() const
+        {
+            std::vector<GraphNodeHandle> order;
+            order.reserve(m_nodeCount);
+
+            for (const std::vector<GraphNodeHandle>& level : computeLevels())
+                order.insert(order.end(), level.cbegin(), level.cend());
+
+            return order;
+        }
+
+        /// Calls a function on every node, level by level; the nodes of each level are processed concurrently on the thread pool.
+        /// \note The function may be called from several threads at once, and must thus only write into the given node.
+        /// \tparam FuncT Type of the function to be called.
+        /// \param threadPool Thread pool on which to process the levels; if nullptr, everything is processed on the calling thread.
+        /// \param func Function to be called, taking the node's handle followed by a reference to its data.
+        /// \param grainSize Maximum number of nodes of a level processed by a single job.
+        template <typename FuncT>
+        void parallelForEachLevel(ThreadPool* threadPool, FuncT&& func, std::size_t grainSize = 64)
+        {
+            for (const std::vector<GraphNodeHandle>& level : computeLevels())
+            {
+                const auto processRange = [this, &level, &func](std::size_t beginIndex, std::size_t endIndex)
+                {
+                    for (std::size_t nodeIndex = beginIndex; nodeIndex < endIndex; ++nodeIndex)
+                        func(level[nodeIndex], *m_slots[level[nodeIndex].index].value);
+                };
+
+                if (threadPool == nullptr || level.size() <= grainSize)
+                    processRange(0, level.size());
+                else
+                    threadPool->parallelFor(level.size(), grainSize, processRange);
+            }
+        }
+
+        CompactGraph& operator=(const CompactGraph&) = delete;
+        CompactGraph& operator=(CompactGraph&&) noexcept = default;
+
+    private:
+        struct Slot
+        {
+            std::optional<T> value{};
+            uint32_t generation = 0;
+        };
+
+        static constexpr uint64_t computeEdgeKey(uint32_t parentIndex, uint32_t childIndex) noexcept
+        {
+            return (static_cast<uint64_t>(parentIndex) << 32u) | childIndex;
+        }
+
+        GraphNodeHandle recoverHandle(uint32_t index) const noexcept { return GraphNodeHandle{ index, m_slots[index].generation }; }
+
+        /// Rebuilds the CSR arrays from the recorded links if the graph has been modified since the last rebuild, purging the links of removed nodes.
+        void rebuildAdjacency() const
+        {
+            if (!m_isAdjacencyDirty)
+                return;
+
+            for (auto edgeIt = m_edges.begin(); edgeIt != m_edges.end();)
+            {
+                const auto parentIndex = static_cast<uint32_t>(*edgeIt >> 32u);
+                const auto childIndex  = static_cast<uint32_t>(*edgeIt & std::numeric_limits<uint32_t>::max());
+
+                if (m_slots[parentIndex].value.has_value() && m_slots[childIndex].value.has_value())
+                    ++edgeIt;
+                else
+                    edgeIt = m_edges.erase(edgeIt);
+            }
+
+            m_freeIndices.insert(m_freeIndices.end(), m_removedIndices.cbegin(), m_removedIndices.cend());
+            m_removedIndices.clear();
+
+            // Counting sort: every row's size is counted, then turned into its starting offset
+            const auto computeOffsets = [this](std::vector<std::size_t>& offsets, bool isChildRow)
+            {
+                offsets.assign(m_slots.size() + 1, 0);
+
+                for (const uint64_t edge : m_edges)
+                    ++offsets[(isChildRow ? (edge >> 32u) : (edge & std::numeric_limits<uint32_t>::max())) + 1];
+
+                for (std::size_t slotIndex = 0; slotIndex < m_slots.size(); ++slotIndex)
+                    offsets[slotIndex + 1] += offsets[slotIndex];
+            };
+
+            // Scatters the links of the given rows into the transposed ones; the source rows being visited in order, each transposed row ends up sorted
+            const auto transposeRows = [this](const std::vector<std::size_t>& offsets, const std::vector<uint32_t>& indices,
+                                              const std::vector<std::size_t>& transposedOffsets, std::vector<uint32_t>& transposedIndices)
+            {
+                std::vector<std::size_t> insertOffsets(transposedOffsets.cbegin(), transposedOffsets.cend() - 1);
+                transposedIndices.resize(m_edges.size());
+
+                for (std::size_t slotIndex = 0; slotIndex < m_slots.size(); ++slotIndex)
+                {
+                    for (std::size_t linkIndex = offsets[slotIndex]; linkIndex < offsets[slotIndex + 1]; ++linkIndex)
+                        transposedIndices[insertOffsets[indices[linkIndex]]++] = static_cast<uint32_t>(slotIndex);
+                }
+            };
+
+            computeOffsets(m_childOffsets, true);
+            computeOffsets(m_parentOffsets, false);
+
+            // The hash set having no meaningful order, the parent rows are first filled unsorted, then transposed twice to sort both in linear time
+            {
+                std::vector<std::size_t> insertOffsets(m_parentOffsets.cbegin(), m_parentOffsets.cend() - 1);
+                m_parentIndices.resize(m_edges.size());
+
+                for (const uint64_t edge : m_edges)
+                    m_parentIndices[insertOffsets[edge & std::numeric_limits<uint32_t>::max()]++] = static_cast<uint32_t>(edge >> 32u);
+            }
+
+            transposeRows(m_parentOffsets, m_parentIndices, m_childOffsets, m_childIndices);
+            transposeRows(m_childOffsets, m_childIndices, m_parentOffsets, m_parentIndices);
+
+            m_isAdjacencyDirty = false;
+        }
+
+        std::vector<Slot> m_slots{};
+        std::size_t m_nodeCount = 0;
+        mutable std::vector<uint32_t> m_freeIndices{};
+        mutable std::vector<uint32_t> m_removedIndices{};
+        mutable std::unordered_set<uint64_t> m_edges{};
+
+        // CSR arrays, each node's children (or parents) being stored in [offsets[index]; offsets[index + 1][
+        mutable std::vector<std::size_t> m_childOffsets = std::vector<std::size_t>(1, 0);
+        mutable std::vector<uint32_t> m_childIndices{};
+        mutable std::vector<std::size_t> m_parentOffsets = std::vector<std::size_t>(1, 0);
+        mutable std::vector<uint32_t> m_parentIndices{};
+        mutable bool m_isAdjacencyDirty = false;
+    };
+
+} // namespace Rei
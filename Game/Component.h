@@ -3,23 +3,37 @@
 #include <memory>
 #include <type_traits>
 
+#include "StaticBitset.h"
+#include "TypeRegistry.h"
+
 namespace Rei
 {
 
+/// Maximum number of distinct component types; this defines the size of the component masks.
+constexpr std::size_t MaxComponentCount = 128;
+/// Number of registered component types; this defines the size of the tables indexed by component ID.
+constexpr std::size_t ComponentCount = ComponentTypes::Size;
+
+static_assert(ComponentCount <= MaxComponentCount, "Error: Too many component types are registered; MaxComponentCount must be increased.");
+
 class Component;
 using ComponentPtr = std::unique_ptr<Component>;
+using ComponentMask = StaticBitset<MaxComponentCount>;
 
 class Component
 {
 public:
+    /// Gets the identifier of a component type, which is its index in the registered ComponentTypes.
+    /// \tparam CompT Type of the component; must be registered in TypeRegistry.h.
+    /// \return Identifier of the component type, known at compile time.
     template <typename CompT>
-    static std::size_t getId()
+    static constexpr std::size_t getId() noexcept
     {
-        static_assert(std::is_base_of<Component, CompT>, "Error: CompT is not derived from Component");
+        static_assert(std::is_base_of_v<Component, CompT>, "Error: CompT is not derived from Component");
         static_assert(!std::is_same_v<Component, CompT>, "Error: CompT is same as Component");
+        static_assert(TypeListContains_v<CompT, ComponentTypes>, "Error: CompT must be registered in ComponentTypes (TypeRegistry.h)");
 
-        static const std::size_t id = sMaxID++;
-        return id;
+        return TypeListIndex_v<CompT, ComponentTypes>;
     }
 
     virtual ~Component() = default;
@@ -31,9 +45,6 @@ protected:
 
     Component& operator=(const Component&) = default;
     Component& operator=(Component&&) noexcept = default;
-private:
-    static inline std::size_t sMaxID = 0;
-
 };
 
 } // namespace Rei
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "ComponentStorage.h"
+#include "Entity.h"
+
+namespace Rei
+{
+
+    ComponentStorage::ComponentStorage()
+    {
+        // The first archetype holds no component at all; every entity is placed into it on creation
+        m_archetypes.emplace_back(std::make_unique<Archetype>(ComponentMask()));
+    }
+
+    void ComponentStorage::addEntity(Entity& entity)
+    {
+        const std::size_t entityId = entity.getId();
+
+        if (entityId >= m_locations.size())
+            m_locations.resize(entityId + 1);
+
+        assert("Error: The entity is already registered in the component storage." && m_locations[entityId].archetype == nullptr);
+
+        Archetype& rootArchetype = *m_archetypes.front();
+        m_locations[entityId] = EntityLocation{ &rootArchetype, rootArchetype.m_entities.size() };
+        rootArchetype.m_entities.emplace_back(&entity);
+    }
+
+    void ComponentStorage::removeEntity(const Entity& entity)
+    {
+        const std::size_t entityId = entity.getId();
+        const EntityLocation location = getLocation(entityId);
+
+        Entity* movedEntity = location.archetype->swapRemoveRow(location.row);
+
+        if (movedEntity)
+            m_locations[movedEntity->getId()].row = location.row;
+
+        m_locations[entityId] = EntityLocation{};
+    }
+
+    void ComponentStorage::clear()
+    {
+        m_archetypes.resize(1);
+
+        Archetype& rootArchetype = *m_archetypes.front();
+        rootArchetype.clear();
+        rootArchetype.m_addEdges.fill(nullptr);
+
+        m_locations.clear();
+    }
+
+    void ComponentStorage::removeComponent(std::size_t entityId, std::size_t compId)
+    {
+        Archetype& source = *getLocation(entityId).archetype;
+
+        if (!source.hasColumn(compId))
+            return;
+
+        Archetype* target = source.m_removeEdges[compId];
+
+        if (target == nullptr)
+        {
+            ComponentMask signature = source.getSignature();
+            signature.setBit(compId, false);
+
+            target = findArchetype(signature);
+
+            if (target == nullptr)
+                target = &createArchetype(signature, source);
+
+            linkArchetypes(*target, source, compId);
+        }
+
+        moveEntity(entityId, *target);
+    }
+
+    void ComponentStorage::moveEntity(std::size_t entityId, Archetype& archetype)
+    {
+        EntityLocation& location = m_locations[entityId];
+        const std::size_t newRow = archetype.m_entities.size();
+
+        Entity* movedEntity = location.archetype->moveRowTo(location.row, archetype);
+
+        if (movedEntity)
+            m_locations[movedEntity->getId()].row = location.row;
+
+        location = EntityLocation{ &archetype, newRow };
+    }
+
+    Archetype* ComponentStorage::findArchetype(const ComponentMask& signature) const noexcept
+    {
+        for (const ArchetypePtr& archetype : m_archetypes)
+        {
+            if (archetype->getSignature() == signature)
+                return archetype.get();
+        }
+
+        return nullptr;
+    }
+
+    Archetype& ComponentStorage::createArchetype(const ComponentMask& signature, const Archetype& source)
+    {
+        Archetype& archetype = *m_archetypes.emplace_back(std::make_unique<Archetype>(signature));
+        archetype.copyLayout(source);
+
+        return archetype;
+    }
+
+    void ComponentStorage::linkArchetypes(Archetype& source, Archetype& target, std::size_t compId)
+    {
+        source.m_addEdges[compId] = &target;
+        target.m_removeEdges[compId] = &source;
+    }
+
+} // namespace Rei
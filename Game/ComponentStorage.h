@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+#include "Archetype.h"
+#include "Component.h"
+
+namespace Rei
+{
+    class Entity;
+
+    /// Location of an entity's components within the storage.
+    struct EntityLocation
+    {
+        Archetype* archetype{};
+        std::size_t row{};
+    };
+
+    /// Archetype-based component storage, grouping entities by their exact set of components.
+    /// Every component type of an archetype is packed in a contiguous column, so that iterating over entities sharing components touches sequential memory.
+    /// \note Adding or removing a component moves all of the entity's components into another archetype; references to components are thus invalidated
+    ///   by any structural change made to an entity sharing the same archetype.
+    class ComponentStorage
+    {
+    public:
+        ComponentStorage();
+        ComponentStorage(const ComponentStorage&) = delete;
+        ComponentStorage(ComponentStorage&&) noexcept = default;
+
+        const std::vector<ArchetypePtr>& getArchetypes() const noexcept { return m_archetypes; }
+
+        const EntityLocation& getLocation(std::size_t entityId) const noexcept
+        {
+            assert("Error: The entity isn't registered in the component storage." && entityId < m_locations.size() && m_locations[entityId].archetype);
+            return m_locations[entityId];
+        }
+
+        /// Registers an entity, which is placed into the archetype holding no component.
+        /// \param entity Entity to be registered.
+        void addEntity(Entity& entity);
+        /// Unregisters an entity, destroying all its components.
+        /// \param entity Entity to be unregistered.
+        void removeEntity(const Entity& entity);
+
+        /// Adds a component to an entity, moving it into the matching archetype. If the entity already has a component of this type, it is replaced.
+        /// \tparam CompT Type of the component to be added.
+        /// \tparam Args Types of the arguments to be forwarded to the component's constructor.
+        /// \param entityId Identifier of the entity to add the component to.
+        /// \param args Arguments to be forwarded to the component's constructor.
+        /// \return Reference to the newly added component.
+        template <typename CompT, typename... Args>
+        CompT& addComponent(std::size_t entityId, Args&&... args)
+        {
+            constexpr std::size_t compId = Component::getId<CompT>();
+            const EntityLocation location = getLocation(entityId);
+
+            CompT component(std::forward<Args>(args)...);
+
+            if (location.archetype->hasColumn(compId))
+            {
+                CompT& existingComponent = location.archetype->getColumn<CompT>()[location.row];
+                existingComponent = std::move(component);
+
+                return existingComponent;
+            }
+
+            Archetype& source = *location.archetype;
+            Archetype* target = source.m_addEdges[compId];
+
+            if (target == nullptr)
+            {
+                ComponentMask signature = source.getSignature();
+                signature.setBit(compId);
+
+                target = findArchetype(signature);
+
+                if (target == nullptr)
+                {
+                    target = &createArchetype(signature, source);
+                    target->addColumn<CompT>();
+                }
+
+                linkArchetypes(source, *target, compId);
+            }
+
+            moveEntity(entityId, *target);
+
+            std::vector<CompT>& column = target->getColumn<CompT>();
+            column.emplace_back(std::move(component));
+
+            return column.back();
+        }
+
+        /// Adds several default-constructed components to an entity, moving it only once into the archetype holding all of them.
+        /// If the entity already has a component of one of these types, it is replaced.
+        /// \tparam CompTs Types of the components to be added.
+        /// \param entityId Identifier of the entity to add the components to.
+        template <typename... CompTs>
+        void addComponents(std::size_t entityId)
+        {
+            Archetype* target = getLocation(entityId).archetype;
+            ComponentMask signature = target->getSignature();
+            (signature.setBit(Component::getId<CompTs>()), ...);
+
+            if (signature != target->getSignature())
+            {
+                Archetype& source = *target;
+                target = findArchetype(signature);
+
+                if (target == nullptr)
+                {
+                    target = &createArchetype(signature, source);
+                    (target->addColumn<CompTs>(), ...);
+                }
+
+                moveEntity(entityId, *target);
+            }
+
+            const std::size_t row = getLocation(entityId).row;
+
+            // Columns the entity just got into lack its row, while the ones it already had hold the components to be replaced
+            const auto placeComponent = [target, row] (auto&& component)
+            {
+                using CompT = std::decay_t<decltype(component)>;
+                std::vector<CompT>& column = target->getColumn<CompT>();
+
+                if (column.size() <= row)
+                    column.emplace_back(std::move(component));
+                else
+                    column[row] = std::move(component);
+            };
+
+            (placeComponent(CompTs()), ...);
+        }
+
+        /// Removes a component from an entity, moving it into the matching archetype. Does nothing if the entity doesn't have a component of this type.
+        /// \tparam CompT Type of the component to be removed.
+        /// \param entityId Identifier of the entity to remove the component from.
+        template <typename CompT>
+        void removeComponent(std::size_t entityId) { removeComponent(entityId, Component::getId<CompT>()); }
+
+        /// Gets an entity's component.
+        /// \note The entity is assumed to have a component of the given type; this is only checked in Debug.
+        /// \tparam CompT Type of the component to be fetched.
+        /// \param entityId Identifier of the entity to get the component from.
+        /// \return Reference to the found component.
+        template <typename CompT>
+        const CompT& getComponent(std::size_t entityId) const noexcept
+        {
+            const EntityLocation& location = getLocation(entityId);
+            return location.archetype->getColumn<CompT>()[location.row];
+        }
+
+        template <typename CompT>
+        CompT& getComponent(std::size_t entityId) noexcept
+        {
+            return const_cast<CompT&>(static_cast<const ComponentStorage*>(this)->getComponent<CompT>(entityId));
+        }
+
+        /// Calls a function on every non-empty archetype holding at least all the given components.
+        /// \tparam FuncT Type of the function to be called.
+        /// \param components Components the archetypes must hold.
+        /// \param func Function to be called with each matching archetype.
+        template <typename FuncT>
+        void forEachArchetype(const ComponentMask& components, FuncT&& func)
+        {
+            for (const ArchetypePtr& archetype : m_archetypes)
+            {
+                if (!archetype->isEmpty() && archetype->getSignature().contains(components))
+                    func(*archetype);
+            }
+        }
+
+        /// Removes all entities & their components, keeping only the archetype holding no component.
+        void clear();
+
+        ComponentStorage& operator=(const ComponentStorage&) = delete;
+        ComponentStorage& operator=(ComponentStorage&&) noexcept = default;
+
+    private:
+        void removeComponent(std::size_t entityId, std::size_t compId);
+        /// Moves an entity & the components it keeps into the given archetype, updating the location of the entity moved in its former row.
+        /// \param entityId Identifier of the entity to be moved.
+        /// \param archetype Archetype to move the entity into.
+        void moveEntity(std::size_t entityId, Archetype& archetype);
+        Archetype* findArchetype(const ComponentMask& signature) const noexcept;
+        /// Creates an archetype with the given signature, copying the columns of another one.
+        /// \note Columns which are not part of the signature are not created; the missing ones must be added afterward.
+        /// \param signature Signature of the archetype to be created.
+        /// \param source Archetype to copy the columns of.
+        /// \return Reference to the newly created archetype.
+        Archetype& createArchetype(const ComponentMask& signature, const Archetype& source);
+        /// Caches the transitions between two archetypes differing only by the given component.
+        /// \param source Archetype which doesn't contain the component.
+        /// \param target Archetype which contains the component.
+        /// \param compId Identifier of the component.
+        static void linkArchetypes(Archetype& source, Archetype& target, std::size_t compId);
+
+        std::vector<ArchetypePtr> m_archetypes{};
+        std::vector<EntityLocation> m_locations{}; // Indexed by entity ID
+    };
+
+} // namespace Rei
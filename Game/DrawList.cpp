@@ -0,0 +1,109 @@
+#include "DrawList.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace Rei
+{
+
+    void DrawList::reserve(std::size_t drawCount)
+    {
+        m_draws.reserve(drawCount);
+        m_transforms.reserve(drawCount);
+        m_instanceTransforms.reserve(drawCount);
+    }
+
+    void DrawList::addDraw(uint32_t passId, uint32_t shaderId, uint32_t materialId, uint32_t meshId, const Mat4f& transform, float depth)
+    {
+        assert("Error: The draw's pass index is too large for the draw key." && passId <= DrawKey::computeMask(DrawKey::PassBitCount));
+        assert("Error: The draw's shader index is too large for the draw key." && shaderId <= DrawKey::computeMask(DrawKey::ShaderBitCount));
+        assert("Error: The draw's material index is too large for the draw key." && materialId <= DrawKey::computeMask(DrawKey::MaterialBitCount));
+        assert("Error: The draw's mesh index is too large for the draw key." && meshId <= DrawKey::computeMask(DrawKey::MeshBitCount));
+
+        const float normalizedDepth = std::clamp(depth / m_maxDepth, 0.f, 1.f);
+        const auto quantizedDepth   = static_cast<uint32_t>(normalizedDepth * static_cast<float>(DrawKey::computeMask(DrawKey::DepthBitCount)));
+
+        m_draws.emplace_back(DrawKey::pack(passId, shaderId, materialId, meshId, quantizedDepth), static_cast<uint32_t>(m_transforms.size()));
+        m_transforms.emplace_back(transform);
+    }
+
+    void DrawList::build()
+    {
+        std::sort(m_draws.begin(), m_draws.end(), [](const auto& draw1, const auto& draw2) { return (draw1.first < draw2.first); });
+
+        m_batches.clear();
+        m_instanceTransforms.clear();
+
+        for (std::size_t drawIndex = 0; drawIndex < m_draws.size(); ++drawIndex)
+        {
+            const uint64_t key = m_draws[drawIndex].first;
+
+            if (m_batches.empty() || !DrawKey::haveSameStates(key, m_draws[drawIndex - 1].first) || m_batches.back().instanceCount == MaxInstanceCount)
+            {
+                DrawBatch& batch = m_batches.emplace_back();
+                batch.passId        = DrawKey::recoverPass(key);
+                batch.shaderId      = DrawKey::recoverShader(key);
+                batch.materialId    = DrawKey::recoverMaterial(key);
+                batch.meshId        = DrawKey::recoverMesh(key);
+                batch.firstInstance = m_instanceTransforms.size();
+            }
+
+            ++m_batches.back().instanceCount;
+            m_instanceTransforms.emplace_back(m_transforms[m_draws[drawIndex].second]);
+        }
+    }
+
+    std::size_t DrawList::submit(DrawSubmitter& submitter, uint32_t passId) const
+    {
+        // Batches being sorted by pass first, those of the requested pass are contiguous
+        const auto passBegin = std::lower_bound(m_batches.cbegin(), m_batches.cend(), passId, [](const DrawBatch& batch, uint32_t id) { return (batch.passId < id); });
+        const auto passEnd   = std::upper_bound(passBegin, m_batches.cend(), passId, [](uint32_t id, const DrawBatch& batch) { return (id < batch.passId); });
+
+        if (passBegin == passEnd)
+            return 0;
+
+        const DrawBatch* previousBatch = nullptr;
+        // Range of instances currently uploaded, which never holds more than the instance buffer
+        std::size_t firstChunkInstance = 0;
+        std::size_t chunkEndInstance = 0;
+
+        for (auto batchIt = passBegin; batchIt != passEnd; ++batchIt)
+        {
+            if (batchIt->firstInstance + batchIt->instanceCount > chunkEndInstance)
+            {
+                // No batch holding more than MaxInstanceCount instances, the chunk always fits at least this one
+                firstChunkInstance = batchIt->firstInstance;
+                chunkEndInstance = firstChunkInstance;
+
+                for (auto chunkIt = batchIt; chunkIt != passEnd && chunkIt->firstInstance + chunkIt->instanceCount - firstChunkInstance <= MaxInstanceCount; ++chunkIt)
+                    chunkEndInstance = chunkIt->firstInstance + chunkIt->instanceCount;
+
+                submitter.uploadInstances(m_instanceTransforms.data() + firstChunkInstance, chunkEndInstance - firstChunkInstance);
+            }
+
+            if (previousBatch == nullptr || batchIt->shaderId != previousBatch->shaderId)
+                submitter.bindShader(batchIt->shaderId);
+
+            if (previousBatch == nullptr || batchIt->materialId != previousBatch->materialId)
+                submitter.bindMaterial(batchIt->materialId);
+
+            if (previousBatch == nullptr || batchIt->meshId != previousBatch->meshId)
+                submitter.bindMesh(batchIt->meshId);
+
+            submitter.drawInstanced(batchIt->firstInstance - firstChunkInstance, batchIt->instanceCount);
+            previousBatch = &*batchIt;
+        }
+
+        return static_cast<std::size_t>(passEnd - passBegin);
+    }
+
+    void DrawList::clear() noexcept
+    {
+        m_draws.clear();
+        m_transforms.clear();
+        m_batches.clear();
+        m_instanceTransforms.clear();
+    }
+
+} // namespace Rei
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Matrix.h"
+
+namespace Rei
+{
+
+    /// Interface of the graphics backend receiving the draws of a draw list.
+    /// With Direct3D 11, uploadInstances() is expected to fill a dynamic instance buffer mapped with D3D11_MAP_WRITE_DISCARD, & drawInstanced() to call
+    ///   DrawIndexedInstanced() with the given first instance as StartInstanceLocation.
+    class DrawSubmitter
+    {
+    public:
+        virtual void bindShader(uint32_t shaderId) = 0;
+        virtual void bindMaterial(uint32_t materialId) = 0;
+        virtual void bindMesh(uint32_t meshId) = 0;
+        /// Uploads the world matrices of the instances to be drawn next, replacing the previously uploaded ones.
+        /// \note Called before the first draw of a pass, then again whenever the next draw's instances were not part of the last upload; a single upload
+        ///   never holds more than DrawList::MaxInstanceCount matrices, nor splits a draw's instances.
+        /// \param transforms Instances' world matrices, in the order of the draws.
+        /// \param count Number of matrices.
+        virtual void uploadInstances(const Mat4f* transforms, std::size_t count) = 0;
+        /// Draws instances of the currently bound mesh.
+        /// \param firstInstance Index of the first instance's matrix in the last uploaded ones.
+        /// \param instanceCount Number of instances to be drawn.
+        virtual void drawInstanced(std::size_t firstInstance, std::size_t instanceCount) = 0;
+
+        virtual ~DrawSubmitter() = default;
+    };
+
+    /// Packed 64-bit sort key of a draw. From the most to the least significant bits: pass (8), shader (12), material (14), mesh (14) & depth (16).
+    /// Sorting draws by key thus groups them by pass first, then by the most expensive state to change; draws sharing all states are ordered by depth.
+    struct DrawKey
+    {
+        static constexpr uint32_t PassBitCount     = 8;
+        static constexpr uint32_t ShaderBitCount   = 12;
+        static constexpr uint32_t MaterialBitCount = 14;
+        static constexpr uint32_t MeshBitCount     = 14;
+        static constexpr uint32_t DepthBitCount    = 16;
+
+        static constexpr uint32_t DepthShift    = 0;
+        static constexpr uint32_t MeshShift     = DepthShift + DepthBitCount;
+        static constexpr uint32_t MaterialShift = MeshShift + MeshBitCount;
+        static constexpr uint32_t ShaderShift   = MaterialShift + MaterialBitCount;
+        static constexpr uint32_t PassShift     = ShaderShift + ShaderBitCount;
+
+        static_assert(PassShift + PassBitCount == 64, "Error: The draw key's fields must fill exactly 64 bits.");
+
+        static constexpr uint64_t computeMask(uint32_t bitCount) noexcept { return (uint64_t(1) << bitCount) - 1; }
+
+        static constexpr uint64_t pack(uint32_t passId, uint32_t shaderId, uint32_t materialId, uint32_t meshId, uint32_t depth) noexcept
+        {
+            return ((passId & computeMask(PassBitCount)) << PassShift) | ((shaderId & computeMask(ShaderBitCount)) << ShaderShift)
+                 | ((materialId & computeMask(MaterialBitCount)) << MaterialShift) | ((meshId & computeMask(MeshBitCount)) << MeshShift)
+                 | ((depth & computeMask(DepthBitCount)) << DepthShift);
+        }
+
+        static constexpr uint32_t recoverPass(uint64_t key) noexcept { return static_cast<uint32_t>((key >> PassShift) & computeMask(PassBitCount)); }
+        static constexpr uint32_t recoverShader(uint64_t key) noexcept { return static_cast<uint32_t>((key >> ShaderShift) & computeMask(ShaderBitCount)); }
+        static constexpr uint32_t recoverMaterial(uint64_t key) noexcept { return static_cast<uint32_t>((key >> MaterialShift) & computeMask(MaterialBitCount)); }
+        static constexpr uint32_t recoverMesh(uint64_t key) noexcept { return static_cast<uint32_t>((key >> MeshShift) & computeMask(MeshBitCount)); }
+        /// Checks if two draws only differ by their depth, and can thus be drawn as instances of a single draw.
+        static constexpr bool haveSameStates(uint64_t key1, uint64_t key2) noexcept { return ((key1 >> MeshShift) == (key2 >> MeshShift)); }
+    };
+
+    /// Instanced draw, made of consecutive sorted draws sharing all their states.
+    struct DrawBatch
+    {
+        uint32_t passId = 0;
+        uint32_t shaderId = 0;
+        uint32_t materialId = 0;
+        uint32_t meshId = 0;
+        std::size_t firstInstance = 0;
+        std::size_t instanceCount = 0;
+    };
+
+    /// List of the draws of a frame, sorted by key & merged into instanced draws before being submitted.
+    class DrawList
+    {
+    public:
+        /// Maximum number of instances a single draw can hold, matching the size of the backend's instance buffer.
+        static constexpr std::size_t MaxInstanceCount = 1024;
+
+        std::size_t getDrawCount() const noexcept { return m_draws.size(); }
+        const std::vector<DrawBatch>& getBatches() const noexcept { return m_batches; }
+        const std::vector<Mat4f>& getInstanceTransforms() const noexcept { return m_instanceTransforms; }
+
+        /// Sets the view-space depth range over which the draws' depths are quantized; farther draws are all considered at the maximum depth.
+        /// \param maxDepth Maximum view-space depth.
+        void setMaxDepth(float maxDepth) noexcept { m_maxDepth = maxDepth; }
+        void reserve(std::size_t drawCount);
+        /// Adds a draw to the list.
+        /// \note Identifiers must fit in their field of the draw key; this is only checked in Debug.
+        /// \param passId Index of the render pass to draw in.
+        /// \param shaderId Index of the shader program to draw with.
+        /// \param materialId Index of the material to draw with.
+        /// \param meshId Index of the mesh to be drawn.
+        /// \param transform World matrix of the draw.
+        /// \param depth View-space depth of the draw, used to order draws sharing all their states front to back.
+        void addDraw(uint32_t passId, uint32_t shaderId, uint32_t materialId, uint32_t meshId, const Mat4f& transform, float depth);
+        /// Sorts the draws by key, then merges consecutive draws sharing all their states into instanced draws.
+        void build();
+        /// Submits the instanced draws of a pass, only binding a state when it differs from the previous draw's.
+        /// The instances are uploaded in chunks of consecutive draws, each holding at most MaxInstanceCount matrices.
+        /// \param submitter Graphics backend to submit to.
+        /// \param passId Index of the pass whose draws are to be submitted.
+        /// \return Number of submitted draw calls.
+        std::size_t submit(DrawSubmitter& submitter, uint32_t passId) const;
+        void clear() noexcept;
+
+    private:
+        /// Draw's key, associated to the index of its world matrix.
+        std::vector<std::pair<uint64_t, uint32_t>> m_draws{};
+        std::vector<Mat4f> m_transforms{};
+        std::vector<DrawBatch> m_batches{};
+        /// World matrices of the instances, in the order of the sorted draws.
+        std::vector<Mat4f> m_instanceTransforms{};
+        float m_maxDepth = 1000.f;
+    };
+
+} // namespace Rei
@@ -0,0 +1,24 @@
+#include "Entity.h"
+#include "World.h"
+
+namespace Rei
+{
+
+Entity::Entity(std::size_t index, World& world, bool enabled, uint32_t generation)
+    : m_id{ index }, m_generation{ generation }, m_enabled{ enabled }, m_world{ &world }, m_storage{ &world.m_componentStorage } {}
+
+void Entity::enable(bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+
+    m_enabled = enabled;
+    notifyChanged();
+}
+
+void Entity::notifyChanged()
+{
+    m_world->onEntityChanged(*this);
+}
+
+} // namespace Rei
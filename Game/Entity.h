@@ -1,30 +1,51 @@
 #pragma once
 
 #include "Component.h"
-#include "Bitset.h"
+#include "ComponentStorage.h"
 
+#include <cassert>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <type_traits>
 #include <vector>
 #include <stdexcept>
+#include <tuple>
 
 namespace Rei
 {
 
 class Entity;
+class World;
 using EntityPtr = std::unique_ptr<Entity>;
 
+/// Weak reference to an entity, which can safely be checked for validity after the entity has been destroyed.
+/// Entity indices are reused once their entity is destroyed; the generation tells apart the successive entities having had the same index.
+struct EntityHandle
+{
+    static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    bool isNull() const noexcept { return (index == InvalidIndex); }
+
+    bool operator==(const EntityHandle& handle) const noexcept { return (index == handle.index && generation == handle.generation); }
+    bool operator!=(const EntityHandle& handle) const noexcept { return !(*this == handle); }
+
+    uint32_t index = InvalidIndex;
+    uint32_t generation = 0;
+};
+
 class Entity
 {
 public:
-    explicit Entity(std::size_t index, bool enabled = true) : m_id{ index }, m_enabled{ enabled } {}
+    Entity(std::size_t index, World& world, bool enabled = true, uint32_t generation = 0);
     Entity(const Entity&) = delete;
     Entity(Entity&&) noexcept = delete;
 
     std::size_t getId() const noexcept { return m_id; }
+    uint32_t getGeneration() const noexcept { return m_generation; }
+    EntityHandle getHandle() const noexcept { return EntityHandle{ static_cast<uint32_t>(m_id), m_generation }; }
     bool isEnabled() const noexcept { return m_enabled; }
-    const std::vector<ComponentPtr>& getComponents() const noexcept { return m_components; }
-    const Bitset& getEnabledComponents() const noexcept { return m_enabledComponents; }
+    const ComponentMask& getEnabledComponents() const noexcept { return m_enabledComponents; }
 
     template <typename... Args>
     static EntityPtr create(Args&&... args)
@@ -32,39 +53,35 @@ public:
         return std::make_unique<Entity>(std::forward<Args>(args)...);
     }
 
-    void enable(bool enabled = true) noexcept { m_enabled = enabled; }
-    void disable() noexcept { enable(false); }
+    void enable(bool enabled = true);
+    void disable() { enable(false); }
 
     template <typename CompT, typename... Args>
     CompT& addComponent(Args&&... args)
     {
         static_assert(std::is_base_of_v<Component, CompT>, "Error: The added component must be derived from Component.");
 
-        const std::size_t compId = Component::getId<CompT>();
+        CompT& component = m_storage->addComponent<CompT>(m_id, std::forward<Args>(args)...);
+        m_enabledComponents.setBit(Component::getId<CompT>());
+        notifyChanged();
 
-        if (compId >= m_components.size())
-            m_components.resize(compId + 1);
-
-        m_components[compId] = std::make_unique<CompT>(std::forward<Args>(args)...);
-        m_enabledComponents.setBit(compId);
-
-        return static_cast<CompT&>(*m_components[compId]);
+        return component;
     }
 
-    template <typename CompT>
-    std::tuple<CompT&> addComponents()
+    /// Adds several default-constructed components at once, moving the entity's components into another archetype a single time.
+    /// \tparam CompTs Types of the components to be added.
+    /// \return References to the added components, all fetched once the entity has reached its final archetype.
+    template <typename... CompTs>
+    std::tuple<CompTs&...> addComponents()
     {
-        static_assert(std::is_base_of_v<Component, CompT>, "Error: The added component must be derived from Component.");
+        static_assert(sizeof...(CompTs) > 0, "Error: At least one component must be added.");
+        static_assert((std::is_base_of_v<Component, CompTs> && ...), "Error: The added components must be derived from Component.");
 
-        return std::forward_as_tuple(addComponent<CompT>());
-    }
+        m_storage->addComponents<CompTs...>(m_id);
+        (m_enabledComponents.setBit(Component::getId<CompTs>()), ...);
+        notifyChanged();
 
-    template <typename CompT1, typename CompT2, typename... C>
-    std::tuple<CompT1&, CompT2&, C...> addComponents()
-    {
-        static_assert(std::is_base_of_v<Component, CompT1>, "Error: The added component must be derived from Component.");
-
-        return std::tuple_cat(std::forward_as_tuple(addComponent<CompT1>()), addComponents<CompT2, C...>());
+        return std::forward_as_tuple(getComponent<CompTs>()...);
     }
 
     template <typename CompT>
@@ -72,8 +89,7 @@ public:
     {
         static_assert(std::is_base_of_v<Component, CompT>, "Error: The checked component must be derived from Component.");
 
-        const std::size_t compId = Component::getId<CompT>();
-        return ((compId < m_components.size()) && m_enabledComponents[compId]);
+        return m_enabledComponents[Component::getId<CompT>()];
     }
 
     template <typename CompT>
@@ -82,7 +98,7 @@ public:
         static_assert(std::is_base_of_v<Component, CompT>, "Error: The fetched component must be derived from Component.");
 
         if (hasComponent<CompT>())
-            return static_cast<const CompT&>(*m_components[Component::getId<CompT>()]);
+            return m_storage->getComponent<CompT>(m_id);
 
         throw std::runtime_error("Error: No component available of specified type");
     }
@@ -93,16 +109,32 @@ public:
         return const_cast<CompT&>(static_cast<const Entity*>(this)->getComponent<CompT>());
     }
 
+    /// Gets a component without checking that the entity holds it, which is only asserted in Debug.
+    /// \note To be used in hot loops where the entity's components are already known, for example after checking its enabled components' mask.
+    /// \tparam CompT Type of the component to be fetched.
+    /// \return Reference to the component.
+    template <typename CompT>
+    const CompT& getComponentUnchecked() const noexcept
+    {
+        assert("Error: No component available of specified type." && hasComponent<CompT>());
+        return m_storage->getComponent<CompT>(m_id);
+    }
+
+    template <typename CompT>
+    CompT& getComponentUnchecked() noexcept
+    {
+        return const_cast<CompT&>(static_cast<const Entity*>(this)->getComponentUnchecked<CompT>());
+    }
+
     template <typename CompT> void removeComponent()
     {
         static_assert(std::is_base_of_v<Component, CompT>, "Error: The removed component must be derived from Component.");
 
         if (hasComponent<CompT>())
         {
-            const std::size_t compId = Component::getId<CompT>();
-
-            m_components[compId].reset();
-            m_enabledComponents.setBit(compId, false);
+            m_storage->removeComponent<CompT>(m_id);
+            m_enabledComponents.setBit(Component::getId<CompT>(), false);
+            notifyChanged();
         }
     }
 
@@ -110,10 +142,15 @@ public:
     Entity& operator=(Entity&&) noexcept = delete;
 
 private:
+    /// Notifies the owning world that the entity's components or enabled state have changed.
+    void notifyChanged();
+
     std::size_t m_id{};
+    uint32_t m_generation{};
     bool m_enabled{};
-    std::vector<ComponentPtr> m_components{};
-    Bitset m_enabledComponents{};
+    World* m_world{};
+    ComponentStorage* m_storage{};
+    ComponentMask m_enabledComponents{};
 };
 
 } // namespace Rei
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Entity.h"
+#include "EntitySet.h"
+
+namespace Rei
+{
+
+    /// Persistent set of all the enabled entities holding at least a given set of components.
+    /// Queries are owned by a World, which keeps them up to date whenever an entity's components or enabled state change.
+    class EntityQuery
+    {
+        friend class World;
+
+    public:
+        explicit EntityQuery(const ComponentMask& components) : m_components{ components } {}
+        EntityQuery(const EntityQuery&) = delete;
+        EntityQuery(EntityQuery&&) noexcept = delete;
+
+        const ComponentMask& getComponents() const noexcept { return m_components; }
+        std::size_t getSize() const noexcept { return m_entities.getSize(); }
+        bool isEmpty() const noexcept { return m_entities.isEmpty(); }
+        const std::vector<Entity*>& getEntities() const noexcept { return m_entities.getEntities(); }
+
+        /// Checks if the given entity is enabled & holds all the components of the query.
+        /// \param entity Entity to be checked.
+        /// \return True if the entity matches the query, false otherwise.
+        bool matches(const Entity& entity) const noexcept
+        {
+            return (entity.isEnabled() && entity.getEnabledComponents().contains(m_components));
+        }
+
+        EntitySet::Iterator begin() const noexcept { return m_entities.begin(); }
+        EntitySet::Iterator end() const noexcept { return m_entities.end(); }
+        Entity* operator[](std::size_t index) const noexcept { return m_entities[index]; }
+
+        EntityQuery& operator=(const EntityQuery&) = delete;
+        EntityQuery& operator=(EntityQuery&&) noexcept = delete;
+
+    private:
+        /// Adds or removes the entity according to whether it matches the query.
+        /// \param entity Entity to be refreshed.
+        void refreshEntity(Entity& entity)
+        {
+            if (matches(entity))
+                m_entities.insert(entity);
+            else
+                m_entities.erase(entity);
+        }
+
+        void removeEntity(const Entity& entity) { m_entities.erase(entity); }
+        void clear() noexcept { m_entities.clear(); }
+
+        ComponentMask m_components{};
+        EntitySet m_entities{};
+    };
+
+    using EntityQueryPtr = std::unique_ptr<EntityQuery>;
+
+} // namespace Rei
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cassert>
+#include <limits>
+#include <vector>
+
+#include "Entity.h"
+
+namespace Rei
+{
+
+    /// Sparse set of entities, giving constant-time insertion, removal & lookup while keeping its elements densely packed for iteration.
+    /// \note The iteration order is not stable: removing an entity moves the last one in its place.
+    class EntitySet
+    {
+    public:
+        using Iterator = std::vector<Entity*>::const_iterator;
+
+        EntitySet() = default;
+
+        std::size_t getSize() const noexcept { return m_entities.size(); }
+        bool isEmpty() const noexcept { return m_entities.empty(); }
+        const std::vector<Entity*>& getEntities() const noexcept { return m_entities; }
+
+        bool contains(const Entity& entity) const noexcept
+        {
+            const std::size_t entityId = entity.getId();
+            return (entityId < m_indices.size() && m_indices[entityId] != InvalidIndex);
+        }
+
+        /// Inserts an entity into the set.
+        /// \param entity Entity to be inserted.
+        /// \return True if the entity has been inserted, false if it already was in the set.
+        bool insert(Entity& entity)
+        {
+            const std::size_t entityId = entity.getId();
+
+            if (entityId >= m_indices.size())
+                m_indices.resize(entityId + 1, InvalidIndex);
+            else if (m_indices[entityId] != InvalidIndex)
+                return false;
+
+            m_indices[entityId] = m_entities.size();
+            m_entities.emplace_back(&entity);
+
+            return true;
+        }
+
+        /// Removes an entity from the set, replacing it by the last one.
+        /// \param entity Entity to be removed.
+        /// \return True if the entity has been removed, false if it wasn't in the set.
+        bool erase(const Entity& entity)
+        {
+            if (!contains(entity))
+                return false;
+
+            const std::size_t entityId = entity.getId();
+            const std::size_t entityIndex = m_indices[entityId];
+
+            Entity* lastEntity = m_entities.back();
+            m_entities[entityIndex] = lastEntity;
+            m_indices[lastEntity->getId()] = entityIndex;
+
+            m_entities.pop_back();
+            m_indices[entityId] = InvalidIndex;
+
+            return true;
+        }
+
+        void reserve(std::size_t entityCount) { m_entities.reserve(entityCount); }
+
+        /// Removes all entities from the set; only the entries of the contained entities are reset, making this proportional to the set's size.
+        void clear() noexcept
+        {
+            for (const Entity* entity : m_entities)
+                m_indices[entity->getId()] = InvalidIndex;
+
+            m_entities.clear();
+        }
+
+        Iterator begin() const noexcept { return m_entities.cbegin(); }
+        Iterator end() const noexcept { return m_entities.cend(); }
+
+        Entity* operator[](std::size_t index) const noexcept
+        {
+            assert("Error: The requested entity is out of bounds." && index < m_entities.size());
+            return m_entities[index];
+        }
+
+    private:
+        static constexpr std::size_t InvalidIndex = std::numeric_limits<std::size_t>::max();
+
+        std::vector<Entity*> m_entities{};
+        std::vector<std::size_t> m_indices{}; // Indexed by entity ID
+    };
+
+} // namespace Rei
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace Rei {
+
+    template <typename T, std::size_t Size>
+    class Vector;
+
+    namespace FloatUtils {
+
+        /// Checks if two given floating-point values are nearly equal to each other.
+        /// The tolerance is absolute for values close to 0, and relative to the largest magnitude otherwise, so that large values are compared as reliably as small ones.
+        /// \tparam T Type of the values to be compared; must be floating-point.
+        /// \tparam TolT Type of the tolerance.
+        /// \param val1 First value to be compared.
+        /// \param val2 Second value to be compared.
+        /// \param tolerance Tolerance of the comparison.
+        /// \return True if values are nearly equal, false otherwise.
+        template <typename T, typename TolT = T>
+        constexpr bool areNearlyEqual(T val1, T val2, TolT tolerance = std::numeric_limits<T>::epsilon()) noexcept {
+            static_assert(std::is_floating_point_v<T>, "Error: Values' type must be floating-point.");
+            static_assert(std::is_floating_point_v<TolT>, "Error: Tolerance's type must be floating-point.");
+
+            const T difference = (val1 > val2 ? val1 - val2 : val2 - val1);
+            const T absVal1 = (val1 < 0 ? -val1 : val1);
+            const T absVal2 = (val2 < 0 ? -val2 : val2);
+
+            return (difference <= static_cast<T>(tolerance) * std::max({ static_cast<T>(1), absVal1, absVal2 }));
+        }
+
+        /// Checks if two given floating-point vectors are nearly equal to each other, element by element.
+        /// \tparam T Type of the vectors' values; must be floating-point.
+        /// \tparam Size Vectors' size.
+        /// \tparam TolT Type of the tolerance.
+        /// \param vec1 First vector to be compared.
+        /// \param vec2 Second vector to be compared.
+        /// \param tolerance Tolerance of the comparison.
+        /// \return True if vectors are nearly equal, false otherwise.
+        template <typename T, std::size_t Size, typename TolT = T>
+        constexpr bool areNearlyEqual(const Vector<T, Size>& vec1, const Vector<T, Size>& vec2, TolT tolerance = std::numeric_limits<T>::epsilon()) noexcept {
+            for (std::size_t i = 0; i < Size; ++i) {
+                if (!areNearlyEqual(vec1[i], vec2[i], tolerance))
+                    return false;
+            }
+
+            return true;
+        }
+
+    } // namespace FloatUtils
+
+} // namespace Rei
@@ -1 +1,185 @@
 #include "FrameBuffer.h"
+
+#include <algorithm>
+
+#include "RenderTargetPool.h"
+
+namespace Rei
+{
+
+    void FrameBuffer::setDepthBuffer(Texture2DPtr texture)
+    {
+        releaseBuffer(m_depthBuffer);
+        m_depthBuffer = std::move(texture);
+    }
+
+    void FrameBuffer::setDepthBuffer(TextureFormat format)
+    {
+        assert("Error: A depth buffer must have a depth format." && isDepthFormat(format));
+        setDepthBuffer(acquireBuffer(format));
+    }
+
+    void FrameBuffer::addColorBuffer(Texture2DPtr texture, unsigned int index)
+    {
+        m_colorBuffers.emplace_back(std::move(texture), index);
+    }
+
+    void FrameBuffer::addColorBuffer(TextureFormat format, unsigned int index)
+    {
+        assert("Error: A color buffer must not have a depth format." && !isDepthFormat(format));
+        addColorBuffer(acquireBuffer(format), index);
+    }
+
+    void FrameBuffer::removeTextureBuffer(const Texture2DPtr& texture)
+    {
+        if (texture == m_depthBuffer)
+        {
+            clearDepthBuffer();
+            return;
+        }
+
+        const auto bufferIt = std::find_if(m_colorBuffers.begin(), m_colorBuffers.end(), [&texture](const auto& buffer) { return (buffer.first == texture); });
+
+        if (bufferIt == m_colorBuffers.end())
+            return;
+
+        releaseBuffer(texture);
+        m_colorBuffers.erase(bufferIt);
+    }
+
+    void FrameBuffer::clearDepthBuffer()
+    {
+        releaseBuffer(m_depthBuffer);
+        m_depthBuffer.reset();
+    }
+
+    void FrameBuffer::clearColorBuffers()
+    {
+        for (const auto& [texture, index] : m_colorBuffers)
+            releaseBuffer(texture);
+
+        m_colorBuffers.clear();
+    }
+
+    void FrameBuffer::clearTextureBuffers()
+    {
+        clearDepthBuffer();
+        clearColorBuffers();
+    }
+
+    void FrameBuffer::resizeBuffers(unsigned int width, unsigned int height)
+    {
+        m_width  = width;
+        m_height = height;
+        m_isResizePending = true;
+    }
+
+    void FrameBuffer::setSampleCount(unsigned int sampleCount)
+    {
+        assert("Error: A framebuffer must have at least one sample per pixel." && sampleCount > 0);
+
+        m_sampleCount = sampleCount;
+        m_isResizePending = true;
+    }
+
+    bool FrameBuffer::applyPendingResize()
+    {
+        // A window being minimized is resized to 0x0; the buffers keep their size until a valid one is requested
+        if (!m_isResizePending || m_width == 0 || m_height == 0)
+            return false;
+
+        m_isResizePending = false;
+        bool hasReallocated = false;
+
+        for (PooledBuffer& buffer : m_pooledBuffers)
+        {
+            // Going back to the size the buffers already have, as can happen while resizing, requires no reallocation
+            if (buffer.descriptor.width == m_width && buffer.descriptor.height == m_height && buffer.descriptor.sampleCount == m_sampleCount)
+                continue;
+
+            TextureDescriptor descriptor = buffer.descriptor;
+            descriptor.width       = m_width;
+            descriptor.height      = m_height;
+            descriptor.sampleCount = m_sampleCount;
+
+            Texture2DPtr texture = m_pool->acquire(descriptor);
+
+            if (m_depthBuffer == buffer.texture)
+            {
+                m_depthBuffer = texture;
+            }
+            else
+            {
+                for (auto& colorBuffer : m_colorBuffers)
+                {
+                    if (colorBuffer.first == buffer.texture)
+                        colorBuffer.first = texture;
+                }
+            }
+
+            m_pool->release(std::move(buffer.texture), buffer.descriptor);
+            buffer.texture    = std::move(texture);
+            buffer.descriptor = descriptor;
+            hasReallocated = true;
+        }
+
+        return hasReallocated;
+    }
+
+    FrameBuffer& FrameBuffer::operator=(FrameBuffer&& frameBuffer) noexcept
+    {
+        releaseBuffers();
+
+        m_index           = std::move(frameBuffer.m_index);
+        m_depthBuffer     = std::move(frameBuffer.m_depthBuffer);
+        m_colorBuffers    = std::move(frameBuffer.m_colorBuffers);
+        m_pool            = frameBuffer.m_pool;
+        m_pooledBuffers   = std::move(frameBuffer.m_pooledBuffers);
+        m_width           = frameBuffer.m_width;
+        m_height          = frameBuffer.m_height;
+        m_sampleCount     = frameBuffer.m_sampleCount;
+        m_isResizePending = frameBuffer.m_isResizePending;
+
+        return *this;
+    }
+
+    FrameBuffer::~FrameBuffer()
+    {
+        releaseBuffers();
+    }
+
+    Texture2DPtr FrameBuffer::acquireBuffer(TextureFormat format)
+    {
+        assert("Error: The framebuffer has no render target pool to take its buffers from." && m_pool != nullptr);
+        assert("Error: The framebuffer must be given a size before taking buffers from its pool." && m_width > 0 && m_height > 0);
+
+        const TextureDescriptor descriptor{ m_width, m_height, format, m_sampleCount };
+        Texture2DPtr texture = m_pool->acquire(descriptor);
+        m_pooledBuffers.push_back(PooledBuffer{ texture, descriptor });
+
+        return texture;
+    }
+
+    void FrameBuffer::releaseBuffer(const Texture2DPtr& texture)
+    {
+        if (texture == nullptr)
+            return;
+
+        const auto bufferIt = std::find_if(m_pooledBuffers.begin(), m_pooledBuffers.end(), [&texture](const PooledBuffer& buffer) { return (buffer.texture == texture); });
+
+        if (bufferIt == m_pooledBuffers.end())
+            return;
+
+        m_pool->release(std::move(bufferIt->texture), bufferIt->descriptor);
+        m_pooledBuffers.erase(bufferIt);
+    }
+
+    void FrameBuffer::releaseBuffers() noexcept
+    {
+        for (PooledBuffer& buffer : m_pooledBuffers)
+            m_pool->release(std::move(buffer.texture), buffer.descriptor);
+
+        m_pooledBuffers.clear();
+    }
+
+} // namespace Rei
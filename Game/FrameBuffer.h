@@ -5,27 +5,40 @@
 #include <vector>
 
 #include "OwnerValue.h"
+#include "RenderPass.h"
 namespace Rei
 {
     class RenderShaderProgram;
+    class RenderTargetPool;
     class Texture2D;
     using Texture2DPtr = std::shared_ptr<Texture2D>;
     class VertexShader;
 
+    /// Set of buffer textures rendered into.
+    /// Buffers can either be given directly, their owner being responsible for them, or be taken from a render target pool; pooled buffers are
+    ///   given back when removed or when the framebuffer is destroyed, & are the only ones reallocated on resize.
     class FrameBuffer
     {
         friend class RenderPass;
     public:
-        Framebuffer();
-        Framebuffer(const Framebuffer&) = delete;
-        Framebuffer(Framebuffer&&) noexcept = default;
+        FrameBuffer() = default;
+        /// Creates a framebuffer whose pooled buffers are taken from the given pool.
+        /// \param pool Render target pool, which must outlive the framebuffer.
+        explicit FrameBuffer(RenderTargetPool& pool) noexcept : m_pool{ &pool } {}
+        FrameBuffer(const FrameBuffer&) = delete;
+        FrameBuffer(FrameBuffer&&) noexcept = default;
 
         unsigned int getIndex() const noexcept { return m_index; }
         bool isEmpty() const noexcept { return (!hasDepthBuffer() && m_colorBuffers.empty()); }
         bool hasDepthBuffer() const noexcept { return (m_depthBuffer != nullptr); }
-        const Texture2D& getDepthBuffer() const noexcept { assert("Error: Framebuffer doesn't contain a depth buffer." && hasDepthBuffer()); return *m_depthBuffer; }
+        const Texture2D& getDepthBuffer() const noexcept { assert("Error: FrameBuffer doesn't contain a depth buffer." && hasDepthBuffer()); return *m_depthBuffer; }
         std::size_t getColorBufferCount() const noexcept { return m_colorBuffers.size(); }
         const Texture2D& getColorBuffer(std::size_t bufferIndex) const noexcept { return *m_colorBuffers[bufferIndex].first; }
+        unsigned int getWidth() const noexcept { return m_width; }
+        unsigned int getHeight() const noexcept { return m_height; }
+        unsigned int getSampleCount() const noexcept { return m_sampleCount; }
+        /// Checks if a resize has been requested but not yet applied to the pooled buffers.
+        bool isResizePending() const noexcept { return m_isResizePending; }
 
         /// Gives a basic vertex shader, to display the framebuffer.
         /// \return Basic display vertex shader.
@@ -34,23 +47,39 @@ namespace Rei
         /// Sets the write depth buffer texture.
         /// \param texture Depth buffer texture to be set; must have a depth colorspace.
         void setDepthBuffer(Texture2DPtr texture);
+        /// Sets a write depth buffer taken from the render target pool, of the framebuffer's size.
+        /// \param format Format of the depth buffer; must be a depth format.
+        void setDepthBuffer(TextureFormat format);
         /// Adds a write color buffer texture.
         /// \param texture Color buffer texture to be added; must have a non-depth colorspace.
         /// \param index Buffer's index (location of the shader's output value).
         void addColorBuffer(Texture2DPtr texture, unsigned int index);
+        /// Adds a write color buffer taken from the render target pool, of the framebuffer's size.
+        /// \param format Format of the color buffer; must not be a depth format.
+        /// \param index Buffer's index (location of the shader's output value).
+        void addColorBuffer(TextureFormat format, unsigned int index);
         /// Removes a write buffer texture.
         /// \param texture Buffer texture to be removed.
         void removeTextureBuffer(const Texture2DPtr& texture);
         /// Removes the depth buffer.
-        void clearDepthBuffer() { m_depthBuffer.reset(); }
+        void clearDepthBuffer();
         /// Removes all color buffers.
-        void clearColorBuffers() { m_colorBuffers.clear(); }
+        void clearColorBuffers();
         /// Removes both depth & color buffers.
         void clearTextureBuffers();
-        /// Resizes the buffer textures.
+        /// Requests the buffer textures to be resized; the pooled buffers are only reallocated by applyPendingResize().
+        /// Successive requests thus coalesce into a single reallocation, for instance while the window is being resized by dragging its border.
         /// \param width Width to be resized to.
         /// \param height Height to be resized to.
         void resizeBuffers(unsigned int width, unsigned int height);
+        /// Requests the number of samples per pixel of the pooled buffers to be changed, applied along with the pending resize.
+        /// \param sampleCount Number of samples per pixel.
+        void setSampleCount(unsigned int sampleCount);
+        /// Reallocates the pooled buffers which don't match the last requested size & sample count, giving the previous ones back to the pool.
+        /// Nothing calls it implicitly: the framebuffer's owner must call it once a frame, before the buffers are bound.
+        /// \note Resizes to a null width or height, as requested when the window is minimized, are deferred until a valid size is requested.
+        /// \return True if any buffer has been reallocated, false otherwise.
+        bool applyPendingResize();
         /// Maps the buffers textures onto the graphics card.
         void mapBuffers() const;
         /// Binds the framebuffer and clears the color & depth buffers.
@@ -60,15 +89,34 @@ namespace Rei
         /// Displays the framebuffer.
         void display() const;
 
-        Framebuffer& operator=(const Framebuffer&) = delete;
-        Framebuffer& operator=(Framebuffer&&) noexcept = default;
+        FrameBuffer& operator=(const FrameBuffer&) = delete;
+        FrameBuffer& operator=(FrameBuffer&& frameBuffer) noexcept;
 
-        ~Framebuffer();
+        ~FrameBuffer();
 
     private:
+        /// Buffer taken from the pool, along with the properties it has been acquired with.
+        struct PooledBuffer
+        {
+            Texture2DPtr texture{};
+            TextureDescriptor descriptor{};
+        };
+
+        Texture2DPtr acquireBuffer(TextureFormat format);
+        /// Gives a buffer back to the pool if it has been taken from it.
+        /// \param texture Buffer to be released.
+        void releaseBuffer(const Texture2DPtr& texture);
+        void releaseBuffers() noexcept;
+
         OwnerValue<unsigned int> m_index{};
         Texture2DPtr m_depthBuffer{};
         std::vector<std::pair<Texture2DPtr, unsigned int>> m_colorBuffers{};
+        RenderTargetPool* m_pool{};
+        std::vector<PooledBuffer> m_pooledBuffers{};
+        unsigned int m_width = 0;
+        unsigned int m_height = 0;
+        unsigned int m_sampleCount = 1;
+        bool m_isResizePending = false;
     };
 
-} // namespace Rei
\ No newline at end of file
+} // namespace Rei
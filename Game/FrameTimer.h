@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+
+namespace Rei
+{
+    struct FrameTimeInfo
+    {
+        /// Time elapsed since the previous frame, in seconds.
+        float deltaTime{};
+        /// Time elapsed since the start, in seconds; kept in double precision so that it stays accurate over long uptimes.
+        double globalTime{};
+        /// Number of fixed steps to be simulated this frame.
+        int substepCount{};
+        /// Duration of a fixed step, in seconds.
+        float substepTime{};
+        /// Progress toward the next fixed step, between 0 & 1, to interpolate between the states of the last two steps when rendering.
+        float interpolationAlpha{};
+    };
+
+    /// Timer measuring frame times with a monotonic clock, & accumulating them into fixed steps.
+    /// The number of fixed steps a frame can have is capped: after a hitch, the time beyond the cap is dropped instead of being caught up on,
+    ///   which would otherwise take longer & longer frames (the "spiral of death").
+    class FrameTimer
+    {
+    public:
+        static constexpr int DefaultMaxSubstepCount = 8;
+
+        explicit FrameTimer(double fixedTimeStep = 1.0 / 60.0) { setFixedTimeStep(fixedTimeStep); }
+
+        const FrameTimeInfo& getTimeInfo() const noexcept { return m_timeInfo; }
+        double getFixedTimeStep() const noexcept { return m_fixedTimeStep; }
+        int getMaxSubstepCount() const noexcept { return m_maxSubstepCount; }
+        /// Gets the total number of fixed steps dropped because a frame would have exceeded the maximum substep count.
+        std::size_t getDroppedSubstepCount() const noexcept { return m_droppedSubstepCount; }
+
+        void setFixedTimeStep(double fixedTimeStep)
+        {
+            assert("Error: Fixed time step must be positive." && fixedTimeStep > 0.0);
+
+            m_fixedTimeStep = fixedTimeStep;
+            m_timeInfo.substepTime = static_cast<float>(fixedTimeStep);
+        }
+        /// Sets the maximum number of fixed steps a frame can have.
+        /// \param maxSubstepCount Maximum substep count; must be strictly positive.
+        void setMaxSubstepCount(int maxSubstepCount)
+        {
+            assert("Error: The maximum substep count must be strictly positive." && maxSubstepCount > 0);
+            m_maxSubstepCount = maxSubstepCount;
+        }
+
+        /// Starts a new frame, measuring the time elapsed since the previous one.
+        /// \return Time information of the new frame.
+        const FrameTimeInfo& tick()
+        {
+            const std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+            const double deltaTime = std::chrono::duration<double>(currentTime - m_lastTime).count();
+            m_lastTime = currentTime;
+
+            return advance(deltaTime);
+        }
+        /// Starts a new frame, lasting the given time; allows running the simulation on a different clock, or replaying it.
+        /// \param deltaTime Duration of the previous frame, in seconds.
+        /// \return Time information of the new frame.
+        const FrameTimeInfo& advance(double deltaTime)
+        {
+            m_timeInfo.deltaTime   = static_cast<float>(deltaTime);
+            m_timeInfo.globalTime += deltaTime;
+            m_accumulatedTime     += deltaTime;
+
+            const double substepCount = std::floor(m_accumulatedTime / m_fixedTimeStep);
+            m_accumulatedTime -= substepCount * m_fixedTimeStep;
+
+            if (substepCount > static_cast<double>(m_maxSubstepCount))
+            {
+                m_droppedSubstepCount += static_cast<std::size_t>(substepCount) - static_cast<std::size_t>(m_maxSubstepCount);
+                m_timeInfo.substepCount = m_maxSubstepCount;
+            }
+            else
+            {
+                m_timeInfo.substepCount = static_cast<int>(substepCount);
+            }
+
+            m_timeInfo.interpolationAlpha = static_cast<float>(m_accumulatedTime / m_fixedTimeStep);
+
+            return m_timeInfo;
+        }
+        /// Restarts the clock from now, so that the time spent since the last frame (for instance loading) is not simulated.
+        void resetClock() noexcept { m_lastTime = std::chrono::steady_clock::now(); }
+
+    private:
+        FrameTimeInfo m_timeInfo{};
+        std::chrono::steady_clock::time_point m_lastTime = std::chrono::steady_clock::now();
+        double m_fixedTimeStep = 1.0 / 60.0;
+        double m_accumulatedTime = 0.0;
+        int m_maxSubstepCount = DefaultMaxSubstepCount;
+        std::size_t m_droppedSubstepCount = 0;
+    };
+
+} // namespace Rei
@@ -0,0 +1,68 @@
+#include "HitDetectionSystem.h"
+#include "FrameTimer.h"
+#include "Hitbox.h"
+#include "MatrixSimd.h"
+#include "Profiler.h"
+#include "TransformGraph.h"
+
+#include <algorithm>
+
+namespace Rei
+{
+
+    HitDetectionSystem::HitDetectionSystem(std::size_t historySize) : m_history(historySize)
+    {
+        registerComponents<Hitbox>();
+        registerWrittenComponents<Hitbox>();
+
+        m_isFixedStep = true;
+    }
+
+    uint32_t HitDetectionSystem::findRewoundTick(float delay) const noexcept
+    {
+        uint32_t tick = m_tick;
+        m_history.findTick(m_time - static_cast<double>(delay), tick);
+
+        return tick;
+    }
+
+    bool HitDetectionSystem::update(const FrameTimeInfo& timeInfo)
+    {
+        REI_PROFILE_ZONE("HitDetectionSystem::update");
+
+        ++m_tick;
+        m_time += static_cast<double>(timeInfo.deltaTime);
+
+        m_history.beginFrame(m_tick, m_time);
+
+        forEach<Hitbox>([this] (const Entity& entity, const Hitbox& hitbox)
+        {
+            m_history.addEntity(entity.getHandle());
+
+            for (std::size_t shapeIndex = 0; shapeIndex < hitbox.getShapeCount(); ++shapeIndex)
+            {
+                const HitShape& shape = hitbox.getShape(shapeIndex);
+
+                // As with the renderers' bounding spheres, the radius is scaled by the largest of the transform's scales
+                const Mat4f& worldMatrix = shape.transform->getWorldMatrix();
+                const float maxScale = std::max({ worldMatrix.recoverColumn(0).computeLength(),
+                                                  worldMatrix.recoverColumn(1).computeLength(),
+                                                  worldMatrix.recoverColumn(2).computeLength() });
+
+                m_history.addShape(Vec3f(Simd::multiply(worldMatrix, Vec4f(shape.localStart, 1.f))),
+                                   Vec3f(Simd::multiply(worldMatrix, Vec4f(shape.localEnd, 1.f))),
+                                   shape.radius * maxScale, shape.zone);
+            }
+        });
+
+        m_history.endFrame();
+
+        return true;
+    }
+
+    void HitDetectionSystem::destroy()
+    {
+        m_history.clear();
+    }
+
+} // namespace Rei
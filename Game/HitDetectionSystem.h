@@ -0,0 +1,52 @@
+#pragma once
+
+#include "HitboxHistory.h"
+#include "System.h"
+
+namespace Rei
+{
+
+    /// Fixed-step system recording the world-space shapes of every entity holding a Hitbox at each tick, to trace rays against them as they were
+    ///   in the past. Rewinding to the tick a shooter was seeing compensates for its latency: on the server, a shot on a head is thus a hit on the head
+    ///   the shooter aimed at, wherever it has moved since.
+    /// \note The shapes are recorded from their transforms' world matrices as of the transform graph's last update. As Hitbox is declared as written,
+    ///   systems tracing rays during their update must declare reading it, for them not to be updated concurrently with the recording.
+    class HitDetectionSystem final : public System
+    {
+    public:
+        /// Creates the system.
+        /// \param historySize Number of past ticks whose shapes are kept; shots lagging further behind are traced against the oldest of them.
+        explicit HitDetectionSystem(std::size_t historySize = HitboxHistory::DefaultFrameCount);
+
+        const HitboxHistory& getHistory() const noexcept { return m_history; }
+        /// Gets the last recorded tick.
+        uint32_t getTick() const noexcept { return m_tick; }
+        /// Gets the time of the last recorded tick, in seconds since the system's first update.
+        double getTime() const noexcept { return m_time; }
+
+        /// Finds the tick to rewind to for a shooter seeing the world with the given delay.
+        /// \param delay Delay to be compensated for, in seconds; typically the shooter's round-trip time plus its interpolation delay.
+        /// \return Most recent tick at least as old as the delay, or the oldest recorded tick if none is.
+        uint32_t findRewoundTick(float delay) const noexcept;
+        /// Finds the closest shape hit by each ray, as the shapes were at the given tick.
+        /// \param rays Rays to be traced.
+        /// \param rayCount Number of rays.
+        /// \param tick Recorded tick to trace the rays at.
+        /// \param results Closest hit of each ray; must hold at least rayCount elements.
+        /// \return Number of rays which hit an entity; 0 if the tick isn't recorded anymore.
+        std::size_t traceRays(const HitRay* rays, std::size_t rayCount, uint32_t tick, HitResult* results) const
+        {
+            return m_history.traceRays(rays, rayCount, tick, results, m_threadPool);
+        }
+
+        bool update(const FrameTimeInfo& timeInfo) override;
+
+        void destroy() override;
+
+    private:
+        HitboxHistory m_history;
+        uint32_t m_tick = 0;
+        double m_time = 0.0;
+    };
+
+} // namespace Rei
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+#include "Component.h"
+#include "Vector.h"
+
+namespace Rei
+{
+    class TransformNode;
+
+    /// Capsule around a segment, following a transform node; it degenerates into a sphere if both ends of the segment are the same.
+    struct HitShape
+    {
+        const TransformNode* transform{};
+        Vec3f localStart{};
+        Vec3f localEnd{};
+        float radius = 0.f;
+        /// Game-defined identifier of the part of the entity hit (head, torso, ...), reported along with the hits.
+        uint8_t zone = 0;
+    };
+
+    /// Component giving an entity the shapes rays can hit, each attached to a transform node (typically a skeleton's bones).
+    /// The shapes' world positions of the last ticks are recorded by the HitDetectionSystem, to trace rays against where the entity was in the past.
+    class Hitbox final : public Component
+    {
+    public:
+        static constexpr std::size_t MaxShapeCount = 16;
+
+        std::size_t getShapeCount() const noexcept { return m_shapeCount; }
+        const HitShape& getShape(std::size_t shapeIndex) const noexcept
+        {
+            assert("Error: The shape index is out of bounds." && shapeIndex < m_shapeCount);
+            return m_shapes[shapeIndex];
+        }
+
+        /// Adds a capsule to the hitbox.
+        /// \param transform Transform node the capsule follows; must outlive the component.
+        /// \param localStart Start of the capsule's segment, relative to the transform.
+        /// \param localEnd End of the capsule's segment, relative to the transform.
+        /// \param radius Radius of the capsule, scaled along with the transform.
+        /// \param zone Identifier of the part of the entity the capsule covers.
+        void addCapsule(const TransformNode& transform, const Vec3f& localStart, const Vec3f& localEnd, float radius, uint8_t zone = 0) noexcept
+        {
+            assert("Error: The hitbox cannot hold more shapes." && m_shapeCount < MaxShapeCount);
+            m_shapes[m_shapeCount++] = HitShape{ &transform, localStart, localEnd, radius, zone };
+        }
+
+        /// Adds a sphere to the hitbox.
+        /// \param transform Transform node the sphere follows; must outlive the component.
+        /// \param localCenter Center of the sphere, relative to the transform.
+        /// \param radius Radius of the sphere, scaled along with the transform.
+        /// \param zone Identifier of the part of the entity the sphere covers.
+        void addSphere(const TransformNode& transform, const Vec3f& localCenter, float radius, uint8_t zone = 0) noexcept
+        {
+            addCapsule(transform, localCenter, localCenter, radius, zone);
+        }
+
+        void clearShapes() noexcept { m_shapeCount = 0; }
+
+    private:
+        std::array<HitShape, MaxShapeCount> m_shapes{};
+        std::size_t m_shapeCount = 0;
+    };
+} // namespace Rei
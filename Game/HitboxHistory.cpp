@@ -0,0 +1,663 @@
+#include "HitboxHistory.h"
+#include "Profiler.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+
+namespace Rei
+{
+
+    namespace
+    {
+
+        constexpr float Infinity = std::numeric_limits<float>::infinity();
+        constexpr uint32_t InvalidShape = std::numeric_limits<uint32_t>::max();
+
+        /// View over consecutive capsules of a frame, stored as structures of arrays.
+        struct CapsuleSoaView
+        {
+            const float* startsX{};
+            const float* startsY{};
+            const float* startsZ{};
+            const float* endsX{};
+            const float* endsY{};
+            const float* endsZ{};
+            const float* radii{};
+            std::size_t count{};
+        };
+
+        // A capsule is hit either on its cylindrical body, between the planes of its segment's ends, or on either of the spheres capping it;
+        //  a hit on the body, if any, is always the closest. A sphere is a capsule of length 0, whose body can never be hit.
+
+        float intersectSphere(float centerToOriginX, float centerToOriginY, float centerToOriginZ, const Vec3f& direction, float sqRadius) noexcept
+        {
+            const float b = direction.x() * centerToOriginX + direction.y() * centerToOriginY + direction.z() * centerToOriginZ;
+            const float c = centerToOriginX * centerToOriginX + centerToOriginY * centerToOriginY + centerToOriginZ * centerToOriginZ - sqRadius;
+            const float h = b * b - c;
+
+            if (h < 0.f)
+                return Infinity;
+
+            const float distance = -b - std::sqrt(h);
+            return (distance >= 0.f ? distance : Infinity);
+        }
+
+        float intersectCapsule(const CapsuleSoaView& capsules, std::size_t capsuleIndex, const Vec3f& origin, const Vec3f& direction) noexcept
+        {
+            const float axisX = capsules.endsX[capsuleIndex] - capsules.startsX[capsuleIndex];
+            const float axisY = capsules.endsY[capsuleIndex] - capsules.startsY[capsuleIndex];
+            const float axisZ = capsules.endsZ[capsuleIndex] - capsules.startsZ[capsuleIndex];
+            const float startToOriginX = origin.x() - capsules.startsX[capsuleIndex];
+            const float startToOriginY = origin.y() - capsules.startsY[capsuleIndex];
+            const float startToOriginZ = origin.z() - capsules.startsZ[capsuleIndex];
+            const float sqRadius = capsules.radii[capsuleIndex] * capsules.radii[capsuleIndex];
+
+            const float axisSqLength = axisX * axisX + axisY * axisY + axisZ * axisZ;
+            const float axisDotDir = axisX * direction.x() + axisY * direction.y() + axisZ * direction.z();
+            const float axisDotOrigin = axisX * startToOriginX + axisY * startToOriginY + axisZ * startToOriginZ;
+            const float dirDotOrigin = direction.x() * startToOriginX + direction.y() * startToOriginY + direction.z() * startToOriginZ;
+            const float originSqLength = startToOriginX * startToOriginX + startToOriginY * startToOriginY + startToOriginZ * startToOriginZ;
+
+            const float a = axisSqLength - axisDotDir * axisDotDir;
+            const float b = axisSqLength * dirDotOrigin - axisDotOrigin * axisDotDir;
+            const float c = axisSqLength * originSqLength - axisDotOrigin * axisDotOrigin - sqRadius * axisSqLength;
+            const float h = b * b - a * c;
+
+            // The ray misses the infinite cylinder, & thus the caps inside it as well
+            if (h < 0.f)
+                return Infinity;
+
+            const float bodyDistance = (-b - std::sqrt(h)) / a;
+            const float axisCoord = axisDotOrigin + bodyDistance * axisDotDir;
+
+            if (bodyDistance >= 0.f && axisCoord > 0.f && axisCoord < axisSqLength)
+                return bodyDistance;
+
+            return std::min(intersectSphere(startToOriginX, startToOriginY, startToOriginZ, direction, sqRadius),
+                            intersectSphere(origin.x() - capsules.endsX[capsuleIndex], origin.y() - capsules.endsY[capsuleIndex],
+                                            origin.z() - capsules.endsZ[capsuleIndex], direction, sqRadius));
+        }
+
+#if defined(REI_SIMD_SSE2)
+        inline __m128 select(__m128 mask, __m128 values1, __m128 values2) noexcept
+        {
+            return _mm_or_ps(_mm_and_ps(mask, values1), _mm_andnot_ps(mask, values2));
+        }
+
+        inline __m128 intersectSpheres4(__m128 toOriginX, __m128 toOriginY, __m128 toOriginZ, __m128 dirX, __m128 dirY, __m128 dirZ, __m128 sqRadii) noexcept
+        {
+            const __m128 b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dirX, toOriginX), _mm_mul_ps(dirY, toOriginY)), _mm_mul_ps(dirZ, toOriginZ));
+            const __m128 c = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(toOriginX, toOriginX), _mm_mul_ps(toOriginY, toOriginY)), _mm_mul_ps(toOriginZ, toOriginZ)), sqRadii);
+            const __m128 h = _mm_sub_ps(_mm_mul_ps(b, b), c);
+            const __m128 distances = _mm_sub_ps(_mm_sub_ps(_mm_setzero_ps(), b), _mm_sqrt_ps(h));
+
+            // A negative h gives a NaN distance, which fails the comparison
+            return select(_mm_cmpge_ps(distances, _mm_setzero_ps()), distances, _mm_set1_ps(Infinity));
+        }
+
+        __m128 intersectCapsules4(const CapsuleSoaView& capsules, std::size_t capsuleIndex, const Vec3f& origin, const Vec3f& direction) noexcept
+        {
+            const __m128 dirX = _mm_set1_ps(direction.x());
+            const __m128 dirY = _mm_set1_ps(direction.y());
+            const __m128 dirZ = _mm_set1_ps(direction.z());
+            const __m128 originX = _mm_set1_ps(origin.x());
+            const __m128 originY = _mm_set1_ps(origin.y());
+            const __m128 originZ = _mm_set1_ps(origin.z());
+            const __m128 startX = _mm_loadu_ps(capsules.startsX + capsuleIndex);
+            const __m128 startY = _mm_loadu_ps(capsules.startsY + capsuleIndex);
+            const __m128 startZ = _mm_loadu_ps(capsules.startsZ + capsuleIndex);
+            const __m128 endX = _mm_loadu_ps(capsules.endsX + capsuleIndex);
+            const __m128 endY = _mm_loadu_ps(capsules.endsY + capsuleIndex);
+            const __m128 endZ = _mm_loadu_ps(capsules.endsZ + capsuleIndex);
+            const __m128 radii = _mm_loadu_ps(capsules.radii + capsuleIndex);
+
+            const __m128 axisX = _mm_sub_ps(endX, startX);
+            const __m128 axisY = _mm_sub_ps(endY, startY);
+            const __m128 axisZ = _mm_sub_ps(endZ, startZ);
+            const __m128 toOriginX = _mm_sub_ps(originX, startX);
+            const __m128 toOriginY = _mm_sub_ps(originY, startY);
+            const __m128 toOriginZ = _mm_sub_ps(originZ, startZ);
+            const __m128 sqRadii = _mm_mul_ps(radii, radii);
+
+            const __m128 axisSqLength = _mm_add_ps(_mm_add_ps(_mm_mul_ps(axisX, axisX), _mm_mul_ps(axisY, axisY)), _mm_mul_ps(axisZ, axisZ));
+            const __m128 axisDotDir = _mm_add_ps(_mm_add_ps(_mm_mul_ps(axisX, dirX), _mm_mul_ps(axisY, dirY)), _mm_mul_ps(axisZ, dirZ));
+            const __m128 axisDotOrigin = _mm_add_ps(_mm_add_ps(_mm_mul_ps(axisX, toOriginX), _mm_mul_ps(axisY, toOriginY)), _mm_mul_ps(axisZ, toOriginZ));
+            const __m128 dirDotOrigin = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dirX, toOriginX), _mm_mul_ps(dirY, toOriginY)), _mm_mul_ps(dirZ, toOriginZ));
+            const __m128 originSqLength = _mm_add_ps(_mm_add_ps(_mm_mul_ps(toOriginX, toOriginX), _mm_mul_ps(toOriginY, toOriginY)), _mm_mul_ps(toOriginZ, toOriginZ));
+
+            const __m128 a = _mm_sub_ps(axisSqLength, _mm_mul_ps(axisDotDir, axisDotDir));
+            const __m128 b = _mm_sub_ps(_mm_mul_ps(axisSqLength, dirDotOrigin), _mm_mul_ps(axisDotOrigin, axisDotDir));
+            const __m128 c = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(axisSqLength, originSqLength), _mm_mul_ps(axisDotOrigin, axisDotOrigin)), _mm_mul_ps(sqRadii, axisSqLength));
+            const __m128 h = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(a, c));
+
+            // Lanes missing the cylinder, or being spheres, get NaN or infinite values, which fail all the comparisons
+            const __m128 bodyDistances = _mm_div_ps(_mm_sub_ps(_mm_sub_ps(_mm_setzero_ps(), b), _mm_sqrt_ps(h)), a);
+            const __m128 axisCoords = _mm_add_ps(axisDotOrigin, _mm_mul_ps(bodyDistances, axisDotDir));
+            const __m128 isBodyHit = _mm_and_ps(_mm_cmpge_ps(bodyDistances, _mm_setzero_ps()),
+                                                _mm_and_ps(_mm_cmpgt_ps(axisCoords, _mm_setzero_ps()), _mm_cmplt_ps(axisCoords, axisSqLength)));
+
+            const __m128 capDistances = _mm_min_ps(intersectSpheres4(toOriginX, toOriginY, toOriginZ, dirX, dirY, dirZ, sqRadii),
+                                                   intersectSpheres4(_mm_sub_ps(originX, endX), _mm_sub_ps(originY, endY), _mm_sub_ps(originZ, endZ),
+                                                                     dirX, dirY, dirZ, sqRadii));
+
+            return select(isBodyHit, bodyDistances, select(_mm_cmpge_ps(h, _mm_setzero_ps()), capDistances, _mm_set1_ps(Infinity)));
+        }
+#endif
+
+#if defined(REI_SIMD_AVX)
+        inline __m256 intersectSpheres8(__m256 toOriginX, __m256 toOriginY, __m256 toOriginZ, __m256 dirX, __m256 dirY, __m256 dirZ, __m256 sqRadii) noexcept
+        {
+            const __m256 b = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dirX, toOriginX), _mm256_mul_ps(dirY, toOriginY)), _mm256_mul_ps(dirZ, toOriginZ));
+            const __m256 c = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(toOriginX, toOriginX), _mm256_mul_ps(toOriginY, toOriginY)),
+                                                         _mm256_mul_ps(toOriginZ, toOriginZ)), sqRadii);
+            const __m256 h = _mm256_sub_ps(_mm256_mul_ps(b, b), c);
+            const __m256 distances = _mm256_sub_ps(_mm256_sub_ps(_mm256_setzero_ps(), b), _mm256_sqrt_ps(h));
+
+            return _mm256_blendv_ps(_mm256_set1_ps(Infinity), distances, _mm256_cmp_ps(distances, _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+
+        __m256 intersectCapsules8(const CapsuleSoaView& capsules, std::size_t capsuleIndex, const Vec3f& origin, const Vec3f& direction) noexcept
+        {
+            const __m256 dirX = _mm256_set1_ps(direction.x());
+            const __m256 dirY = _mm256_set1_ps(direction.y());
+            const __m256 dirZ = _mm256_set1_ps(direction.z());
+            const __m256 originX = _mm256_set1_ps(origin.x());
+            const __m256 originY = _mm256_set1_ps(origin.y());
+            const __m256 originZ = _mm256_set1_ps(origin.z());
+            const __m256 startX = _mm256_loadu_ps(capsules.startsX + capsuleIndex);
+            const __m256 startY = _mm256_loadu_ps(capsules.startsY + capsuleIndex);
+            const __m256 startZ = _mm256_loadu_ps(capsules.startsZ + capsuleIndex);
+            const __m256 endX = _mm256_loadu_ps(capsules.endsX + capsuleIndex);
+            const __m256 endY = _mm256_loadu_ps(capsules.endsY + capsuleIndex);
+            const __m256 endZ = _mm256_loadu_ps(capsules.endsZ + capsuleIndex);
+            const __m256 radii = _mm256_loadu_ps(capsules.radii + capsuleIndex);
+
+            const __m256 axisX = _mm256_sub_ps(endX, startX);
+            const __m256 axisY = _mm256_sub_ps(endY, startY);
+            const __m256 axisZ = _mm256_sub_ps(endZ, startZ);
+            const __m256 toOriginX = _mm256_sub_ps(originX, startX);
+            const __m256 toOriginY = _mm256_sub_ps(originY, startY);
+            const __m256 toOriginZ = _mm256_sub_ps(originZ, startZ);
+            const __m256 sqRadii = _mm256_mul_ps(radii, radii);
+
+            const __m256 axisSqLength = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(axisX, axisX), _mm256_mul_ps(axisY, axisY)), _mm256_mul_ps(axisZ, axisZ));
+            const __m256 axisDotDir = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(axisX, dirX), _mm256_mul_ps(axisY, dirY)), _mm256_mul_ps(axisZ, dirZ));
+            const __m256 axisDotOrigin = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(axisX, toOriginX), _mm256_mul_ps(axisY, toOriginY)), _mm256_mul_ps(axisZ, toOriginZ));
+            const __m256 dirDotOrigin = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dirX, toOriginX), _mm256_mul_ps(dirY, toOriginY)), _mm256_mul_ps(dirZ, toOriginZ));
+            const __m256 originSqLength = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(toOriginX, toOriginX), _mm256_mul_ps(toOriginY, toOriginY)),
+                                                        _mm256_mul_ps(toOriginZ, toOriginZ));
+
+            const __m256 a = _mm256_sub_ps(axisSqLength, _mm256_mul_ps(axisDotDir, axisDotDir));
+            const __m256 b = _mm256_sub_ps(_mm256_mul_ps(axisSqLength, dirDotOrigin), _mm256_mul_ps(axisDotOrigin, axisDotDir));
+            const __m256 c = _mm256_sub_ps(_mm256_sub_ps(_mm256_mul_ps(axisSqLength, originSqLength), _mm256_mul_ps(axisDotOrigin, axisDotOrigin)),
+                                           _mm256_mul_ps(sqRadii, axisSqLength));
+            const __m256 h = _mm256_sub_ps(_mm256_mul_ps(b, b), _mm256_mul_ps(a, c));
+
+            const __m256 bodyDistances = _mm256_div_ps(_mm256_sub_ps(_mm256_sub_ps(_mm256_setzero_ps(), b), _mm256_sqrt_ps(h)), a);
+            const __m256 axisCoords = _mm256_add_ps(axisDotOrigin, _mm256_mul_ps(bodyDistances, axisDotDir));
+            const __m256 isBodyHit = _mm256_and_ps(_mm256_cmp_ps(bodyDistances, _mm256_setzero_ps(), _CMP_GE_OQ),
+                                                   _mm256_and_ps(_mm256_cmp_ps(axisCoords, _mm256_setzero_ps(), _CMP_GT_OQ),
+                                                                 _mm256_cmp_ps(axisCoords, axisSqLength, _CMP_LT_OQ)));
+
+            const __m256 capDistances = _mm256_min_ps(intersectSpheres8(toOriginX, toOriginY, toOriginZ, dirX, dirY, dirZ, sqRadii),
+                                                      intersectSpheres8(_mm256_sub_ps(originX, endX), _mm256_sub_ps(originY, endY), _mm256_sub_ps(originZ, endZ),
+                                                                        dirX, dirY, dirZ, sqRadii));
+            const __m256 hitDistances = _mm256_blendv_ps(_mm256_set1_ps(Infinity), capDistances, _mm256_cmp_ps(h, _mm256_setzero_ps(), _CMP_GE_OQ));
+
+            return _mm256_blendv_ps(hitDistances, bodyDistances, isBodyHit);
+        }
+#endif
+
+        /// Finds the closest capsule hit by a ray, several capsules being tested at a time with the widest available registers (8 with AVX, 4 with SSE).
+        /// \param distance Maximum distance of the hit, replaced by the distance of the closest hit if any.
+        /// \return Index of the closest capsule hit, InvalidShape if none is hit closer than the given distance.
+        uint32_t intersectCapsules(const CapsuleSoaView& capsules, const Vec3f& origin, const Vec3f& direction, float& distance) noexcept
+        {
+            uint32_t closestIndex = InvalidShape;
+            std::size_t capsuleIndex = 0;
+
+            const auto keepClosest = [&distance, &closestIndex](const float* distances, std::size_t firstIndex, std::size_t laneCount)
+            {
+                for (std::size_t laneIndex = 0; laneIndex < laneCount; ++laneIndex)
+                {
+                    if (distances[laneIndex] < distance)
+                    {
+                        distance = distances[laneIndex];
+                        closestIndex = static_cast<uint32_t>(firstIndex + laneIndex);
+                    }
+                }
+            };
+
+#if defined(REI_SIMD_AVX)
+            for (; capsuleIndex + 8 <= capsules.count; capsuleIndex += 8)
+            {
+                const __m256 distances = intersectCapsules8(capsules, capsuleIndex, origin, direction);
+
+                // Lanes are only looked at if any of them is closer, which is rare once a hit has been found
+                if (_mm256_movemask_ps(_mm256_cmp_ps(distances, _mm256_set1_ps(distance), _CMP_LT_OQ)) == 0)
+                    continue;
+
+                alignas(32) std::array<float, 8> laneDistances{};
+                _mm256_store_ps(laneDistances.data(), distances);
+                keepClosest(laneDistances.data(), capsuleIndex, 8);
+            }
+#endif
+
+#if defined(REI_SIMD_SSE2)
+            for (; capsuleIndex + 4 <= capsules.count; capsuleIndex += 4)
+            {
+                const __m128 distances = intersectCapsules4(capsules, capsuleIndex, origin, direction);
+
+                if (_mm_movemask_ps(_mm_cmplt_ps(distances, _mm_set1_ps(distance))) == 0)
+                    continue;
+
+                alignas(16) std::array<float, 4> laneDistances{};
+                _mm_store_ps(laneDistances.data(), distances);
+                keepClosest(laneDistances.data(), capsuleIndex, 4);
+            }
+#endif
+
+            for (; capsuleIndex < capsules.count; ++capsuleIndex)
+            {
+                const float capsuleDistance = intersectCapsule(capsules, capsuleIndex, origin, direction);
+                keepClosest(&capsuleDistance, capsuleIndex, 1);
+            }
+
+            return closestIndex;
+        }
+
+        /// Computes the distance at which a ray enters a box.
+        /// \return Entry distance, 0 if the origin is inside the box, & infinite if the box isn't hit before the maximum distance.
+        float intersectBox(const Vec3f& boundsMin, const Vec3f& boundsMax, const Vec3f& origin, const Vec3f& invDirection, float maxDistance) noexcept
+        {
+            float entryDistance = 0.f;
+            float exitDistance = maxDistance;
+
+            for (std::size_t axisIndex = 0; axisIndex < 3; ++axisIndex)
+            {
+                const float distance1 = (boundsMin[axisIndex] - origin[axisIndex]) * invDirection[axisIndex];
+                const float distance2 = (boundsMax[axisIndex] - origin[axisIndex]) * invDirection[axisIndex];
+
+                entryDistance = std::max(entryDistance, std::min(distance1, distance2));
+                exitDistance = std::min(exitDistance, std::max(distance1, distance2));
+            }
+
+            return (entryDistance <= exitDistance ? entryDistance : Infinity);
+        }
+
+    } // namespace
+
+    HitboxHistory::HitboxHistory(std::size_t frameCount) : m_frames(frameCount)
+    {
+        assert("Error: The history must hold at least 2 frames." && frameCount >= 2);
+    }
+
+    bool HitboxHistory::hasTick(uint32_t tick) const noexcept
+    {
+        return (recoverFrame(tick) != nullptr);
+    }
+
+    bool HitboxHistory::findTick(double time, uint32_t& tick) const noexcept
+    {
+        const Frame* foundFrame{};
+        const Frame* oldestFrame{};
+
+        for (const Frame& frame : m_frames)
+        {
+            if (!frame.isRecorded)
+                continue;
+
+            if (frame.time <= time && (foundFrame == nullptr || frame.time > foundFrame->time))
+                foundFrame = &frame;
+
+            if (oldestFrame == nullptr || frame.time < oldestFrame->time)
+                oldestFrame = &frame;
+        }
+
+        if (foundFrame == nullptr)
+            foundFrame = oldestFrame;
+
+        if (foundFrame == nullptr)
+            return false;
+
+        tick = foundFrame->tick;
+        return true;
+    }
+
+    void HitboxHistory::beginFrame(uint32_t tick, double time)
+    {
+        m_previousFrameIndex = m_currentFrameIndex;
+        m_currentFrameIndex = tick % m_frames.size();
+
+        // The vectors are only cleared, so that recording a tick allocates no memory once the history has been filled
+        Frame& frame = m_frames[m_currentFrameIndex];
+        frame.tick = tick;
+        frame.time = time;
+        frame.isRecorded = false;
+        frame.entities.clear();
+        frame.shapeOffsets.clear();
+        frame.startsX.clear();
+        frame.startsY.clear();
+        frame.startsZ.clear();
+        frame.endsX.clear();
+        frame.endsY.clear();
+        frame.endsZ.clear();
+        frame.radii.clear();
+        frame.zones.clear();
+        frame.entityMins.clear();
+        frame.entityMaxs.clear();
+    }
+
+    void HitboxHistory::addEntity(const EntityHandle& entityHandle)
+    {
+        Frame& frame = m_frames[m_currentFrameIndex];
+        frame.entities.emplace_back(entityHandle);
+        frame.shapeOffsets.emplace_back(static_cast<uint32_t>(frame.radii.size()));
+    }
+
+    void HitboxHistory::addShape(const Vec3f& start, const Vec3f& end, float radius, uint8_t zone)
+    {
+        Frame& frame = m_frames[m_currentFrameIndex];
+
+        assert("Error: An entity must be added before its shapes." && !frame.entities.empty());
+
+        frame.startsX.emplace_back(start.x());
+        frame.startsY.emplace_back(start.y());
+        frame.startsZ.emplace_back(start.z());
+        frame.endsX.emplace_back(end.x());
+        frame.endsY.emplace_back(end.y());
+        frame.endsZ.emplace_back(end.z());
+        frame.radii.emplace_back(radius);
+        frame.zones.emplace_back(zone);
+    }
+
+    void HitboxHistory::endFrame()
+    {
+        REI_PROFILE_ZONE("HitboxHistory::endFrame");
+
+        Frame& frame = m_frames[m_currentFrameIndex];
+        frame.shapeOffsets.emplace_back(static_cast<uint32_t>(frame.radii.size()));
+
+        for (std::size_t entityIndex = 0; entityIndex < frame.entities.size(); ++entityIndex)
+        {
+            Vec3f boundsMin(Infinity);
+            Vec3f boundsMax(-Infinity);
+
+            for (uint32_t shapeIndex = frame.shapeOffsets[entityIndex]; shapeIndex < frame.shapeOffsets[entityIndex + 1]; ++shapeIndex)
+            {
+                const float radius = frame.radii[shapeIndex];
+
+                boundsMin = Vec3f(std::min({ boundsMin.x(), frame.startsX[shapeIndex] - radius, frame.endsX[shapeIndex] - radius }),
+                                  std::min({ boundsMin.y(), frame.startsY[shapeIndex] - radius, frame.endsY[shapeIndex] - radius }),
+                                  std::min({ boundsMin.z(), frame.startsZ[shapeIndex] - radius, frame.endsZ[shapeIndex] - radius }));
+                boundsMax = Vec3f(std::max({ boundsMax.x(), frame.startsX[shapeIndex] + radius, frame.endsX[shapeIndex] + radius }),
+                                  std::max({ boundsMax.y(), frame.startsY[shapeIndex] + radius, frame.endsY[shapeIndex] + radius }),
+                                  std::max({ boundsMax.z(), frame.startsZ[shapeIndex] + radius, frame.endsZ[shapeIndex] + radius }));
+            }
+
+            frame.entityMins.emplace_back(boundsMin);
+            frame.entityMaxs.emplace_back(boundsMax);
+        }
+
+        // Refitting is only valid if the entities & their shape counts are the same as in the previous tick
+        const Frame& previousFrame = m_frames[m_previousFrameIndex];
+        const bool canRefit = (m_ticksSinceRebuild < RebuildInterval && m_previousFrameIndex != m_currentFrameIndex && previousFrame.isRecorded
+                            && previousFrame.entities == frame.entities && previousFrame.shapeOffsets == frame.shapeOffsets);
+
+        if (canRefit)
+        {
+            frame.entityOrder = previousFrame.entityOrder;
+            frame.nodes = previousFrame.nodes;
+            refitNodes(frame);
+
+            ++m_ticksSinceRebuild;
+        }
+        else
+        {
+            frame.entityOrder.clear();
+            frame.nodes.clear();
+
+            // Entities without any shape can never be hit, & are left out of the hierarchy
+            for (std::size_t entityIndex = 0; entityIndex < frame.entities.size(); ++entityIndex)
+            {
+                if (frame.shapeOffsets[entityIndex + 1] > frame.shapeOffsets[entityIndex])
+                    frame.entityOrder.emplace_back(static_cast<uint32_t>(entityIndex));
+            }
+
+            if (!frame.entityOrder.empty())
+                buildNode(frame, 0, static_cast<uint32_t>(frame.entityOrder.size()));
+
+            m_ticksSinceRebuild = 0;
+        }
+
+        frame.isRecorded = true;
+    }
+
+    std::size_t HitboxHistory::traceRays(const HitRay* rays, std::size_t rayCount, uint32_t tick, HitResult* results, ThreadPool* threadPool) const
+    {
+        REI_PROFILE_ZONE("HitboxHistory::traceRays");
+
+        const Frame* frame = recoverFrame(tick);
+
+        if (frame == nullptr)
+        {
+            std::fill(results, results + rayCount, HitResult{});
+            return 0;
+        }
+
+        const auto traceRange = [frame, rays, results](std::size_t beginIndex, std::size_t endIndex)
+        {
+            for (std::size_t rayIndex = beginIndex; rayIndex < endIndex; ++rayIndex)
+            {
+                results[rayIndex] = HitResult{};
+                traceRay(*frame, rays[rayIndex], results[rayIndex]);
+            }
+        };
+
+        if (threadPool == nullptr || rayCount <= ParallelGrainSize)
+            traceRange(0, rayCount);
+        else
+            threadPool->parallelFor(rayCount, ParallelGrainSize, traceRange);
+
+        return static_cast<std::size_t>(std::count_if(results, results + rayCount, [] (const HitResult& result) { return result.hasHit(); }));
+    }
+
+    void HitboxHistory::clear() noexcept
+    {
+        for (Frame& frame : m_frames)
+            frame.isRecorded = false;
+
+        m_ticksSinceRebuild = RebuildInterval;
+    }
+
+    const HitboxHistory::Frame* HitboxHistory::recoverFrame(uint32_t tick) const noexcept
+    {
+        const Frame& frame = m_frames[tick % m_frames.size()];
+        return ((frame.isRecorded && frame.tick == tick) ? &frame : nullptr);
+    }
+
+    void HitboxHistory::buildNode(Frame& frame, uint32_t beginIndex, uint32_t endIndex)
+    {
+        const std::size_t nodeIndex = frame.nodes.size();
+        frame.nodes.emplace_back();
+
+        Vec3f boundsMin(Infinity);
+        Vec3f boundsMax(-Infinity);
+        Vec3f centroidsMin(Infinity);
+        Vec3f centroidsMax(-Infinity);
+
+        for (uint32_t orderIndex = beginIndex; orderIndex < endIndex; ++orderIndex)
+        {
+            const uint32_t entityIndex = frame.entityOrder[orderIndex];
+            const Vec3f centroid = frame.entityMins[entityIndex] + frame.entityMaxs[entityIndex];
+
+            for (std::size_t axisIndex = 0; axisIndex < 3; ++axisIndex)
+            {
+                boundsMin[axisIndex] = std::min(boundsMin[axisIndex], frame.entityMins[entityIndex][axisIndex]);
+                boundsMax[axisIndex] = std::max(boundsMax[axisIndex], frame.entityMaxs[entityIndex][axisIndex]);
+                centroidsMin[axisIndex] = std::min(centroidsMin[axisIndex], centroid[axisIndex]);
+                centroidsMax[axisIndex] = std::max(centroidsMax[axisIndex], centroid[axisIndex]);
+            }
+        }
+
+        frame.nodes[nodeIndex].boundsMin = boundsMin;
+        frame.nodes[nodeIndex].boundsMax = boundsMax;
+
+        if (endIndex - beginIndex <= LeafSize)
+        {
+            frame.nodes[nodeIndex].firstIndex = beginIndex;
+            frame.nodes[nodeIndex].entityCount = endIndex - beginIndex;
+            return;
+        }
+
+        const Vec3f centroidsExtent = centroidsMax - centroidsMin;
+        const std::size_t splitAxis = (centroidsExtent.x() >= centroidsExtent.y() ? (centroidsExtent.x() >= centroidsExtent.z() ? 0 : 2)
+                                                                                  : (centroidsExtent.y() >= centroidsExtent.z() ? 1 : 2));
+        const uint32_t middleIndex = beginIndex + (endIndex - beginIndex) / 2;
+
+        // Splitting at the median keeps the hierarchy balanced, whatever the entities' distribution
+        std::nth_element(frame.entityOrder.begin() + beginIndex, frame.entityOrder.begin() + middleIndex, frame.entityOrder.begin() + endIndex,
+                         [&frame, splitAxis] (uint32_t entityIndex1, uint32_t entityIndex2)
+        {
+            return (frame.entityMins[entityIndex1][splitAxis] + frame.entityMaxs[entityIndex1][splitAxis]
+                  < frame.entityMins[entityIndex2][splitAxis] + frame.entityMaxs[entityIndex2][splitAxis]);
+        });
+
+        buildNode(frame, beginIndex, middleIndex);
+        frame.nodes[nodeIndex].firstIndex = static_cast<uint32_t>(frame.nodes.size());
+        frame.nodes[nodeIndex].entityCount = 0;
+        buildNode(frame, middleIndex, endIndex);
+    }
+
+    void HitboxHistory::refitNodes(Frame& frame) noexcept
+    {
+        // Children always come after their parent, so that going backward updates them first
+        for (std::size_t nodeIndex = frame.nodes.size(); nodeIndex-- > 0;)
+        {
+            BvhNode& node = frame.nodes[nodeIndex];
+
+            if (node.entityCount == 0)
+            {
+                const BvhNode& firstChild = frame.nodes[nodeIndex + 1];
+                const BvhNode& secondChild = frame.nodes[node.firstIndex];
+
+                for (std::size_t axisIndex = 0; axisIndex < 3; ++axisIndex)
+                {
+                    node.boundsMin[axisIndex] = std::min(firstChild.boundsMin[axisIndex], secondChild.boundsMin[axisIndex]);
+                    node.boundsMax[axisIndex] = std::max(firstChild.boundsMax[axisIndex], secondChild.boundsMax[axisIndex]);
+                }
+
+                continue;
+            }
+
+            node.boundsMin = Vec3f(Infinity);
+            node.boundsMax = Vec3f(-Infinity);
+
+            for (uint32_t orderIndex = node.firstIndex; orderIndex < node.firstIndex + node.entityCount; ++orderIndex)
+            {
+                const uint32_t entityIndex = frame.entityOrder[orderIndex];
+
+                for (std::size_t axisIndex = 0; axisIndex < 3; ++axisIndex)
+                {
+                    node.boundsMin[axisIndex] = std::min(node.boundsMin[axisIndex], frame.entityMins[entityIndex][axisIndex]);
+                    node.boundsMax[axisIndex] = std::max(node.boundsMax[axisIndex], frame.entityMaxs[entityIndex][axisIndex]);
+                }
+            }
+        }
+    }
+
+    void HitboxHistory::traceRay(const Frame& frame, const HitRay& ray, HitResult& result) noexcept
+    {
+        assert("Error: The ray's direction must be normalized." && std::abs(ray.direction.computeSquaredLength() - 1.f) < 0.001f);
+
+        if (frame.nodes.empty())
+            return;
+
+        const Vec3f invDirection(1.f / ray.direction.x(), 1.f / ray.direction.y(), 1.f / ray.direction.z());
+        float closestDistance = ray.maxDistance;
+
+        struct StackEntry
+        {
+            uint32_t nodeIndex;
+            float entryDistance;
+        };
+
+        // The hierarchy is balanced, its depth never exceeding the log2 of the entity count
+        std::array<StackEntry, 64> stack{};
+        std::size_t stackSize = 0;
+
+        const BvhNode& rootNode = frame.nodes.front();
+        const float rootDistance = intersectBox(rootNode.boundsMin, rootNode.boundsMax, ray.origin, invDirection, closestDistance);
+
+        if (rootDistance == Infinity)
+            return;
+
+        stack[stackSize++] = StackEntry{ 0, rootDistance };
+
+        while (stackSize > 0)
+        {
+            const StackEntry entry = stack[--stackSize];
+
+            // A closer hit may have been found since the node was pushed
+            if (entry.entryDistance > closestDistance)
+                continue;
+
+            const BvhNode& node = frame.nodes[entry.nodeIndex];
+
+            if (node.entityCount > 0)
+            {
+                for (uint32_t orderIndex = node.firstIndex; orderIndex < node.firstIndex + node.entityCount; ++orderIndex)
+                {
+                    const uint32_t entityIndex = frame.entityOrder[orderIndex];
+
+                    if (frame.entities[entityIndex] == ray.ignoredEntity)
+                        continue;
+
+                    const uint32_t firstShape = frame.shapeOffsets[entityIndex];
+                    const CapsuleSoaView capsules{ frame.startsX.data() + firstShape, frame.startsY.data() + firstShape, frame.startsZ.data() + firstShape,
+                                                   frame.endsX.data() + firstShape, frame.endsY.data() + firstShape, frame.endsZ.data() + firstShape,
+                                                   frame.radii.data() + firstShape, frame.shapeOffsets[entityIndex + 1] - firstShape };
+                    const uint32_t shapeIndex = intersectCapsules(capsules, ray.origin, ray.direction, closestDistance);
+
+                    if (shapeIndex == InvalidShape)
+                        continue;
+
+                    result.entity = frame.entities[entityIndex];
+                    result.distance = closestDistance;
+                    result.zone = frame.zones[firstShape + shapeIndex];
+                }
+
+                continue;
+            }
+
+            const uint32_t firstChildIndex = entry.nodeIndex + 1;
+            const uint32_t secondChildIndex = node.firstIndex;
+            const float firstDistance = intersectBox(frame.nodes[firstChildIndex].boundsMin, frame.nodes[firstChildIndex].boundsMax,
+                                                     ray.origin, invDirection, closestDistance);
+            const float secondDistance = intersectBox(frame.nodes[secondChildIndex].boundsMin, frame.nodes[secondChildIndex].boundsMax,
+                                                      ray.origin, invDirection, closestDistance);
+
+            // The farthest child is pushed first, so that the closest one is visited next & may shorten the ray for the other
+            if (firstDistance <= secondDistance)
+            {
+                if (secondDistance != Infinity)
+                    stack[stackSize++] = StackEntry{ secondChildIndex, secondDistance };
+
+                if (firstDistance != Infinity)
+                    stack[stackSize++] = StackEntry{ firstChildIndex, firstDistance };
+            }
+            else
+            {
+                if (firstDistance != Infinity)
+                    stack[stackSize++] = StackEntry{ firstChildIndex, firstDistance };
+
+                stack[stackSize++] = StackEntry{ secondChildIndex, secondDistance };
+            }
+        }
+    }
+
+} // namespace Rei
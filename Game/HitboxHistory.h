@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Entity.h"
+#include "Vector.h"
+
+namespace Rei
+{
+    class ThreadPool;
+
+    struct HitRay
+    {
+        Vec3f origin{};
+        /// Direction of the ray; must be normalized.
+        Vec3f direction = Vec3f(0.f, 0.f, 1.f);
+        float maxDistance = std::numeric_limits<float>::infinity();
+        /// Entity whose shapes are never hit by the ray, usually the shooter's own.
+        EntityHandle ignoredEntity{};
+    };
+
+    struct HitResult
+    {
+        bool hasHit() const noexcept { return !entity.isNull(); }
+
+        /// Entity hit, null if the ray hit nothing.
+        EntityHandle entity{};
+        float distance = std::numeric_limits<float>::infinity();
+        uint8_t zone = 0;
+    };
+
+    /// Ring buffer of the world-space hit shapes of the last ticks, against which rays can be traced as the shapes were at any of these ticks.
+    /// Each tick's entities are indexed by a bounding volume hierarchy; as entities barely move from one tick to the next, the hierarchy of the
+    ///   previous tick is only refitted to the new bounds, & is fully rebuilt periodically or whenever the set of entities changes.
+    /// \note The shapes are stored as a structure of arrays, the capsules of each entity being tested against a ray several at a time.
+    class HitboxHistory
+    {
+    public:
+        /// Default number of recorded ticks, which is a second at 64 ticks per second.
+        static constexpr std::size_t DefaultFrameCount = 64;
+
+        explicit HitboxHistory(std::size_t frameCount = DefaultFrameCount);
+
+        std::size_t getFrameCount() const noexcept { return m_frames.size(); }
+        /// Checks if the shapes of a tick are still recorded.
+        bool hasTick(uint32_t tick) const noexcept;
+        /// Finds the most recent recorded tick at or before the given time.
+        /// \param time Time to find the tick of, in seconds.
+        /// \param tick Tick to be filled; if all recorded ticks are after the given time, the oldest one.
+        /// \return True if a tick has been found, false if nothing is recorded.
+        bool findTick(double time, uint32_t& tick) const noexcept;
+
+        /// Starts recording the shapes of a tick, replacing the oldest recorded one; ticks are expected to be consecutive.
+        /// \param tick Tick to be recorded.
+        /// \param time Time of the tick, in seconds.
+        void beginFrame(uint32_t tick, double time);
+        /// Adds an entity into the recorded tick, whose shapes are to be added next.
+        void addEntity(const EntityHandle& entityHandle);
+        /// Adds a capsule to the last added entity.
+        /// \param start World-space start of the capsule's segment.
+        /// \param end World-space end of the capsule's segment; a sphere if equal to the start.
+        /// \param radius World-space radius of the capsule.
+        /// \param zone Identifier of the part of the entity the capsule covers.
+        void addShape(const Vec3f& start, const Vec3f& end, float radius, uint8_t zone);
+        /// Finishes recording the tick, computing its bounds & hierarchy.
+        void endFrame();
+
+        /// Finds the closest shape hit by each ray, as the shapes were at the given tick.
+        /// \note Rays starting inside a shape do not hit it.
+        /// \param rays Rays to be traced.
+        /// \param rayCount Number of rays.
+        /// \param tick Recorded tick to trace the rays at.
+        /// \param results Closest hit of each ray; must hold at least rayCount elements.
+        /// \param threadPool Thread pool on which to split the rays; if nullptr, every ray is traced on the calling thread.
+        /// \return Number of rays which hit an entity; 0 if the tick isn't recorded.
+        std::size_t traceRays(const HitRay* rays, std::size_t rayCount, uint32_t tick, HitResult* results, ThreadPool* threadPool = nullptr) const;
+        void clear() noexcept;
+
+    private:
+        /// Node of a tick's hierarchy; a leaf references entities, & a branch its two children, the first being right after it.
+        struct BvhNode
+        {
+            Vec3f boundsMin{};
+            Vec3f boundsMax{};
+            uint32_t firstIndex{}; // First entity of a leaf in the frame's entity order, or second child of a branch
+            uint32_t entityCount{}; // 0 for a branch
+        };
+
+        struct Frame
+        {
+            uint32_t tick = 0;
+            double time = 0.0;
+            bool isRecorded = false;
+            std::vector<EntityHandle> entities{};
+            /// Index of the first shape of each entity, followed by the total number of shapes.
+            std::vector<uint32_t> shapeOffsets{};
+            std::vector<float> startsX{};
+            std::vector<float> startsY{};
+            std::vector<float> startsZ{};
+            std::vector<float> endsX{};
+            std::vector<float> endsY{};
+            std::vector<float> endsZ{};
+            std::vector<float> radii{};
+            std::vector<uint8_t> zones{};
+            std::vector<Vec3f> entityMins{};
+            std::vector<Vec3f> entityMaxs{};
+            /// Indices of the entities, ordered as referenced by the hierarchy's leaves.
+            std::vector<uint32_t> entityOrder{};
+            std::vector<BvhNode> nodes{};
+        };
+
+        /// Maximum number of entities referenced by a leaf.
+        static constexpr std::size_t LeafSize = 2;
+        /// Number of ticks after which the hierarchy is rebuilt, even if only refitting it would be valid.
+        static constexpr std::size_t RebuildInterval = 32;
+        static constexpr std::size_t ParallelGrainSize = 16;
+
+        const Frame* recoverFrame(uint32_t tick) const noexcept;
+        /// Builds the current frame's hierarchy, splitting the given range of its entity order at the median along its largest axis.
+        void buildNode(Frame& frame, uint32_t beginIndex, uint32_t endIndex);
+        /// Recomputes the bounds of the current frame's nodes, whose hierarchy has been copied from the previous frame.
+        static void refitNodes(Frame& frame) noexcept;
+        static void traceRay(const Frame& frame, const HitRay& ray, HitResult& result) noexcept;
+
+        std::vector<Frame> m_frames{};
+        std::size_t m_currentFrameIndex = 0;
+        std::size_t m_previousFrameIndex = 0;
+        std::size_t m_ticksSinceRebuild = RebuildInterval;
+    };
+
+} // namespace Rei
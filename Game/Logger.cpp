@@ -1,59 +1,550 @@
 #include "Logger.h"
 
-
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Profiler.h"
 
 namespace Rei
 {
 
+    namespace
+    {
+        /// Size in bytes of each thread's ring buffer; must be a power of two.
+        constexpr std::size_t RingBufferSize = 1 << 18;
+        /// Maximum time the flush thread waits before emptying the ring buffers.
+        constexpr std::chrono::milliseconds FlushPeriod(5);
+
+        static_assert((RingBufferSize & (RingBufferSize - 1)) == 0, "Error: The log ring buffer's size must be a power of two.");
+
+        /// Header of a message in a ring buffer, followed by its arguments & the content of its string arguments.
+        struct RecordHeader
+        {
+            int64_t timestamp = 0;
+            const char* format{};
+            uint32_t size = 0;
+            uint32_t argumentCount = 0;
+            LoggingLevel level = LoggingLevel::NONE;
+        };
+
+        /// Single-producer single-consumer ring buffer of messages, written by a logging thread & read by the flush one.
+        class RingBuffer
+        {
+        public:
+            RingBuffer() : m_data{ std::make_unique<uint8_t[]>(RingBufferSize) } {}
+
+            bool isEmpty() const noexcept { return (m_readPosition.load(std::memory_order_relaxed) == m_writePosition.load(std::memory_order_acquire)); }
+            bool isAbandoned() const noexcept { return m_isAbandoned.load(std::memory_order_acquire); }
+
+            void abandon() noexcept { m_isAbandoned.store(true, std::memory_order_release); }
+            /// Copies a message into the buffer; only called by the thread owning the buffer.
+            /// \param isHalfFull Set to true if the buffer has just gone past half its capacity, the messages having to be read soon.
+            /// \return True if the message has been added, false if there is not enough space left.
+            bool push(bool& isHalfFull, LoggingLevel level, const char* format, const LogArgument* arguments, std::size_t argumentCount) noexcept
+            {
+                std::size_t textSize = 0;
+
+                for (std::size_t argumentIndex = 0; argumentIndex < argumentCount; ++argumentIndex)
+                {
+                    if (arguments[argumentIndex].type == LogArgument::Type::STRING)
+                        textSize += arguments[argumentIndex].stringSize;
+                }
+
+                const std::size_t recordSize = (sizeof(RecordHeader) + sizeof(LogArgument) * argumentCount + textSize + 7) & ~std::size_t(7);
+                const uint64_t writePosition = m_writePosition.load(std::memory_order_relaxed);
+                const uint64_t readPosition  = m_readPosition.load(std::memory_order_acquire);
+
+                if (RingBufferSize - (writePosition - readPosition) < recordSize)
+                    return false;
+
+                RecordHeader header;
+                header.timestamp     = std::chrono::steady_clock::now().time_since_epoch().count();
+                header.format        = format;
+                header.size          = static_cast<uint32_t>(recordSize);
+                header.argumentCount = static_cast<uint32_t>(argumentCount);
+                header.level         = level;
+                write(writePosition, &header, sizeof(header));
+
+                // Strings are moved after the arguments, which then hold their offset instead of their address
+                uint64_t argumentPosition = writePosition + sizeof(RecordHeader);
+                uint64_t textPosition     = argumentPosition + sizeof(LogArgument) * argumentCount;
+                uint64_t textOffset       = 0;
+
+                for (std::size_t argumentIndex = 0; argumentIndex < argumentCount; ++argumentIndex)
+                {
+                    LogArgument argument = arguments[argumentIndex];
+
+                    if (argument.type == LogArgument::Type::STRING)
+                    {
+                        write(textPosition + textOffset, argument.stringValue, argument.stringSize);
+                        argument.uintValue = textOffset;
+                        textOffset += argument.stringSize;
+                    }
+
+                    write(argumentPosition, &argument, sizeof(argument));
+                    argumentPosition += sizeof(argument);
+                }
+
+                m_writePosition.store(writePosition + recordSize, std::memory_order_release);
+
+                const uint64_t usedSize = writePosition - readPosition;
+                isHalfFull = (usedSize < RingBufferSize / 2 && usedSize + recordSize >= RingBufferSize / 2);
+
+                return true;
+            }
+            /// Reads all the messages available; only called by the flush thread.
+            /// \param func Function called on each message, taking its header, arguments & string contents.
+            /// \param record Memory the messages are copied into before being given to the function.
+            template <typename FuncT>
+            void consume(FuncT&& func, std::vector<uint8_t>& record)
+            {
+                uint64_t readPosition = m_readPosition.load(std::memory_order_relaxed);
+                const uint64_t writePosition = m_writePosition.load(std::memory_order_acquire);
+
+                while (readPosition < writePosition)
+                {
+                    RecordHeader header;
+                    read(readPosition, &header, sizeof(header));
+
+                    record.resize(header.size);
+                    read(readPosition, record.data(), header.size);
+
+                    const auto* arguments = reinterpret_cast<const LogArgument*>(record.data() + sizeof(RecordHeader));
+                    const auto* text = reinterpret_cast<const char*>(arguments + header.argumentCount);
+                    func(header, arguments, text);
+
+                    readPosition += header.size;
+                }
+
+                m_readPosition.store(readPosition, std::memory_order_release);
+            }
+
+        private:
+            void write(uint64_t position, const void* data, std::size_t size) noexcept
+            {
+                const std::size_t index = position & (RingBufferSize - 1);
+                const std::size_t firstSize = std::min(size, RingBufferSize - index);
+
+                std::memcpy(m_data.get() + index, data, firstSize);
+                std::memcpy(m_data.get(), static_cast<const uint8_t*>(data) + firstSize, size - firstSize);
+            }
+
+            void read(uint64_t position, void* data, std::size_t size) const noexcept
+            {
+                const std::size_t index = position & (RingBufferSize - 1);
+                const std::size_t firstSize = std::min(size, RingBufferSize - index);
+
+                std::memcpy(data, m_data.get() + index, firstSize);
+                std::memcpy(static_cast<uint8_t*>(data) + firstSize, m_data.get(), size - firstSize);
+            }
+
+            // Both positions only ever increase, the index in the buffer being recovered with a mask; they are kept apart to avoid false sharing
+            alignas(64) std::atomic<uint64_t> m_writePosition = 0;
+            alignas(64) std::atomic<uint64_t> m_readPosition = 0;
+            std::atomic<bool> m_isAbandoned = false;
+            std::unique_ptr<uint8_t[]> m_data{};
+        };
+
+        /// Ring buffer of the current thread, marked as abandoned on the thread's exit for the flush thread to destroy it once emptied.
+        struct ThreadBuffer
+        {
+            ~ThreadBuffer()
+            {
+                if (buffer)
+                    buffer->abandon();
+            }
+
+            std::shared_ptr<RingBuffer> buffer{};
+        };
+
+        constexpr std::string_view recoverPrefix(LoggingLevel level) noexcept
+        {
+            switch (level)
+            {
+                case LoggingLevel::ERROR:   return "[Rei] [Error] - ";
+                case LoggingLevel::WARNING: return "[Rei] [Warning] - ";
+                case LoggingLevel::INFO:    return "[Rei] [Info] - ";
+                default:                    return "[Rei] [Debug] - ";
+            }
+        }
+
+        void appendArgument(const LogArgument& argument, const char* text, std::string& output)
+        {
+            char buffer[32];
+
+            switch (argument.type)
+            {
+                case LogArgument::Type::BOOL:
+                    output += (argument.uintValue ? "true" : "false");
+                    break;
+
+                case LogArgument::Type::CHAR:
+                    output += static_cast<char>(argument.uintValue);
+                    break;
+
+                case LogArgument::Type::INT:
+                    output.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), static_cast<int64_t>(argument.uintValue)).ptr);
+                    break;
+
+                case LogArgument::Type::UINT:
+                    output.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), argument.uintValue).ptr);
+                    break;
+
+                case LogArgument::Type::FLOAT:
+                    output.append(buffer, static_cast<std::size_t>(std::max(std::snprintf(buffer, sizeof(buffer), "%g", argument.floatValue), 0)));
+                    break;
+
+                case LogArgument::Type::STRING:
+                    output.append(text + argument.uintValue, argument.stringSize);
+                    break;
+
+                case LogArgument::Type::POINTER:
+                    output.append(buffer, static_cast<std::size_t>(std::max(std::snprintf(buffer, sizeof(buffer), "%p", argument.pointerValue), 0)));
+                    break;
+            }
+        }
+
+        void formatMessage(const char* format, const LogArgument* arguments, std::size_t argumentCount, const char* text, std::string& output)
+        {
+            std::size_t argumentIndex = 0;
+
+            for (const char* character = format; *character != '\0'; ++character)
+            {
+                if (character[0] == '{' && character[1] == '}' && argumentIndex < argumentCount)
+                {
+                    appendArgument(arguments[argumentIndex++], text, output);
+                    ++character;
+                    continue;
+                }
+
+                output += *character;
+            }
+        }
+
+        /// Owner of the ring buffers & of the flush thread, which formats the messages & writes them in the order they have been logged.
+        class LogBackend
+        {
+        public:
+            static LogBackend& get()
+            {
+                static LogBackend backend;
+                return backend;
+            }
+
+            std::size_t getDroppedMessageCount() const noexcept { return m_droppedMessageCount.load(std::memory_order_relaxed); }
+
+            void setLoggingFunction(Logger::LoggingFunction logFunc)
+            {
+                std::lock_guard<std::mutex> lock(m_outputMutex);
+                m_logFunc = std::move(logFunc);
+            }
+
+            bool setOutputFile(const std::string& filePath)
+            {
+                std::lock_guard<std::mutex> lock(m_outputMutex);
+
+                m_file.close();
+
+                if (filePath.empty())
+                    return true;
+
+                m_file.open(filePath, std::ios::out | std::ios::trunc);
+                return m_file.is_open();
+            }
+
+            void push(LoggingLevel level, const char* format, const LogArgument* arguments, std::size_t argumentCount) noexcept
+            {
+                thread_local ThreadBuffer threadBuffer;
+
+                if (threadBuffer.buffer == nullptr)
+                {
+                    try
+                    {
+                        auto buffer = std::make_shared<RingBuffer>();
+
+                        std::lock_guard<std::mutex> lock(m_buffersMutex);
+                        m_buffers.emplace_back(buffer);
+                        threadBuffer.buffer = std::move(buffer);
+                    }
+                    catch (...)
+                    {
+                        // Logging must never throw; without a buffer, the message is simply dropped
+                        m_droppedMessageCount.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                }
+
+                bool isHalfFull = false;
+
+                if (!threadBuffer.buffer->push(isHalfFull, level, format, arguments, argumentCount))
+                    m_droppedMessageCount.fetch_add(1, std::memory_order_relaxed);
+
+                // Waking the flush thread early makes full buffers unlikely; as it also wakes up periodically, a missed notification is harmless
+                if (isHalfFull)
+                {
+                    m_isWakeUpRequested.store(true, std::memory_order_relaxed);
+                    m_wakeUpCondition.notify_one();
+                }
+            }
+
+            void flush()
+            {
+                // A logging function flushing from the flush thread would wait on itself
+                if (std::this_thread::get_id() == m_thread.get_id())
+                    return;
+
+                std::unique_lock<std::mutex> lock(m_flushMutex);
+                const uint64_t flushIndex = ++m_requestedFlushCount;
+                m_wakeUpCondition.notify_one();
+                m_flushCondition.wait(lock, [this, flushIndex] () { return (m_completedFlushCount >= flushIndex); });
+            }
+
+            ~LogBackend()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_flushMutex);
+                    m_isStopping = true;
+                }
+
+                m_wakeUpCondition.notify_one();
+                m_thread.join();
+            }
+
+        private:
+            struct Entry
+            {
+                int64_t timestamp = 0;
+                LoggingLevel level = LoggingLevel::NONE;
+                std::size_t textOffset = 0;
+                std::size_t textSize = 0;
+            };
+
+            LogBackend() : m_thread([this] () { run(); }) {}
+
+            void run()
+            {
+                std::unique_lock<std::mutex> lock(m_flushMutex);
+
+                while (true)
+                {
+                    m_wakeUpCondition.wait_for(lock, FlushPeriod, [this] ()
+                    {
+                        return (m_isStopping || m_requestedFlushCount != m_completedFlushCount || m_isWakeUpRequested.load(std::memory_order_relaxed));
+                    });
+                    m_isWakeUpRequested.store(false, std::memory_order_relaxed);
+
+                    const bool isStopping = m_isStopping;
+                    const uint64_t flushIndex = m_requestedFlushCount;
+
+                    lock.unlock();
+                    collectMessages();
+                    writeMessages();
+                    lock.lock();
+
+                    m_completedFlushCount = flushIndex;
+                    m_flushCondition.notify_all();
+
+                    if (isStopping)
+                        return;
+                }
+            }
+
+            void collectMessages()
+            {
+                m_entries.clear();
+                m_text.clear();
+
+                {
+                    std::lock_guard<std::mutex> lock(m_buffersMutex);
+
+                    for (const std::shared_ptr<RingBuffer>& buffer : m_buffers)
+                    {
+                        buffer->consume([this] (const RecordHeader& header, const LogArgument* arguments, const char* text)
+                        {
+                            Entry& entry = m_entries.emplace_back();
+                            entry.timestamp  = header.timestamp;
+                            entry.level      = header.level;
+                            entry.textOffset = m_text.size();
+
+                            formatMessage(header.format, arguments, header.argumentCount, text, m_text);
+                            entry.textSize = m_text.size() - entry.textOffset;
+                        }, m_record);
+                    }
+
+                    // Buffers of exited threads are destroyed once they have been emptied
+                    m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(), [] (const std::shared_ptr<RingBuffer>& buffer)
+                    {
+                        return (buffer->isAbandoned() && buffer->isEmpty());
+                    }), m_buffers.end());
+                }
+
+                const std::size_t droppedMessageCount = m_droppedMessageCount.load(std::memory_order_relaxed);
+
+                if (droppedMessageCount != m_reportedDroppedMessageCount)
+                {
+                    Entry& entry = m_entries.emplace_back();
+                    entry.timestamp  = std::chrono::steady_clock::now().time_since_epoch().count();
+                    entry.level      = LoggingLevel::WARNING;
+                    entry.textOffset = m_text.size();
+
+                    m_text += std::to_string(droppedMessageCount - m_reportedDroppedMessageCount);
+                    m_text += " log message(s) dropped, a ring buffer being full";
+                    entry.textSize = m_text.size() - entry.textOffset;
+
+                    m_reportedDroppedMessageCount = droppedMessageCount;
+                }
+
+                // Each buffer's messages being in order, sorting them by time interleaves those of the different threads
+                std::stable_sort(m_entries.begin(), m_entries.end(), [] (const Entry& entry1, const Entry& entry2) { return (entry1.timestamp < entry2.timestamp); });
+            }
+
+            void writeMessages()
+            {
+                if (m_entries.empty())
+                    return;
+
+                std::lock_guard<std::mutex> lock(m_outputMutex);
+
+                if (!m_file.is_open() && m_logFunc)
+                {
+                    for (const Entry& entry : m_entries)
+                        m_logFunc(entry.level, m_text.substr(entry.textOffset, entry.textSize));
+
+                    return;
+                }
+
+                m_output.clear();
+                m_errorOutput.clear();
+
+                for (const Entry& entry : m_entries)
+                {
+                    // Errors & warnings go to the standard error output, as they always have
+                    std::string& output = (!m_file.is_open() && static_cast<int>(entry.level) <= static_cast<int>(LoggingLevel::WARNING) ? m_errorOutput : m_output);
+                    output += recoverPrefix(entry.level);
+                    output.append(m_text, entry.textOffset, entry.textSize);
+                    output += '\n';
+                }
+
+                if (m_file.is_open())
+                {
+                    m_file.write(m_output.data(), static_cast<std::streamsize>(m_output.size()));
+                    m_file.flush();
+                    return;
+                }
+
+                if (!m_output.empty())
+                    std::cout.write(m_output.data(), static_cast<std::streamsize>(m_output.size())).flush();
+
+                if (!m_errorOutput.empty())
+                    std::cerr.write(m_errorOutput.data(), static_cast<std::streamsize>(m_errorOutput.size())).flush();
+            }
+
+            std::mutex m_buffersMutex{};
+            std::vector<std::shared_ptr<RingBuffer>> m_buffers{};
+            std::atomic<std::size_t> m_droppedMessageCount = 0;
+            std::size_t m_reportedDroppedMessageCount = 0;
+
+            std::mutex m_outputMutex{};
+            Logger::LoggingFunction m_logFunc{};
+            std::ofstream m_file{};
+
+            std::mutex m_flushMutex{};
+            /// Notified to have the flush thread empty the buffers before its period ends.
+            std::condition_variable m_wakeUpCondition{};
+            /// Notified by the flush thread each time it has emptied the buffers.
+            std::condition_variable m_flushCondition{};
+            std::atomic<bool> m_isWakeUpRequested = false;
+            uint64_t m_requestedFlushCount = 0;
+            uint64_t m_completedFlushCount = 0;
+            bool m_isStopping = false;
+
+            // Only used by the flush thread, & kept between flushes to avoid reallocations
+            std::vector<uint8_t> m_record{};
+            std::vector<Entry> m_entries{};
+            std::string m_text{};
+            std::string m_output{};
+            std::string m_errorOutput{};
+
+            std::thread m_thread{};
+        };
+    } // namespace
+
+    std::size_t Logger::getDroppedMessageCount() noexcept
+    {
+        return LogBackend::get().getDroppedMessageCount();
+    }
+
+    void Logger::setLoggingFunction(LoggingFunction logFunc)
+    {
+        LogBackend::get().setLoggingFunction(std::move(logFunc));
+    }
+
+    bool Logger::setOutputFile(const std::string& filePath)
+    {
+        return LogBackend::get().setOutputFile(filePath);
+    }
+
     void Logger::error(const std::string& message)
     {
-        if (static_cast<int>(m_logLevel) < static_cast<int>(LoggingLevel::ERROR))
+        if (!isEnabled(LoggingLevel::ERROR))
             return;
 
-        // TracyMessageCS(message.c_str(), message.size(), tracy::Color::Red, 10);
+        REI_PROFILE_MESSAGE(message.c_str(), message.size(), 0xFF0000);
 
-        if (m_logFunc)
-            m_logFunc(LoggingLevel::ERROR, message);
-        else
-            std::cerr << "[Rei] [Error] - " << message << '\n';
+        log(LoggingLevel::ERROR, "{}", message);
     }
-    void Logger::warn(const std::string& message) {
-        if (static_cast<int>(m_logLevel) < static_cast<int>(LoggingLevel::WARNING))
+
+    void Logger::warn(const std::string& message)
+    {
+        if (!isEnabled(LoggingLevel::WARNING))
             return;
 
-        // TracyMessageC(message.c_str(), message.size(), tracy::Color::Gold);
+        REI_PROFILE_MESSAGE(message.c_str(), message.size(), 0xFFD700);
 
-        if (m_logFunc)
-            m_logFunc(LoggingLevel::WARNING, message);
-        else
-            std::cerr << "[Rei] [Warning] - " << message << '\n';
+        log(LoggingLevel::WARNING, "{}", message);
     }
 
-    void Logger::info(const std::string& message) {
-        if (static_cast<int>(m_logLevel) < static_cast<int>(LoggingLevel::INFO))
+    void Logger::info(const std::string& message)
+    {
+        if (!isEnabled(LoggingLevel::INFO))
             return;
 
-        // TracyMessageC(message.c_str(), message.size(), tracy::Color::DeepSkyBlue);
+        REI_PROFILE_MESSAGE(message.c_str(), message.size(), 0x00BFFF);
 
-        if (m_logFunc)
-            m_logFunc(LoggingLevel::INFO, message);
-        else
-            std::cout << "[Rei] [Info] - " << message << '\n';
+        log(LoggingLevel::INFO, "{}", message);
     }
 
 #if !defined(NDEBUG) || defined(RAZ_FORCE_DEBUG_LOG)
-    void Logger::debug(const std::string& message) {
-        if (static_cast<int>(m_logLevel) < static_cast<int>(LoggingLevel::DEBUG))
+    void Logger::debug(const std::string& message)
+    {
+        if (!isEnabled(LoggingLevel::DEBUG))
             return;
 
-        // TracyMessageC(message.c_str(), message.size(), tracy::Color::Gray);
+        REI_PROFILE_MESSAGE(message.c_str(), message.size(), 0xBEBEBE);
 
-        if (m_logFunc)
-            m_logFunc(LoggingLevel::DEBUG, message);
-        else
-            std::cout << "[Rei] [Debug] - " << message << '\n';
+        log(LoggingLevel::DEBUG, "{}", message);
     }
 #endif
 
-} // namespace Rei
\ No newline at end of file
+    void Logger::flush()
+    {
+        LogBackend::get().flush();
+    }
+
+    void Logger::enqueue(LoggingLevel level, const char* format, const LogArgument* arguments, std::size_t argumentCount) noexcept
+    {
+        LogBackend::get().push(level, format, arguments, argumentCount);
+    }
+
+} // namespace Rei
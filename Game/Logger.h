@@ -1,7 +1,11 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
 
 namespace Rei
@@ -16,15 +20,138 @@ namespace Rei
         ALL       ///< Output all logs.
     };
 
+    /// Argument of a log message, stored as-is alongside its format; the message is only formatted by the logger's flush thread.
+    struct LogArgument
+    {
+        enum class Type : uint8_t
+        {
+            BOOL,
+            CHAR,
+            INT,
+            UINT,
+            FLOAT,
+            STRING,
+            POINTER
+        };
+
+        /// Creates an argument from a value.
+        /// \note Strings are copied along with the message, & can thus be temporaries.
+        /// \tparam T Type of the value; must be arithmetic, an enumeration, a string or a pointer.
+        /// \param value Value of the argument.
+        /// \return Log argument.
+        template <typename T>
+        static LogArgument create(const T& value) noexcept
+        {
+            LogArgument argument;
+
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                argument.type = Type::BOOL;
+                argument.uintValue = value;
+            }
+            else if constexpr (std::is_same_v<T, char>)
+            {
+                argument.type = Type::CHAR;
+                argument.uintValue = static_cast<unsigned char>(value);
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                return create(static_cast<std::underlying_type_t<T>>(value));
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                argument.type = (std::is_signed_v<T> ? Type::INT : Type::UINT);
+                argument.uintValue = static_cast<uint64_t>(value);
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                argument.type = Type::FLOAT;
+                argument.floatValue = static_cast<double>(value);
+            }
+            else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+            {
+                std::string_view string;
+
+                if constexpr (std::is_pointer_v<T>)
+                    string = (value == nullptr ? std::string_view("(null)") : std::string_view(value));
+                else
+                    string = value;
+
+                argument.type = Type::STRING;
+                argument.stringValue = string.data();
+                argument.stringSize = static_cast<uint32_t>(string.size());
+            }
+            else if constexpr (std::is_pointer_v<T>)
+            {
+                argument.type = Type::POINTER;
+                argument.pointerValue = value;
+            }
+            else
+            {
+                static_assert(std::is_pointer_v<T>, "Error: The log argument's type is not supported.");
+            }
+
+            return argument;
+        }
+
+        Type type = Type::INT;
+        /// Length of the string, if the argument is one.
+        uint32_t stringSize = 0;
+        union
+        {
+            uint64_t uintValue = 0;
+            double floatValue;
+            const char* stringValue;
+            const void* pointerValue;
+        };
+    };
+
+    /// Logger whose messages are written, batched, by a background thread.
+    /// Each thread logging pushes its messages into its own lock-free ring buffer, which the flush thread empties regularly; the calling thread
+    ///   never waits on I/O. When a thread's ring buffer is full, its messages are dropped & counted instead of blocking.
     class Logger
     {
     public:
+        using LoggingFunction = std::function<void(LoggingLevel, const std::string&)>;
+
+        /// Maximum number of arguments a formatted message can have.
+        static constexpr std::size_t MaxArgumentCount = 16;
+
         Logger() = delete;
 
+        /// Checks if messages of the given level are to be output; done before formatting anything.
+        static bool isEnabled(LoggingLevel level) noexcept { return (static_cast<int>(m_logLevel) >= static_cast<int>(level)); }
+        /// Gets the total number of messages dropped because their thread's ring buffer was full.
+        static std::size_t getDroppedMessageCount() noexcept;
+
         static void setLoggingLevel(LoggingLevel level) { m_logLevel = level; }
-        static void setLoggingFunction(std::function<void(LoggingLevel, const std::string&)> logFunc) { m_logFunc = std::move(logFunc); }
-        static void resetLoggingFunction() { m_logFunc = nullptr; }
+        /// Sets a function receiving the formatted messages instead of the console.
+        /// \note The function is called from the flush thread.
+        /// \param logFunc Logging function.
+        static void setLoggingFunction(LoggingFunction logFunc);
+        static void resetLoggingFunction() { setLoggingFunction(nullptr); }
+        /// Redirects the messages to a file, which takes precedence over the logging function & the console.
+        /// \param filePath Path to the file to write into, replacing its content; if empty, goes back to the previous output.
+        /// \return True if the file has been opened or the output reset, false otherwise.
+        static bool setOutputFile(const std::string& filePath);
+
+        /// Logs a formatted message, each "{}" in the format being replaced by the next argument.
+        /// \note Prefer the REI_LOG_* macros, which do not even evaluate the arguments if the level is disabled.
+        /// \tparam Args Types of the arguments.
+        /// \param level Level of the message.
+        /// \param format Message's format; only its address is stored, & it must thus be a string literal or live until the message is flushed.
+        /// \param args Arguments to be formatted into the message.
+        template <typename... Args>
+        static void log(LoggingLevel level, const char* format, const Args&... args)
+        {
+            static_assert(sizeof...(Args) <= MaxArgumentCount, "Error: Too many arguments have been given to the log message.");
+
+            if (!isEnabled(level))
+                return;
 
+            const std::array<LogArgument, sizeof...(Args)> arguments{ LogArgument::create(args)... };
+            enqueue(level, format, arguments.data(), arguments.size());
+        }
         /// Prints an error message.
         /// \note Requires a logging level of "error" or above.
         /// \param message Message to be printed.
@@ -42,7 +169,7 @@ namespace Rei
         /// \note Does nothing in a configuration other than Debug, unless RAZ_FORCE_DEBUG_LOG is defined.
         /// \note Requires a logging level of "debug" or above.
         /// \param message Message to be printed.
-        static void debug(const char* message) { debug(std::string(message)); }
+        static void debug(const char* message) { log(LoggingLevel::DEBUG, "{}", message); }
         /// Prints a debug message.
         /// \note Does nothing in a configuration other than Debug, unless RAZ_FORCE_DEBUG_LOG is defined.
         /// \note Requires a logging level of "debug" or above.
@@ -52,13 +179,27 @@ namespace Rei
         static void debug(const char*) {}
         static void debug(const std::string&) {}
 #endif
+        /// Waits for all the messages logged so far to be written.
+        static void flush();
 
         ~Logger() = delete;
 
     private:
+        /// Copies a message & its arguments into the calling thread's ring buffer.
+        static void enqueue(LoggingLevel level, const char* format, const LogArgument* arguments, std::size_t argumentCount) noexcept;
+
         static inline LoggingLevel m_logLevel = LoggingLevel::ERROR;
-        static inline std::function<void(LoggingLevel, const std::string&)> m_logFunc{};
     };
 
 } // namespace Rei
 
+/// Logs a formatted message if the given level is enabled, without evaluating the arguments otherwise.
+#define REI_LOG(level, ...) do { if (::Rei::Logger::isEnabled(level)) ::Rei::Logger::log(level, __VA_ARGS__); } while (false)
+#define REI_LOG_ERROR(...) REI_LOG(::Rei::LoggingLevel::ERROR, __VA_ARGS__)
+#define REI_LOG_WARN(...) REI_LOG(::Rei::LoggingLevel::WARNING, __VA_ARGS__)
+#define REI_LOG_INFO(...) REI_LOG(::Rei::LoggingLevel::INFO, __VA_ARGS__)
+#if !defined(NDEBUG) || defined(RAZ_FORCE_DEBUG_LOG)
+#define REI_LOG_DEBUG(...) REI_LOG(::Rei::LoggingLevel::DEBUG, __VA_ARGS__)
+#else
+#define REI_LOG_DEBUG(...) do {} while (false)
+#endif
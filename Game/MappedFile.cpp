@@ -0,0 +1,168 @@
+#include "MappedFile.h"
+#include "Logger.h"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Rei
+{
+
+    namespace
+    {
+
+        /// Smallest page size of the supported platforms; touching a byte every such size faults every page in.
+        constexpr std::size_t PageSize = 4096;
+
+    } // namespace
+
+    bool MappedFile::open(const std::string& filePath)
+    {
+        close();
+
+#if defined(_WIN32)
+        HANDLE fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+
+        if (fileHandle == INVALID_HANDLE_VALUE)
+        {
+            Logger::error("[MappedFile] Couldn't open the file '" + filePath + "'.");
+            return false;
+        }
+
+        LARGE_INTEGER fileSize {};
+
+        if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+        {
+            Logger::error("[MappedFile] The file '" + filePath + "' is empty or its size can't be read.");
+            CloseHandle(fileHandle);
+            return false;
+        }
+
+        HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* data = (mappingHandle != nullptr ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr);
+
+        if (data == nullptr)
+        {
+            Logger::error("[MappedFile] Couldn't map the file '" + filePath + "'.");
+
+            if (mappingHandle != nullptr)
+                CloseHandle(mappingHandle);
+            CloseHandle(fileHandle);
+
+            return false;
+        }
+
+        m_fileHandle    = fileHandle;
+        m_mappingHandle = mappingHandle;
+        m_size          = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+        const int fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+
+        if (fileDescriptor < 0)
+        {
+            Logger::error("[MappedFile] Couldn't open the file '" + filePath + "'.");
+            return false;
+        }
+
+        struct stat fileStatus {};
+
+        if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0)
+        {
+            Logger::error("[MappedFile] The file '" + filePath + "' is empty or its size can't be read.");
+            ::close(fileDescriptor);
+            return false;
+        }
+
+        void* data = mmap(nullptr, static_cast<std::size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+        // The mapping stays valid once the file is closed
+        ::close(fileDescriptor);
+
+        if (data == MAP_FAILED)
+        {
+            Logger::error("[MappedFile] Couldn't map the file '" + filePath + "'.");
+            return false;
+        }
+
+        m_size = static_cast<std::size_t>(fileStatus.st_size);
+#endif
+
+        m_data = static_cast<const uint8_t*>(data);
+        return true;
+    }
+
+    void MappedFile::close() noexcept
+    {
+        if (m_data == nullptr)
+            return;
+
+#if defined(_WIN32)
+        UnmapViewOfFile(m_data);
+        CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+        CloseHandle(static_cast<HANDLE>(m_fileHandle));
+#else
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+
+        m_data          = nullptr;
+        m_size          = 0;
+        m_fileHandle    = nullptr;
+        m_mappingHandle = nullptr;
+    }
+
+    void MappedFile::prefetch(std::size_t offset, std::size_t size) const noexcept
+    {
+        // Empty ranges are ignored, as touching their last byte would read before them
+        if (size == 0 || offset >= m_size)
+            return;
+
+        size = std::min(size, m_size - offset);
+
+        // Hinting the system first lets it issue large reads, instead of a small one at each page fault
+#if defined(_WIN32)
+        WIN32_MEMORY_RANGE_ENTRY range {};
+        range.VirtualAddress = const_cast<uint8_t*>(m_data + offset);
+        range.NumberOfBytes  = size;
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+        const std::size_t alignedOffset = offset / PageSize * PageSize;
+        madvise(const_cast<uint8_t*>(m_data + alignedOffset), size + (offset - alignedOffset), MADV_WILLNEED);
+#endif
+
+        const volatile uint8_t* data = m_data + offset;
+
+        for (std::size_t byteIndex = 0; byteIndex < size; byteIndex += PageSize)
+            static_cast<void>(data[byteIndex]);
+
+        static_cast<void>(data[size - 1]);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& file) noexcept
+    {
+        if (this == &file)
+            return *this;
+
+        close();
+
+        std::swap(m_data, file.m_data);
+        std::swap(m_size, file.m_size);
+        std::swap(m_fileHandle, file.m_fileHandle);
+        std::swap(m_mappingHandle, file.m_mappingHandle);
+
+        return *this;
+    }
+
+} // namespace Rei
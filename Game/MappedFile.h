@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace Rei
+{
+
+    /// Read-only view of a whole file mapped into memory, whose pages are only read from the disk when first accessed.
+    /// \note The mapping can be read from any thread; it must only be opened & closed from a single one.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(MappedFile&& file) noexcept { *this = std::move(file); }
+
+        bool isOpen() const noexcept { return (m_data != nullptr); }
+        const uint8_t* getData() const noexcept { return m_data; }
+        std::size_t getSize() const noexcept { return m_size; }
+
+        /// Maps a file into memory, closing any previously mapped one.
+        /// \param filePath Path to the file to be mapped.
+        /// \return True if the file has been mapped, false if it cannot be opened or is empty.
+        bool open(const std::string& filePath);
+        void close() noexcept;
+        /// Asks the system to read a range of the file ahead of its access, then touches each of its pages, so that they are read from the disk
+        ///   by the calling thread (usually an I/O one) instead of by the one later accessing them.
+        /// \param offset Offset of the range in the file, in bytes.
+        /// \param size Size of the range, in bytes.
+        void prefetch(std::size_t offset, std::size_t size) const noexcept;
+
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile&& file) noexcept;
+
+        ~MappedFile() { close(); }
+
+    private:
+        const uint8_t* m_data{};
+        std::size_t m_size = 0;
+        void* m_fileHandle{};
+        void* m_mappingHandle{};
+    };
+
+} // namespace Rei
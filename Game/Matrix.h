@@ -0,0 +1,512 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "FloatUtils.h"
+#include "Vector.h"
+
+namespace Rei {
+
+    template <typename T, std::size_t W, std::size_t H>
+    class Matrix;
+
+    template <typename T, std::size_t W, std::size_t H>
+    std::ostream& operator<<(std::ostream& stream, const Matrix<T, W, H>& mat);
+
+    namespace Detail {
+
+        /// Matrices made of columns exactly filling a 128-bit SIMD register (such as Mat4f) are aligned on 16 bytes, so that each column can be loaded at once.
+        template <typename T, std::size_t W, std::size_t H>
+        constexpr std::size_t MatrixAlignment = (sizeof(T) * H == 16 ? 16 : alignof(std::array<T, W * H>));
+
+    } // namespace Detail
+
+    /// Matrix class, representing a mathematical matrix, with generic type and size.
+    /// Data is stored column by column (column-major), matching the default layout of shader constants; vectors are considered as columns,
+    ///   and are thus transformed by multiplying them on the right (M * v).
+    /// \tparam T Type of the matrix's data.
+    /// \tparam W Matrix's width (number of columns).
+    /// \tparam H Matrix's height (number of rows).
+    template <typename T, std::size_t W, std::size_t H>
+    class Matrix {
+        static_assert(W > 0 && H > 0, "Error: Both matrix dimensions must be strictly positive.");
+        static_assert(std::is_arithmetic_v<T>, "Error: The matrix's type must be arithmetic.");
+
+    public:
+        constexpr Matrix() noexcept = default;
+        /// Creates a matrix from values given row by row, which is the natural writing order; they are stored column-major nonetheless.
+        template <typename... Args,
+            typename = std::enable_if_t<sizeof...(Args) == W * H>, // There can't be more or less values than W * H
+            typename = std::enable_if_t<(std::is_convertible_v<std::decay_t<Args>, T> && ...)>> // Given values must be of a convertible type
+            constexpr explicit Matrix(Args&&... args) noexcept;
+        constexpr Matrix(const Matrix&) noexcept = default;
+        constexpr Matrix(Matrix&&) noexcept = default;
+
+        constexpr std::size_t getWidth() const noexcept { return W; }
+        constexpr std::size_t getHeight() const noexcept { return H; }
+        constexpr const std::array<T, W * H>& getData() const noexcept { return m_data; }
+        constexpr std::array<T, W * H>& getData() noexcept { return m_data; }
+        constexpr const T* getDataPtr() const noexcept { return m_data.data(); }
+        constexpr T* getDataPtr() noexcept { return m_data.data(); }
+
+        /// Creates an identity matrix, whose diagonal elements are 1 & others 0.
+        /// \return Identity matrix.
+        static constexpr Matrix identity() noexcept;
+        /// Creates a matrix from its columns.
+        /// \param columns Columns of the matrix, from left to right.
+        /// \return Matrix made of the given columns.
+        static constexpr Matrix fromColumns(const std::array<Vector<T, H>, W>& columns) noexcept;
+        /// Gets an element of the matrix.
+        /// \param widthIndex Index of the element's column.
+        /// \param heightIndex Index of the element's row.
+        /// \return Constant reference to the element.
+        constexpr const T& getElement(std::size_t widthIndex, std::size_t heightIndex) const noexcept;
+        /// Gets an element of the matrix.
+        /// \param widthIndex Index of the element's column.
+        /// \param heightIndex Index of the element's row.
+        /// \return Reference to the element.
+        constexpr T& getElement(std::size_t widthIndex, std::size_t heightIndex) noexcept;
+        /// Gets a column of the matrix.
+        /// \param widthIndex Index of the column.
+        /// \return Copy of the column.
+        constexpr Vector<T, H> recoverColumn(std::size_t widthIndex) const noexcept;
+        /// Gets a row of the matrix.
+        /// \param heightIndex Index of the row.
+        /// \return Copy of the row.
+        constexpr Vector<T, W> recoverRow(std::size_t heightIndex) const noexcept;
+        /// Replaces a column of the matrix.
+        /// \param widthIndex Index of the column.
+        /// \param column Values of the column.
+        constexpr void setColumn(std::size_t widthIndex, const Vector<T, H>& column) noexcept;
+        /// Computes the transposed matrix, whose rows are the current matrix's columns.
+        /// \return Transposed matrix.
+        constexpr Matrix<T, H, W> transpose() const noexcept;
+        /// Computes the matrix without the given column & row.
+        /// \param widthIndex Index of the column to be removed.
+        /// \param heightIndex Index of the row to be removed.
+        /// \return Submatrix.
+        constexpr Matrix<T, W - 1, H - 1> recoverSubmatrix(std::size_t widthIndex, std::size_t heightIndex) const noexcept;
+        /// Computes the determinant of the matrix, by cofactor expansion along its first column.
+        /// \return Matrix's determinant.
+        constexpr T computeDeterminant() const noexcept;
+        /// Computes the inverse of the matrix, through a Gauss-Jordan elimination with partial pivoting.
+        /// \note The matrix must be invertible; this is only checked in Debug.
+        /// \return Inverse matrix.
+        constexpr Matrix inverse() const noexcept;
+        /// Checks for strict equality between the current matrix & the given one.
+        /// \param mat Matrix to be compared with.
+        /// \return True if matrices are strictly equal to each other, false otherwise.
+        constexpr bool strictlyEquals(const Matrix& mat) const noexcept;
+
+        /// Default copy assignment operator.
+        /// \return Reference to the copied matrix.
+        constexpr Matrix& operator=(const Matrix&) noexcept = default;
+        /// Default move assignment operator.
+        /// \return Reference to the moved matrix.
+        constexpr Matrix& operator=(Matrix&&) noexcept = default;
+        /// Element-wise matrix-matrix addition operator.
+        /// \param mat Matrix to be added.
+        /// \return Result of the summed matrices.
+        constexpr Matrix operator+(const Matrix& mat) const noexcept;
+        /// Element-wise matrix-matrix substraction operator.
+        /// \param mat Matrix to be substracted.
+        /// \return Result of the substracted matrices.
+        constexpr Matrix operator-(const Matrix& mat) const noexcept;
+        /// Element-wise matrix-value multiplication operator.
+        /// \param val Value to be multiplied by.
+        /// \return Result of the matrix multiplied by the value.
+        constexpr Matrix operator*(T val) const noexcept;
+        /// Element-wise matrix-value division operator.
+        /// \param val Value to be divided by.
+        /// \return Result of the matrix divided by the value.
+        constexpr Matrix operator/(T val) const noexcept;
+        /// Matrix-matrix multiplication operator.
+        /// \tparam W2 Width of the matrix to be multiplied by.
+        /// \param mat Matrix to be multiplied by; its height must be equal to the current matrix's width.
+        /// \return Result of the matrix product, of the given matrix's width & the current matrix's height.
+        template <std::size_t W2>
+        constexpr Matrix<T, W2, H> operator*(const Matrix<T, W2, W>& mat) const noexcept;
+        /// Matrix-vector multiplication operator, transforming the given column vector.
+        /// \param vec Vector to be transformed.
+        /// \return Transformed vector.
+        constexpr Vector<T, H> operator*(const Vector<T, W>& vec) const noexcept;
+        /// Element-wise matrix-matrix addition assignment operator.
+        /// \param mat Matrix to be added.
+        /// \return Reference to the modified original matrix.
+        constexpr Matrix& operator+=(const Matrix& mat) noexcept;
+        /// Element-wise matrix-matrix substraction assignment operator.
+        /// \param mat Matrix to be substracted.
+        /// \return Reference to the modified original matrix.
+        constexpr Matrix& operator-=(const Matrix& mat) noexcept;
+        /// Element-wise matrix-value multiplication assignment operator.
+        /// \param val Value to be multiplied by.
+        /// \return Reference to the modified original matrix.
+        constexpr Matrix& operator*=(T val) noexcept;
+        /// Element-wise matrix-value division assignment operator.
+        /// \param val Value to be divided by.
+        /// \return Reference to the modified original matrix.
+        constexpr Matrix& operator/=(T val) noexcept;
+        /// Matrix-matrix multiplication assignment operator; only available for square matrices.
+        /// \param mat Matrix to be multiplied by.
+        /// \return Reference to the modified original matrix.
+        constexpr Matrix& operator*=(const Matrix& mat) noexcept;
+        /// Element fetching operator given its index in the column-major data.
+        /// \param index Element's index.
+        /// \return Constant reference to the fetched element.
+        constexpr const T& operator[](std::size_t index) const noexcept { return m_data[index]; }
+        /// Element fetching operator given its index in the column-major data.
+        /// \param index Element's index.
+        /// \return Reference to the fetched element.
+        constexpr T& operator[](std::size_t index) noexcept { return m_data[index]; }
+        /// Matrix equality comparison operator.
+        /// Uses a near-equality check on floating types to take floating-point errors into account.
+        /// \param mat Matrix to be compared with.
+        /// \return True if matrices are [nearly] equal, else otherwise.
+        constexpr bool operator==(const Matrix& mat) const noexcept;
+        /// Matrix inequality comparison operator.
+        /// Uses a near-equality check on floating types to take floating-point errors into account.
+        /// \param mat Matrix to be compared with.
+        /// \return True if matrices are different, else otherwise.
+        constexpr bool operator!=(const Matrix& mat) const noexcept { return !(*this == mat); }
+        /// Output stream operator.
+        /// \param stream Stream to output into.
+        /// \param mat Matrix to be output.
+        friend std::ostream& operator<< <>(std::ostream& stream, const Matrix& mat);
+
+    private:
+        alignas(Detail::MatrixAlignment<T, W, H>) std::array<T, W * H> m_data{};
+    };
+
+    // Aliases
+
+    template <typename T> using Mat2 = Matrix<T, 2, 2>;
+    template <typename T> using Mat3 = Matrix<T, 3, 3>;
+    template <typename T> using Mat4 = Matrix<T, 4, 4>;
+
+    using Mat2i = Mat2<int>;
+    using Mat3i = Mat3<int>;
+    using Mat4i = Mat4<int>;
+
+    using Mat2f = Mat2<float>;
+    using Mat3f = Mat3<float>;
+    using Mat4f = Mat4<float>;
+
+    using Mat2d = Mat2<double>;
+    using Mat3d = Mat3<double>;
+    using Mat4d = Mat4<double>;
+
+    template <typename T, std::size_t W, std::size_t H>
+    template <typename... Args, typename, typename>
+    constexpr Matrix<T, W, H>::Matrix(Args&&... args) noexcept {
+        const std::array<T, W * H> rowMajorValues{ static_cast<T>(args)... };
+
+        for (std::size_t heightIndex = 0; heightIndex < H; ++heightIndex) {
+            for (std::size_t widthIndex = 0; widthIndex < W; ++widthIndex)
+                m_data[widthIndex * H + heightIndex] = rowMajorValues[heightIndex * W + widthIndex];
+        }
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Matrix<T, W, H> Matrix<T, W, H>::identity() noexcept {
+        static_assert(W == H, "Error: An identity matrix must be square.");
+
+        Matrix res;
+        for (std::size_t i = 0; i < W; ++i)
+            res.m_data[i * H + i] = static_cast<T>(1);
+        return res;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Matrix<T, W, H> Matrix<T, W, H>::fromColumns(const std::array<Vector<T, H>, W>& columns) noexcept {
+        Matrix res;
+        for (std::size_t widthIndex = 0; widthIndex < W; ++widthIndex)
+            res.setColumn(widthIndex, columns[widthIndex]);
+        return res;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr const T& Matrix<T, W, H>::getElement(std::size_t widthIndex, std::size_t heightIndex) const noexcept {
+        assert("Error: The given width index is invalid." && widthIndex < W);
+        assert("Error: The given height index is invalid." && heightIndex < H);
+
+        return m_data[widthIndex * H + heightIndex];
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr T& Matrix<T, W, H>::getElement(std::size_t widthIndex, std::size_t heightIndex) noexcept {
+        return const_cast<T&>(static_cast<const Matrix*>(this)->getElement(widthIndex, heightIndex));
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Vector<T, H> Matrix<T, W, H>::recoverColumn(std::size_t widthIndex) const noexcept {
+        assert("Error: The given column index is invalid." && widthIndex < W);
+
+        Vector<T, H> res;
+        for (std::size_t heightIndex = 0; heightIndex < H; ++heightIndex)
+            res[heightIndex] = m_data[widthIndex * H + heightIndex];
+        return res;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Vector<T, W> Matrix<T, W, H>::recoverRow(std::size_t heightIndex) const noexcept {
+        assert("Error: The given row index is invalid." && heightIndex < H);
+
+        Vector<T, W> res;
+        for (std::size_t widthIndex = 0; widthIndex < W; ++widthIndex)
+            res[widthIndex] = m_data[widthIndex * H + heightIndex];
+        return res;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr void Matrix<T, W, H>::setColumn(std::size_t widthIndex, const Vector<T, H>& column) noexcept {
+        assert("Error: The given column index is invalid." && widthIndex < W);
+
+        for (std::size_t heightIndex = 0; heightIndex < H; ++heightIndex)
+            m_data[widthIndex * H + heightIndex] = column[heightIndex];
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Matrix<T, H, W> Matrix<T, W, H>::transpose() const noexcept {
+        Matrix<T, H, W> res;
+        for (std::size_t widthIndex = 0; widthIndex < W; ++widthIndex) {
+            for (std::size_t heightIndex = 0; heightIndex < H; ++heightIndex)
+                res.getElement(heightIndex, widthIndex) = m_data[widthIndex * H + heightIndex];
+        }
+        return res;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Matrix<T, W - 1, H - 1> Matrix<T, W, H>::recoverSubmatrix(std::size_t widthIndex, std::size_t heightIndex) const noexcept {
+        static_assert(W > 1 && H > 1, "Error: A submatrix can only be computed from a matrix of size 2 or more.");
+
+        Matrix<T, W - 1, H - 1> res;
+        std::size_t resIndex = 0;
+
+        for (std::size_t columnIndex = 0; columnIndex < W; ++columnIndex) {
+            if (columnIndex == widthIndex)
+                continue;
+
+            for (std::size_t rowIndex = 0; rowIndex < H; ++rowIndex) {
+                if (rowIndex != heightIndex)
+                    res[resIndex++] = m_data[columnIndex * H + rowIndex];
+            }
+        }
+
+        return res;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr T Matrix<T, W, H>::computeDeterminant() const noexcept {
+        static_assert(W == H, "Error: The determinant can only be computed for a square matrix.");
+
+        if constexpr (W == 1) {
+            return m_data[0];
+        } else if constexpr (W == 2) {
+            return m_data[0] * m_data[3] - m_data[2] * m_data[1];
+        } else {
+            T determinant{};
+            T sign = static_cast<T>(1);
+
+            for (std::size_t heightIndex = 0; heightIndex < H; ++heightIndex) {
+                determinant += sign * m_data[heightIndex] * recoverSubmatrix(0, heightIndex).computeDeterminant();
+                sign = -sign;
+            }
+
+            return determinant;
+        }
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Matrix<T, W, H> Matrix<T, W, H>::inverse() const noexcept {
+        static_assert(W == H, "Error: Only a square matrix can be inverted.");
+        static_assert(std::is_floating_point_v<T>, "Error: Only a floating-point matrix can be inverted.");
+
+        Matrix reduced = *this;
+        Matrix res = identity();
+
+        for (std::size_t pivotIndex = 0; pivotIndex < W; ++pivotIndex) {
+            // The row having the largest value in the current column is taken as pivot, to limit the precision loss
+            std::size_t pivotRow = pivotIndex;
+
+            for (std::size_t rowIndex = pivotIndex + 1; rowIndex < H; ++rowIndex) {
+                const T value = reduced.getElement(pivotIndex, rowIndex);
+                const T pivotValue = reduced.getElement(pivotIndex, pivotRow);
+
+                if ((value < 0 ? -value : value) > (pivotValue < 0 ? -pivotValue : pivotValue))
+                    pivotRow = rowIndex;
+            }
+
+            assert("Error: The matrix is not invertible." && reduced.getElement(pivotIndex, pivotRow) != static_cast<T>(0));
+
+            if (pivotRow != pivotIndex) {
+                for (std::size_t widthIndex = 0; widthIndex < W; ++widthIndex) {
+                    std::swap(reduced.getElement(widthIndex, pivotIndex), reduced.getElement(widthIndex, pivotRow));
+                    std::swap(res.getElement(widthIndex, pivotIndex), res.getElement(widthIndex, pivotRow));
+                }
+            }
+
+            const T invPivot = static_cast<T>(1) / reduced.getElement(pivotIndex, pivotIndex);
+
+            for (std::size_t widthIndex = 0; widthIndex < W; ++widthIndex) {
+                reduced.getElement(widthIndex, pivotIndex) *= invPivot;
+                res.getElement(widthIndex, pivotIndex) *= invPivot;
+            }
+
+            for (std::size_t rowIndex = 0; rowIndex < H; ++rowIndex) {
+                if (rowIndex == pivotIndex)
+                    continue;
+
+                const T factor = reduced.getElement(pivotIndex, rowIndex);
+
+                if (factor == static_cast<T>(0))
+                    continue;
+
+                for (std::size_t widthIndex = 0; widthIndex < W; ++widthIndex) {
+                    reduced.getElement(widthIndex, rowIndex) -= factor * reduced.getElement(widthIndex, pivotIndex);
+                    res.getElement(widthIndex, rowIndex) -= factor * res.getElement(widthIndex, pivotIndex);
+                }
+            }
+        }
+
+        return res;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr bool Matrix<T, W, H>::strictlyEquals(const Matrix& mat) const noexcept {
+        for (std::size_t i = 0; i < W * H; ++i) {
+            if (m_data[i] != mat.m_data[i])
+                return false;
+        }
+
+        return true;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Matrix<T, W, H> Matrix<T, W, H>::operator+(const Matrix& mat) const noexcept {
+        Matrix res = *this;
+        res += mat;
+        return res;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Matrix<T, W, H> Matrix<T, W, H>::operator-(const Matrix& mat) const noexcept {
+        Matrix res = *this;
+        res -= mat;
+        return res;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Matrix<T, W, H> Matrix<T, W, H>::operator*(T val) const noexcept {
+        Matrix res = *this;
+        res *= val;
+        return res;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Matrix<T, W, H> Matrix<T, W, H>::operator/(T val) const noexcept {
+        Matrix res = *this;
+        res /= val;
+        return res;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    template <std::size_t W2>
+    constexpr Matrix<T, W2, H> Matrix<T, W, H>::operator*(const Matrix<T, W2, W>& mat) const noexcept {
+        Matrix<T, W2, H> res;
+
+        // Each resulting column is a combination of the current matrix's columns, weighted by the other matrix's column values
+        for (std::size_t resWidthIndex = 0; resWidthIndex < W2; ++resWidthIndex) {
+            for (std::size_t widthIndex = 0; widthIndex < W; ++widthIndex) {
+                const T factor = mat.getElement(resWidthIndex, widthIndex);
+
+                for (std::size_t heightIndex = 0; heightIndex < H; ++heightIndex)
+                    res.getElement(resWidthIndex, heightIndex) += m_data[widthIndex * H + heightIndex] * factor;
+            }
+        }
+
+        return res;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Vector<T, H> Matrix<T, W, H>::operator*(const Vector<T, W>& vec) const noexcept {
+        Vector<T, H> res;
+
+        for (std::size_t widthIndex = 0; widthIndex < W; ++widthIndex) {
+            for (std::size_t heightIndex = 0; heightIndex < H; ++heightIndex)
+                res[heightIndex] += m_data[widthIndex * H + heightIndex] * vec[widthIndex];
+        }
+
+        return res;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Matrix<T, W, H>& Matrix<T, W, H>::operator+=(const Matrix& mat) noexcept {
+        for (std::size_t i = 0; i < W * H; ++i)
+            m_data[i] += mat.m_data[i];
+        return *this;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Matrix<T, W, H>& Matrix<T, W, H>::operator-=(const Matrix& mat) noexcept {
+        for (std::size_t i = 0; i < W * H; ++i)
+            m_data[i] -= mat.m_data[i];
+        return *this;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Matrix<T, W, H>& Matrix<T, W, H>::operator*=(T val) noexcept {
+        for (T& elt : m_data)
+            elt *= val;
+        return *this;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Matrix<T, W, H>& Matrix<T, W, H>::operator/=(T val) noexcept {
+        if constexpr (std::is_integral_v<T>)
+            assert("Error: Integer matrix division by 0 is undefined." && (val != 0));
+
+        for (T& elt : m_data)
+            elt /= val;
+        return *this;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr Matrix<T, W, H>& Matrix<T, W, H>::operator*=(const Matrix& mat) noexcept {
+        static_assert(W == H, "Error: Only a square matrix can be multiplied in place.");
+
+        *this = *this * mat;
+        return *this;
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    constexpr bool Matrix<T, W, H>::operator==(const Matrix& mat) const noexcept {
+        if constexpr (std::is_floating_point_v<T>) {
+            for (std::size_t i = 0; i < W * H; ++i) {
+                if (!FloatUtils::areNearlyEqual(m_data[i], mat.m_data[i]))
+                    return false;
+            }
+
+            return true;
+        } else {
+            return strictlyEquals(mat);
+        }
+    }
+
+    template <typename T, std::size_t W, std::size_t H>
+    std::ostream& operator<<(std::ostream& stream, const Matrix<T, W, H>& mat) {
+        for (std::size_t heightIndex = 0; heightIndex < H; ++heightIndex) {
+            stream << (heightIndex == 0 ? "[[ " : " [ ") << mat.getElement(0, heightIndex);
+
+            for (std::size_t widthIndex = 1; widthIndex < W; ++widthIndex)
+                stream << ", " << mat.getElement(widthIndex, heightIndex);
+
+            stream << (heightIndex == H - 1 ? " ]]" : " ]\n");
+        }
+
+        return stream;
+    }
+
+} // namespace Rei
@@ -0,0 +1,297 @@
+#include "MatrixSimd.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace Rei::Simd {
+
+#if defined(REI_SIMD_SSE2)
+    namespace {
+
+        /// Picks the two first elements from the first register & the two last from the second one.
+        template <int X, int Y, int Z, int W>
+        __m128 shuffle(__m128 data1, __m128 data2) noexcept { return _mm_shuffle_ps(data1, data2, _MM_SHUFFLE(W, Z, Y, X)); }
+
+        template <int X, int Y, int Z, int W>
+        __m128 swizzle(__m128 data) noexcept { return shuffle<X, Y, Z, W>(data, data); }
+
+        // 2x2 matrices are stored in a register as (m00, m01, m10, m11); A# denotes the adjugate of A
+
+        /// Computes A * B.
+        __m128 multiply2x2(__m128 mat1, __m128 mat2) noexcept {
+            return _mm_add_ps(_mm_mul_ps(mat1, swizzle<0, 3, 0, 3>(mat2)), _mm_mul_ps(swizzle<1, 0, 3, 2>(mat1), swizzle<2, 1, 2, 1>(mat2)));
+        }
+
+        /// Computes A# * B.
+        __m128 adjugateMultiply2x2(__m128 mat1, __m128 mat2) noexcept {
+            return _mm_sub_ps(_mm_mul_ps(swizzle<3, 3, 0, 0>(mat1), mat2), _mm_mul_ps(swizzle<1, 1, 2, 2>(mat1), swizzle<2, 3, 0, 1>(mat2)));
+        }
+
+        /// Computes A * B#.
+        __m128 multiplyAdjugate2x2(__m128 mat1, __m128 mat2) noexcept {
+            return _mm_sub_ps(_mm_mul_ps(mat1, swizzle<3, 0, 3, 0>(mat2)), _mm_mul_ps(swizzle<1, 0, 3, 2>(mat1), swizzle<2, 1, 2, 1>(mat2)));
+        }
+
+    } // namespace
+#endif
+
+    Mat4f inverse(const Mat4f& mat) noexcept {
+#if defined(REI_SIMD_SSE2)
+        // The inverse of the transpose being the transpose of the inverse, the columns can be processed as if they were rows
+        const float* data = mat.getDataPtr();
+        const __m128 row0 = _mm_load_ps(data);
+        const __m128 row1 = _mm_load_ps(data + 4);
+        const __m128 row2 = _mm_load_ps(data + 8);
+        const __m128 row3 = _mm_load_ps(data + 12);
+
+        // The matrix is split into four 2x2 blocks:
+        //   | A B |
+        //   | C D |
+        const __m128 blockA = _mm_movelh_ps(row0, row1);
+        const __m128 blockB = _mm_movehl_ps(row1, row0);
+        const __m128 blockC = _mm_movelh_ps(row2, row3);
+        const __m128 blockD = _mm_movehl_ps(row3, row2);
+
+        // (|A|, |B|, |C|, |D|)
+        const __m128 blockDets = _mm_sub_ps(_mm_mul_ps(shuffle<0, 2, 0, 2>(row0, row2), shuffle<1, 3, 1, 3>(row1, row3)),
+                                            _mm_mul_ps(shuffle<1, 3, 1, 3>(row0, row2), shuffle<0, 2, 0, 2>(row1, row3)));
+        const __m128 detA = swizzle<0, 0, 0, 0>(blockDets);
+        const __m128 detB = swizzle<1, 1, 1, 1>(blockDets);
+        const __m128 detC = swizzle<2, 2, 2, 2>(blockDets);
+        const __m128 detD = swizzle<3, 3, 3, 3>(blockDets);
+
+        const __m128 adjDMulC = adjugateMultiply2x2(blockD, blockC);
+        const __m128 adjAMulB = adjugateMultiply2x2(blockA, blockB);
+
+        // The inverse is 1/|M| * | X Y |, whose blocks' adjugates are computed:
+        //                        | Z W |
+        //   X# = |D|A - B(D#C), Y# = |B|C - D(A#B)#, Z# = |C|B - A(D#C)#, W# = |A|D - C(A#B)
+        __m128 adjX = _mm_sub_ps(_mm_mul_ps(detD, blockA), multiply2x2(blockB, adjDMulC));
+        __m128 adjY = _mm_sub_ps(_mm_mul_ps(detB, blockC), multiplyAdjugate2x2(blockD, adjAMulB));
+        __m128 adjZ = _mm_sub_ps(_mm_mul_ps(detC, blockB), multiplyAdjugate2x2(blockA, adjDMulC));
+        __m128 adjW = _mm_sub_ps(_mm_mul_ps(detA, blockD), multiply2x2(blockC, adjAMulB));
+
+        // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+        const __m128 traceTerms = _mm_mul_ps(adjAMulB, swizzle<0, 2, 1, 3>(adjDMulC));
+        const __m128 tracePairs = _mm_add_ps(traceTerms, swizzle<1, 0, 3, 2>(traceTerms));
+        const __m128 trace = _mm_add_ps(tracePairs, swizzle<2, 3, 0, 1>(tracePairs));
+        const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+
+        assert("Error: The matrix is not invertible." && _mm_cvtss_f32(det) != 0.f);
+
+        // The adjugates' signs are applied alongside the division by the determinant
+        const __m128 invDet = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), det);
+        adjX = _mm_mul_ps(adjX, invDet);
+        adjY = _mm_mul_ps(adjY, invDet);
+        adjZ = _mm_mul_ps(adjZ, invDet);
+        adjW = _mm_mul_ps(adjW, invDet);
+
+        // Swapping the adjugates' diagonals recovers the blocks, which are reassembled into rows
+        Mat4f res;
+        _mm_store_ps(res.getDataPtr(), shuffle<3, 1, 3, 1>(adjX, adjY));
+        _mm_store_ps(res.getDataPtr() + 4, shuffle<2, 0, 2, 0>(adjX, adjY));
+        _mm_store_ps(res.getDataPtr() + 8, shuffle<3, 1, 3, 1>(adjZ, adjW));
+        _mm_store_ps(res.getDataPtr() + 12, shuffle<2, 0, 2, 0>(adjZ, adjW));
+        return res;
+#else
+        return mat.inverse();
+#endif
+    }
+
+    Quaternionf slerp(const Quaternionf& quat1, const Quaternionf& quat2, float coeff) noexcept {
+#if defined(REI_SIMD_SSE2)
+        assert("Error: The interpolation coefficient must be between 0 & 1." && (coeff >= 0.f && coeff <= 1.f));
+
+        const __m128 data1 = load(quat1);
+        __m128 data2 = load(quat2);
+        __m128 cosAngles = dot(data1, data2);
+
+        // q & -q represent the same rotation; the closest one is taken to interpolate along the shortest path
+        const __m128 signMask = _mm_and_ps(cosAngles, _mm_set1_ps(-0.f));
+        data2 = _mm_xor_ps(data2, signMask);
+        cosAngles = _mm_xor_ps(cosAngles, signMask);
+
+        const float cosAngle = _mm_cvtss_f32(cosAngles);
+        __m128 coeffs1 {};
+        __m128 coeffs2 {};
+
+        // Quaternions too close to each other would make the sine tend to 0; a linear interpolation is then precise enough
+        if (cosAngle > 0.9995f) {
+            coeffs1 = _mm_set1_ps(1.f - coeff);
+            coeffs2 = _mm_set1_ps(coeff);
+        } else {
+            const float angle = std::acos(cosAngle);
+            const float invSinAngle = 1.f / std::sin(angle);
+            coeffs1 = _mm_set1_ps(std::sin((1.f - coeff) * angle) * invSinAngle);
+            coeffs2 = _mm_set1_ps(std::sin(coeff * angle) * invSinAngle);
+        }
+
+        const Vec4f res = toVec4f(normalize(_mm_add_ps(_mm_mul_ps(data1, coeffs1), _mm_mul_ps(data2, coeffs2))));
+        return Quaternionf(res.w(), res.x(), res.y(), res.z());
+#else
+        return quat1.slerp(quat2, coeff);
+#endif
+    }
+
+    Mat4f composeTrs(const Vec3f& translation, const Quaternionf& rotation, const Vec3f& scale) noexcept {
+#if defined(REI_SIMD_SSE2)
+        const __m128 quat = load(rotation);
+        const __m128 doubledQuat = _mm_add_ps(quat, quat);
+        const __m128 squares = _mm_mul_ps(quat, doubledQuat); // (2xx, 2yy, 2zz, 2ww)
+
+        // Diagonal: (1 - 2yy - 2zz, 1 - 2xx - 2zz, 1 - 2xx - 2yy)
+        const __m128 diagonal = _mm_sub_ps(_mm_sub_ps(_mm_setr_ps(1.f, 1.f, 1.f, 0.f), swizzle<1, 0, 0, 3>(squares)), swizzle<2, 2, 1, 3>(squares));
+        // (2xz, 2xy, 2yz) & (2wy, 2wz, 2wx)
+        const __m128 crossProducts = _mm_mul_ps(swizzle<0, 0, 1, 3>(quat), swizzle<2, 1, 2, 3>(doubledQuat));
+        const __m128 realProducts = _mm_mul_ps(swizzle<3, 3, 3, 3>(quat), swizzle<1, 2, 0, 3>(doubledQuat));
+        const __m128 sums = _mm_add_ps(crossProducts, realProducts); // (2xz + 2wy, 2xy + 2wz, 2yz + 2wx)
+        const __m128 diffs = _mm_sub_ps(crossProducts, realProducts); // (2xz - 2wy, 2xy - 2wz, 2yz - 2wx)
+
+        alignas(16) float diagonalValues[4];
+        alignas(16) float sumValues[4];
+        alignas(16) float diffValues[4];
+        _mm_store_ps(diagonalValues, diagonal);
+        _mm_store_ps(sumValues, sums);
+        _mm_store_ps(diffValues, diffs);
+
+        const __m128 column0 = _mm_setr_ps(diagonalValues[0], sumValues[1], diffValues[0], 0.f);
+        const __m128 column1 = _mm_setr_ps(diffValues[1], diagonalValues[1], sumValues[2], 0.f);
+        const __m128 column2 = _mm_setr_ps(sumValues[0], diffValues[2], diagonalValues[2], 0.f);
+
+        Mat4f res;
+        _mm_store_ps(res.getDataPtr(), _mm_mul_ps(column0, _mm_set1_ps(scale.x())));
+        _mm_store_ps(res.getDataPtr() + 4, _mm_mul_ps(column1, _mm_set1_ps(scale.y())));
+        _mm_store_ps(res.getDataPtr() + 8, _mm_mul_ps(column2, _mm_set1_ps(scale.z())));
+        _mm_store_ps(res.getDataPtr() + 12, _mm_setr_ps(translation.x(), translation.y(), translation.z(), 1.f));
+        return res;
+#else
+        return Rei::composeTrs(translation, rotation, scale);
+#endif
+    }
+
+    void decomposeTrs(const Mat4f& transform, Vec3f& translation, Quaternionf& rotation, Vec3f& scale) noexcept {
+#if defined(REI_SIMD_SSE2)
+        const float* data = transform.getDataPtr();
+        const __m128 columns[3] = { _mm_load_ps(data), _mm_load_ps(data + 4), _mm_load_ps(data + 8) };
+
+        translation = Vec3f(data[12], data[13], data[14]);
+
+        Mat3f rotationMat;
+
+        for (std::size_t widthIndex = 0; widthIndex < 3; ++widthIndex) {
+            // The last row of an affine matrix's first three columns is 0, thus not altering the length
+            const __m128 length = _mm_sqrt_ps(dot(columns[widthIndex], columns[widthIndex]));
+            scale[widthIndex] = _mm_cvtss_f32(length);
+
+            assert("Error: A transformation matrix with a scale of 0 cannot be decomposed." && scale[widthIndex] != 0.f);
+            rotationMat.setColumn(widthIndex, toVec3f(_mm_div_ps(columns[widthIndex], length)));
+        }
+
+        rotation = Quaternionf::fromRotationMatrix(rotationMat);
+#else
+        Rei::decomposeTrs(transform, translation, rotation, scale);
+#endif
+    }
+
+    // As for the vector kernels, as many elements as possible are processed with the widest available registers, the remaining ones with scalar operations
+
+    void transform(const Mat4f& mat, const Vec4f* vecs, Vec4f* results, std::size_t count) noexcept {
+        std::size_t vecIndex = 0;
+
+#if defined(REI_SIMD_SSE2)
+        const float* data = mat.getDataPtr();
+        const __m128 columns[4] = { _mm_load_ps(data), _mm_load_ps(data + 4), _mm_load_ps(data + 8), _mm_load_ps(data + 12) };
+
+#if defined(REI_SIMD_AVX)
+        // Two vectors are transformed at once, each register lane holding one of them
+        const __m256 columns8[4] = { _mm256_broadcast_ps(&columns[0]), _mm256_broadcast_ps(&columns[1]),
+                                     _mm256_broadcast_ps(&columns[2]), _mm256_broadcast_ps(&columns[3]) };
+
+        for (; vecIndex + 2 <= count; vecIndex += 2) {
+            const __m256 vecPair = _mm256_loadu_ps(vecs[vecIndex].getDataPtr());
+
+            const __m256 xTerms = _mm256_mul_ps(columns8[0], _mm256_permute_ps(vecPair, _MM_SHUFFLE(0, 0, 0, 0)));
+            const __m256 yTerms = _mm256_mul_ps(columns8[1], _mm256_permute_ps(vecPair, _MM_SHUFFLE(1, 1, 1, 1)));
+            const __m256 zTerms = _mm256_mul_ps(columns8[2], _mm256_permute_ps(vecPair, _MM_SHUFFLE(2, 2, 2, 2)));
+            const __m256 wTerms = _mm256_mul_ps(columns8[3], _mm256_permute_ps(vecPair, _MM_SHUFFLE(3, 3, 3, 3)));
+
+            _mm256_storeu_ps(results[vecIndex].getDataPtr(), _mm256_add_ps(_mm256_add_ps(xTerms, yTerms), _mm256_add_ps(zTerms, wTerms)));
+        }
+#endif
+
+        for (; vecIndex < count; ++vecIndex)
+            _mm_store_ps(results[vecIndex].getDataPtr(), Simd::transform(columns, load(vecs[vecIndex])));
+#else
+        for (; vecIndex < count; ++vecIndex)
+            results[vecIndex] = mat * vecs[vecIndex];
+#endif
+    }
+
+    void transformPoints(const Mat4f& mat, const ConstVec3fSoaView& points, const Vec3fSoaView& results) noexcept {
+        assert("Error: The resulting points must be at least as many as the input ones." && results.count >= points.count);
+
+        std::size_t pointIndex = 0;
+
+        // Each output coordinate is a combination of the input ones with a row of the matrix: x' = m00 x + m10 y + m20 z + m30
+#if defined(REI_SIMD_AVX)
+        {
+            __m256 elements[4][3];
+
+            for (std::size_t widthIndex = 0; widthIndex < 4; ++widthIndex) {
+                for (std::size_t heightIndex = 0; heightIndex < 3; ++heightIndex)
+                    elements[widthIndex][heightIndex] = _mm256_set1_ps(mat.getElement(widthIndex, heightIndex));
+            }
+
+            for (; pointIndex + 8 <= points.count; pointIndex += 8) {
+                const __m256 x = _mm256_loadu_ps(points.x + pointIndex);
+                const __m256 y = _mm256_loadu_ps(points.y + pointIndex);
+                const __m256 z = _mm256_loadu_ps(points.z + pointIndex);
+
+                float* outputs[3] = { results.x + pointIndex, results.y + pointIndex, results.z + pointIndex };
+
+                for (std::size_t heightIndex = 0; heightIndex < 3; ++heightIndex) {
+                    const __m256 res = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(elements[0][heightIndex], x), _mm256_mul_ps(elements[1][heightIndex], y)),
+                                                     _mm256_add_ps(_mm256_mul_ps(elements[2][heightIndex], z), elements[3][heightIndex]));
+                    _mm256_storeu_ps(outputs[heightIndex], res);
+                }
+            }
+        }
+#endif
+
+#if defined(REI_SIMD_SSE2)
+        {
+            __m128 elements[4][3];
+
+            for (std::size_t widthIndex = 0; widthIndex < 4; ++widthIndex) {
+                for (std::size_t heightIndex = 0; heightIndex < 3; ++heightIndex)
+                    elements[widthIndex][heightIndex] = _mm_set1_ps(mat.getElement(widthIndex, heightIndex));
+            }
+
+            for (; pointIndex + 4 <= points.count; pointIndex += 4) {
+                const __m128 x = _mm_loadu_ps(points.x + pointIndex);
+                const __m128 y = _mm_loadu_ps(points.y + pointIndex);
+                const __m128 z = _mm_loadu_ps(points.z + pointIndex);
+
+                float* outputs[3] = { results.x + pointIndex, results.y + pointIndex, results.z + pointIndex };
+
+                for (std::size_t heightIndex = 0; heightIndex < 3; ++heightIndex) {
+                    const __m128 res = _mm_add_ps(_mm_add_ps(_mm_mul_ps(elements[0][heightIndex], x), _mm_mul_ps(elements[1][heightIndex], y)),
+                                                  _mm_add_ps(_mm_mul_ps(elements[2][heightIndex], z), elements[3][heightIndex]));
+                    _mm_storeu_ps(outputs[heightIndex], res);
+                }
+            }
+        }
+#endif
+
+        for (; pointIndex < points.count; ++pointIndex) {
+            const float x = points.x[pointIndex];
+            const float y = points.y[pointIndex];
+            const float z = points.z[pointIndex];
+
+            results.x[pointIndex] = mat.getElement(0, 0) * x + mat.getElement(1, 0) * y + mat.getElement(2, 0) * z + mat.getElement(3, 0);
+            results.y[pointIndex] = mat.getElement(0, 1) * x + mat.getElement(1, 1) * y + mat.getElement(2, 1) * z + mat.getElement(3, 1);
+            results.z[pointIndex] = mat.getElement(0, 2) * x + mat.getElement(1, 2) * y + mat.getElement(2, 2) * z + mat.getElement(3, 2);
+        }
+    }
+
+} // namespace Rei::Simd
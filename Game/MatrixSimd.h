@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Matrix.h"
+#include "Quaternion.h"
+#include "Simd.h"
+#include "VectorSimd.h"
+
+namespace Rei {
+
+    /// SIMD implementations of the most frequent single-precision matrix & quaternion operations, which fall back to Matrix's & Quaternion's scalar ones
+    ///   when no SIMD instruction set is available.
+    /// Mat4f's columns & Quaternionf's values being 16-byte aligned, each of them is loaded into a register at once.
+    /// \note Unlike Matrix's & Quaternion's member functions, these are not usable at compile time.
+    namespace Simd {
+
+#if defined(REI_SIMD_SSE2)
+        /// Loads a quaternion into a SIMD register, as (x, y, z, w).
+        inline __m128 load(const Quaternionf& quat) noexcept { return _mm_load_ps(quat.getDataPtr()); }
+
+        /// Transforms a vector by the columns of a matrix, combining them with the vector's broadcast values.
+        inline __m128 transform(const __m128 (&columns)[4], __m128 vec) noexcept {
+            const __m128 xTerm = _mm_mul_ps(columns[0], _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(0, 0, 0, 0)));
+            const __m128 yTerm = _mm_mul_ps(columns[1], _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(1, 1, 1, 1)));
+            const __m128 zTerm = _mm_mul_ps(columns[2], _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(2, 2, 2, 2)));
+            const __m128 wTerm = _mm_mul_ps(columns[3], _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(3, 3, 3, 3)));
+
+            return _mm_add_ps(_mm_add_ps(xTerm, yTerm), _mm_add_ps(zTerm, wTerm));
+        }
+#endif
+
+        inline Vec4f multiply(const Mat4f& mat, const Vec4f& vec) noexcept {
+#if defined(REI_SIMD_SSE2)
+            const float* data = mat.getDataPtr();
+            const __m128 columns[4] = { _mm_load_ps(data), _mm_load_ps(data + 4), _mm_load_ps(data + 8), _mm_load_ps(data + 12) };
+
+            return toVec4f(transform(columns, load(vec)));
+#else
+            return mat * vec;
+#endif
+        }
+
+        inline Mat4f multiply(const Mat4f& mat1, const Mat4f& mat2) noexcept {
+#if defined(REI_SIMD_SSE2)
+            const float* data1 = mat1.getDataPtr();
+            const float* data2 = mat2.getDataPtr();
+            const __m128 columns[4] = { _mm_load_ps(data1), _mm_load_ps(data1 + 4), _mm_load_ps(data1 + 8), _mm_load_ps(data1 + 12) };
+
+            // Each resulting column is the first matrix's transformation of the second one's corresponding column
+            Mat4f res;
+            _mm_store_ps(res.getDataPtr(), transform(columns, _mm_load_ps(data2)));
+            _mm_store_ps(res.getDataPtr() + 4, transform(columns, _mm_load_ps(data2 + 4)));
+            _mm_store_ps(res.getDataPtr() + 8, transform(columns, _mm_load_ps(data2 + 8)));
+            _mm_store_ps(res.getDataPtr() + 12, transform(columns, _mm_load_ps(data2 + 12)));
+            return res;
+#else
+            return mat1 * mat2;
+#endif
+        }
+
+        inline Quaternionf multiply(const Quaternionf& quat1, const Quaternionf& quat2) noexcept {
+#if defined(REI_SIMD_SSE2)
+            const __m128 data1 = load(quat1);
+            const __m128 data2 = load(quat2);
+
+            // w1 * (x2, y2, z2, w2) + x1 * (w2, -z2, y2, -x2) + y1 * (z2, w2, -x2, -y2) + z1 * (-y2, x2, w2, -z2)
+            const __m128 wTerm = _mm_mul_ps(_mm_shuffle_ps(data1, data1, _MM_SHUFFLE(3, 3, 3, 3)), data2);
+            const __m128 xTerm = _mm_mul_ps(_mm_shuffle_ps(data1, data1, _MM_SHUFFLE(0, 0, 0, 0)),
+                                            _mm_xor_ps(_mm_shuffle_ps(data2, data2, _MM_SHUFFLE(0, 1, 2, 3)), _mm_setr_ps(0.f, -0.f, 0.f, -0.f)));
+            const __m128 yTerm = _mm_mul_ps(_mm_shuffle_ps(data1, data1, _MM_SHUFFLE(1, 1, 1, 1)),
+                                            _mm_xor_ps(_mm_shuffle_ps(data2, data2, _MM_SHUFFLE(1, 0, 3, 2)), _mm_setr_ps(0.f, 0.f, -0.f, -0.f)));
+            const __m128 zTerm = _mm_mul_ps(_mm_shuffle_ps(data1, data1, _MM_SHUFFLE(2, 2, 2, 2)),
+                                            _mm_xor_ps(_mm_shuffle_ps(data2, data2, _MM_SHUFFLE(2, 3, 0, 1)), _mm_setr_ps(-0.f, 0.f, 0.f, -0.f)));
+
+            const Vec4f res = toVec4f(_mm_add_ps(_mm_add_ps(wTerm, xTerm), _mm_add_ps(yTerm, zTerm)));
+            return Quaternionf(res.w(), res.x(), res.y(), res.z());
+#else
+            return quat1 * quat2;
+#endif
+        }
+
+        /// Computes the inverse of a matrix, by blockwise inversion of its 2x2 submatrices.
+        /// \note The matrix must be invertible; this is only checked in Debug.
+        /// \param mat Matrix to be inverted.
+        /// \return Inverse matrix.
+        Mat4f inverse(const Mat4f& mat) noexcept;
+        /// Computes the spherical linear interpolation between normalized quaternions, taking the shortest path.
+        /// \param quat1 Quaternion returned with a coefficient of 0.
+        /// \param quat2 Quaternion returned with a coefficient of 1.
+        /// \param coeff Interpolation coefficient, between 0 & 1.
+        /// \return Normalized interpolated quaternion.
+        Quaternionf slerp(const Quaternionf& quat1, const Quaternionf& quat2, float coeff) noexcept;
+        /// Composes a transformation matrix, applying the scale first, then the rotation & finally the translation.
+        /// \param translation Translation to be applied.
+        /// \param rotation Rotation to be applied; must be normalized.
+        /// \param scale Scale to be applied.
+        /// \return 4x4 TRS transformation matrix.
+        Mat4f composeTrs(const Vec3f& translation, const Quaternionf& rotation, const Vec3f& scale) noexcept;
+        /// Decomposes a transformation matrix made of a translation, a rotation & a positive scale.
+        /// \note Neither shearing nor negative scaling can be recovered.
+        /// \param transform Transformation matrix to be decomposed.
+        /// \param translation Recovered translation.
+        /// \param rotation Recovered normalized rotation.
+        /// \param scale Recovered scale.
+        void decomposeTrs(const Mat4f& transform, Vec3f& translation, Quaternionf& rotation, Vec3f& scale) noexcept;
+        /// Transforms vectors by a single matrix.
+        /// \param mat Transformation matrix.
+        /// \param vecs Vectors to be transformed.
+        /// \param results Transformed vectors; may be the same array as the input one.
+        /// \param count Number of vectors to be transformed.
+        void transform(const Mat4f& mat, const Vec4f* vecs, Vec4f* results, std::size_t count) noexcept;
+        /// Transforms points by a single affine matrix, their W component being considered as 1; no perspective division is applied.
+        /// \param mat Affine transformation matrix.
+        /// \param points Points to be transformed.
+        /// \param results Transformed points; may be the same arrays as the input ones, & must be at least as many as them.
+        void transformPoints(const Mat4f& mat, const ConstVec3fSoaView& points, const Vec3fSoaView& results) noexcept;
+
+    } // namespace Simd
+
+} // namespace Rei
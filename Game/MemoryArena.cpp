@@ -0,0 +1,55 @@
+#include "MemoryArena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace Rei
+{
+
+    void* MemoryArena::allocate(std::size_t size, std::size_t alignment)
+    {
+        assert("Error: The allocation alignment must be a power of two." && alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+        if (!m_blocks.empty())
+        {
+            const Block& block = m_blocks.back();
+            const auto blockAddress = reinterpret_cast<std::uintptr_t>(block.memory.get());
+            const std::size_t alignedOffset = ((blockAddress + m_blockOffset + alignment - 1) & ~(alignment - 1)) - blockAddress;
+
+            if (alignedOffset + size <= block.size)
+            {
+                m_usedSize += alignedOffset + size - m_blockOffset;
+                m_blockOffset = alignedOffset + size;
+
+                return block.memory.get() + alignedOffset;
+            }
+        }
+
+        // The memory returned by new[] is aligned at most on max_align_t; larger alignments may require some padding
+        const std::size_t blockSize = std::max(m_blockSize, size + alignment);
+        Block& block = m_blocks.emplace_back(Block{ std::make_unique<std::byte[]>(blockSize), blockSize });
+        m_capacity += blockSize;
+
+        const auto blockAddress = reinterpret_cast<std::uintptr_t>(block.memory.get());
+        const std::size_t alignedOffset = ((blockAddress + alignment - 1) & ~(alignment - 1)) - blockAddress;
+
+        m_usedSize += alignedOffset + size;
+        m_blockOffset = alignedOffset + size;
+
+        return block.memory.get() + alignedOffset;
+    }
+
+    void MemoryArena::release() noexcept
+    {
+        for (auto destructor = m_destructors.rbegin(); destructor != m_destructors.rend(); ++destructor)
+            destructor->function(destructor->object);
+
+        m_destructors.clear();
+        m_blocks.clear();
+        m_blockOffset = 0;
+        m_usedSize = 0;
+        m_capacity = 0;
+    }
+
+} // namespace Rei
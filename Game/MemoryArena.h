@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Rei
+{
+
+    /// Linear allocator handing out memory from large blocks, which can only be released all at once.
+    /// Allocating is a mere pointer bump; this suits data sharing the same lifetime, such as everything tied to a loaded map.
+    /// \note Objects created with create() have their destructor called on release; raw allocations are released without any cleanup.
+    class MemoryArena
+    {
+    public:
+        static constexpr std::size_t DefaultBlockSize = 64 * 1024;
+
+        /// Creates an arena; no memory is allocated until the first allocation.
+        /// \param blockSize Size in bytes of the blocks to be allocated; allocations larger than this get a dedicated block.
+        explicit MemoryArena(std::size_t blockSize = DefaultBlockSize) : m_blockSize{ blockSize } {}
+        MemoryArena(const MemoryArena&) = delete;
+        MemoryArena(MemoryArena&&) noexcept = delete;
+
+        /// Gets the number of bytes handed out since the last release, alignment padding included.
+        std::size_t getUsedSize() const noexcept { return m_usedSize; }
+        /// Gets the total size in bytes of the allocated blocks.
+        std::size_t getCapacity() const noexcept { return m_capacity; }
+
+        /// Allocates uninitialized memory.
+        /// \param size Number of bytes to be allocated.
+        /// \param alignment Alignment of the memory to be returned; must be a power of two.
+        /// \return Pointer to the allocated memory, valid until the arena is released.
+        void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+        /// Constructs an object in the arena, which is destroyed when the arena is released.
+        /// \tparam T Type of the object to be created.
+        /// \tparam Args Types of the arguments to be forwarded to the object's constructor.
+        /// \param args Arguments to be forwarded to the object's constructor.
+        /// \return Reference to the newly created object.
+        template <typename T, typename... Args>
+        T& create(Args&&... args)
+        {
+            T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+            if constexpr (!std::is_trivially_destructible_v<T>)
+                m_destructors.emplace_back(Destructor{ object, [](void* destroyedObject) { static_cast<T*>(destroyedObject)->~T(); } });
+
+            return *object;
+        }
+
+        /// Allocates an array of value-initialized elements, which must be trivially destructible.
+        /// \tparam T Type of the elements.
+        /// \param count Number of elements to be allocated.
+        /// \return Pointer to the first element.
+        template <typename T>
+        T* allocateArray(std::size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "Error: The elements of an arena array must be trivially destructible.");
+
+            T* elements = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+
+            for (std::size_t elementIndex = 0; elementIndex < count; ++elementIndex)
+                new (elements + elementIndex) T();
+
+            return elements;
+        }
+
+        /// Destroys all the objects created in the arena, in reverse order of creation, then frees all its memory.
+        void release() noexcept;
+
+        MemoryArena& operator=(const MemoryArena&) = delete;
+        MemoryArena& operator=(MemoryArena&&) noexcept = delete;
+
+        ~MemoryArena() { release(); }
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> memory{};
+            std::size_t size{};
+        };
+
+        struct Destructor
+        {
+            void* object{};
+            void (*function)(void*){};
+        };
+
+        std::size_t m_blockSize{};
+        std::vector<Block> m_blocks{};
+        std::size_t m_blockOffset = 0; // Offset of the first free byte in the last block
+        std::size_t m_usedSize = 0;
+        std::size_t m_capacity = 0;
+        std::vector<Destructor> m_destructors{};
+    };
+
+} // namespace Rei
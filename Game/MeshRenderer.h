@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "Component.h"
+
+namespace Rei
+{
+    class TransformNode;
+
+    /// Component drawing a mesh with a given material & shader, at the position of a transform node.
+    /// Mesh, material & shader are identified by their indices in the renderer's resource tables; identical indices are drawn as a single instanced draw.
+    /// The mesh is bounded by a sphere centered on the transform's origin, used to cull it when out of view; by default, it is never culled.
+    class MeshRenderer final : public Component
+    {
+    public:
+        /// Creates a mesh renderer.
+        /// \param meshId Index of the mesh to be drawn.
+        /// \param materialId Index of the material to draw the mesh with.
+        /// \param shaderId Index of the shader program to draw the mesh with.
+        /// \param transform Transform node giving the mesh's world matrix; must outlive the component.
+        /// \param passId Index of the render pass to draw the mesh in.
+        MeshRenderer(uint32_t meshId, uint32_t materialId, uint32_t shaderId, const TransformNode& transform, uint8_t passId = 0) noexcept
+            : m_meshId{ meshId }, m_materialId{ materialId }, m_shaderId{ shaderId }, m_passId{ passId }, m_transform{ &transform } {}
+
+        uint32_t getMeshId() const noexcept { return m_meshId; }
+        uint32_t getMaterialId() const noexcept { return m_materialId; }
+        uint32_t getShaderId() const noexcept { return m_shaderId; }
+        uint8_t getPassId() const noexcept { return m_passId; }
+        const TransformNode& getTransform() const noexcept { return *m_transform; }
+        bool isVisible() const noexcept { return m_isVisible; }
+        /// Gets the radius of the mesh's local-space bounding sphere, scaled along with the transform.
+        float getBoundingRadius() const noexcept { return m_boundingRadius; }
+
+        void setMeshId(uint32_t meshId) noexcept { m_meshId = meshId; }
+        void setMaterialId(uint32_t materialId) noexcept { m_materialId = materialId; }
+        void setShaderId(uint32_t shaderId) noexcept { m_shaderId = shaderId; }
+        void setPassId(uint8_t passId) noexcept { m_passId = passId; }
+        void setTransform(const TransformNode& transform) noexcept { m_transform = &transform; }
+        void setVisible(bool isVisible) noexcept { m_isVisible = isVisible; }
+        void setBoundingRadius(float boundingRadius) noexcept { m_boundingRadius = boundingRadius; }
+
+    private:
+        uint32_t m_meshId = 0;
+        uint32_t m_materialId = 0;
+        uint32_t m_shaderId = 0;
+        uint8_t m_passId = 0;
+        bool m_isVisible = true;
+        float m_boundingRadius = std::numeric_limits<float>::infinity();
+        const TransformNode* m_transform{};
+    };
+} // namespace Rei
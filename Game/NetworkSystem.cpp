@@ -0,0 +1,520 @@
+#include "NetworkSystem.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include "Serialization.h"
+#include "World.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace Rei
+{
+
+    namespace
+    {
+
+        // Every packet starts with the protocol identifier, so that stray datagrams are ignored, followed by its type
+        constexpr uint32_t ProtocolId = 0x4E494552; // "REIN"
+        constexpr std::size_t PacketHeaderSize = sizeof(ProtocolId) + sizeof(uint8_t);
+
+        enum PacketType : uint8_t
+        {
+            CONNECT,    ///< Sent repeatedly by a client until it receives a snapshot.
+            DISCONNECT, ///< Sent by either end when closing.
+            SNAPSHOT,   ///< Fragment of an encoded snapshot: tick (u32), fragment index (u16), fragment count (u16), then the fragment's data.
+            ACK,        ///< Acknowledgement of a restored snapshot: tick (u32).
+            MESSAGE     ///< User message, filling the rest of the packet.
+        };
+
+        constexpr std::size_t FragmentHeaderSize = sizeof(uint32_t) + 2 * sizeof(uint16_t);
+        constexpr std::size_t MaxFragmentSize = Packet::MaxSize - PacketHeaderSize - FragmentHeaderSize;
+        /// Largest encoded snapshot sent or reassembled, which bounds the memory a received fragment count can make the client allocate.
+        constexpr std::size_t MaxSnapshotSize = 1024 * 1024;
+        constexpr std::size_t MaxFragmentCount = (MaxSnapshotSize + MaxFragmentSize - 1) / MaxFragmentSize;
+
+        constexpr std::size_t ReceivePacketCount = 1024;
+        constexpr std::size_t SendPacketCount = 2048;
+        constexpr int IoTimeoutMs = 10; // Maximum delay for the I/O thread to notice it must stop
+
+        template <typename T>
+        void writeValue(Packet& packet, const T& value) noexcept
+        {
+            std::memcpy(packet.data.data() + packet.size, &value, sizeof(T));
+            packet.size += sizeof(T);
+        }
+
+    } // namespace
+
+    NetworkSystem::NetworkSystem(uint16_t port)
+        : m_role{ NetworkRole::SERVER }, m_receivePool{ ReceivePacketCount }, m_sendPool{ SendPacketCount }, m_receivedPackets{ ReceivePacketCount }
+    {
+        m_isFixedStep = true;
+
+        if (!m_socket.open(port, m_receivePool))
+        {
+            Logger::error("[NetworkSystem] Couldn't open the server on port " + std::to_string(port) + '.');
+            return;
+        }
+
+        startIoThread();
+    }
+
+    NetworkSystem::NetworkSystem(const NetworkAddress& serverAddress, uint16_t port)
+        : m_role{ NetworkRole::CLIENT }, m_receivePool{ ReceivePacketCount }, m_sendPool{ SendPacketCount }, m_receivedPackets{ ReceivePacketCount }
+    {
+        m_isFixedStep = true;
+        m_connections[0].address = serverAddress;
+
+        if (!m_socket.open(port, m_receivePool))
+        {
+            Logger::error("[NetworkSystem] Couldn't open the client on port " + std::to_string(port) + '.');
+            return;
+        }
+
+        startIoThread();
+    }
+
+    std::size_t NetworkSystem::getConnectionCount() const noexcept
+    {
+        return static_cast<std::size_t>(std::count_if(m_connections.cbegin(), m_connections.cend(), [] (const Connection& connection)
+        {
+            return connection.isActive;
+        }));
+    }
+
+    bool NetworkSystem::sendMessage(std::size_t connectionIndex, const uint8_t* data, std::size_t size)
+    {
+        assert("Error: The connection index is out of bounds." && connectionIndex < MaxConnectionCount);
+
+        if (size > Packet::MaxSize - PacketHeaderSize || !m_connections[connectionIndex].isActive)
+            return false;
+
+        Packet* packet = createPacket(m_connections[connectionIndex].address, MESSAGE);
+
+        if (packet == nullptr)
+            return false;
+
+        std::memcpy(packet->data.data() + packet->size, data, size);
+        packet->size += static_cast<uint32_t>(size);
+
+        return true;
+    }
+
+    bool NetworkSystem::update(const FrameTimeInfo& timeInfo)
+    {
+        REI_PROFILE_ZONE("NetworkSystem::update");
+
+        if (!m_socket.isOpen())
+            return true;
+
+        for (Connection& connection : m_connections)
+        {
+            if (connection.isActive)
+                connection.timeSinceLastPacket += timeInfo.deltaTime;
+        }
+
+        {
+            REI_PROFILE_ZONE("NetworkSystem::receive");
+
+            Packet* packet{};
+
+            // The packets are processed in place, & only given back to the I/O thread's pool afterwards
+            while (m_receivedPackets.pop(packet))
+            {
+                processPacket(*packet);
+                m_receivePool.release(*packet);
+            }
+        }
+
+        for (std::size_t connectionIndex = 0; connectionIndex < MaxConnectionCount; ++connectionIndex)
+        {
+            Connection& connection = m_connections[connectionIndex];
+
+            if (!connection.isActive || connection.timeSinceLastPacket < ConnectionTimeout)
+                continue;
+
+            Logger::info("[NetworkSystem] The connection " + std::to_string(connectionIndex) + " timed out.");
+            closeConnection(connectionIndex);
+        }
+
+        if (m_role == NetworkRole::SERVER)
+        {
+            sendSnapshots();
+        }
+        else
+        {
+            if (m_isRestorePending)
+            {
+                // A single restoration is recorded for all the snapshots received during the update, applying the most recent one
+                m_world->getCommandBuffer().editWorld([this, tick = m_tick] (World& world)
+                {
+                    const WorldSnapshot& snapshot = m_snapshots[tick % SnapshotHistorySize];
+
+                    if (snapshot.getTick() == tick)
+                        snapshot.restore(world);
+                });
+
+                m_isRestorePending = false;
+            }
+
+            if (!m_connections[0].isActive)
+            {
+                m_timeSinceConnectionRequest += timeInfo.deltaTime;
+
+                if (m_timeSinceConnectionRequest >= ConnectionRequestInterval)
+                {
+                    createPacket(m_connections[0].address, CONNECT);
+                    m_timeSinceConnectionRequest = 0.f;
+                }
+            }
+        }
+
+        flushPackets();
+
+        return true;
+    }
+
+    void NetworkSystem::destroy()
+    {
+        if (!m_socket.isOpen())
+            return;
+
+        for (const Connection& connection : m_connections)
+        {
+            if (connection.isActive)
+                createPacket(connection.address, DISCONNECT);
+        }
+
+        flushPackets();
+
+        m_isRunning.store(false, std::memory_order_relaxed);
+
+        if (m_ioThread.joinable())
+            m_ioThread.join();
+
+        m_socket.close();
+
+        Packet* packet{};
+
+        while (m_receivedPackets.pop(packet))
+            m_receivePool.release(*packet);
+
+        for (Connection& connection : m_connections)
+            connection.isActive = false;
+    }
+
+    void NetworkSystem::startIoThread()
+    {
+        m_outgoingPackets.reserve(SendPacketCount);
+        m_isRunning.store(true, std::memory_order_relaxed);
+        m_ioThread = std::thread(&NetworkSystem::runIoThread, this);
+    }
+
+    void NetworkSystem::runIoThread()
+    {
+        std::array<Packet*, UdpSocket::MaxBatchSize> packets{};
+
+        while (m_isRunning.load(std::memory_order_relaxed))
+        {
+            const std::size_t packetCount = m_socket.receive(packets.data(), packets.size(), IoTimeoutMs);
+
+            for (std::size_t packetIndex = 0; packetIndex < packetCount; ++packetIndex)
+            {
+                if (m_receivedPackets.push(packets[packetIndex]))
+                    continue;
+
+                m_receivePool.release(*packets[packetIndex]);
+                m_droppedPacketCount.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void NetworkSystem::processPacket(const Packet& packet)
+    {
+        ByteReader reader(packet.data.data(), packet.size);
+        uint32_t protocolId{};
+        uint8_t packetType{};
+
+        if (!reader.read(protocolId) || !reader.read(packetType) || protocolId != ProtocolId)
+            return;
+
+        std::size_t connectionIndex = MaxConnectionCount;
+
+        for (std::size_t index = 0; index < MaxConnectionCount; ++index)
+        {
+            if (m_connections[index].address == packet.address && (m_connections[index].isActive || m_role == NetworkRole::CLIENT))
+            {
+                connectionIndex = index;
+                break;
+            }
+        }
+
+        if (connectionIndex == MaxConnectionCount)
+        {
+            // Only a server accepts new connections, each in the first free slot
+            if (m_role != NetworkRole::SERVER || packetType != CONNECT)
+                return;
+
+            const auto freeConnection = std::find_if(m_connections.begin(), m_connections.end(), [] (const Connection& connection)
+            {
+                return !connection.isActive;
+            });
+
+            if (freeConnection == m_connections.end())
+                return;
+
+            *freeConnection = Connection{ packet.address, 0.f, 0, false, true };
+            Logger::info("[NetworkSystem] The connection " + std::to_string(freeConnection - m_connections.begin()) + " has been established.");
+
+            return;
+        }
+
+        Connection& connection = m_connections[connectionIndex];
+        connection.timeSinceLastPacket = 0.f;
+
+        switch (packetType)
+        {
+            case SNAPSHOT:
+                if (m_role == NetworkRole::CLIENT)
+                {
+                    if (!connection.isActive)
+                        Logger::info("[NetworkSystem] The connection to the server has been established.");
+
+                    connection.isActive = true;
+                    processSnapshotFragment(packet.data.data() + PacketHeaderSize, reader.getRemainingSize());
+                }
+                break;
+
+            case ACK:
+            {
+                uint32_t tick{};
+
+                // Acknowledgements may arrive out of order, so only the most recent one is kept
+                if (reader.read(tick) && tick <= m_tick && (!connection.hasAcknowledged || tick > connection.acknowledgedTick))
+                {
+                    connection.acknowledgedTick = tick;
+                    connection.hasAcknowledged = true;
+                }
+                break;
+            }
+
+            case MESSAGE:
+                if (m_messageCallback && connection.isActive)
+                    m_messageCallback(connectionIndex, packet.data.data() + PacketHeaderSize, reader.getRemainingSize());
+                break;
+
+            case DISCONNECT:
+                if (connection.isActive)
+                    Logger::info("[NetworkSystem] The connection " + std::to_string(connectionIndex) + " has been closed by the remote end.");
+
+                closeConnection(connectionIndex);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    void NetworkSystem::closeConnection(std::size_t connectionIndex)
+    {
+        m_connections[connectionIndex].isActive = false;
+
+        if (m_role == NetworkRole::SERVER)
+            return;
+
+        // The next server may start over from any tick, so nothing received so far can be relied on anymore
+        m_tick = 0;
+        m_isRestorePending = false;
+        m_receivedFragments.clear();
+        m_receivedFragmentCount = 0;
+
+        for (WorldSnapshot& snapshot : m_snapshots)
+            snapshot.clear();
+    }
+
+    void NetworkSystem::processSnapshotFragment(const uint8_t* data, std::size_t size)
+    {
+        ByteReader reader(data, size);
+        uint32_t tick{};
+        uint16_t fragmentIndex{};
+        uint16_t fragmentCount{};
+
+        if (!reader.read(tick) || !reader.read(fragmentIndex) || !reader.read(fragmentCount) || fragmentIndex >= fragmentCount || fragmentCount > MaxFragmentCount)
+            return;
+
+        // Snapshots older than the last restored one are useless, their content being superseded
+        if (tick <= m_tick && m_tick != 0)
+            return;
+
+        const uint8_t* fragmentData = data + FragmentHeaderSize;
+        const std::size_t fragmentSize = reader.getRemainingSize();
+
+        // Most deltas fit in a single packet, & are decoded right from its buffer
+        if (fragmentCount == 1)
+        {
+            decodeSnapshot(fragmentData, fragmentSize);
+            return;
+        }
+
+        // Only the most recent snapshot is reassembled; fragments of an older one still being received are discarded
+        if (tick != m_assembledTick || m_receivedFragments.size() != fragmentCount)
+        {
+            if (tick < m_assembledTick && m_receivedFragmentCount > 0)
+                return;
+
+            m_assembledTick = tick;
+            m_receivedFragments.assign(fragmentCount, false);
+            m_receivedFragmentCount = 0;
+            m_assembledSize = 0;
+            m_snapshotBuffer.resize(fragmentCount * MaxFragmentSize);
+        }
+
+        // All fragments but the last one are full, so that each has a fixed place in the buffer
+        if (m_receivedFragments[fragmentIndex] || (fragmentIndex + 1u < fragmentCount && fragmentSize != MaxFragmentSize))
+            return;
+
+        std::memcpy(m_snapshotBuffer.data() + fragmentIndex * MaxFragmentSize, fragmentData, fragmentSize);
+        m_receivedFragments[fragmentIndex] = true;
+        m_assembledSize += fragmentSize;
+
+        if (++m_receivedFragmentCount == fragmentCount)
+        {
+            decodeSnapshot(m_snapshotBuffer.data(), m_assembledSize);
+            m_receivedFragments.clear();
+            m_receivedFragmentCount = 0;
+        }
+    }
+
+    void NetworkSystem::decodeSnapshot(const uint8_t* data, std::size_t size)
+    {
+        REI_PROFILE_ZONE("NetworkSystem::decodeSnapshot");
+
+        WorldSnapshot::Header header;
+
+        if (!WorldSnapshot::decodeHeader(data, size, header) || (header.tick <= m_tick && m_tick != 0))
+            return;
+
+        const WorldSnapshot* baseline{};
+
+        if (header.isDelta)
+        {
+            baseline = &m_snapshots[header.baselineTick % SnapshotHistorySize];
+
+            // The baseline may have been overwritten by a more recent snapshot, in which case the server will eventually send a newer delta
+            if (baseline->getTick() != header.baselineTick || baseline->isEmpty())
+                return;
+        }
+
+        if (!m_snapshots[header.tick % SnapshotHistorySize].decode(data, size, baseline))
+        {
+            Logger::warn("[NetworkSystem] The snapshot " + std::to_string(header.tick) + " couldn't be decoded.");
+            return;
+        }
+
+        m_tick = header.tick;
+        m_isRestorePending = true;
+
+        Packet* packet = createPacket(m_connections[0].address, ACK);
+
+        if (packet != nullptr)
+            writeValue(*packet, header.tick);
+    }
+
+    void NetworkSystem::sendSnapshots()
+    {
+        REI_PROFILE_ZONE("NetworkSystem::sendSnapshots");
+
+        if (std::none_of(m_connections.cbegin(), m_connections.cend(), [] (const Connection& connection) { return connection.isActive; }))
+            return;
+
+        ++m_tick;
+
+        WorldSnapshot& snapshot = m_snapshots[m_tick % SnapshotHistorySize];
+        snapshot.capture(*m_world, m_tick);
+
+        for (const Connection& connection : m_connections)
+        {
+            if (!connection.isActive)
+                continue;
+
+            const WorldSnapshot* baseline{};
+
+            if (connection.hasAcknowledged && m_tick - connection.acknowledgedTick < SnapshotHistorySize)
+            {
+                baseline = &m_snapshots[connection.acknowledgedTick % SnapshotHistorySize];
+
+                if (baseline->getTick() != connection.acknowledgedTick)
+                    baseline = nullptr;
+            }
+
+            m_snapshotBuffer.clear();
+
+            if (baseline)
+                snapshot.encodeDelta(*baseline, m_snapshotBuffer);
+            else
+                snapshot.encode(m_snapshotBuffer);
+
+            const std::size_t fragmentCount = (m_snapshotBuffer.size() + MaxFragmentSize - 1) / MaxFragmentSize;
+
+            if (fragmentCount > MaxFragmentCount)
+            {
+                Logger::error("[NetworkSystem] The snapshot " + std::to_string(m_tick) + " is too big to be sent.");
+                continue;
+            }
+
+            for (std::size_t fragmentIndex = 0; fragmentIndex < fragmentCount; ++fragmentIndex)
+            {
+                Packet* packet = createPacket(connection.address, SNAPSHOT);
+
+                if (packet == nullptr)
+                    break;
+
+                const std::size_t fragmentOffset = fragmentIndex * MaxFragmentSize;
+                const std::size_t fragmentSize = std::min(MaxFragmentSize, m_snapshotBuffer.size() - fragmentOffset);
+
+                writeValue(*packet, m_tick);
+                writeValue(*packet, static_cast<uint16_t>(fragmentIndex));
+                writeValue(*packet, static_cast<uint16_t>(fragmentCount));
+                std::memcpy(packet->data.data() + packet->size, m_snapshotBuffer.data() + fragmentOffset, fragmentSize);
+                packet->size += static_cast<uint32_t>(fragmentSize);
+            }
+        }
+    }
+
+    Packet* NetworkSystem::createPacket(const NetworkAddress& address, uint8_t packetType)
+    {
+        Packet* packet = m_sendPool.acquire();
+
+        if (packet == nullptr)
+        {
+            Logger::warn("[NetworkSystem] No packet is available; the packet to be sent has been dropped.");
+            return nullptr;
+        }
+
+        packet->address = address;
+        packet->size = 0;
+        writeValue(*packet, ProtocolId);
+        writeValue(*packet, packetType);
+
+        m_outgoingPackets.push_back(packet);
+
+        return packet;
+    }
+
+    void NetworkSystem::flushPackets()
+    {
+        if (m_outgoingPackets.empty())
+            return;
+
+        REI_PROFILE_ZONE("NetworkSystem::send");
+
+        m_socket.send(m_outgoingPackets.data(), m_outgoingPackets.size());
+
+        for (Packet* packet : m_outgoingPackets)
+            m_sendPool.release(*packet);
+
+        m_outgoingPackets.clear();
+    }
+
+} // namespace Rei
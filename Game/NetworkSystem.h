@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "Packet.h"
+#include "SpscQueue.h"
+#include "System.h"
+#include "UdpSocket.h"
+#include "WorldSnapshot.h"
+
+namespace Rei
+{
+
+    enum class NetworkRole
+    {
+        SERVER, ///< Sends its world's state to all connected clients.
+        CLIENT  ///< Replicates the server's world into its own.
+    };
+
+    /// System replicating a server's world into its clients' over UDP.
+    /// Every fixed step, the server captures a snapshot of its world & sends each client the delta against the last snapshot it acknowledged;
+    ///   clients restore each snapshot they receive into their world, & acknowledge it. Both ends can also exchange messages, such as inputs.
+    /// Packets are received by a dedicated I/O thread directly into pooled buffers, & handed to the update through a lock-free queue. Snapshots
+    ///   fitting in a single packet are decoded right from its buffer; the packets to be sent are batched, & all sent at the end of the update.
+    /// \note A client's world must only hold replicated entities, since the entities absent from the server's snapshots are destroyed; local
+    ///   entities (camera, interface, ...) must live in another world.
+    /// \note The system reads or writes every serializable component, & is therefore never updated concurrently with another system. The snapshots
+    ///   received by a client are restored through the world's command buffer, along with the other structural changes.
+    class NetworkSystem final : public System
+    {
+    public:
+        using MessageCallback = std::function<void(std::size_t connectionIndex, const uint8_t* data, std::size_t size)>;
+
+        static constexpr std::size_t MaxConnectionCount = 64;
+        /// Number of past snapshots kept as potential baselines for the deltas; a client lagging further behind is sent a full snapshot.
+        static constexpr std::size_t SnapshotHistorySize = 32;
+        /// Time without receiving anything after which a connection is considered lost, in seconds.
+        static constexpr float ConnectionTimeout = 5.f;
+        /// Time between two connection requests sent by a client which is not connected, in seconds.
+        static constexpr float ConnectionRequestInterval = 0.25f;
+
+        /// Creates a server.
+        /// \param port Port to listen on.
+        explicit NetworkSystem(uint16_t port);
+        /// Creates a client.
+        /// \param serverAddress Address of the server to connect to.
+        /// \param port Local port to bind to; if 0, any free port is picked.
+        explicit NetworkSystem(const NetworkAddress& serverAddress, uint16_t port = 0);
+
+        NetworkRole getRole() const noexcept { return m_role; }
+        bool isOpen() const noexcept { return m_socket.isOpen(); }
+        uint16_t getPort() const noexcept { return m_socket.getPort(); }
+        /// Gets the tick of the last snapshot sent by the server, or restored by the client.
+        uint32_t getTick() const noexcept { return m_tick; }
+        /// Checks if a connection is established; a client's only connection, to its server, has the index 0.
+        bool isConnected(std::size_t connectionIndex = 0) const noexcept { return m_connections[connectionIndex].isActive; }
+        std::size_t getConnectionCount() const noexcept;
+        const NetworkAddress& getConnectionAddress(std::size_t connectionIndex) const noexcept { return m_connections[connectionIndex].address; }
+        /// Gets the number of received packets dropped because the updates did not consume them fast enough.
+        std::size_t getDroppedPacketCount() const noexcept { return m_droppedPacketCount.load(std::memory_order_relaxed); }
+
+        /// Sets the function called during the update for each message received.
+        /// \param messageCallback Function to be called with the index of the connection the message comes from, & the message's content.
+        void setMessageCallback(MessageCallback messageCallback) { m_messageCallback = std::move(messageCallback); }
+
+        /// Queues a message, to be sent at the end of the next update.
+        /// \param connectionIndex Index of the connection to send the message to; each client only has the connection 0, to its server.
+        /// \param data Content of the message.
+        /// \param size Size of the message, in bytes; must fit in a single packet.
+        /// \return True if the message has been queued, false if it is too big, the connection isn't established or no packet is available.
+        bool sendMessage(std::size_t connectionIndex, const uint8_t* data, std::size_t size);
+
+        bool update(const FrameTimeInfo& timeInfo) override;
+        void destroy() override;
+
+        ~NetworkSystem() override { destroy(); }
+
+    private:
+        struct Connection
+        {
+            NetworkAddress address{};
+            float timeSinceLastPacket = 0.f;
+            uint32_t acknowledgedTick = 0;
+            bool hasAcknowledged = false;
+            bool isActive = false;
+        };
+
+        void startIoThread();
+        /// Receives packets until the system is destroyed, pushing them into the queue consumed by the update.
+        void runIoThread();
+        void processPacket(const Packet& packet);
+        /// Marks a connection as closed; a client also forgets about the snapshots it received, to be able to connect again to any server.
+        void closeConnection(std::size_t connectionIndex);
+        /// Stores a fragment of a snapshot, decoding the snapshot once all its fragments have been received.
+        void processSnapshotFragment(const uint8_t* data, std::size_t size);
+        void decodeSnapshot(const uint8_t* data, std::size_t size);
+        void sendSnapshots();
+        /// Takes a packet from the send pool & writes its header, the packet being sent at the end of the update.
+        /// \return Packet to write the rest of the content into, or nullptr if none is available.
+        Packet* createPacket(const NetworkAddress& address, uint8_t packetType);
+        void flushPackets();
+
+        NetworkRole m_role{};
+        float m_timeSinceConnectionRequest = ConnectionRequestInterval;
+
+        // The pools must outlive the socket & the queue, which hold some of their packets
+        PacketPool m_receivePool;
+        PacketPool m_sendPool;
+        UdpSocket m_socket{};
+        SpscQueue<Packet*> m_receivedPackets;
+        std::thread m_ioThread{};
+        std::atomic<bool> m_isRunning = false;
+        std::atomic<std::size_t> m_droppedPacketCount = 0;
+        std::vector<Packet*> m_outgoingPackets{};
+
+        std::array<Connection, MaxConnectionCount> m_connections{};
+        MessageCallback m_messageCallback{};
+
+        uint32_t m_tick = 0;
+        // Snapshots of the last ticks, indexed by tick modulo the history size
+        std::array<WorldSnapshot, SnapshotHistorySize> m_snapshots{};
+        std::vector<uint8_t> m_snapshotBuffer{}; // Encoded snapshot for the server, reassembled fragments for the client
+        uint32_t m_assembledTick = 0;
+        std::vector<char> m_receivedFragments{};
+        std::size_t m_receivedFragmentCount = 0;
+        std::size_t m_assembledSize = 0;
+        bool m_isRestorePending = false;
+    };
+
+} // namespace Rei
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cassert>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Rei
+{
+
+    /// Pool of fixed-size objects, allocated by chunks of contiguous memory.
+    /// Creating & destroying an object are constant-time operations which never touch the general heap once enough chunks have been allocated;
+    ///   the slots of destroyed objects are reused by the next ones to be created.
+    /// \note Objects never move in memory; pointers to them remain valid until they are destroyed.
+    /// \tparam T Type of the objects to be pooled.
+    /// \tparam ChunkSize Number of objects each chunk can hold.
+    template <typename T, std::size_t ChunkSize = 256>
+    class ObjectPool
+    {
+        static_assert(ChunkSize > 0, "Error: The pool's chunk size must be strictly positive.");
+
+    public:
+        /// Creates a pool, allocating the memory for at least the given number of objects.
+        /// \param capacity Number of objects the pool must be able to hold without any further allocation.
+        explicit ObjectPool(std::size_t capacity = 0) { reserve(capacity); }
+        ObjectPool(const ObjectPool&) = delete;
+        ObjectPool(ObjectPool&&) noexcept = delete;
+
+        std::size_t getSize() const noexcept { return m_size; }
+        std::size_t getCapacity() const noexcept { return m_chunks.size() * ChunkSize; }
+        bool isEmpty() const noexcept { return (m_size == 0); }
+
+        /// Allocates chunks until the pool can hold at least the given number of objects.
+        /// \param capacity Number of objects the pool must be able to hold.
+        void reserve(std::size_t capacity)
+        {
+            while (getCapacity() < capacity)
+                allocateChunk();
+        }
+
+        /// Constructs an object in a free slot, allocating a new chunk if none is available.
+        /// \tparam Args Types of the arguments to be forwarded to the object's constructor.
+        /// \param args Arguments to be forwarded to the object's constructor.
+        /// \return Reference to the newly created object.
+        template <typename... Args>
+        T& create(Args&&... args)
+        {
+            if (m_freeSlot == nullptr)
+                allocateChunk();
+
+            Slot* slot = m_freeSlot;
+            m_freeSlot = slot->nextFreeSlot; // Unlinked first, since the object overwrites it
+
+            T* object{};
+
+            try
+            {
+                object = new (slot->storage) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                slot->nextFreeSlot = m_freeSlot;
+                m_freeSlot = slot;
+                throw;
+            }
+
+            ++m_size;
+
+            return *object;
+        }
+
+        /// Destroys an object created by this pool, releasing its slot.
+        /// \param object Object to be destroyed.
+        void destroy(T& object) noexcept
+        {
+            assert("Error: The pool holds no object to be destroyed." && m_size > 0);
+
+            object.~T();
+
+            Slot* slot = reinterpret_cast<Slot*>(&object);
+            slot->nextFreeSlot = m_freeSlot;
+            m_freeSlot = slot;
+            --m_size;
+        }
+
+        ObjectPool& operator=(const ObjectPool&) = delete;
+        ObjectPool& operator=(ObjectPool&&) noexcept = delete;
+
+        ~ObjectPool() { assert("Error: All the pooled objects must be destroyed before their pool." && m_size == 0); }
+
+    private:
+        union Slot
+        {
+            Slot* nextFreeSlot;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        void allocateChunk()
+        {
+            Slot* chunk = m_chunks.emplace_back(std::make_unique<Slot[]>(ChunkSize)).get();
+
+            // Slots are linked in reverse order so that consecutive creations use consecutive memory
+            for (std::size_t slotIndex = ChunkSize; slotIndex > 0; --slotIndex)
+            {
+                chunk[slotIndex - 1].nextFreeSlot = m_freeSlot;
+                m_freeSlot = &chunk[slotIndex - 1];
+            }
+        }
+
+        std::vector<std::unique_ptr<Slot[]>> m_chunks{};
+        Slot* m_freeSlot{};
+        std::size_t m_size = 0;
+    };
+
+} // namespace Rei
@@ -0,0 +1,98 @@
+#include "Packet.h"
+
+#include <cassert>
+
+namespace Rei
+{
+
+    bool NetworkAddress::parse(std::string_view address, uint16_t port, NetworkAddress& result) noexcept
+    {
+        uint32_t host = 0;
+        std::size_t position = 0;
+
+        for (std::size_t byteIndex = 0; byteIndex < 4; ++byteIndex)
+        {
+            if (byteIndex > 0)
+            {
+                if (position >= address.size() || address[position] != '.')
+                    return false;
+
+                ++position;
+            }
+
+            uint32_t byte = 0;
+            const std::size_t firstDigit = position;
+
+            while (position < address.size() && address[position] >= '0' && address[position] <= '9' && position - firstDigit < 3)
+                byte = byte * 10 + static_cast<uint32_t>(address[position++] - '0');
+
+            if (position == firstDigit || byte > 255)
+                return false;
+
+            host = (host << 8) | byte;
+        }
+
+        if (position != address.size())
+            return false;
+
+        result.host = host;
+        result.port = port;
+
+        return true;
+    }
+
+    PacketPool::PacketPool(std::size_t packetCount)
+        : m_packetCount{ packetCount },
+          m_packets{ std::make_unique<Packet[]>(packetCount) },
+          m_nextFreeIndices{ std::make_unique<std::atomic<uint32_t>[]>(packetCount) },
+          m_freePacketCount{ packetCount }
+    {
+        assert("Error: A packet pool cannot hold that many packets." && packetCount < InvalidIndex);
+
+        for (std::size_t packetIndex = 0; packetIndex < packetCount; ++packetIndex)
+            m_nextFreeIndices[packetIndex].store((packetIndex + 1 < packetCount ? static_cast<uint32_t>(packetIndex + 1) : InvalidIndex), std::memory_order_relaxed);
+
+        m_freeListHead.store((packetCount > 0 ? 0 : InvalidIndex), std::memory_order_release);
+    }
+
+    Packet* PacketPool::acquire() noexcept
+    {
+        uint64_t head = m_freeListHead.load(std::memory_order_acquire);
+
+        while (true)
+        {
+            const uint32_t packetIndex = static_cast<uint32_t>(head);
+
+            if (packetIndex == InvalidIndex)
+                return nullptr;
+
+            // The next index may be stale if another thread took the packet in the meantime, in which case the exchange fails on the counter
+            const uint64_t nextHead = (((head >> 32) + 1) << 32) | m_nextFreeIndices[packetIndex].load(std::memory_order_relaxed);
+
+            if (m_freeListHead.compare_exchange_weak(head, nextHead, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                m_freePacketCount.fetch_sub(1, std::memory_order_relaxed);
+                return &m_packets[packetIndex];
+            }
+        }
+    }
+
+    void PacketPool::release(Packet& packet) noexcept
+    {
+        assert("Error: The released packet doesn't belong to this pool." && &packet >= m_packets.get() && &packet < m_packets.get() + m_packetCount);
+
+        const uint32_t packetIndex = static_cast<uint32_t>(&packet - m_packets.get());
+        uint64_t head = m_freeListHead.load(std::memory_order_relaxed);
+        uint64_t nextHead{};
+
+        do
+        {
+            m_nextFreeIndices[packetIndex].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            nextHead = (((head >> 32) + 1) << 32) | packetIndex;
+        }
+        while (!m_freeListHead.compare_exchange_weak(head, nextHead, std::memory_order_release, std::memory_order_relaxed));
+
+        m_freePacketCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+} // namespace Rei
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace Rei
+{
+
+    /// IPv4 address & port of a network endpoint, both in host byte order.
+    struct NetworkAddress
+    {
+        /// Parses a dotted IPv4 address, such as "127.0.0.1".
+        /// \param address Address to be parsed.
+        /// \param port Port of the endpoint.
+        /// \param result Address to be filled.
+        /// \return True if the address is valid, false otherwise.
+        static bool parse(std::string_view address, uint16_t port, NetworkAddress& result) noexcept;
+
+        bool operator==(const NetworkAddress& address) const noexcept { return (host == address.host && port == address.port); }
+        bool operator!=(const NetworkAddress& address) const noexcept { return !(*this == address); }
+
+        uint32_t host = 0;
+        uint16_t port = 0;
+    };
+
+    /// Datagram buffer, received into or sent from directly by the socket.
+    struct Packet
+    {
+        /// Maximum size of a datagram; kept below the usual Internet MTU, so that datagrams never get fragmented on the way.
+        static constexpr std::size_t MaxSize = 1200;
+
+        NetworkAddress address{};
+        uint32_t size = 0;
+        std::array<uint8_t, MaxSize> data{};
+    };
+
+    /// Preallocated set of packets, so that no memory is allocated while sending or receiving.
+    /// \note Packets can be acquired & released from any thread, without locking.
+    class PacketPool
+    {
+    public:
+        explicit PacketPool(std::size_t packetCount);
+        PacketPool(const PacketPool&) = delete;
+        PacketPool(PacketPool&&) noexcept = delete;
+
+        std::size_t getPacketCount() const noexcept { return m_packetCount; }
+        std::size_t getFreePacketCount() const noexcept { return m_freePacketCount.load(std::memory_order_relaxed); }
+
+        /// Takes a packet out of the pool.
+        /// \return Free packet, or nullptr if all of them are in use.
+        Packet* acquire() noexcept;
+        /// Gives a packet back to the pool.
+        /// \param packet Packet to be released; must have been acquired from this pool.
+        void release(Packet& packet) noexcept;
+
+        PacketPool& operator=(const PacketPool&) = delete;
+        PacketPool& operator=(PacketPool&&) noexcept = delete;
+
+    private:
+        static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+        std::size_t m_packetCount{};
+        std::unique_ptr<Packet[]> m_packets{};
+        std::unique_ptr<std::atomic<uint32_t>[]> m_nextFreeIndices{};
+        // Index of the first free packet in the low half, & in the high half a counter incremented by every change, so that a thread
+        //   which read the head before another acquired & released the same packet in the meantime does not overwrite the list (ABA problem)
+        std::atomic<uint64_t> m_freeListHead{};
+        std::atomic<std::size_t> m_freePacketCount{};
+    };
+
+} // namespace Rei
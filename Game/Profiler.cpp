@@ -0,0 +1,247 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <vector>
+
+namespace Rei
+{
+
+    namespace
+    {
+        struct ProfileEvent
+        {
+            enum class Type : uint8_t
+            {
+                ZONE,
+                FRAME,
+                MESSAGE
+            };
+
+            Type type = Type::ZONE;
+            const char* name{};
+            std::string message{};
+            int64_t beginTime = 0;
+            int64_t endTime = 0;
+            uint32_t threadIndex = 0;
+        };
+
+        /// Events recorded by a single thread, merged with the other threads' when the capture ends.
+        /// \note Its mutex is only contended when a capture begins or ends; threads thus never wait on each other to record events.
+        struct ThreadEvents
+        {
+            std::mutex mutex{};
+            std::vector<ProfileEvent> events{};
+            uint32_t threadIndex = 0;
+        };
+
+        std::atomic<bool> s_isCapturing = false;
+        std::mutex s_threadEventsMutex{};
+        /// Every thread's events, kept after their thread exits so that its last events still get exported.
+        std::vector<std::shared_ptr<ThreadEvents>> s_threadEvents{};
+
+        /// Gets the calling thread's events, registering them on the thread's first call.
+        /// Each thread gets a small index, which is far more readable in a trace than its actual identifier.
+        ThreadEvents& recoverThreadEvents()
+        {
+            thread_local const std::shared_ptr<ThreadEvents> threadEvents = []
+            {
+                auto events = std::make_shared<ThreadEvents>();
+
+                std::lock_guard<std::mutex> lock(s_threadEventsMutex);
+                events->threadIndex = static_cast<uint32_t>(s_threadEvents.size());
+                s_threadEvents.emplace_back(events);
+
+                return events;
+            }();
+
+            return *threadEvents;
+        }
+
+        void addEvent(ProfileEvent&& event)
+        {
+            ThreadEvents& threadEvents = recoverThreadEvents();
+            event.threadIndex = threadEvents.threadIndex;
+
+            std::lock_guard<std::mutex> lock(threadEvents.mutex);
+            threadEvents.events.emplace_back(std::move(event));
+        }
+
+        void writeEscaped(std::ofstream& file, std::string_view text)
+        {
+            for (const char character : text)
+            {
+                if (character == '"' || character == '\\')
+                    file << '\\' << character;
+                else if (static_cast<unsigned char>(character) < 0x20)
+                    file << ' ';
+                else
+                    file << character;
+            }
+        }
+    } // namespace
+
+    float TimingStatistics::computeAverage() const noexcept
+    {
+        if (m_sampleCount == 0)
+            return 0.f;
+
+        return std::accumulate(m_samples.cbegin(), m_samples.cbegin() + static_cast<std::ptrdiff_t>(m_sampleCount), 0.f) / static_cast<float>(m_sampleCount);
+    }
+
+    float TimingStatistics::computePercentile(float percentile) const noexcept
+    {
+        if (m_sampleCount == 0)
+            return 0.f;
+
+        // Samples are copied to be partially sorted, the window being small enough for it to stay cheap
+        std::array<float, WindowSize> samples = m_samples;
+        const auto rank = static_cast<std::size_t>(std::clamp(percentile, 0.f, 100.f) / 100.f * static_cast<float>(m_sampleCount - 1) + 0.5f);
+
+        std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(rank), samples.begin() + static_cast<std::ptrdiff_t>(m_sampleCount));
+        return samples[rank];
+    }
+
+    void TimingStatistics::addSample(float duration) noexcept
+    {
+        m_samples[m_nextIndex] = duration;
+        m_nextIndex   = (m_nextIndex + 1) % WindowSize;
+        m_sampleCount = std::min(m_sampleCount + 1, WindowSize);
+    }
+
+    void TimingStatistics::clear() noexcept
+    {
+        m_sampleCount = 0;
+        m_nextIndex   = 0;
+    }
+
+    int64_t Profiler::recoverTime() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool Profiler::isCapturing() noexcept
+    {
+        return s_isCapturing.load(std::memory_order_relaxed);
+    }
+
+    void Profiler::beginCapture()
+    {
+        std::lock_guard<std::mutex> lock(s_threadEventsMutex);
+
+        for (const std::shared_ptr<ThreadEvents>& threadEvents : s_threadEvents)
+        {
+            std::lock_guard<std::mutex> eventsLock(threadEvents->mutex);
+            threadEvents->events.clear();
+        }
+
+        s_isCapturing.store(true, std::memory_order_relaxed);
+    }
+
+    bool Profiler::endCapture(const std::string& filePath)
+    {
+        std::vector<ProfileEvent> events;
+
+        {
+            std::lock_guard<std::mutex> lock(s_threadEventsMutex);
+            s_isCapturing.store(false, std::memory_order_relaxed);
+
+            for (const std::shared_ptr<ThreadEvents>& threadEvents : s_threadEvents)
+            {
+                std::lock_guard<std::mutex> eventsLock(threadEvents->mutex);
+
+                events.insert(events.end(), std::make_move_iterator(threadEvents->events.begin()), std::make_move_iterator(threadEvents->events.end()));
+                threadEvents->events.clear();
+            }
+        }
+
+        std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+
+        if (!file)
+            return false;
+
+        const int64_t originTime = (events.empty() ? 0 : std::min_element(events.cbegin(), events.cend(), [] (const ProfileEvent& event1, const ProfileEvent& event2)
+        {
+            return (event1.beginTime < event2.beginTime);
+        })->beginTime);
+
+        // Times are given in microseconds, relative to the first event
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        for (std::size_t eventIndex = 0; eventIndex < events.size(); ++eventIndex)
+        {
+            const ProfileEvent& event = events[eventIndex];
+
+            file << (eventIndex == 0 ? "" : ",") << "{\"name\":\"";
+
+            switch (event.type)
+            {
+                case ProfileEvent::Type::ZONE:
+                    writeEscaped(file, event.name);
+                    file << "\",\"ph\":\"X\",\"dur\":" << static_cast<double>(event.endTime - event.beginTime) / 1000.0;
+                    break;
+
+                case ProfileEvent::Type::FRAME:
+                    file << "Frame\",\"ph\":\"i\",\"s\":\"g\"";
+                    break;
+
+                case ProfileEvent::Type::MESSAGE:
+                    writeEscaped(file, event.message);
+                    file << "\",\"ph\":\"i\",\"s\":\"t\"";
+                    break;
+            }
+
+            file << ",\"ts\":" << static_cast<double>(event.beginTime - originTime) / 1000.0 << ",\"pid\":0,\"tid\":" << event.threadIndex << '}';
+        }
+
+        file << "]}\n";
+
+        return static_cast<bool>(file);
+    }
+
+    void Profiler::addZone(const char* name, int64_t beginTime, int64_t endTime)
+    {
+        if (!isCapturing())
+            return;
+
+        ProfileEvent event;
+        event.type        = ProfileEvent::Type::ZONE;
+        event.name        = name;
+        event.beginTime   = beginTime;
+        event.endTime     = endTime;
+
+        addEvent(std::move(event));
+    }
+
+    void Profiler::markFrame()
+    {
+        if (!isCapturing())
+            return;
+
+        ProfileEvent event;
+        event.type        = ProfileEvent::Type::FRAME;
+        event.beginTime   = recoverTime();
+
+        addEvent(std::move(event));
+    }
+
+    void Profiler::addMessage(const char* text, std::size_t size)
+    {
+        if (!isCapturing())
+            return;
+
+        ProfileEvent event;
+        event.type        = ProfileEvent::Type::MESSAGE;
+        event.message.assign(text, size);
+        event.beginTime   = recoverTime();
+
+        addEvent(std::move(event));
+    }
+
+} // namespace Rei
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Profiling markers are compiled out unless either switch is defined:
+// - REI_USE_TRACY forwards them to Tracy, which must then be in the include path & linked (TRACY_ENABLE being defined as well);
+// - REI_ENABLE_PROFILING records them with the built-in profiler, whose captures are exported as Chrome traces (chrome://tracing, Perfetto).
+
+#if defined(REI_USE_TRACY)
+#include <tracy/Tracy.hpp>
+
+#define REI_PROFILE_ZONE(name) ZoneScopedN(name)
+#define REI_PROFILE_FRAME() FrameMark
+#define REI_PROFILE_MESSAGE(text, size, color) TracyMessageC(text, size, color)
+#elif defined(REI_ENABLE_PROFILING)
+#define REI_PROFILE_CONCAT_IMPL(first, second) first##second
+#define REI_PROFILE_CONCAT(first, second) REI_PROFILE_CONCAT_IMPL(first, second)
+
+#define REI_PROFILE_ZONE(name) const ::Rei::ProfileZone REI_PROFILE_CONCAT(reiProfileZone, __LINE__)(name)
+#define REI_PROFILE_FRAME() ::Rei::Profiler::markFrame()
+#define REI_PROFILE_MESSAGE(text, size, color) ::Rei::Profiler::addMessage(text, size)
+#else
+#define REI_PROFILE_ZONE(name) do {} while (false)
+#define REI_PROFILE_FRAME() do {} while (false)
+#define REI_PROFILE_MESSAGE(text, size, color) do {} while (false)
+#endif
+
+namespace Rei
+{
+
+    /// Rolling statistics over the durations measured during the last frames.
+    class TimingStatistics
+    {
+    public:
+        /// Number of frames the statistics are computed over.
+        static constexpr std::size_t WindowSize = 128;
+
+        std::size_t getSampleCount() const noexcept { return m_sampleCount; }
+        /// Gets the last measured duration, in milliseconds.
+        float getLastDuration() const noexcept { return (m_sampleCount == 0 ? 0.f : m_samples[(m_nextIndex + WindowSize - 1) % WindowSize]); }
+
+        /// Computes the average duration over the window, in milliseconds.
+        float computeAverage() const noexcept;
+        /// Computes the duration below which the given proportion of the samples lie, in milliseconds.
+        /// \param percentile Proportion of the samples, between 0 & 100.
+        /// \return Percentile of the durations; 0 if there is no sample.
+        float computePercentile(float percentile) const noexcept;
+        float computeMaximum() const noexcept { return computePercentile(100.f); }
+        /// Adds a duration, replacing the oldest one if the window is full.
+        /// \param duration Duration to be added, in milliseconds.
+        void addSample(float duration) noexcept;
+        void clear() noexcept;
+
+    private:
+        std::array<float, WindowSize> m_samples{};
+        std::size_t m_sampleCount = 0;
+        std::size_t m_nextIndex = 0;
+    };
+
+    /// Built-in profiler, recording timed zones into captures exported as Chrome traces.
+    /// The systems' updates are always recorded while capturing, so that a capture can be taken without a profiling build.
+    /// Each thread records its events into its own buffer, the buffers being merged when the capture ends.
+    class Profiler
+    {
+    public:
+        Profiler() = delete;
+
+        /// Gets the current time in nanoseconds, from the clock the recorded zones are measured with.
+        static int64_t recoverTime() noexcept;
+        static bool isCapturing() noexcept;
+
+        /// Starts a capture, discarding the events of any previous one.
+        static void beginCapture();
+        /// Ends the current capture & writes it in the Chrome trace event format.
+        /// \param filePath Path to the file to write the trace into.
+        /// \return True if the file has been written, false otherwise.
+        static bool endCapture(const std::string& filePath);
+        /// Records a zone if a capture is ongoing.
+        /// \param name Name of the zone; only its address is stored, & it must thus live until the capture is ended.
+        /// \param beginTime Time at which the zone began, as given by recoverTime().
+        /// \param endTime Time at which the zone ended, as given by recoverTime().
+        static void addZone(const char* name, int64_t beginTime, int64_t endTime);
+        /// Records the end of a frame if a capture is ongoing.
+        static void markFrame();
+        /// Records a message if a capture is ongoing.
+        /// \param text Message to be recorded, which is copied.
+        /// \param size Length of the message.
+        static void addMessage(const char* text, std::size_t size);
+
+        ~Profiler() = delete;
+    };
+
+    /// Zone recorded from its construction to its destruction, if a capture is ongoing at its construction.
+    class ProfileZone
+    {
+    public:
+        explicit ProfileZone(const char* name) noexcept : m_name{ name }, m_beginTime{ Profiler::isCapturing() ? Profiler::recoverTime() : -1 } {}
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone(ProfileZone&&) noexcept = delete;
+
+        ProfileZone& operator=(const ProfileZone&) = delete;
+        ProfileZone& operator=(ProfileZone&&) noexcept = delete;
+
+        ~ProfileZone()
+        {
+            if (m_beginTime >= 0)
+                Profiler::addZone(m_name, m_beginTime, Profiler::recoverTime());
+        }
+
+    private:
+        const char* m_name{};
+        int64_t m_beginTime = -1;
+    };
+
+} // namespace Rei
@@ -0,0 +1,299 @@
+#pragma once
+#include <cassert>
+#include <cmath>
+#include <ostream>
+#include <type_traits>
+
+#include "FloatUtils.h"
+#include "Matrix.h"
+#include "Vector.h"
+
+namespace Rei {
+
+    /// Quaternion class, representing a rotation in 3D space.
+    /// Its values are stored as (x, y, z, w), so that a single-precision quaternion can be loaded into a SIMD register at once.
+    /// \tparam T Type of the quaternion's data; must be floating-point.
+    template <typename T = float>
+    class Quaternion {
+        static_assert(std::is_floating_point_v<T>, "Error: The quaternion's type must be floating-point.");
+
+    public:
+        constexpr Quaternion() noexcept = default;
+        /// Creates a quaternion from its real (w) & imaginary (x, y, z) parts.
+        constexpr Quaternion(T w, T x, T y, T z) noexcept : m_data(x, y, z, w) {}
+        /// Creates a quaternion representing a rotation around the given axis.
+        /// \param angle Angle of the rotation, in radians.
+        /// \param axis Axis to rotate around; must be normalized.
+        Quaternion(T angle, const Vec3<T>& axis) noexcept;
+        constexpr Quaternion(const Quaternion&) noexcept = default;
+        constexpr Quaternion(Quaternion&&) noexcept = default;
+
+        constexpr const Vec4<T>& getData() const noexcept { return m_data; }
+        constexpr const T* getDataPtr() const noexcept { return m_data.getDataPtr(); }
+        constexpr T w() const noexcept { return m_data.w(); }
+        constexpr T x() const noexcept { return m_data.x(); }
+        constexpr T y() const noexcept { return m_data.y(); }
+        constexpr T z() const noexcept { return m_data.z(); }
+
+        /// Creates a quaternion representing no rotation.
+        /// \return Identity quaternion.
+        static constexpr Quaternion identity() noexcept { return Quaternion(1, 0, 0, 0); }
+        /// Recovers the rotation represented by a pure rotation matrix (orthonormal, with a determinant of 1).
+        /// \param rotation Rotation matrix.
+        /// \return Normalized quaternion representing the same rotation.
+        static Quaternion fromRotationMatrix(const Mat3<T>& rotation) noexcept;
+        /// Computes the dot product between quaternions.
+        /// \param quat Quaternion to compute the dot product with.
+        /// \return Quaternions' dot product.
+        constexpr T dot(const Quaternion& quat) const noexcept { return m_data.dot(quat.m_data); }
+        /// Computes the squared norm of the quaternion.
+        /// \return Quaternion's squared norm.
+        constexpr T computeSquaredNorm() const noexcept { return m_data.computeSquaredLength(); }
+        /// Computes the norm of the quaternion.
+        /// \return Quaternion's norm.
+        T computeNorm() const noexcept { return m_data.computeLength(); }
+        /// Computes the normalized quaternion, of norm 1.
+        /// \return Normalized quaternion.
+        Quaternion normalize() const noexcept { return Quaternion(m_data.normalize()); }
+        /// Computes the conjugate quaternion, whose imaginary part is negated.
+        /// \return Conjugate quaternion.
+        constexpr Quaternion conjugate() const noexcept { return Quaternion(w(), -x(), -y(), -z()); }
+        /// Computes the inverse quaternion, representing the opposite rotation.
+        /// \return Inverse quaternion.
+        constexpr Quaternion inverse() const noexcept;
+        /// Computes the normalized linear interpolation between quaternions, taking the shortest path.
+        /// Faster than a spherical interpolation, but does not rotate at constant speed.
+        /// \param quat Quaternion to be interpolated with.
+        /// \param coeff Coefficient between 0 (returns the current quaternion) & 1 (returns the given one).
+        /// \return Normalized interpolated quaternion.
+        Quaternion nlerp(const Quaternion& quat, T coeff) const noexcept;
+        /// Computes the spherical linear interpolation between normalized quaternions, taking the shortest path.
+        /// \param quat Quaternion to be interpolated with.
+        /// \param coeff Coefficient between 0 (returns the current quaternion) & 1 (returns the given one).
+        /// \return Normalized interpolated quaternion.
+        Quaternion slerp(const Quaternion& quat, T coeff) const noexcept;
+        /// Computes the rotation matrix represented by the quaternion; the latter must be normalized.
+        /// \return 3x3 rotation matrix.
+        constexpr Mat3<T> computeRotationMatrix() const noexcept;
+        /// Checks for strict equality between the current quaternion & the given one.
+        /// \param quat Quaternion to be compared with.
+        /// \return True if quaternions are strictly equal to each other, false otherwise.
+        constexpr bool strictlyEquals(const Quaternion& quat) const noexcept { return m_data.strictlyEquals(quat.m_data); }
+
+        /// Default copy assignment operator.
+        /// \return Reference to the copied quaternion.
+        constexpr Quaternion& operator=(const Quaternion&) noexcept = default;
+        /// Default move assignment operator.
+        /// \return Reference to the moved quaternion.
+        constexpr Quaternion& operator=(Quaternion&&) noexcept = default;
+        /// Quaternion multiplication operator, combining rotations; the given one is applied first.
+        /// \param quat Quaternion to be multiplied by.
+        /// \return Product of the quaternions.
+        constexpr Quaternion operator*(const Quaternion& quat) const noexcept;
+        /// Quaternion multiplication assignment operator.
+        /// \param quat Quaternion to be multiplied by.
+        /// \return Reference to the modified original quaternion.
+        constexpr Quaternion& operator*=(const Quaternion& quat) noexcept { return (*this = *this * quat); }
+        /// Vector rotation operator; the quaternion must be normalized.
+        /// \param vec Vector to be rotated.
+        /// \return Rotated vector.
+        constexpr Vec3<T> operator*(const Vec3<T>& vec) const noexcept;
+        /// Quaternion equality comparison operator.
+        /// Uses a near-equality check to take floating-point errors into account.
+        /// \param quat Quaternion to be compared with.
+        /// \return True if quaternions are [nearly] equal, else otherwise.
+        constexpr bool operator==(const Quaternion& quat) const noexcept { return (m_data == quat.m_data); }
+        /// Quaternion inequality comparison operator.
+        /// Uses a near-equality check to take floating-point errors into account.
+        /// \param quat Quaternion to be compared with.
+        /// \return True if quaternions are different, else otherwise.
+        constexpr bool operator!=(const Quaternion& quat) const noexcept { return !(*this == quat); }
+        /// Output stream operator.
+        /// \param stream Stream to output into.
+        /// \param quat Quaternion to be output.
+        friend std::ostream& operator<<(std::ostream& stream, const Quaternion& quat) {
+            return stream << "[ " << quat.w() << ", " << quat.x() << ", " << quat.y() << ", " << quat.z() << " ]";
+        }
+
+    private:
+        constexpr explicit Quaternion(const Vec4<T>& data) noexcept : m_data(data) {}
+
+        Vec4<T> m_data = Vec4<T>(0, 0, 0, 1);
+    };
+
+    // Aliases
+
+    using Quaternionf = Quaternion<float>;
+    using Quaterniond = Quaternion<double>;
+
+    /// Composes a transformation matrix, applying the scale first, then the rotation & finally the translation.
+    /// \param translation Translation to be applied.
+    /// \param rotation Rotation to be applied; must be normalized.
+    /// \param scale Scale to be applied.
+    /// \return 4x4 TRS transformation matrix.
+    template <typename T>
+    constexpr Mat4<T> composeTrs(const Vec3<T>& translation, const Quaternion<T>& rotation, const Vec3<T>& scale) noexcept;
+    /// Decomposes a transformation matrix made of a translation, a rotation & a positive scale.
+    /// \note Neither shearing nor negative scaling can be recovered.
+    /// \param transform Transformation matrix to be decomposed.
+    /// \param translation Recovered translation.
+    /// \param rotation Recovered normalized rotation.
+    /// \param scale Recovered scale.
+    template <typename T>
+    void decomposeTrs(const Mat4<T>& transform, Vec3<T>& translation, Quaternion<T>& rotation, Vec3<T>& scale) noexcept;
+
+    template <typename T>
+    Quaternion<T>::Quaternion(T angle, const Vec3<T>& axis) noexcept {
+        const T halfAngle = angle / 2;
+        const T sinHalfAngle = std::sin(halfAngle);
+
+        m_data = Vec4<T>(axis.x() * sinHalfAngle, axis.y() * sinHalfAngle, axis.z() * sinHalfAngle, std::cos(halfAngle));
+    }
+
+    template <typename T>
+    Quaternion<T> Quaternion<T>::fromRotationMatrix(const Mat3<T>& rotation) noexcept {
+        const T m00 = rotation.getElement(0, 0);
+        const T m11 = rotation.getElement(1, 1);
+        const T m22 = rotation.getElement(2, 2);
+        const T trace = m00 + m11 + m22;
+
+        // The largest of the four possible divisors is chosen to avoid dividing by a value close to 0
+        if (trace > 0) {
+            const T factor = std::sqrt(trace + 1) * 2;
+            return Quaternion(factor / 4,
+                              (rotation.getElement(1, 2) - rotation.getElement(2, 1)) / factor,
+                              (rotation.getElement(2, 0) - rotation.getElement(0, 2)) / factor,
+                              (rotation.getElement(0, 1) - rotation.getElement(1, 0)) / factor).normalize();
+        }
+
+        if (m00 > m11 && m00 > m22) {
+            const T factor = std::sqrt(1 + m00 - m11 - m22) * 2;
+            return Quaternion((rotation.getElement(1, 2) - rotation.getElement(2, 1)) / factor,
+                              factor / 4,
+                              (rotation.getElement(1, 0) + rotation.getElement(0, 1)) / factor,
+                              (rotation.getElement(2, 0) + rotation.getElement(0, 2)) / factor).normalize();
+        }
+
+        if (m11 > m22) {
+            const T factor = std::sqrt(1 + m11 - m00 - m22) * 2;
+            return Quaternion((rotation.getElement(2, 0) - rotation.getElement(0, 2)) / factor,
+                              (rotation.getElement(1, 0) + rotation.getElement(0, 1)) / factor,
+                              factor / 4,
+                              (rotation.getElement(2, 1) + rotation.getElement(1, 2)) / factor).normalize();
+        }
+
+        const T factor = std::sqrt(1 + m22 - m00 - m11) * 2;
+        return Quaternion((rotation.getElement(0, 1) - rotation.getElement(1, 0)) / factor,
+                          (rotation.getElement(2, 0) + rotation.getElement(0, 2)) / factor,
+                          (rotation.getElement(2, 1) + rotation.getElement(1, 2)) / factor,
+                          factor / 4).normalize();
+    }
+
+    template <typename T>
+    constexpr Quaternion<T> Quaternion<T>::inverse() const noexcept {
+        const T sqNorm = computeSquaredNorm();
+        assert("Error: A quaternion of norm 0 cannot be inverted." && sqNorm != 0);
+
+        return Quaternion(conjugate().m_data / sqNorm);
+    }
+
+    template <typename T>
+    Quaternion<T> Quaternion<T>::nlerp(const Quaternion& quat, T coeff) const noexcept {
+        assert("Error: The interpolation coefficient must be between 0 & 1." && (coeff >= 0 && coeff <= 1));
+
+        // q & -q represent the same rotation; the closest one is taken to interpolate along the shortest path
+        const Vec4<T> target = (dot(quat) < 0 ? -quat.m_data : quat.m_data);
+        return Quaternion(m_data.lerp(target, coeff)).normalize();
+    }
+
+    template <typename T>
+    Quaternion<T> Quaternion<T>::slerp(const Quaternion& quat, T coeff) const noexcept {
+        assert("Error: The interpolation coefficient must be between 0 & 1." && (coeff >= 0 && coeff <= 1));
+
+        T cosAngle = dot(quat);
+        Vec4<T> target = quat.m_data;
+
+        if (cosAngle < 0) {
+            cosAngle = -cosAngle;
+            target = -target;
+        }
+
+        // Quaternions too close to each other would make the sine tend to 0; a linear interpolation is then precise enough
+        if (cosAngle > static_cast<T>(0.9995))
+            return Quaternion(m_data.lerp(target, coeff)).normalize();
+
+        const T angle = std::acos(cosAngle);
+        const T invSinAngle = 1 / std::sin(angle);
+        const T currentCoeff = std::sin((1 - coeff) * angle) * invSinAngle;
+        const T targetCoeff = std::sin(coeff * angle) * invSinAngle;
+
+        return Quaternion(m_data * currentCoeff + target * targetCoeff);
+    }
+
+    template <typename T>
+    constexpr Mat3<T> Quaternion<T>::computeRotationMatrix() const noexcept {
+        const T xx = x() * x();
+        const T yy = y() * y();
+        const T zz = z() * z();
+        const T xy = x() * y();
+        const T xz = x() * z();
+        const T yz = y() * z();
+        const T wx = w() * x();
+        const T wy = w() * y();
+        const T wz = w() * z();
+
+        return Mat3<T>(1 - 2 * (yy + zz),     2 * (xy - wz),     2 * (xz + wy),
+                           2 * (xy + wz), 1 - 2 * (xx + zz),     2 * (yz - wx),
+                           2 * (xz - wy),     2 * (yz + wx), 1 - 2 * (xx + yy));
+    }
+
+    template <typename T>
+    constexpr Quaternion<T> Quaternion<T>::operator*(const Quaternion& quat) const noexcept {
+        return Quaternion(w() * quat.w() - x() * quat.x() - y() * quat.y() - z() * quat.z(),
+                          w() * quat.x() + x() * quat.w() + y() * quat.z() - z() * quat.y(),
+                          w() * quat.y() - x() * quat.z() + y() * quat.w() + z() * quat.x(),
+                          w() * quat.z() + x() * quat.y() - y() * quat.x() + z() * quat.w());
+    }
+
+    template <typename T>
+    constexpr Vec3<T> Quaternion<T>::operator*(const Vec3<T>& vec) const noexcept {
+        // v' = v + 2w (u x v) + 2 (u x (u x v)), u being the imaginary part; cheaper than computing q * v * q^-1
+        const Vec3<T> imaginary(x(), y(), z());
+        const Vec3<T> uv = imaginary.cross(vec) * static_cast<T>(2);
+
+        return vec + uv * w() + imaginary.cross(uv);
+    }
+
+    template <typename T>
+    constexpr Mat4<T> composeTrs(const Vec3<T>& translation, const Quaternion<T>& rotation, const Vec3<T>& scale) noexcept {
+        const Mat3<T> rotationMat = rotation.computeRotationMatrix();
+        Mat4<T> res;
+
+        for (std::size_t widthIndex = 0; widthIndex < 3; ++widthIndex) {
+            for (std::size_t heightIndex = 0; heightIndex < 3; ++heightIndex)
+                res.getElement(widthIndex, heightIndex) = rotationMat.getElement(widthIndex, heightIndex) * scale[widthIndex];
+        }
+
+        res.setColumn(3, Vec4<T>(translation, 1));
+
+        return res;
+    }
+
+    template <typename T>
+    void decomposeTrs(const Mat4<T>& transform, Vec3<T>& translation, Quaternion<T>& rotation, Vec3<T>& scale) noexcept {
+        translation = Vec3<T>(transform.recoverColumn(3));
+
+        Mat3<T> rotationMat;
+
+        for (std::size_t widthIndex = 0; widthIndex < 3; ++widthIndex) {
+            const Vec3<T> column(transform.recoverColumn(widthIndex));
+            scale[widthIndex] = column.computeLength();
+
+            assert("Error: A transformation matrix with a scale of 0 cannot be decomposed." && scale[widthIndex] != 0);
+            rotationMat.setColumn(widthIndex, column / scale[widthIndex]);
+        }
+
+        rotation = Quaternion<T>::fromRotationMatrix(rotationMat);
+    }
+
+} // namespace Rei
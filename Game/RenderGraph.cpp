@@ -0,0 +1,474 @@
+#include "RenderGraph.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "CommandRecorder.h"
+#include "ThreadPool.h"
+
+namespace Rei
+{
+
+    std::size_t RenderGraph::getTransientMemorySize() const noexcept
+    {
+        std::size_t memorySize = 0;
+
+        for (const PhysicalTexture& physicalTexture : m_physicalTextures)
+            memorySize += physicalTexture.descriptor.computeByteSize();
+
+        return memorySize;
+    }
+
+    void RenderGraph::setTextureFactory(TextureFactory factory)
+    {
+        m_textureFactory = std::move(factory);
+
+        // The textures created by the previous factory are replaced on the next compilation
+        m_physicalTextures.clear();
+        m_isCompiled = false;
+    }
+
+    RenderTextureHandle RenderGraph::createTexture(const TextureDescriptor& descriptor)
+    {
+        m_textures.emplace_back().descriptor = descriptor;
+        m_isCompiled = false;
+
+        return RenderTextureHandle{ static_cast<uint32_t>(m_textures.size() - 1) };
+    }
+
+    RenderTextureHandle RenderGraph::importTexture(Texture2DPtr texture, const TextureDescriptor& descriptor)
+    {
+        TextureResource& resource = m_textures.emplace_back();
+        resource.descriptor = descriptor;
+        resource.importedTexture = std::move(texture);
+        resource.isImported = true;
+        m_isCompiled = false;
+
+        return RenderTextureHandle{ static_cast<uint32_t>(m_textures.size() - 1) };
+    }
+
+    const TextureDescriptor& RenderGraph::getTextureDescriptor(const RenderTextureHandle& handle) const
+    {
+        if (handle.index >= m_textures.size())
+            throw std::invalid_argument("Error: The given render texture does not exist");
+
+        return m_textures[handle.index].descriptor;
+    }
+
+    void RenderGraph::removeNode(RenderPass& pass)
+    {
+        for (const auto& node : m_nodes)
+        {
+            std::vector<RenderPass*>& dependencies = node->m_explicitDependencies;
+            dependencies.erase(std::remove(dependencies.begin(), dependencies.end(), &pass), dependencies.end());
+        }
+
+        Graph::removeNode(pass);
+        m_isCompiled = false;
+    }
+
+    void RenderGraph::compile()
+    {
+        if (!isCompilationNeeded())
+            return;
+
+        linkPasses();
+        cullPasses();
+        orderPasses();
+        aliasTextures();
+
+        for (const auto& node : m_nodes)
+            node->m_isDirty = false;
+
+        m_isCompiled = true;
+    }
+
+    bool RenderGraph::execute(ThreadPool* threadPool)
+    {
+        compile();
+
+        if (m_recorder != nullptr)
+        {
+            if (m_executionOrder.empty())
+                return false;
+
+            const std::size_t passCount    = m_executionOrder.size();
+            const std::size_t contextCount = (threadPool == nullptr ? 1 : std::min(passCount, std::max<std::size_t>(m_recorder->getContextCount(), 1)));
+            std::vector<std::size_t> stateChangeCounts(contextCount, 0);
+
+            // Passes are split as evenly as possible, keeping their order; each context's commands thus directly follow the previous one's
+            const auto recordContexts = [this, passCount, contextCount, &stateChangeCounts](std::size_t beginIndex, std::size_t endIndex)
+            {
+                for (std::size_t contextIndex = beginIndex; contextIndex < endIndex; ++contextIndex)
+                {
+                    stateChangeCounts[contextIndex] = recordPasses(contextIndex,
+                                                                   passCount * contextIndex / contextCount,
+                                                                   passCount * (contextIndex + 1) / contextCount);
+                }
+            };
+
+            if (contextCount > 1)
+                threadPool->parallelFor(contextCount, 1, recordContexts);
+            else
+                recordContexts(0, 1);
+
+            for (std::size_t contextIndex = 0; contextIndex < contextCount; ++contextIndex)
+                m_recorder->execute(contextIndex);
+
+            m_stateChangeCount = 0;
+
+            for (const std::size_t stateChangeCount : stateChangeCounts)
+                m_stateChangeCount += stateChangeCount;
+
+            return true;
+        }
+
+        const RenderPassResources resources(*this);
+        uint64_t currentStateKey = 0;
+        m_stateChangeCount = 0;
+
+        for (RenderPass* pass : m_executionOrder)
+        {
+            if (m_stateChangeCount == 0 || pass->m_stateKey != currentStateKey)
+            {
+                if (m_stateApplier)
+                    m_stateApplier(pass->m_stateKey);
+
+                currentStateKey = pass->m_stateKey;
+                ++m_stateChangeCount;
+            }
+
+            if (pass->m_execution)
+                pass->m_execution(resources);
+        }
+
+        return !m_executionOrder.empty();
+    }
+
+    std::size_t RenderGraph::recordPasses(std::size_t contextIndex, std::size_t beginPosition, std::size_t endPosition) const
+    {
+        DrawSubmitter& submitter = m_recorder->beginRecording(contextIndex);
+        const RenderPassResources resources(*this, &submitter, contextIndex);
+        std::size_t stateChangeCount = 0;
+
+        for (std::size_t position = beginPosition; position < endPosition; ++position)
+        {
+            const RenderPass& pass = *m_executionOrder[position];
+
+            // A command list starting from the default state, the first pass always binds its own
+            if (position == beginPosition || pass.m_stateKey != m_executionOrder[position - 1]->m_stateKey)
+            {
+                m_recorder->bindState(contextIndex, pass.m_stateKey);
+                ++stateChangeCount;
+            }
+
+            if (pass.m_execution)
+                pass.m_execution(resources);
+        }
+
+        m_recorder->endRecording(contextIndex);
+
+        return stateChangeCount;
+    }
+
+    bool RenderGraph::isCompilationNeeded() const noexcept
+    {
+        if (!m_isCompiled)
+            return true;
+
+        return std::any_of(m_nodes.cbegin(), m_nodes.cend(), [](const auto& node) { return node->m_isDirty; });
+    }
+
+    const Texture2DPtr& RenderGraph::recoverTexture(const RenderTextureHandle& handle) const
+    {
+        static const Texture2DPtr nullTexture{};
+
+        if (handle.index >= m_textures.size())
+            throw std::invalid_argument("Error: The given render texture does not exist");
+
+        const TextureResource& resource = m_textures[handle.index];
+
+        if (resource.isImported)
+            return resource.importedTexture;
+
+        return (resource.physicalIndex == InvalidIndex ? nullTexture : m_physicalTextures[resource.physicalIndex].texture);
+    }
+
+    void RenderGraph::validateTextures(const RenderPass& pass) const
+    {
+        for (const RenderTextureHandle& texture : pass.m_readTextures)
+            getTextureDescriptor(texture);
+
+        for (const auto& [texture, index] : pass.m_writtenColorTextures)
+        {
+            if (isDepthFormat(getTextureDescriptor(texture).format))
+                throw std::invalid_argument("Error: The render pass '" + pass.m_name + "' writes a depth texture as a color one");
+        }
+
+        if (!pass.m_writtenDepthTexture.isNull() && !isDepthFormat(getTextureDescriptor(pass.m_writtenDepthTexture).format))
+            throw std::invalid_argument("Error: The render pass '" + pass.m_name + "' writes a color texture as a depth one");
+    }
+
+    void RenderGraph::linkPasses()
+    {
+        for (const auto& node : m_nodes)
+        {
+            node->m_parents.clear();
+            node->m_children.clear();
+        }
+
+        struct TextureAccesses
+        {
+            RenderPass* lastWriter{};
+            std::vector<RenderPass*> readersSinceWrite{};
+        };
+
+        std::vector<TextureAccesses> accesses(m_textures.size());
+
+        // A reader depends on the last pass having written the texture before it; a writer depends on the previous writer & on all readers since,
+        //  which must be done before the texture is overwritten
+        const auto addWrite = [&accesses](RenderPass& pass, const RenderTextureHandle& texture)
+        {
+            TextureAccesses& textureAccesses = accesses[texture.index];
+
+            if (textureAccesses.lastWriter && textureAccesses.lastWriter != &pass)
+                pass.addParents(*textureAccesses.lastWriter);
+
+            for (RenderPass* reader : textureAccesses.readersSinceWrite)
+            {
+                if (reader != &pass)
+                    pass.addParents(*reader);
+            }
+
+            textureAccesses.lastWriter = &pass;
+            textureAccesses.readersSinceWrite.clear();
+        };
+
+        for (const auto& node : m_nodes)
+        {
+            RenderPass& pass = *node;
+
+            // Disabled passes are left out of the graph, as if they had been removed
+            if (!pass.m_isEnabled)
+                continue;
+
+            validateTextures(pass);
+
+            for (RenderPass* dependency : pass.m_explicitDependencies)
+            {
+                if (dependency->m_isEnabled)
+                    pass.addParents(*dependency);
+            }
+
+            for (const RenderTextureHandle& texture : pass.m_readTextures)
+            {
+                TextureAccesses& textureAccesses = accesses[texture.index];
+
+                if (textureAccesses.lastWriter && textureAccesses.lastWriter != &pass)
+                    pass.addParents(*textureAccesses.lastWriter);
+
+                textureAccesses.readersSinceWrite.emplace_back(&pass);
+            }
+
+            for (const auto& [texture, index] : pass.m_writtenColorTextures)
+                addWrite(pass, texture);
+
+            if (!pass.m_writtenDepthTexture.isNull())
+                addWrite(pass, pass.m_writtenDepthTexture);
+        }
+    }
+
+    void RenderGraph::cullPasses()
+    {
+        std::vector<RenderPass*> alivePasses;
+
+        for (const auto& node : m_nodes)
+        {
+            RenderPass& pass = *node;
+            pass.m_isCulled = true;
+
+            if (!pass.m_isEnabled)
+                continue;
+
+            bool isOutput = pass.m_hasSideEffects
+                         || (!pass.m_writtenDepthTexture.isNull() && m_textures[pass.m_writtenDepthTexture.index].isImported);
+
+            for (const auto& [texture, index] : pass.m_writtenColorTextures)
+                isOutput = isOutput || m_textures[texture.index].isImported;
+
+            if (isOutput)
+                alivePasses.emplace_back(&pass);
+        }
+
+        // Every pass an output depends on, directly or not, is kept; all others produce nothing that is used
+        while (!alivePasses.empty())
+        {
+            RenderPass* pass = alivePasses.back();
+            alivePasses.pop_back();
+
+            if (!pass->m_isCulled)
+                continue;
+
+            pass->m_isCulled = false;
+
+            for (RenderPass* parent : pass->m_parents)
+            {
+                if (parent->m_isCulled)
+                    alivePasses.emplace_back(parent);
+            }
+        }
+    }
+
+    void RenderGraph::orderPasses()
+    {
+        m_executionOrder.clear();
+
+        std::unordered_map<const RenderPass*, std::size_t> passIndices;
+        std::unordered_map<const RenderPass*, std::size_t> remainingParentCounts;
+        std::vector<RenderPass*> readyPasses;
+        std::size_t alivePassCount = 0;
+
+        for (std::size_t passIndex = 0; passIndex < m_nodes.size(); ++passIndex)
+        {
+            RenderPass& pass = *m_nodes[passIndex];
+
+            if (pass.m_isCulled)
+                continue;
+
+            passIndices.emplace(&pass, passIndex);
+            remainingParentCounts.emplace(&pass, pass.m_parents.size());
+            ++alivePassCount;
+
+            if (pass.m_parents.empty())
+                readyPasses.emplace_back(&pass);
+        }
+
+        // Amongst the passes whose dependencies are all executed, the first one added that requires the current state is picked, so as to keep it bound;
+        //  if there is none, the first one added is
+        while (!readyPasses.empty())
+        {
+            auto passIt = readyPasses.begin();
+
+            if (!m_executionOrder.empty())
+            {
+                const uint64_t currentStateKey = m_executionOrder.back()->m_stateKey;
+                const auto sameStateIt = std::find_if(readyPasses.begin(), readyPasses.end(), [currentStateKey](const RenderPass* pass)
+                {
+                    return (pass->m_stateKey == currentStateKey);
+                });
+
+                if (sameStateIt != readyPasses.end())
+                    passIt = sameStateIt;
+            }
+
+            RenderPass* pass = *passIt;
+            readyPasses.erase(passIt);
+            m_executionOrder.emplace_back(pass);
+
+            for (RenderPass* child : pass->m_children)
+            {
+                if (child->m_isCulled || --remainingParentCounts[child] > 0)
+                    continue;
+
+                const auto insertIt = std::upper_bound(readyPasses.begin(), readyPasses.end(), child, [&passIndices](const RenderPass* pass1, const RenderPass* pass2)
+                {
+                    return (passIndices[pass1] < passIndices[pass2]);
+                });
+                readyPasses.insert(insertIt, child);
+            }
+        }
+
+        if (m_executionOrder.size() != alivePassCount)
+            throw std::invalid_argument("Error: The render graph contains a cyclic dependency");
+    }
+
+    void RenderGraph::aliasTextures()
+    {
+        std::vector<std::size_t> firstUses(m_textures.size(), InvalidIndex);
+        std::vector<std::size_t> lastUses(m_textures.size(), 0);
+
+        const auto recordUse = [&firstUses, &lastUses](const RenderTextureHandle& texture, std::size_t position)
+        {
+            firstUses[texture.index] = std::min(firstUses[texture.index], position);
+            lastUses[texture.index]  = std::max(lastUses[texture.index], position);
+        };
+
+        for (std::size_t position = 0; position < m_executionOrder.size(); ++position)
+        {
+            const RenderPass& pass = *m_executionOrder[position];
+
+            for (const RenderTextureHandle& texture : pass.m_readTextures)
+                recordUse(texture, position);
+
+            for (const auto& [texture, index] : pass.m_writtenColorTextures)
+                recordUse(texture, position);
+
+            if (!pass.m_writtenDepthTexture.isNull())
+                recordUse(pass.m_writtenDepthTexture, position);
+        }
+
+        std::vector<std::size_t> usedTextures;
+        m_unaliasedMemorySize = 0;
+
+        for (std::size_t textureIndex = 0; textureIndex < m_textures.size(); ++textureIndex)
+        {
+            m_textures[textureIndex].physicalIndex = InvalidIndex;
+
+            if (m_textures[textureIndex].isImported || firstUses[textureIndex] == InvalidIndex)
+                continue;
+
+            usedTextures.emplace_back(textureIndex);
+            m_unaliasedMemorySize += m_textures[textureIndex].descriptor.computeByteSize();
+        }
+
+        std::stable_sort(usedTextures.begin(), usedTextures.end(), [&firstUses](std::size_t textureIndex1, std::size_t textureIndex2)
+        {
+            return (firstUses[textureIndex1] < firstUses[textureIndex2]);
+        });
+
+        // The actual textures created for the previous compilation are reused whenever possible
+        std::vector<PhysicalTexture> previousTextures = std::move(m_physicalTextures);
+        m_physicalTextures.clear();
+
+        for (const std::size_t textureIndex : usedTextures)
+        {
+            TextureResource& resource = m_textures[textureIndex];
+
+            // A texture can take the place of any other of the same properties which is no longer used when it starts being
+            const auto physicalIt = std::find_if(m_physicalTextures.begin(), m_physicalTextures.end(), [&resource, &firstUses, textureIndex](const PhysicalTexture& physicalTexture)
+            {
+                return (physicalTexture.descriptor == resource.descriptor && physicalTexture.lastUse < firstUses[textureIndex]);
+            });
+
+            if (physicalIt != m_physicalTextures.end())
+            {
+                physicalIt->lastUse = lastUses[textureIndex];
+                resource.physicalIndex = static_cast<std::size_t>(physicalIt - m_physicalTextures.begin());
+                continue;
+            }
+
+            PhysicalTexture& physicalTexture = m_physicalTextures.emplace_back();
+            physicalTexture.descriptor = resource.descriptor;
+            physicalTexture.lastUse = lastUses[textureIndex];
+
+            const auto previousIt = std::find_if(previousTextures.begin(), previousTextures.end(), [&resource](const PhysicalTexture& previousTexture)
+            {
+                return (previousTexture.descriptor == resource.descriptor);
+            });
+
+            if (previousIt != previousTextures.end())
+            {
+                physicalTexture.texture = std::move(previousIt->texture);
+                previousTextures.erase(previousIt);
+            }
+            else if (m_textureFactory)
+            {
+                physicalTexture.texture = m_textureFactory(resource.descriptor);
+            }
+
+            resource.physicalIndex = m_physicalTextures.size() - 1;
+        }
+    }
+
+} // namespace Rei
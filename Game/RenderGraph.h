@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "Graph.h"
+#include "RenderPass.h"
+
+namespace Rei
+{
+    class CommandRecorder;
+    class ThreadPool;
+
+    /// Graph of render passes, compiled into an execution order before being executed.
+    /// Compiling the graph:
+    /// - deduces the dependencies between passes from the textures they read & write, in the order the passes have been added;
+    /// - culls the passes none of whose outputs are used, the outputs being the imported textures & the passes having side effects;
+    /// - orders the remaining passes, grouping those sharing a pipeline state whenever their dependencies allow it;
+    /// - assigns memory to the transient textures, those used by passes whose lifetimes don't overlap sharing the same one.
+    /// With a command recorder, the ordered passes are split into as many consecutive groups as there are recording contexts, each group being recorded
+    ///   by a worker thread; only the execution of the recorded commands, in order, is left to the calling thread.
+    class RenderGraph : public Graph<RenderPass>
+    {
+        friend RenderPassResources;
+
+    public:
+        using TextureFactory = std::function<Texture2DPtr(const TextureDescriptor&)>;
+        using StateApplier = std::function<void(uint64_t)>;
+
+        const std::vector<RenderPass*>& getExecutionOrder() const noexcept { return m_executionOrder; }
+        /// Gets the number of actual textures created for the transient ones, as of the last compilation.
+        std::size_t getPhysicalTextureCount() const noexcept { return m_physicalTextures.size(); }
+        /// Gets the memory taken by the transient textures once aliased, as of the last compilation.
+        std::size_t getTransientMemorySize() const noexcept;
+        /// Gets the memory the transient textures used by the executed passes would take without aliasing, as of the last compilation.
+        std::size_t getUnaliasedMemorySize() const noexcept { return m_unaliasedMemorySize; }
+        /// Gets the number of pipeline states bound during the last execution.
+        std::size_t getStateChangeCount() const noexcept { return m_stateChangeCount; }
+
+        /// Sets the function creating the actual textures assigned to transient ones.
+        /// \param factory Texture creation function.
+        void setTextureFactory(TextureFactory factory);
+        /// Sets the function binding a pipeline state, only called when the executed pass requires a different state than the previous one.
+        /// \param applier State binding function, taking the key of the state to be bound.
+        void setStateApplier(StateApplier applier) { m_stateApplier = std::move(applier); }
+        /// Sets the backend recording the passes' commands; when set, pipeline states are bound through it instead of the state applier.
+        /// \param recorder Command recorder, which must outlive the graph; may be nullptr to execute the passes directly.
+        void setCommandRecorder(CommandRecorder* recorder) noexcept { m_recorder = recorder; }
+        /// Declares a transient texture, whose memory is managed by the graph & whose content only lives during a frame.
+        /// \param descriptor Properties of the texture.
+        /// \return Handle to the texture.
+        RenderTextureHandle createTexture(const TextureDescriptor& descriptor);
+        /// Declares an external texture, for instance a swapchain buffer; passes writing into it are outputs of the graph, & are never culled.
+        /// \param texture Texture to be imported.
+        /// \param descriptor Properties of the texture.
+        /// \return Handle to the texture.
+        RenderTextureHandle importTexture(Texture2DPtr texture, const TextureDescriptor& descriptor);
+        /// Gets the properties of a declared texture.
+        /// \param handle Handle to the texture.
+        /// \return Texture's descriptor.
+        const TextureDescriptor& getTextureDescriptor(const RenderTextureHandle& handle) const;
+        /// Adds a pass into the graph; passes are expected to be added in the order they logically execute.
+        /// \tparam Args Types of the arguments to be forwarded to the pass's constructor.
+        /// \param args Arguments to be forwarded to the pass's constructor.
+        /// \return Reference to the newly added pass.
+        template <typename... Args>
+        RenderPass& addNode(Args&&... args)
+        {
+            m_isCompiled = false;
+            return Graph::addNode(std::forward<Args>(args)...);
+        }
+        /// Removes a pass from the graph.
+        /// \param pass Pass to be removed.
+        void removeNode(RenderPass& pass);
+        /// Compiles the graph if it, any of its passes or any texture has been modified since the last compilation.
+        void compile();
+        /// Executes the passes in order, compiling the graph beforehand if needed.
+        /// \param threadPool Thread pool on which to record the passes if the graph has a command recorder; if nullptr, everything is recorded on the calling thread.
+        /// \return True if at least a pass has been executed, false otherwise.
+        bool execute(ThreadPool* threadPool = nullptr);
+
+    private:
+        static constexpr std::size_t InvalidIndex = std::numeric_limits<std::size_t>::max();
+
+        struct TextureResource
+        {
+            TextureDescriptor descriptor{};
+            Texture2DPtr importedTexture{};
+            bool isImported = false;
+            /// Index of the actual texture assigned to the transient texture, InvalidIndex if it is not used.
+            std::size_t physicalIndex = InvalidIndex;
+        };
+
+        struct PhysicalTexture
+        {
+            TextureDescriptor descriptor{};
+            Texture2DPtr texture{};
+            /// Position in the execution order of the last pass using the texture.
+            std::size_t lastUse = 0;
+        };
+
+        bool isCompilationNeeded() const noexcept;
+        const Texture2DPtr& recoverTexture(const RenderTextureHandle& handle) const;
+        void validateTextures(const RenderPass& pass) const;
+        void linkPasses();
+        void cullPasses();
+        void orderPasses();
+        void aliasTextures();
+        /// Records a group of consecutive passes on a context of the command recorder.
+        /// \param contextIndex Index of the context to record on.
+        /// \param beginPosition Position in the execution order of the first pass to be recorded.
+        /// \param endPosition Position in the execution order past the last pass to be recorded.
+        /// \return Number of pipeline states bound.
+        std::size_t recordPasses(std::size_t contextIndex, std::size_t beginPosition, std::size_t endPosition) const;
+
+        std::vector<TextureResource> m_textures{};
+        std::vector<PhysicalTexture> m_physicalTextures{};
+        std::vector<RenderPass*> m_executionOrder{};
+        TextureFactory m_textureFactory{};
+        StateApplier m_stateApplier{};
+        CommandRecorder* m_recorder{};
+        std::size_t m_unaliasedMemorySize = 0;
+        std::size_t m_stateChangeCount = 0;
+        bool m_isCompiled = false;
+    };
+
+} // namespace Rei
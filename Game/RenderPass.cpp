@@ -0,0 +1,79 @@
+#include "RenderPass.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "RenderGraph.h"
+
+namespace Rei
+{
+
+    const Texture2DPtr& RenderPassResources::getTexture(const RenderTextureHandle& handle) const
+    {
+        return m_graph.recoverTexture(handle);
+    }
+
+    void RenderPass::setStateKey(uint64_t stateKey) noexcept
+    {
+        m_stateKey = stateKey;
+        m_isDirty = true;
+    }
+
+    void RenderPass::enable(bool enabled) noexcept
+    {
+        m_isEnabled = enabled;
+        m_isDirty = true;
+    }
+
+    void RenderPass::setHasSideEffects(bool hasSideEffects) noexcept
+    {
+        m_hasSideEffects = hasSideEffects;
+        m_isDirty = true;
+    }
+
+    void RenderPass::addReadTexture(const RenderTextureHandle& texture)
+    {
+        if (texture.isNull())
+            throw std::invalid_argument("Error: A render pass cannot read an invalid texture");
+
+        if (std::find(m_readTextures.cbegin(), m_readTextures.cend(), texture) == m_readTextures.cend())
+            m_readTextures.emplace_back(texture);
+
+        m_isDirty = true;
+    }
+
+    void RenderPass::addWriteColorTexture(const RenderTextureHandle& texture, unsigned int index)
+    {
+        if (texture.isNull())
+            throw std::invalid_argument("Error: A render pass cannot write an invalid texture");
+
+        m_writtenColorTextures.emplace_back(texture, index);
+        m_isDirty = true;
+    }
+
+    void RenderPass::setWriteDepthTexture(const RenderTextureHandle& texture)
+    {
+        m_writtenDepthTexture = texture;
+        m_isDirty = true;
+    }
+
+    void RenderPass::clearTextures() noexcept
+    {
+        m_readTextures.clear();
+        m_writtenColorTextures.clear();
+        m_writtenDepthTexture = RenderTextureHandle{};
+        m_isDirty = true;
+    }
+
+    void RenderPass::addDependency(RenderPass& pass)
+    {
+        if (&pass == this)
+            throw std::invalid_argument("Error: A render pass cannot depend on itself");
+
+        if (std::find(m_explicitDependencies.cbegin(), m_explicitDependencies.cend(), &pass) == m_explicitDependencies.cend())
+            m_explicitDependencies.emplace_back(&pass);
+
+        m_isDirty = true;
+    }
+
+} // namespace Rei
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Graph.h"
+
+namespace Rei
+{
+    class DrawSubmitter;
+    class RenderGraph;
+    class Texture2D;
+    using Texture2DPtr = std::shared_ptr<Texture2D>;
+
+    enum class TextureFormat : uint8_t
+    {
+        R8,
+        RGBA8,
+        RGBA16F,
+        R32F,
+        DEPTH24_STENCIL8,
+        DEPTH32F
+    };
+
+    constexpr bool isDepthFormat(TextureFormat format) noexcept
+    {
+        return (format == TextureFormat::DEPTH24_STENCIL8 || format == TextureFormat::DEPTH32F);
+    }
+
+    constexpr std::size_t recoverPixelSize(TextureFormat format) noexcept
+    {
+        switch (format)
+        {
+            case TextureFormat::R8:      return 1;
+            case TextureFormat::RGBA16F: return 8;
+            default:                     return 4;
+        }
+    }
+
+    /// Properties of a texture used by render passes; two textures of equal descriptors can share the same memory.
+    struct TextureDescriptor
+    {
+        std::size_t computeByteSize() const noexcept { return static_cast<std::size_t>(width) * height * recoverPixelSize(format) * sampleCount; }
+
+        bool operator==(const TextureDescriptor& descriptor) const noexcept
+        {
+            return (width == descriptor.width && height == descriptor.height && format == descriptor.format && sampleCount == descriptor.sampleCount);
+        }
+        bool operator!=(const TextureDescriptor& descriptor) const noexcept { return !(*this == descriptor); }
+
+        unsigned int width = 0;
+        unsigned int height = 0;
+        TextureFormat format = TextureFormat::RGBA8;
+        /// Number of samples per pixel, greater than 1 for multisampled textures.
+        unsigned int sampleCount = 1;
+    };
+
+    /// Handle to a texture declared in a render graph.
+    struct RenderTextureHandle
+    {
+        static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+        bool isNull() const noexcept { return (index == InvalidIndex); }
+
+        bool operator==(const RenderTextureHandle& handle) const noexcept { return (index == handle.index); }
+        bool operator!=(const RenderTextureHandle& handle) const noexcept { return !(*this == handle); }
+
+        uint32_t index = InvalidIndex;
+    };
+
+    /// Textures available to a render pass during its execution, transient ones being resolved to the memory they have been assigned.
+    class RenderPassResources
+    {
+        friend RenderGraph;
+
+    public:
+        /// Gets the actual texture behind a handle.
+        /// \param handle Handle to the texture, which must have been declared as read or written by the executed pass.
+        /// \return Texture assigned to the handle; may be null if the graph has no texture factory.
+        const Texture2DPtr& getTexture(const RenderTextureHandle& handle) const;
+        /// Gets the submitter recording the pass's draws, on the context the pass is recorded on.
+        /// \return Pointer to the submitter, nullptr if the graph has no command recorder.
+        DrawSubmitter* getSubmitter() const noexcept { return m_submitter; }
+        /// Gets the index of the context the pass is recorded on; passes recorded concurrently always have different contexts.
+        std::size_t getContextIndex() const noexcept { return m_contextIndex; }
+
+    private:
+        explicit RenderPassResources(const RenderGraph& graph, DrawSubmitter* submitter = nullptr, std::size_t contextIndex = 0) noexcept
+            : m_graph{ graph }, m_submitter{ submitter }, m_contextIndex{ contextIndex } {}
+
+        const RenderGraph& m_graph;
+        DrawSubmitter* m_submitter{};
+        std::size_t m_contextIndex = 0;
+    };
+
+    /// Render pass, reading & writing textures declared in a render graph.
+    /// When the graph has a command recorder & a thread pool, passes may be executed concurrently on worker threads, each recording on its own context.
+    /// Dependencies between passes are deduced from these accesses when the graph is compiled; the passes' parent & child links are thus managed by the graph.
+    class RenderPass final : public GraphNode<RenderPass>
+    {
+        friend RenderGraph;
+
+    public:
+        using ExecutionFunc = std::function<void(const RenderPassResources&)>;
+
+        /// Creates a render pass.
+        /// \param name Name of the pass.
+        /// \param stateKey Identifier of the pipeline state (shaders, blending, depth & rasterizer states) the pass requires; passes sharing a state are
+        ///   executed one after the other whenever their dependencies allow it, so that it is only bound once.
+        explicit RenderPass(std::string name, uint64_t stateKey = 0) : m_name{ std::move(name) }, m_stateKey{ stateKey } {}
+
+        const std::string& getName() const noexcept { return m_name; }
+        uint64_t getStateKey() const noexcept { return m_stateKey; }
+        bool isEnabled() const noexcept { return m_isEnabled; }
+        /// Checks if the pass must be executed even if nothing reads what it writes, for instance if it writes into a buffer read back on the CPU.
+        bool hasSideEffects() const noexcept { return m_hasSideEffects; }
+        /// Checks if the pass has been culled during the last compilation, none of its outputs being used.
+        bool isCulled() const noexcept { return m_isCulled; }
+        const std::vector<RenderTextureHandle>& getReadTextures() const noexcept { return m_readTextures; }
+        const std::vector<std::pair<RenderTextureHandle, unsigned int>>& getWrittenColorTextures() const noexcept { return m_writtenColorTextures; }
+        const RenderTextureHandle& getWrittenDepthTexture() const noexcept { return m_writtenDepthTexture; }
+
+        void setStateKey(uint64_t stateKey) noexcept;
+        void enable(bool enabled = true) noexcept;
+        void disable() noexcept { enable(false); }
+        void setHasSideEffects(bool hasSideEffects) noexcept;
+        void setExecution(ExecutionFunc execution) { m_execution = std::move(execution); }
+
+        /// Declares a texture read by the pass, making it depend on the passes writing it before.
+        /// \param texture Texture to be read.
+        void addReadTexture(const RenderTextureHandle& texture);
+        /// Declares a color texture written by the pass.
+        /// \param texture Texture to be written; must have a non-depth format, which is checked when the graph is compiled.
+        /// \param index Location of the shader's output value.
+        void addWriteColorTexture(const RenderTextureHandle& texture, unsigned int index);
+        /// Declares the depth texture written by the pass.
+        /// \param texture Texture to be written; must have a depth format, which is checked when the graph is compiled.
+        void setWriteDepthTexture(const RenderTextureHandle& texture);
+        /// Removes all the declared texture accesses.
+        void clearTextures() noexcept;
+        /// Forces the pass to be executed after the given one, in addition to the dependencies deduced from their texture accesses.
+        /// \param pass Pass to be executed before the current one.
+        void addDependency(RenderPass& pass);
+
+    private:
+        std::string m_name{};
+        uint64_t m_stateKey = 0;
+        bool m_isEnabled = true;
+        bool m_hasSideEffects = false;
+        bool m_isCulled = false;
+        /// Whether the pass has been modified since the last compilation of its graph.
+        bool m_isDirty = true;
+        std::vector<RenderTextureHandle> m_readTextures{};
+        std::vector<std::pair<RenderTextureHandle, unsigned int>> m_writtenColorTextures{};
+        RenderTextureHandle m_writtenDepthTexture{};
+        std::vector<RenderPass*> m_explicitDependencies{};
+        ExecutionFunc m_execution{};
+    };
+
+} // namespace Rei
+
+/// Specialization of std::hash for TextureDescriptor.
+template <>
+struct std::hash<Rei::TextureDescriptor>
+{
+    /// Computes the hash of the given texture descriptor.
+    /// \param descriptor Descriptor to compute the hash of.
+    /// \return Descriptor's hash value.
+    std::size_t operator()(const Rei::TextureDescriptor& descriptor) const noexcept
+    {
+        std::size_t seed = 0;
+
+        for (const unsigned int value : { descriptor.width, descriptor.height, static_cast<unsigned int>(descriptor.format), descriptor.sampleCount })
+            seed ^= std::hash<unsigned int>{}(value) + 0x9e3779b9 + (seed << 6u) + (seed >> 2u);
+
+        return seed;
+    }
+};
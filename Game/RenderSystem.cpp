@@ -1 +1,68 @@
 #include "RenderSystem.h"
+
+#include <algorithm>
+
+#include "MatrixSimd.h"
+#include "MeshRenderer.h"
+#include "TransformGraph.h"
+
+namespace Rei
+{
+
+    RenderSystem::RenderSystem()
+    {
+        registerComponents<MeshRenderer>();
+        registerReadComponents<MeshRenderer>();
+    }
+
+    bool RenderSystem::update([[maybe_unused]] const FrameTimeInfo& timeInfo)
+    {
+        m_drawList.clear();
+        m_culler.clear();
+        m_culledRenderers.clear();
+
+        forEach<MeshRenderer>([this](const Entity&, const MeshRenderer& meshRenderer)
+        {
+            if (!meshRenderer.isVisible())
+                return;
+
+            // The bounding sphere is scaled by the largest of the transform's scales, for it to always contain the mesh
+            const Mat4f& worldMatrix = meshRenderer.getTransform().getWorldMatrix();
+            const float maxScale = std::max({ worldMatrix.recoverColumn(0).computeLength(),
+                                              worldMatrix.recoverColumn(1).computeLength(),
+                                              worldMatrix.recoverColumn(2).computeLength() });
+            const Vec4f position = worldMatrix.recoverColumn(3);
+
+            m_culler.addBoundingSphere(Vec3f(position.x(), position.y(), position.z()), meshRenderer.getBoundingRadius() * maxScale);
+            m_culledRenderers.emplace_back(&meshRenderer);
+        });
+
+        m_culler.cull(Simd::multiply(m_projectionMatrix, m_viewMatrix), m_threadPool);
+
+        // Only the view-space depth is needed, which is the dot product of the view matrix's third row with the position
+        const Vec4f depthRow = m_viewMatrix.recoverRow(2);
+
+        for (const uint32_t rendererIndex : m_culler.getVisibleIndices())
+        {
+            const MeshRenderer& meshRenderer = *m_culledRenderers[rendererIndex];
+            const Mat4f& worldMatrix = meshRenderer.getTransform().getWorldMatrix();
+            const float depth = depthRow.dot(worldMatrix.recoverColumn(3));
+
+            m_drawList.addDraw(meshRenderer.getPassId(), meshRenderer.getShaderId(), meshRenderer.getMaterialId(), meshRenderer.getMeshId(), worldMatrix, depth);
+        }
+
+        m_drawList.build();
+        m_renderGraph.execute(m_threadPool);
+
+        return true;
+    }
+
+    void RenderSystem::destroy()
+    {
+        m_renderGraph = RenderGraph();
+        m_drawList.clear();
+        m_culler.clear();
+        m_culledRenderers.clear();
+    }
+
+} // namespace Rei
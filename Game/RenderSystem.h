@@ -1,15 +1,51 @@
 #pragma once
 
+#include "DrawList.h"
+#include "Matrix.h"
+#include "RenderGraph.h"
 #include "System.h"
+#include "VisibilityCuller.h"
 namespace Rei
 {
     class Entity;
     class MeshRenderer;
 
 
+    /// System collecting the draws of all the visible mesh renderers each frame, then executing the render graph.
+    /// The mesh renderers inside the camera's frustum, & not hidden according to the culler's optional depth buffer, are the only ones drawn.
+    /// The draws are sorted by state & merged into instanced draws, which the render passes submit through getDrawList().
     class RenderSystem final : public System 
     {
-        //friend RenderGraph;
+        friend RenderGraph;
+
+    public:
+        RenderSystem();
+
+        const RenderGraph& getRenderGraph() const noexcept { return m_renderGraph; }
+        RenderGraph& getRenderGraph() noexcept { return m_renderGraph; }
+        const DrawList& getDrawList() const noexcept { return m_drawList; }
+        DrawList& getDrawList() noexcept { return m_drawList; }
+        const VisibilityCuller& getVisibilityCuller() const noexcept { return m_culler; }
+        VisibilityCuller& getVisibilityCuller() noexcept { return m_culler; }
+
+        /// Sets the view matrix used to compute the draws' depths, the view-space Z axis pointing forward (left-handed, as with Direct3D).
+        /// \param viewMatrix View matrix of the camera.
+        void setViewMatrix(const Mat4f& viewMatrix) noexcept { m_viewMatrix = viewMatrix; }
+        /// Sets the projection matrix used to cull the draws, with a clip-space depth between 0 & 1 (as with Direct3D).
+        /// \param projectionMatrix Projection matrix of the camera.
+        void setProjectionMatrix(const Mat4f& projectionMatrix) noexcept { m_projectionMatrix = projectionMatrix; }
+
+        bool update(const FrameTimeInfo& timeInfo) override;
+
+        void destroy() override;
+
+    private:
+        RenderGraph m_renderGraph{};
+        DrawList m_drawList{};
+        VisibilityCuller m_culler{};
+        /// Mesh renderers whose bounds have been given to the culler, in the same order.
+        std::vector<const MeshRenderer*> m_culledRenderers{};
+        Mat4f m_viewMatrix = Mat4f::identity();
+        Mat4f m_projectionMatrix = Mat4f::identity();
     };
 } // namespace Rei
-
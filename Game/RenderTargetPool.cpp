@@ -0,0 +1,89 @@
+#include "RenderTargetPool.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Rei
+{
+
+    Texture2DPtr RenderTargetPool::acquire(const TextureDescriptor& descriptor)
+    {
+        const auto freeTargetsIt = m_freeTargets.find(descriptor);
+
+        if (freeTargetsIt != m_freeTargets.end() && !freeTargetsIt->second.empty())
+        {
+            // The most recently released target is taken, the older ones being the first to expire
+            Texture2DPtr texture = std::move(freeTargetsIt->second.back().texture);
+            freeTargetsIt->second.pop_back();
+
+            m_freeMemory -= descriptor.computeByteSize();
+            --m_freeTargetCount;
+            m_acquiredTargets.insert(texture.get());
+
+            return texture;
+        }
+
+        assert("Error: The render target pool has no texture factory." && m_factory);
+
+        Texture2DPtr texture = m_factory(descriptor);
+        m_allocatedMemory += descriptor.computeByteSize();
+        ++m_creationCount;
+        m_acquiredTargets.insert(texture.get());
+
+        return texture;
+    }
+
+    void RenderTargetPool::release(Texture2DPtr texture, const TextureDescriptor& descriptor)
+    {
+        if (texture == nullptr)
+            return;
+
+        // A foreign target would be destroyed as if it had been created here, skewing the memory counts
+        const bool isAcquired = (m_acquiredTargets.erase(texture.get()) > 0);
+        assert("Error: The render target to be released must have been acquired from this pool." && isAcquired);
+
+        if (!isAcquired)
+            return;
+
+        m_freeTargets[descriptor].push_back(FreeTarget{ std::move(texture), m_frameIndex });
+        m_freeMemory += descriptor.computeByteSize();
+        ++m_freeTargetCount;
+    }
+
+    void RenderTargetPool::advanceFrame(uint32_t maxUnusedFrameCount)
+    {
+        ++m_frameIndex;
+
+        for (auto freeTargetsIt = m_freeTargets.begin(); freeTargetsIt != m_freeTargets.end();)
+        {
+            std::vector<FreeTarget>& freeTargets = freeTargetsIt->second;
+
+            // Targets being released in order, the expired ones are always the first
+            const auto firstKeptIt = std::find_if(freeTargets.begin(), freeTargets.end(), [this, maxUnusedFrameCount](const FreeTarget& target)
+            {
+                return (m_frameIndex - target.releaseFrame <= maxUnusedFrameCount);
+            });
+            const auto expiredCount = static_cast<std::size_t>(firstKeptIt - freeTargets.begin());
+            const std::size_t expiredMemory = expiredCount * freeTargetsIt->first.computeByteSize();
+
+            freeTargets.erase(freeTargets.begin(), firstKeptIt);
+            m_allocatedMemory -= expiredMemory;
+            m_freeMemory      -= expiredMemory;
+            m_freeTargetCount -= expiredCount;
+
+            if (freeTargets.empty())
+                freeTargetsIt = m_freeTargets.erase(freeTargetsIt);
+            else
+                ++freeTargetsIt;
+        }
+    }
+
+    void RenderTargetPool::clear() noexcept
+    {
+        m_freeTargets.clear();
+        m_allocatedMemory -= m_freeMemory;
+        m_freeMemory = 0;
+        m_freeTargetCount = 0;
+    }
+
+} // namespace Rei
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "RenderPass.h"
+
+namespace Rei
+{
+    class Texture2D;
+    using Texture2DPtr = std::shared_ptr<Texture2D>;
+
+    /// Pool of render targets, keyed by size, format & sample count.
+    /// Released targets are kept to be handed back to the next request of the same properties, instead of having a new texture created;
+    ///   those not requested again for a few frames are destroyed to give their memory back.
+    class RenderTargetPool
+    {
+    public:
+        using TextureFactory = std::function<Texture2DPtr(const TextureDescriptor&)>;
+
+        /// Number of frames a released target is kept without being requested again before being destroyed.
+        static constexpr uint32_t DefaultMaxUnusedFrameCount = 3;
+
+        /// Creates a render target pool.
+        /// \param factory Function creating the actual textures.
+        explicit RenderTargetPool(TextureFactory factory) : m_factory{ std::move(factory) } {}
+        RenderTargetPool(const RenderTargetPool&) = delete;
+        RenderTargetPool(RenderTargetPool&&) noexcept = default;
+
+        /// Gets the memory taken by all the targets created by the pool & still alive, whether in use or not.
+        std::size_t getAllocatedMemory() const noexcept { return m_allocatedMemory; }
+        /// Gets the memory taken by the targets waiting in the pool to be reused.
+        std::size_t getFreeMemory() const noexcept { return m_freeMemory; }
+        /// Gets the memory taken by the targets currently acquired.
+        std::size_t getUsedMemory() const noexcept { return m_allocatedMemory - m_freeMemory; }
+        std::size_t getFreeTargetCount() const noexcept { return m_freeTargetCount; }
+        /// Gets the number of textures created since the pool's creation, each being an actual allocation.
+        std::size_t getCreationCount() const noexcept { return m_creationCount; }
+
+        /// Gives a render target of the given properties, reusing a released one if any.
+        /// \param descriptor Properties of the target.
+        /// \return Render target, to be given back with release().
+        Texture2DPtr acquire(const TextureDescriptor& descriptor);
+        /// Gives back a render target acquired from the pool, to be reused.
+        /// \param texture Render target to be released; must have been acquired from this pool & not released since.
+        /// \param descriptor Properties the target has been acquired with.
+        void release(Texture2DPtr texture, const TextureDescriptor& descriptor);
+        /// Starts a new frame, destroying the targets released for too long.
+        /// \note Nothing calls it implicitly: the pool's owner must call it once a frame, otherwise unused targets are never destroyed.
+        /// \param maxUnusedFrameCount Number of frames a released target can remain unused before being destroyed.
+        void advanceFrame(uint32_t maxUnusedFrameCount = DefaultMaxUnusedFrameCount);
+        /// Destroys all the released targets; those still in use are unaffected.
+        void clear() noexcept;
+
+        RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+        RenderTargetPool& operator=(RenderTargetPool&&) noexcept = default;
+
+    private:
+        struct FreeTarget
+        {
+            Texture2DPtr texture{};
+            /// Index of the frame the target has been released in.
+            uint64_t releaseFrame = 0;
+        };
+
+        TextureFactory m_factory{};
+        std::unordered_map<TextureDescriptor, std::vector<FreeTarget>> m_freeTargets{};
+        /// Targets currently handed out, which are the only ones that can be released.
+        std::unordered_set<const Texture2D*> m_acquiredTargets{};
+        uint64_t m_frameIndex = 0;
+        std::size_t m_allocatedMemory = 0;
+        std::size_t m_freeMemory = 0;
+        std::size_t m_freeTargetCount = 0;
+        std::size_t m_creationCount = 0;
+    };
+
+} // namespace Rei
@@ -0,0 +1,185 @@
+#include "Replay.h"
+#include "Logger.h"
+#include "Serialization.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace Rei
+{
+
+    namespace
+    {
+
+        constexpr uint32_t ReplayMagic = 0x4C505252; // "RRPL"
+        constexpr uint8_t ReplayVersion = 1;
+        constexpr std::size_t ReplayHeaderSize = sizeof(ReplayMagic) + sizeof(ReplayVersion);
+
+    } // namespace
+
+    ReplayRecorder::ReplayRecorder(uint32_t keyframeInterval) : m_keyframeInterval{ (keyframeInterval == 0 ? 1 : keyframeInterval) }
+    {
+        clear();
+    }
+
+    void ReplayRecorder::record(const World& world, uint32_t tick)
+    {
+        std::swap(m_snapshot, m_previousSnapshot);
+        m_snapshot.capture(world, tick);
+
+        // Each frame is prefixed by its size, so that the player can index them without decoding anything
+        ByteWriter writer(m_data);
+        const std::size_t sizeOffset = writer.getSize();
+        writer.write(uint32_t{ 0 });
+
+        if (m_frameCount % m_keyframeInterval == 0)
+            m_snapshot.encode(m_data);
+        else
+            m_snapshot.encodeDelta(m_previousSnapshot, m_data);
+
+        const uint32_t frameSize = static_cast<uint32_t>(m_data.size() - sizeOffset - sizeof(uint32_t));
+        std::memcpy(m_data.data() + sizeOffset, &frameSize, sizeof(frameSize));
+
+        ++m_frameCount;
+    }
+
+    bool ReplayRecorder::save(const std::string& filePath) const
+    {
+        std::ofstream file(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+
+        if (!file)
+        {
+            Logger::error("[ReplayRecorder] Couldn't open the file '" + filePath + "'.");
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(m_data.data()), static_cast<std::streamsize>(m_data.size()));
+        return static_cast<bool>(file);
+    }
+
+    void ReplayRecorder::clear()
+    {
+        m_frameCount = 0;
+        m_snapshot.clear();
+        m_previousSnapshot.clear();
+        m_data.clear();
+
+        ByteWriter writer(m_data);
+        writer.write(ReplayMagic);
+        writer.write(ReplayVersion);
+    }
+
+    bool ReplayPlayer::load(std::vector<uint8_t> data)
+    {
+        m_data = std::move(data);
+        m_frames.clear();
+        m_currentFrame = NoFrame;
+        m_snapshot.clear();
+
+        ByteReader reader(m_data.data(), m_data.size());
+
+        uint32_t magic {};
+        uint8_t version {};
+        reader.read(magic);
+        reader.read(version);
+
+        if (reader.hasFailed() || magic != ReplayMagic || version != ReplayVersion)
+        {
+            Logger::error("[ReplayPlayer] The data is not a valid replay.");
+            return false;
+        }
+
+        std::size_t offset = ReplayHeaderSize;
+
+        while (reader.getRemainingSize() > 0)
+        {
+            uint32_t frameSize {};
+            reader.read(frameSize);
+            offset += sizeof(frameSize);
+
+            WorldSnapshot::Header header;
+
+            // The first frame must be a keyframe, for the others to have a baseline
+            if (reader.skipBytes(frameSize) == nullptr || !WorldSnapshot::decodeHeader(m_data.data() + offset, frameSize, header)
+             || (m_frames.empty() && header.isDelta))
+            {
+                Logger::error("[ReplayPlayer] The replay is corrupted.");
+                m_frames.clear();
+                return false;
+            }
+
+            m_frames.emplace_back(Frame{ offset, frameSize, header.tick, !header.isDelta });
+            offset += frameSize;
+        }
+
+        return true;
+    }
+
+    bool ReplayPlayer::loadFromFile(const std::string& filePath)
+    {
+        std::ifstream file(filePath, std::ios::in | std::ios::binary);
+
+        if (!file)
+        {
+            Logger::error("[ReplayPlayer] Couldn't open the file '" + filePath + "'.");
+            return false;
+        }
+
+        return load(std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+    }
+
+    bool ReplayPlayer::seek(std::size_t frameIndex)
+    {
+        if (frameIndex >= m_frames.size())
+            return false;
+
+        if (frameIndex == m_currentFrame)
+            return true;
+
+        std::size_t nextFrame = frameIndex;
+
+        // Deltas are decoded from the current frame if possible, from the nearest previous keyframe otherwise
+        if (m_currentFrame == NoFrame || m_currentFrame > frameIndex)
+        {
+            while (!m_frames[nextFrame].isKeyframe)
+                --nextFrame;
+        }
+        else
+        {
+            nextFrame = m_currentFrame + 1;
+
+            for (std::size_t keyframeIndex = nextFrame; keyframeIndex <= frameIndex; ++keyframeIndex)
+            {
+                if (m_frames[keyframeIndex].isKeyframe)
+                    nextFrame = keyframeIndex;
+            }
+        }
+
+        for (; nextFrame <= frameIndex; ++nextFrame)
+        {
+            const Frame& frame = m_frames[nextFrame];
+            std::swap(m_snapshot, m_previousSnapshot);
+
+            if (!m_snapshot.decode(m_data.data() + frame.offset, frame.size, &m_previousSnapshot))
+            {
+                Logger::error("[ReplayPlayer] The frame " + std::to_string(nextFrame) + " couldn't be decoded.");
+                m_currentFrame = NoFrame;
+                return false;
+            }
+        }
+
+        m_currentFrame = frameIndex;
+        return true;
+    }
+
+    bool ReplayPlayer::restoreFrame(std::size_t frameIndex, World& world)
+    {
+        if (!seek(frameIndex))
+            return false;
+
+        m_snapshot.restore(world);
+        return true;
+    }
+
+} // namespace Rei
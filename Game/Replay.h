@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "WorldSnapshot.h"
+
+namespace Rei
+{
+    class World;
+
+    /// Records a world tick after tick, as the same encoded snapshots sent over the network: a full snapshot every few ticks (a keyframe, from
+    ///   which playback can start), & deltas against the previous tick in between.
+    class ReplayRecorder
+    {
+    public:
+        static constexpr uint32_t DefaultKeyframeInterval = 64;
+
+        /// Creates a recorder.
+        /// \param keyframeInterval Number of frames between two keyframes; the lower, the faster seeking, but the bigger the replay.
+        explicit ReplayRecorder(uint32_t keyframeInterval = DefaultKeyframeInterval);
+
+        /// Gets the recorded replay, which can be given to a ReplayPlayer.
+        const std::vector<uint8_t>& getData() const noexcept { return m_data; }
+        std::size_t getFrameCount() const noexcept { return m_frameCount; }
+
+        /// Records a frame.
+        /// \param world World to capture the state of.
+        /// \param tick Tick of the frame.
+        void record(const World& world, uint32_t tick);
+        /// Writes the recorded replay into a file.
+        /// \param filePath Path to the file to write into, replacing its content.
+        /// \return True if the file has been written, false otherwise.
+        bool save(const std::string& filePath) const;
+        void clear();
+
+    private:
+        uint32_t m_keyframeInterval{};
+        std::size_t m_frameCount = 0;
+        // Snapshots of the current & previous frames, swapped every frame to keep their memory
+        WorldSnapshot m_snapshot{};
+        WorldSnapshot m_previousSnapshot{};
+        std::vector<uint8_t> m_data{};
+    };
+
+    /// Plays a replay back, restoring the recorded state of any of its frames into a world.
+    class ReplayPlayer
+    {
+    public:
+        std::size_t getFrameCount() const noexcept { return m_frames.size(); }
+        uint32_t getFrameTick(std::size_t frameIndex) const noexcept { return m_frames[frameIndex].tick; }
+        /// Gets the snapshot of the frame last seeked to.
+        const WorldSnapshot& getSnapshot() const noexcept { return m_snapshot; }
+
+        /// Loads a replay, as given by a ReplayRecorder.
+        /// \param data Recorded data.
+        /// \return True if the replay has been loaded, false if it is invalid.
+        bool load(std::vector<uint8_t> data);
+        /// Loads a replay from a file.
+        /// \param filePath Path to the file to be read.
+        /// \return True if the replay has been loaded, false if the file cannot be read or is invalid.
+        bool loadFromFile(const std::string& filePath);
+        /// Decodes the snapshot of a frame. Playing forward only decodes the frames in between; any other seek starts from the last keyframe.
+        /// \param frameIndex Index of the frame to seek to.
+        /// \return True if the frame has been decoded, false otherwise.
+        bool seek(std::size_t frameIndex);
+        /// Makes a world match the state of the given frame.
+        /// \note This must not be called while the world's systems are updated.
+        /// \param frameIndex Index of the frame to be restored.
+        /// \param world World to restore the frame into.
+        /// \return True if the frame has been restored, false otherwise.
+        bool restoreFrame(std::size_t frameIndex, World& world);
+
+    private:
+        struct Frame
+        {
+            std::size_t offset{};
+            std::size_t size{};
+            uint32_t tick{};
+            bool isKeyframe{};
+        };
+
+        static constexpr std::size_t NoFrame = static_cast<std::size_t>(-1);
+
+        std::vector<uint8_t> m_data{};
+        std::vector<Frame> m_frames{};
+        std::size_t m_currentFrame = NoFrame;
+        WorldSnapshot m_snapshot{};
+        WorldSnapshot m_previousSnapshot{};
+    };
+
+} // namespace Rei
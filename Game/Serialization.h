@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Rei
+{
+    class FieldLayout;
+
+    /// Appends binary data at the end of a byte buffer.
+    /// \note Values are written in the platform's byte order; all the supported platforms are little-endian.
+    class ByteWriter
+    {
+    public:
+        explicit ByteWriter(std::vector<uint8_t>& buffer) noexcept : m_buffer{ &buffer } {}
+
+        std::size_t getSize() const noexcept { return m_buffer->size(); }
+
+        template <typename T>
+        void write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Error: Only trivially copyable values can be written as-is.");
+            writeBytes(&value, sizeof(T));
+        }
+
+        void writeBytes(const void* data, std::size_t size)
+        {
+            const std::size_t offset = m_buffer->size();
+            m_buffer->resize(offset + size);
+            std::memcpy(m_buffer->data() + offset, data, size);
+        }
+
+        /// Writes an unsigned integer on as few bytes as possible: 7 bits per byte, the highest telling if another byte follows.
+        /// \param value Value to be written; values below 128 take a single byte.
+        void writeVarUint(uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                m_buffer->emplace_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+
+            m_buffer->emplace_back(static_cast<uint8_t>(value));
+        }
+
+    private:
+        std::vector<uint8_t>* m_buffer{};
+    };
+
+    /// Reads binary data written by a ByteWriter.
+    /// Reading past the end of the data does not read anything & marks the reader as failed, so that the validity of untrusted data (for instance
+    ///   received from the network) only needs to be checked once everything has been read.
+    class ByteReader
+    {
+    public:
+        ByteReader(const uint8_t* data, std::size_t size) noexcept : m_data{ data }, m_size{ size } {}
+
+        std::size_t getRemainingSize() const noexcept { return m_size - m_position; }
+        /// Checks if an attempt has been made to read more data than available.
+        bool hasFailed() const noexcept { return m_hasFailed; }
+
+        template <typename T>
+        bool read(T& value) noexcept
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Error: Only trivially copyable values can be read as-is.");
+            return readBytes(&value, sizeof(T));
+        }
+
+        bool readBytes(void* data, std::size_t size) noexcept
+        {
+            if (m_hasFailed || size > getRemainingSize())
+            {
+                m_hasFailed = true;
+                return false;
+            }
+
+            std::memcpy(data, m_data + m_position, size);
+            m_position += size;
+
+            return true;
+        }
+
+        /// Gets a pointer to the given amount of bytes & skips them, without copying anything.
+        /// \param size Number of bytes to be skipped.
+        /// \return Pointer to the skipped bytes, or nullptr if not as many are available.
+        const uint8_t* skipBytes(std::size_t size) noexcept
+        {
+            if (m_hasFailed || size > getRemainingSize())
+            {
+                m_hasFailed = true;
+                return nullptr;
+            }
+
+            const uint8_t* data = m_data + m_position;
+            m_position += size;
+
+            return data;
+        }
+
+        bool readVarUint(uint64_t& value) noexcept
+        {
+            value = 0;
+
+            for (unsigned int shift = 0; shift < 64; shift += 7)
+            {
+                uint8_t byte{};
+
+                if (!read(byte))
+                    return false;
+
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+                if ((byte & 0x80) == 0)
+                    return true;
+            }
+
+            // More than 10 bytes can only come from corrupted data
+            m_hasFailed = true;
+            return false;
+        }
+
+    private:
+        const uint8_t* m_data{};
+        std::size_t m_size{};
+        std::size_t m_position{};
+        bool m_hasFailed = false;
+    };
+
+    /// Checks if a type can be serialized, that is if it has a "serialize" member function template visiting its fields:
+    ///
+    ///     template <typename ArchiveT> void serialize(ArchiveT& archive) { archive(m_position, m_health, m_ammoCount); }
+    ///
+    /// The same function is used to measure, write & read the fields, which must all be trivially copyable; a serializable type thus always
+    ///   has the same serialized size, & its fields can be compared one by one to only send those that changed.
+    template <typename T, typename = void>
+    struct IsSerializable : std::false_type {};
+
+    template <typename T>
+    struct IsSerializable<T, std::void_t<decltype(std::declval<T&>().serialize(std::declval<FieldLayout&>()))>> : std::true_type {};
+
+    template <typename T>
+    constexpr bool IsSerializable_v = IsSerializable<T>::value;
+
+    /// Archive recording the size of each field of a serializable type.
+    class FieldLayout
+    {
+    public:
+        const std::vector<uint32_t>& getFieldSizes() const noexcept { return m_fieldSizes; }
+        std::size_t getFieldCount() const noexcept { return m_fieldSizes.size(); }
+        /// Gets the total size of all the fields, in bytes.
+        uint32_t getSize() const noexcept { return m_size; }
+
+        template <typename... FieldTs>
+        void operator()(const FieldTs&...)
+        {
+            static_assert((std::is_trivially_copyable_v<FieldTs> && ...), "Error: Serialized fields must be trivially copyable.");
+
+            (m_fieldSizes.emplace_back(static_cast<uint32_t>(sizeof(FieldTs))), ...);
+            m_size += (static_cast<uint32_t>(sizeof(FieldTs)) + ... + 0);
+        }
+
+    private:
+        std::vector<uint32_t> m_fieldSizes{};
+        uint32_t m_size = 0;
+    };
+
+    /// Archive copying the fields of a serializable object, packed one after the other, into a buffer of the type's serialized size.
+    class FieldWriter
+    {
+    public:
+        explicit FieldWriter(uint8_t* data) noexcept : m_data{ data } {}
+
+        template <typename... FieldTs>
+        void operator()(const FieldTs&... fields) noexcept
+        {
+            ((std::memcpy(m_data, &fields, sizeof(FieldTs)), m_data += sizeof(FieldTs)), ...);
+        }
+
+    private:
+        uint8_t* m_data{};
+    };
+
+    /// Archive copying back packed fields, as written by a FieldWriter, into a serializable object.
+    class FieldReader
+    {
+    public:
+        explicit FieldReader(const uint8_t* data) noexcept : m_data{ data } {}
+
+        template <typename... FieldTs>
+        void operator()(FieldTs&... fields) noexcept
+        {
+            ((std::memcpy(&fields, m_data, sizeof(FieldTs)), m_data += sizeof(FieldTs)), ...);
+        }
+
+    private:
+        const uint8_t* m_data{};
+    };
+
+} // namespace Rei
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+// Detection of the SIMD instruction sets available at compile time. MSVC only defines __AVX__ & __AVX2__ (through /arch),
+//  SSE2 always being available on x64; other compilers define a macro for each instruction set they are allowed to use.
+
+#if defined(__AVX2__)
+#define REI_SIMD_AVX2
+#endif
+
+#if defined(__AVX__)
+#define REI_SIMD_AVX
+#endif
+
+#if defined(__SSE4_1__) || defined(REI_SIMD_AVX)
+#define REI_SIMD_SSE41
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define REI_SIMD_SSE2
+#endif
+
+#if defined(REI_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Rei::Simd
+{
+
+    /// Counts the number of enabled bits in the given word.
+    /// \param word Word to count the bits of.
+    /// \return Number of bits set to 1.
+    inline int popCount(uint64_t word) noexcept
+    {
+#if defined(_MSC_VER) && defined(_M_X64) && defined(REI_SIMD_AVX)
+        // Every CPU supporting AVX supports POPCNT as well
+        return static_cast<int>(__popcnt64(word));
+#elif defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(word);
+#else
+        word = word - ((word >> 1u) & 0x5555555555555555ull);
+        word = (word & 0x3333333333333333ull) + ((word >> 2u) & 0x3333333333333333ull);
+        word = (word + (word >> 4u)) & 0x0F0F0F0F0F0F0F0Full;
+        return static_cast<int>((word * 0x0101010101010101ull) >> 56u);
+#endif
+    }
+
+} // namespace Rei::Simd
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace Rei
+{
+
+    /// Bounded lock-free queue between a single producer thread & a single consumer thread.
+    /// \note The capacity is rounded up to the next power of two. Neither pushing nor popping ever waits: pushing into a full queue fails instead.
+    /// \tparam T Type of the queued elements; must be default constructible & move assignable.
+    template <typename T>
+    class SpscQueue
+    {
+    public:
+        explicit SpscQueue(std::size_t capacity) : m_capacity{ computeCapacity(capacity) }, m_elements{ std::make_unique<T[]>(m_capacity) } {}
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue(SpscQueue&&) noexcept = delete;
+
+        std::size_t getCapacity() const noexcept { return m_capacity; }
+        /// Gets the number of queued elements; only exact when called from either end while the other one is idle.
+        std::size_t getSize() const noexcept { return (m_writePosition.load(std::memory_order_acquire) - m_readPosition.load(std::memory_order_acquire)); }
+        bool isEmpty() const noexcept { return (getSize() == 0); }
+
+        /// Pushes an element at the end of the queue; must only be called from the producer thread.
+        /// \param element Element to be pushed.
+        /// \return True if the element has been pushed, false if the queue is full.
+        bool push(T element) noexcept(std::is_nothrow_move_assignable_v<T>)
+        {
+            const std::size_t writePosition = m_writePosition.load(std::memory_order_relaxed);
+
+            // The consumer's position is only reloaded when the queue looks full, to avoid bouncing its cache line at every push
+            if (writePosition - m_cachedReadPosition == m_capacity)
+            {
+                m_cachedReadPosition = m_readPosition.load(std::memory_order_acquire);
+
+                if (writePosition - m_cachedReadPosition == m_capacity)
+                    return false;
+            }
+
+            m_elements[writePosition & (m_capacity - 1)] = std::move(element);
+            m_writePosition.store(writePosition + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        /// Pops the element at the front of the queue; must only be called from the consumer thread.
+        /// \param element Element to be filled.
+        /// \return True if an element has been popped, false if the queue is empty.
+        bool pop(T& element) noexcept(std::is_nothrow_move_assignable_v<T>)
+        {
+            const std::size_t readPosition = m_readPosition.load(std::memory_order_relaxed);
+
+            if (readPosition == m_cachedWritePosition)
+            {
+                m_cachedWritePosition = m_writePosition.load(std::memory_order_acquire);
+
+                if (readPosition == m_cachedWritePosition)
+                    return false;
+            }
+
+            element = std::move(m_elements[readPosition & (m_capacity - 1)]);
+            m_readPosition.store(readPosition + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        SpscQueue& operator=(const SpscQueue&) = delete;
+        SpscQueue& operator=(SpscQueue&&) noexcept = delete;
+
+    private:
+        static std::size_t computeCapacity(std::size_t capacity) noexcept
+        {
+            std::size_t powerOfTwo = 1;
+
+            while (powerOfTwo < capacity)
+                powerOfTwo <<= 1;
+
+            return powerOfTwo;
+        }
+
+        const std::size_t m_capacity{};
+        std::unique_ptr<T[]> m_elements{};
+
+        // Each end's position & its cached copy of the other's are kept on their own cache line, only shared when the queue looks full or empty
+        alignas(64) std::atomic<std::size_t> m_writePosition = 0;
+        std::size_t m_cachedReadPosition = 0;
+        alignas(64) std::atomic<std::size_t> m_readPosition = 0;
+        std::size_t m_cachedWritePosition = 0;
+    };
+
+} // namespace Rei
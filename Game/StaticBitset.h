@@ -0,0 +1,345 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <ostream>
+
+#include "Simd.h"
+
+namespace Rei
+{
+
+    namespace Detail
+    {
+
+        // Word-wise binary operations, overloaded for each register width available
+
+        struct BitAnd
+        {
+            static constexpr uint64_t apply(uint64_t lhs, uint64_t rhs) noexcept { return (lhs & rhs); }
+#if defined(REI_SIMD_SSE2)
+            static __m128i apply(__m128i lhs, __m128i rhs) noexcept { return _mm_and_si128(lhs, rhs); }
+#endif
+#if defined(REI_SIMD_AVX2)
+            static __m256i apply(__m256i lhs, __m256i rhs) noexcept { return _mm256_and_si256(lhs, rhs); }
+#endif
+        };
+
+        struct BitOr
+        {
+            static constexpr uint64_t apply(uint64_t lhs, uint64_t rhs) noexcept { return (lhs | rhs); }
+#if defined(REI_SIMD_SSE2)
+            static __m128i apply(__m128i lhs, __m128i rhs) noexcept { return _mm_or_si128(lhs, rhs); }
+#endif
+#if defined(REI_SIMD_AVX2)
+            static __m256i apply(__m256i lhs, __m256i rhs) noexcept { return _mm256_or_si256(lhs, rhs); }
+#endif
+        };
+
+        struct BitXor
+        {
+            static constexpr uint64_t apply(uint64_t lhs, uint64_t rhs) noexcept { return (lhs ^ rhs); }
+#if defined(REI_SIMD_SSE2)
+            static __m128i apply(__m128i lhs, __m128i rhs) noexcept { return _mm_xor_si128(lhs, rhs); }
+#endif
+#if defined(REI_SIMD_AVX2)
+            static __m256i apply(__m256i lhs, __m256i rhs) noexcept { return _mm256_xor_si256(lhs, rhs); }
+#endif
+        };
+
+    } // namespace Detail
+
+    /// Bitset of a size fixed at compile time, stored in 64-bit words.
+    /// Unlike Bitset, it never allocates; mask operations are performed on whole words, using SSE/AVX2 registers when available.
+    /// \tparam BitCount Number of bits held by the bitset.
+    template <std::size_t BitCount>
+    class StaticBitset
+    {
+        static_assert(BitCount > 0, "Error: A static bitset must hold at least one bit.");
+
+    public:
+        static constexpr std::size_t WordBitCount = 64;
+        static constexpr std::size_t WordCount = (BitCount + WordBitCount - 1) / WordBitCount;
+
+        constexpr StaticBitset() noexcept = default;
+        constexpr StaticBitset(std::initializer_list<bool> bits) noexcept
+        {
+            assert("Error: Too many bits given to initialize the static bitset." && bits.size() <= BitCount);
+
+            std::size_t bitIndex = 0;
+            for (bool bit : bits)
+                setBit(bitIndex++, bit);
+        }
+
+        static constexpr std::size_t getSize() noexcept { return BitCount; }
+        constexpr const std::array<uint64_t, WordCount>& getWords() const noexcept { return m_words; }
+
+        /// Checks if no bit is enabled.
+        /// \return True if all bits are disabled, false otherwise.
+        bool isEmpty() const noexcept;
+        /// Counts the enabled bits.
+        /// \return Number of bits set to 1.
+        std::size_t getEnabledBitCount() const noexcept;
+        std::size_t getDisabledBitCount() const noexcept { return BitCount - getEnabledBitCount(); }
+        /// Checks if at least one bit is enabled in both the current bitset & the given one.
+        /// This is equivalent to !(*this & bitset).isEmpty(), without computing the intermediate bitset.
+        /// \param bitset Bitset to be checked against.
+        /// \return True if both bitsets have at least one enabled bit in common, false otherwise.
+        bool intersects(const StaticBitset& bitset) const noexcept;
+        /// Checks if all the enabled bits of the given bitset are enabled in the current one.
+        /// This is equivalent to (*this & bitset) == bitset, without computing the intermediate bitset.
+        /// \param bitset Bitset to be checked against.
+        /// \return True if the current bitset is a superset of the given one, false otherwise.
+        bool contains(const StaticBitset& bitset) const noexcept;
+
+        constexpr void setBit(std::size_t index, bool value = true) noexcept
+        {
+            assert("Error: The bit to be set is out of the static bitset's bounds." && index < BitCount);
+
+            const uint64_t bitMask = (uint64_t{ 1 } << (index % WordBitCount));
+            uint64_t& word = m_words[index / WordBitCount];
+            word = (value ? (word | bitMask) : (word & ~bitMask));
+        }
+
+        constexpr void reset() noexcept
+        {
+            for (uint64_t& word : m_words)
+                word = 0;
+        }
+
+        /// Disables all bits; as the size cannot change, this is equivalent to reset().
+        constexpr void clear() noexcept { reset(); }
+
+        StaticBitset operator~() const noexcept;
+        StaticBitset operator&(const StaticBitset& bitset) const noexcept { StaticBitset res = *this; res &= bitset; return res; }
+        StaticBitset operator|(const StaticBitset& bitset) const noexcept { StaticBitset res = *this; res |= bitset; return res; }
+        StaticBitset operator^(const StaticBitset& bitset) const noexcept { StaticBitset res = *this; res ^= bitset; return res; }
+        StaticBitset& operator&=(const StaticBitset& bitset) noexcept { applyWordwise<Detail::BitAnd>(bitset); return *this; }
+        StaticBitset& operator|=(const StaticBitset& bitset) noexcept { applyWordwise<Detail::BitOr>(bitset); return *this; }
+        StaticBitset& operator^=(const StaticBitset& bitset) noexcept { applyWordwise<Detail::BitXor>(bitset); return *this; }
+
+        constexpr bool operator[](std::size_t index) const noexcept
+        {
+            assert("Error: The requested bit is out of the static bitset's bounds." && index < BitCount);
+            return ((m_words[index / WordBitCount] >> (index % WordBitCount)) & 1u);
+        }
+
+        constexpr bool operator==(const StaticBitset& bitset) const noexcept
+        {
+            for (std::size_t wordIndex = 0; wordIndex < WordCount; ++wordIndex)
+            {
+                if (m_words[wordIndex] != bitset.m_words[wordIndex])
+                    return false;
+            }
+
+            return true;
+        }
+
+        constexpr bool operator!=(const StaticBitset& bitset) const noexcept { return !(*this == bitset); }
+
+    private:
+        // Bits of the last word lying beyond BitCount, which must always remain disabled
+        static constexpr uint64_t LastWordMask = (BitCount % WordBitCount == 0 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << (BitCount % WordBitCount)) - 1);
+
+        template <typename OpT>
+        void applyWordwise(const StaticBitset& bitset) noexcept;
+
+        alignas(WordCount >= 4 ? 32 : (WordCount >= 2 ? 16 : 8)) std::array<uint64_t, WordCount> m_words{};
+    };
+
+    template <std::size_t BitCount>
+    bool StaticBitset<BitCount>::isEmpty() const noexcept
+    {
+        std::size_t wordIndex = 0;
+
+#if defined(REI_SIMD_AVX)
+        for (; wordIndex + 4 <= WordCount; wordIndex += 4)
+        {
+            const __m256i words = _mm256_load_si256(reinterpret_cast<const __m256i*>(m_words.data() + wordIndex));
+
+            if (!_mm256_testz_si256(words, words))
+                return false;
+        }
+#endif
+
+#if defined(REI_SIMD_SSE41)
+        for (; wordIndex + 2 <= WordCount; wordIndex += 2)
+        {
+            const __m128i words = _mm_load_si128(reinterpret_cast<const __m128i*>(m_words.data() + wordIndex));
+
+            if (!_mm_testz_si128(words, words))
+                return false;
+        }
+#endif
+
+        uint64_t remainingBits = 0;
+        for (; wordIndex < WordCount; ++wordIndex)
+            remainingBits |= m_words[wordIndex];
+
+        return (remainingBits == 0);
+    }
+
+    template <std::size_t BitCount>
+    std::size_t StaticBitset<BitCount>::getEnabledBitCount() const noexcept
+    {
+        std::size_t bitCount = 0;
+
+        for (const uint64_t word : m_words)
+            bitCount += static_cast<std::size_t>(Simd::popCount(word));
+
+        return bitCount;
+    }
+
+    template <std::size_t BitCount>
+    bool StaticBitset<BitCount>::intersects(const StaticBitset& bitset) const noexcept
+    {
+        std::size_t wordIndex = 0;
+
+#if defined(REI_SIMD_AVX)
+        for (; wordIndex + 4 <= WordCount; wordIndex += 4)
+        {
+            const __m256i lhs = _mm256_load_si256(reinterpret_cast<const __m256i*>(m_words.data() + wordIndex));
+            const __m256i rhs = _mm256_load_si256(reinterpret_cast<const __m256i*>(bitset.m_words.data() + wordIndex));
+
+            if (!_mm256_testz_si256(lhs, rhs))
+                return true;
+        }
+#endif
+
+#if defined(REI_SIMD_SSE41)
+        for (; wordIndex + 2 <= WordCount; wordIndex += 2)
+        {
+            const __m128i lhs = _mm_load_si128(reinterpret_cast<const __m128i*>(m_words.data() + wordIndex));
+            const __m128i rhs = _mm_load_si128(reinterpret_cast<const __m128i*>(bitset.m_words.data() + wordIndex));
+
+            if (!_mm_testz_si128(lhs, rhs))
+                return true;
+        }
+#endif
+
+        for (; wordIndex < WordCount; ++wordIndex)
+        {
+            if ((m_words[wordIndex] & bitset.m_words[wordIndex]) != 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    template <std::size_t BitCount>
+    bool StaticBitset<BitCount>::contains(const StaticBitset& bitset) const noexcept
+    {
+        std::size_t wordIndex = 0;
+
+        // testc(a, b) checks that (~a & b) == 0, that is all bits enabled in b are enabled in a as well
+
+#if defined(REI_SIMD_AVX)
+        for (; wordIndex + 4 <= WordCount; wordIndex += 4)
+        {
+            const __m256i lhs = _mm256_load_si256(reinterpret_cast<const __m256i*>(m_words.data() + wordIndex));
+            const __m256i rhs = _mm256_load_si256(reinterpret_cast<const __m256i*>(bitset.m_words.data() + wordIndex));
+
+            if (!_mm256_testc_si256(lhs, rhs))
+                return false;
+        }
+#endif
+
+#if defined(REI_SIMD_SSE41)
+        for (; wordIndex + 2 <= WordCount; wordIndex += 2)
+        {
+            const __m128i lhs = _mm_load_si128(reinterpret_cast<const __m128i*>(m_words.data() + wordIndex));
+            const __m128i rhs = _mm_load_si128(reinterpret_cast<const __m128i*>(bitset.m_words.data() + wordIndex));
+
+            if (!_mm_testc_si128(lhs, rhs))
+                return false;
+        }
+#endif
+
+        for (; wordIndex < WordCount; ++wordIndex)
+        {
+            if ((bitset.m_words[wordIndex] & ~m_words[wordIndex]) != 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    template <std::size_t BitCount>
+    StaticBitset<BitCount> StaticBitset<BitCount>::operator~() const noexcept
+    {
+        StaticBitset res;
+
+        for (std::size_t wordIndex = 0; wordIndex < WordCount; ++wordIndex)
+            res.m_words[wordIndex] = ~m_words[wordIndex];
+
+        res.m_words.back() &= LastWordMask;
+
+        return res;
+    }
+
+    template <std::size_t BitCount>
+    template <typename OpT>
+    void StaticBitset<BitCount>::applyWordwise(const StaticBitset& bitset) noexcept
+    {
+        std::size_t wordIndex = 0;
+
+#if defined(REI_SIMD_AVX2)
+        for (; wordIndex + 4 <= WordCount; wordIndex += 4)
+        {
+            auto* words = reinterpret_cast<__m256i*>(m_words.data() + wordIndex);
+            const auto* otherWords = reinterpret_cast<const __m256i*>(bitset.m_words.data() + wordIndex);
+
+            _mm256_store_si256(words, OpT::apply(_mm256_load_si256(words), _mm256_load_si256(otherWords)));
+        }
+#endif
+
+#if defined(REI_SIMD_SSE2)
+        for (; wordIndex + 2 <= WordCount; wordIndex += 2)
+        {
+            auto* words = reinterpret_cast<__m128i*>(m_words.data() + wordIndex);
+            const auto* otherWords = reinterpret_cast<const __m128i*>(bitset.m_words.data() + wordIndex);
+
+            _mm_store_si128(words, OpT::apply(_mm_load_si128(words), _mm_load_si128(otherWords)));
+        }
+#endif
+
+        for (; wordIndex < WordCount; ++wordIndex)
+            m_words[wordIndex] = OpT::apply(m_words[wordIndex], bitset.m_words[wordIndex]);
+    }
+
+    template <std::size_t BitCount>
+    std::ostream& operator<<(std::ostream& stream, const StaticBitset<BitCount>& bitset)
+    {
+        stream << "[ " << bitset[0];
+
+        for (std::size_t i = 1; i < BitCount; ++i)
+            stream << ", " << bitset[i];
+
+        stream << " ]";
+
+        return stream;
+    }
+
+} // namespace Rei
+
+/// Specialization of std::hash for StaticBitset.
+/// \tparam BitCount Number of bits held by the bitset.
+template <std::size_t BitCount>
+struct std::hash<Rei::StaticBitset<BitCount>>
+{
+    /// Computes the hash of the given bitset.
+    /// \param bitset Bitset to compute the hash of.
+    /// \return Bitset's hash value.
+    std::size_t operator()(const Rei::StaticBitset<BitCount>& bitset) const noexcept
+    {
+        std::size_t seed = 0;
+
+        for (const uint64_t word : bitset.getWords())
+            seed ^= std::hash<uint64_t>{}(word) + 0x9e3779b9 + (seed << 6u) + (seed >> 2u);
+
+        return seed;
+    }
+};
@@ -0,0 +1,44 @@
+#include "System.h"
+#include "World.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+
+namespace Rei
+{
+
+    std::string System::demangleTypeName(const char* typeName)
+    {
+#if defined(__GNUC__)
+        // GCC & Clang give the mangled name, which the ABI library can demangle
+        int status = 0;
+        const std::unique_ptr<char, decltype(&std::free)> demangledName(abi::__cxa_demangle(typeName, nullptr, nullptr, &status), &std::free);
+
+        if (status == 0 && demangledName != nullptr)
+            return demangledName.get();
+
+        return typeName;
+#else
+        // MSVC gives readable names, prefixed by the kind of type
+        for (const char* prefix : { "class ", "struct " })
+        {
+            if (std::strncmp(typeName, prefix, std::strlen(prefix)) == 0)
+                return typeName + std::strlen(prefix);
+        }
+
+        return typeName;
+#endif
+    }
+
+    CommandBuffer& System::getCommandBuffer() const
+    {
+        assert("Error: The system must belong to a world to record commands." && m_world);
+        return m_world->getCommandBuffer();
+    }
+
+} // namespace Rei
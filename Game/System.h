@@ -1,17 +1,30 @@
 #pragma once
 
+#include <cassert>
+#include <string>
+#include <typeinfo>
 #include <vector>
 
+#include "CommandBuffer.h"
 #include "Entity.h"
-#include "Bitset.h"
+#include "EntitySet.h"
+#include "StaticBitset.h"
+#include "ThreadPool.h"
 
 namespace Rei
 {
 
 
+    /// Maximum number of distinct system types; this defines the size of the system masks.
+    constexpr std::size_t MaxSystemCount = 64;
+
+    static_assert(SystemTypes::Size <= MaxSystemCount, "Error: Too many system types are registered; MaxSystemCount must be increased.");
+
     struct FrameTimeInfo;
+    class World;
     class System;
     using SystemPtr = std::unique_ptr<System>;
+    using SystemMask = StaticBitset<MaxSystemCount>;
 
     class System
     {
@@ -20,34 +33,94 @@ namespace Rei
         System(const System&) = delete;
         System(System&&) noexcept = delete;
 
-        const Bitset& getAcceptedComponents() const noexcept
+        const ComponentMask& getAcceptedComponents() const noexcept
         {
             return m_acceptedComponents;
         }
 
+        const ComponentMask& getReadComponents() const noexcept { return m_readComponents; }
+        const ComponentMask& getWrittenComponents() const noexcept { return m_writtenComponents; }
+        /// Checks if the system declared which components it accesses; if not, it is never run concurrently with any other system.
+        bool hasDeclaredAccesses() const noexcept { return m_hasDeclaredAccesses; }
+        /// Checks if the system is updated once per fixed step, instead of once per frame.
+        bool isFixedStep() const noexcept { return m_isFixedStep; }
+
+        /// Checks if two systems can safely be updated concurrently, that is if neither writes components the other reads or writes.
+        /// \param system System to be checked against.
+        /// \return True if the systems' component accesses conflict, false otherwise.
+        bool conflictsWith(const System& system) const noexcept
+        {
+            if (!m_hasDeclaredAccesses || !system.m_hasDeclaredAccesses)
+                return true;
+
+            return (m_writtenComponents.intersects(system.m_readComponents) || m_writtenComponents.intersects(system.m_writtenComponents)
+                 || system.m_writtenComponents.intersects(m_readComponents));
+        }
+
+        /// Gets the identifier of a system type, which is its index in the registered SystemTypes.
+        /// \tparam SysT Type of the system; must be registered in TypeRegistry.h.
+        /// \return Identifier of the system type, known at compile time.
         template <typename SysT>
-        static std::size_t getId()
+        static constexpr std::size_t getId() noexcept
         {
             static_assert(std::is_base_of_v<System, SysT>, "Error: The fetched system must be derived from System.");
             static_assert(!std::is_same_v<System, SysT>, "Error: The fetched system must not be of specific type 'System'.");
+            static_assert(TypeListContains_v<SysT, SystemTypes>, "Error: The system must be registered in SystemTypes (TypeRegistry.h).");
 
-            static const std::size_t id = s_maxId++;
-            return id;
+            return TypeListIndex_v<SysT, SystemTypes>;
         }
 
         bool containsEntity(const Entity& entity) const noexcept
         {
-            for (const Entity* entityPtr : m_entities)
+            return m_entities.contains(entity);
+        }
+
+        ThreadPool* getThreadPool() const noexcept { return m_threadPool; }
+        /// Gets the name of the system's type, qualified by its namespaces; used to identify the system in profiling captures.
+        const char* getName() const noexcept { return m_name; }
+        /// Gets the owning world's command buffer associated with the calling thread, into which structural changes must be recorded during an update.
+        /// \return Command buffer of the calling thread.
+        CommandBuffer& getCommandBuffer() const;
+
+        /// Calls a function on every linked entity holding all the given components.
+        /// \note The components are fetched without any further check; the entities not holding all of them are skipped using their components' mask.
+        /// \tparam CompTs Types of the components to be fetched.
+        /// \tparam FuncT Type of the function to be called.
+        /// \param func Function to be called, taking a reference to the entity followed by references to each requested component.
+        template <typename... CompTs, typename FuncT>
+        void forEach(FuncT&& func)
+        {
+            forEachInRange<CompTs...>(recoverComponentMask<CompTs...>(), 0, m_entities.getSize(), func);
+        }
+
+        /// Calls a function on every linked entity holding all the given components, splitting them into batches processed concurrently on the thread pool.
+        /// If the system has no thread pool, this is equivalent to forEach().
+        /// \note The function may be called from several threads at once, and must thus only write into the given entity's components.
+        /// \tparam CompTs Types of the components to be fetched.
+        /// \tparam FuncT Type of the function to be called.
+        /// \param func Function to be called, taking a reference to the entity followed by references to each requested component.
+        /// \param grainSize Maximum number of consecutive entities processed by a single job.
+        template <typename... CompTs, typename FuncT>
+        void parallelForEach(FuncT&& func, std::size_t grainSize = DefaultGrainSize)
+        {
+            const ComponentMask components = recoverComponentMask<CompTs...>();
+
+            if (m_threadPool == nullptr || m_entities.getSize() <= grainSize)
             {
-                if (entityPtr->getId() == entity.getId())
-                {
-                    return true;
-                }
+                forEachInRange<CompTs...>(components, 0, m_entities.getSize(), func);
+                return;
             }
 
-            return false;
+            m_threadPool->parallelFor(m_entities.getSize(), grainSize, [this, &components, &func](std::size_t beginIndex, std::size_t endIndex)
+            {
+                forEachInRange<CompTs...>(components, beginIndex, endIndex, func);
+            });
         }
 
+        /// Updates the system; called once per frame, or once per fixed step if the system is fixed-step.
+        /// \note A fixed-step system is given the fixed step's duration as delta time, & a substep count of 1.
+        /// \param timeInfo Time-related frame information.
+        /// \return True if the system must keep being updated, false if it must be deactivated.
         virtual bool update([[maybe_unused]] const FrameTimeInfo& timeInfo) { return true; }
 
         virtual void destroy() {}
@@ -71,28 +144,80 @@ namespace Rei
             (m_acceptedComponents.setBit(Component::getId<CompTs>(), false), ...);
         }
 
-        virtual void linkEntity(const EntityPtr& entity)
+        /// Declares components which are only read during the system's update.
+        template <typename... CompTs>
+        void registerReadComponents()
         {
-            m_entities.emplace_back(entity.get());
+            (m_readComponents.setBit(Component::getId<CompTs>()), ...);
+            m_hasDeclaredAccesses = true;
         }
 
-        virtual void unlinkEntity(const EntityPtr& entity)
+        /// Declares components which are modified during the system's update.
+        template <typename... CompTs>
+        void registerWrittenComponents()
         {
-            for (std::size_t entityIndex = 0; entityIndex < m_entities.size(); ++entityIndex)
-            {
-                if (m_entities[entityIndex]->getId() == entity->getId())
-                {
-                    m_entities.erase(m_entities.begin() + static_cast<std::ptrdiff_t>(entityIndex));
-                    break;
-                }
-            }
+            (m_writtenComponents.setBit(Component::getId<CompTs>()), ...);
+            m_hasDeclaredAccesses = true;
         }
 
-        std::vector<Entity*> m_entities{};
-        Bitset m_acceptedComponents{};
+        virtual void linkEntity(Entity& entity)
+        {
+            m_entities.insert(entity);
+        }
+
+        virtual void unlinkEntity(const Entity& entity)
+        {
+            m_entities.erase(entity);
+        }
+
+        /// Default number of entities processed by a single job in parallelForEach(); the entity pointers of a batch span 8 cache lines.
+        static constexpr std::size_t DefaultGrainSize = 64;
+
+        /// Entities linked to the system; removing one moves the last linked entity in its place.
+        EntitySet m_entities{};
+        ComponentMask m_acceptedComponents{};
+        ComponentMask m_readComponents{};
+        ComponentMask m_writtenComponents{};
+        bool m_hasDeclaredAccesses = false;
+        /// Fixed-step systems (physics, gameplay simulation) are updated as many times as the frame has fixed steps, before all the
+        ///   variable-step ones (rendering) are updated once; must be set in the system's constructor.
+        bool m_isFixedStep = false;
+        ThreadPool* m_threadPool{};
+        World* m_world{};
 
     private:
-        static inline std::size_t s_maxId = 0;
+        /// Gets the readable name of a system type, which lives until the program exits.
+        template <typename SysT>
+        static const char* recoverTypeName()
+        {
+            static const std::string typeName = demangleTypeName(typeid(SysT).name());
+            return typeName.c_str();
+        }
+        /// Turns a type name given by std::type_info::name() into the one written in the source code, whose form depends on the compiler.
+        static std::string demangleTypeName(const char* typeName);
+
+        const char* m_name = "System";
+
+        template <typename... CompTs>
+        static ComponentMask recoverComponentMask() noexcept
+        {
+            ComponentMask components;
+            (components.setBit(Component::getId<CompTs>()), ...);
+            return components;
+        }
+
+        template <typename... CompTs, typename FuncT>
+        void forEachInRange(const ComponentMask& components, std::size_t beginIndex, std::size_t endIndex, FuncT& func)
+        {
+            for (std::size_t entityIndex = beginIndex; entityIndex < endIndex; ++entityIndex)
+            {
+                Entity& entity = *m_entities[entityIndex];
+
+                if (entity.getEnabledComponents().contains(components))
+                    func(entity, entity.getComponentUnchecked<CompTs>()...);
+            }
+        }
+
     };
 
 } // namespace Rei
\ No newline at end of file
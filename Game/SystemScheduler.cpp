@@ -0,0 +1,105 @@
+#include "SystemScheduler.h"
+#include "ThreadPool.h"
+
+#include <cstring>
+
+namespace Rei
+{
+
+    void SystemScheduler::build(const std::vector<SystemPtr>& systems, const SystemMask& activeSystems)
+    {
+        m_graph = Graph<SystemNode>(activeSystems.getEnabledBitCount());
+        m_rootNodes.clear();
+
+        for (std::size_t systemIndex = 0; systemIndex < systems.size(); ++systemIndex)
+        {
+            if (systems[systemIndex] == nullptr || !activeSystems[systemIndex])
+                continue;
+
+            SystemNode& node = m_graph.addNode(*systems[systemIndex], systemIndex);
+
+            // Nodes are added in the order of their system's index, which gives a deterministic order between all conflicting systems
+            for (std::size_t prevNodeIndex = 0; prevNodeIndex < m_graph.getNodeCount() - 1; ++prevNodeIndex)
+            {
+                SystemNode& prevNode = m_graph.getNode(prevNodeIndex);
+
+                if (prevNode.getSystem().conflictsWith(node.getSystem()))
+                    node.addParents(prevNode);
+            }
+
+            if (node.isRoot())
+                m_rootNodes.emplace_back(&node);
+        }
+    }
+
+    SystemMask SystemScheduler::run(const FrameTimeInfo& timeInfo, ThreadPool* threadPool)
+    {
+        SystemMask deactivatedSystems;
+
+        if (threadPool == nullptr || threadPool->getThreadCount() == 0 || m_graph.getNodeCount() <= 1)
+        {
+            // Nodes being ordered by system index, this guarantees that every system is updated after its parents
+            for (std::size_t nodeIndex = 0; nodeIndex < m_graph.getNodeCount(); ++nodeIndex)
+                updateSystem(m_graph.getNode(nodeIndex), timeInfo);
+        }
+        else
+        {
+            for (std::size_t nodeIndex = 0; nodeIndex < m_graph.getNodeCount(); ++nodeIndex)
+            {
+                SystemNode& node = m_graph.getNode(nodeIndex);
+                node.m_remainingParentCount.store(node.getParentCount(), std::memory_order_relaxed);
+            }
+
+            JobGroup group;
+
+            for (SystemNode* rootNode : m_rootNodes)
+                scheduleNode(*rootNode, timeInfo, *threadPool, group);
+
+            threadPool->wait(group);
+        }
+
+        for (std::size_t nodeIndex = 0; nodeIndex < m_graph.getNodeCount(); ++nodeIndex)
+        {
+            const std::size_t systemIndex = m_graph.getNode(nodeIndex).getSystemIndex();
+
+            m_timings[systemIndex].addSample(m_updateDurations[systemIndex]);
+
+            if (!m_updateResults[systemIndex])
+                deactivatedSystems.setBit(systemIndex);
+        }
+
+        return deactivatedSystems;
+    }
+
+    void SystemScheduler::updateSystem(SystemNode& node, const FrameTimeInfo& timeInfo)
+    {
+        System& system = node.getSystem();
+
+#if defined(REI_USE_TRACY)
+        ZoneScoped;
+        ZoneName(system.getName(), std::strlen(system.getName()));
+#endif
+
+        const int64_t beginTime = Profiler::recoverTime();
+        m_updateResults[node.getSystemIndex()] = system.update(timeInfo);
+        const int64_t endTime = Profiler::recoverTime();
+
+        m_updateDurations[node.getSystemIndex()] = static_cast<float>(endTime - beginTime) / 1'000'000.f;
+        Profiler::addZone(system.getName(), beginTime, endTime);
+    }
+
+    void SystemScheduler::scheduleNode(SystemNode& node, const FrameTimeInfo& timeInfo, ThreadPool& threadPool, JobGroup& group)
+    {
+        threadPool.addJob(group, [this, &node, &timeInfo, &threadPool, &group]()
+        {
+            updateSystem(node, timeInfo);
+
+            for (SystemNode* child : node.getChildren())
+            {
+                if (child->m_remainingParentCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    scheduleNode(*child, timeInfo, threadPool, group);
+            }
+        });
+    }
+
+} // namespace Rei
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "Graph.h"
+#include "Profiler.h"
+#include "System.h"
+
+namespace Rei
+{
+    struct FrameTimeInfo;
+    class JobGroup;
+    class ThreadPool;
+
+    /// Node of the system dependency graph; a node's parents are the systems which must be updated before it.
+    class SystemNode final : public GraphNode<SystemNode>
+    {
+        friend class SystemScheduler;
+
+    public:
+        SystemNode(System& system, std::size_t systemIndex) : m_system{ &system }, m_systemIndex{ systemIndex } {}
+
+        const System& getSystem() const noexcept { return *m_system; }
+        System& getSystem() noexcept { return *m_system; }
+        std::size_t getSystemIndex() const noexcept { return m_systemIndex; }
+
+    private:
+        System* m_system{};
+        std::size_t m_systemIndex{};
+        std::atomic<std::size_t> m_remainingParentCount = 0;
+    };
+
+    /// Orders the updates of a world's systems according to the components they read & write.
+    /// Two conflicting systems are always updated in the order of their indices; all others may be updated concurrently.
+    /// Each system's update is timed, the durations of the last frames being kept to compute statistics over.
+    class SystemScheduler
+    {
+    public:
+        const Graph<SystemNode>& getGraph() const noexcept { return m_graph; }
+        /// Gets the durations of the last updates of a system.
+        /// \param systemIndex Index of the system.
+        /// \return Timing statistics of the system; empty if it has never been updated.
+        const TimingStatistics& getTimings(std::size_t systemIndex) const noexcept { return m_timings[systemIndex]; }
+
+        /// Rebuilds the dependency graph from the given active systems.
+        /// \param systems Systems to be scheduled, indexed by their ID; null entries are ignored.
+        /// \param activeSystems Mask of the systems to be scheduled.
+        void build(const std::vector<SystemPtr>& systems, const SystemMask& activeSystems);
+        /// Updates all the scheduled systems.
+        /// \param timeInfo Time-related frame information.
+        /// \param threadPool Pool to update the independent systems on; if null, all systems are updated sequentially on the calling thread.
+        /// \return Mask of the systems whose update returned false, and which must then be deactivated.
+        SystemMask run(const FrameTimeInfo& timeInfo, ThreadPool* threadPool);
+        /// Discards the recorded durations of a system, for instance when it is removed.
+        /// \param systemIndex Index of the system.
+        void clearTimings(std::size_t systemIndex) noexcept { m_timings[systemIndex].clear(); }
+
+    private:
+        /// Updates a system, measuring the update's duration & recording it if a profiling capture is ongoing.
+        void updateSystem(SystemNode& node, const FrameTimeInfo& timeInfo);
+        /// Pushes the update of the given system, which will in turn push those of its children once they have no more parent left to wait for.
+        void scheduleNode(SystemNode& node, const FrameTimeInfo& timeInfo, ThreadPool& threadPool, JobGroup& group);
+
+        Graph<SystemNode> m_graph{};
+        std::vector<SystemNode*> m_rootNodes{};
+        // Indexed by system ID; not a vector<bool>, since its elements are written concurrently
+        std::vector<char> m_updateResults = std::vector<char>(MaxSystemCount);
+        std::vector<float> m_updateDurations = std::vector<float>(MaxSystemCount);
+        std::vector<TimingStatistics> m_timings = std::vector<TimingStatistics>(MaxSystemCount);
+    };
+
+} // namespace Rei
@@ -0,0 +1,152 @@
+#include "ThreadPool.h"
+
+namespace Rei
+{
+
+    namespace
+    {
+
+        thread_local const ThreadPool* t_currentPool = nullptr;
+        thread_local std::size_t t_currentThreadIndex = 0;
+
+    } // namespace
+
+    ThreadPool::ThreadPool(std::size_t threadCount)
+    {
+        m_queues.reserve(threadCount + 1);
+
+        for (std::size_t queueIndex = 0; queueIndex < threadCount + 1; ++queueIndex)
+            m_queues.emplace_back(std::make_unique<JobQueue>());
+
+        m_threads.reserve(threadCount);
+
+        for (std::size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+            m_threads.emplace_back([this, threadIndex]() { runWorker(threadIndex); });
+    }
+
+    std::size_t ThreadPool::getDefaultThreadCount() noexcept
+    {
+        const std::size_t hardwareThreadCount = std::thread::hardware_concurrency();
+        return (hardwareThreadCount > 1 ? hardwareThreadCount - 1 : 1);
+    }
+
+    std::size_t ThreadPool::getCurrentThreadIndex() const noexcept
+    {
+        return (t_currentPool == this ? t_currentThreadIndex : m_threads.size());
+    }
+
+    void ThreadPool::addJob(JobGroup& group, std::function<void()> job)
+    {
+        group.m_pendingJobCount.fetch_add(1, std::memory_order_relaxed);
+
+        JobQueue& queue = *m_queues[getCurrentThreadIndex()];
+
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.emplace_back(Job{ std::move(job), &group });
+        }
+
+        m_queuedJobCount.fetch_add(1, std::memory_order_release);
+
+        // Locking the mutex guarantees that a worker about to sleep either sees the new job or is already waiting when notified
+        { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+        m_sleepCondition.notify_one();
+    }
+
+    void ThreadPool::wait(const JobGroup& group)
+    {
+        const std::size_t threadIndex = getCurrentThreadIndex();
+
+        while (!group.isDone())
+        {
+            Job job;
+
+            if (recoverJob(threadIndex, job))
+                executeJob(job);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_isStopping = true;
+        }
+
+        m_sleepCondition.notify_all();
+
+        for (std::thread& thread : m_threads)
+            thread.join();
+    }
+
+    bool ThreadPool::recoverJob(std::size_t threadIndex, Job& job)
+    {
+        if (m_queuedJobCount.load(std::memory_order_acquire) == 0)
+            return false;
+
+        // The thread's own queue is processed in LIFO order, keeping recently pushed (and likely cache-hot) jobs on the same thread
+        {
+            JobQueue& ownQueue = *m_queues[threadIndex];
+            std::lock_guard<std::mutex> lock(ownQueue.mutex);
+
+            if (!ownQueue.jobs.empty())
+            {
+                job = std::move(ownQueue.jobs.back());
+                ownQueue.jobs.pop_back();
+                m_queuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+
+                return true;
+            }
+        }
+
+        // Other queues are stolen from in FIFO order, taking the oldest jobs which are generally the largest ones
+        for (std::size_t queueOffset = 1; queueOffset < m_queues.size(); ++queueOffset)
+        {
+            JobQueue& queue = *m_queues[(threadIndex + queueOffset) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (!queue.jobs.empty())
+            {
+                job = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+                m_queuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPool::executeJob(Job& job)
+    {
+        job.function();
+        job.group->m_pendingJobCount.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void ThreadPool::runWorker(std::size_t threadIndex)
+    {
+        t_currentPool = this;
+        t_currentThreadIndex = threadIndex;
+
+        while (true)
+        {
+            Job job;
+
+            if (recoverJob(threadIndex, job))
+            {
+                executeJob(job);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_sleepCondition.wait(lock, [this]() { return (m_isStopping || m_queuedJobCount.load(std::memory_order_acquire) > 0); });
+
+            if (m_isStopping && m_queuedJobCount.load(std::memory_order_acquire) == 0)
+                return;
+        }
+    }
+
+} // namespace Rei
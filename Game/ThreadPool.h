@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Rei
+{
+
+    /// Counter of the jobs pushed into a ThreadPool which have yet to be completed, allowing to wait on a given set of jobs.
+    class JobGroup
+    {
+        friend class ThreadPool;
+
+    public:
+        JobGroup() = default;
+        JobGroup(const JobGroup&) = delete;
+        JobGroup(JobGroup&&) noexcept = delete;
+
+        bool isDone() const noexcept { return (m_pendingJobCount.load(std::memory_order_acquire) == 0); }
+
+        JobGroup& operator=(const JobGroup&) = delete;
+        JobGroup& operator=(JobGroup&&) noexcept = delete;
+
+    private:
+        std::atomic<std::size_t> m_pendingJobCount = 0;
+    };
+
+    /// Pool of worker threads executing jobs, each worker having its own queue & stealing from the others' when it runs out of work.
+    /// \note Jobs may push other jobs. A thread waiting on a group helps executing pending jobs instead of blocking, so that waiting
+    ///   from within a job (for nested parallelism) cannot deadlock the pool.
+    class ThreadPool
+    {
+    public:
+        /// Creates a pool with the given amount of worker threads.
+        /// \param threadCount Number of worker threads; defaults to one less than the number of hardware threads, leaving one for the calling thread.
+        explicit ThreadPool(std::size_t threadCount = getDefaultThreadCount());
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool(ThreadPool&&) noexcept = delete;
+
+        std::size_t getThreadCount() const noexcept { return m_threads.size(); }
+        static std::size_t getDefaultThreadCount() noexcept;
+        /// Gets the index of the calling thread, which is unique amongst the threads that can run this pool's jobs.
+        /// \return Index between 0 & getThreadCount() - 1 for the pool's workers, getThreadCount() for any other thread.
+        std::size_t getCurrentThreadIndex() const noexcept;
+
+        /// Pushes a job to be executed by any thread of the pool.
+        /// \param group Group the job belongs to, which can be waited on.
+        /// \param job Function to be executed.
+        void addJob(JobGroup& group, std::function<void()> job);
+        /// Waits for all the jobs of the given group to be completed, executing pending jobs in the meantime.
+        /// \param group Group to be waited on.
+        void wait(const JobGroup& group);
+        /// Splits a range of indices into batches executed in parallel, then waits for all of them to be completed.
+        /// \tparam FuncT Type of the function to be called on each batch.
+        /// \param count Number of indices to process.
+        /// \param grainSize Maximum number of consecutive indices processed by a single job.
+        /// \param func Function to be called with the [begin; end[ range of each batch.
+        template <typename FuncT>
+        void parallelFor(std::size_t count, std::size_t grainSize, FuncT&& func)
+        {
+            if (count == 0)
+                return;
+
+            if (grainSize == 0)
+                grainSize = 1;
+
+            JobGroup group;
+
+            // The calling thread processes the first batch itself, instead of merely waiting
+            for (std::size_t batchBegin = grainSize; batchBegin < count; batchBegin += grainSize)
+            {
+                const std::size_t batchEnd = std::min(batchBegin + grainSize, count);
+                addJob(group, [&func, batchBegin, batchEnd]() { func(batchBegin, batchEnd); });
+            }
+
+            func(std::size_t{ 0 }, std::min(grainSize, count));
+            wait(group);
+        }
+
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ThreadPool& operator=(ThreadPool&&) noexcept = delete;
+
+        ~ThreadPool();
+
+    private:
+        struct Job
+        {
+            std::function<void()> function{};
+            JobGroup* group{};
+        };
+
+        struct JobQueue
+        {
+            std::mutex mutex{};
+            std::deque<Job> jobs{};
+        };
+
+        /// Pops a job from the given thread's own queue, or steals one from another thread's if it is empty.
+        /// \param threadIndex Index of the thread looking for a job.
+        /// \param job Job to be filled.
+        /// \return True if a job has been found, false otherwise.
+        bool recoverJob(std::size_t threadIndex, Job& job);
+        void executeJob(Job& job);
+        void runWorker(std::size_t threadIndex);
+
+        std::vector<std::thread> m_threads{};
+        // One queue per worker, plus a last one shared between all non-worker threads
+        std::vector<std::unique_ptr<JobQueue>> m_queues{};
+
+        std::atomic<std::size_t> m_queuedJobCount = 0;
+        std::mutex m_sleepMutex{};
+        std::condition_variable m_sleepCondition{};
+        bool m_isStopping = false;
+    };
+
+} // namespace Rei
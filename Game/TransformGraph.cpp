@@ -0,0 +1,140 @@
+#include "TransformGraph.h"
+
+#include <stdexcept>
+
+#include "MatrixSimd.h"
+#include "ThreadPool.h"
+
+namespace Rei
+{
+
+    void TransformGraph::removeNode(TransformNode& node)
+    {
+        // The children's world matrices will no longer depend on the removed node
+        for (TransformNode* child : node.getChildren())
+            child->m_isDirty = true;
+
+        m_graph.removeNode(node);
+        m_isHierarchyDirty = true;
+    }
+
+    void TransformGraph::setParent(TransformNode& node, TransformNode* parent)
+    {
+        assert("Error: A transform node cannot have more than one parent." && node.getParentCount() <= 1);
+
+        for (const TransformNode* ancestor = parent; ancestor != nullptr; ancestor = ancestor->getParentNode())
+        {
+            if (ancestor == &node)
+                throw std::invalid_argument("Error: A transform node cannot be attached to itself or to one of its descendants");
+        }
+
+        if (TransformNode* currentParent = node.getParentNode())
+            node.removeParents(*currentParent);
+
+        if (parent != nullptr)
+            node.addParents(*parent);
+
+        node.m_isDirty = true;
+        m_isHierarchyDirty = true;
+    }
+
+    void TransformGraph::update(ThreadPool* threadPool)
+    {
+        if (m_isHierarchyDirty)
+            flatten();
+
+        for (std::size_t levelIndex = 0; levelIndex < getLevelCount(); ++levelIndex)
+        {
+            const std::size_t levelBegin = m_levelOffsets[levelIndex];
+            const std::size_t levelSize  = m_levelOffsets[levelIndex + 1] - levelBegin;
+
+            // The nodes of a level only read their parents' matrices, which all belong to the previous level
+            if (threadPool == nullptr || levelSize <= ParallelGrainSize)
+            {
+                updateRange(levelBegin, levelBegin + levelSize);
+                continue;
+            }
+
+            threadPool->parallelFor(levelSize, ParallelGrainSize, [this, levelBegin](std::size_t beginIndex, std::size_t endIndex)
+            {
+                updateRange(levelBegin + beginIndex, levelBegin + endIndex);
+            });
+        }
+    }
+
+    void TransformGraph::flatten()
+    {
+        m_flattenedNodes.clear();
+        m_parentIndices.clear();
+        m_levelOffsets.clear();
+
+        m_flattenedNodes.reserve(m_graph.getNodeCount());
+        m_parentIndices.reserve(m_graph.getNodeCount());
+
+        for (std::size_t nodeIndex = 0; nodeIndex < m_graph.getNodeCount(); ++nodeIndex)
+        {
+            TransformNode& node = m_graph.getNode(nodeIndex);
+
+            if (!node.isRoot())
+                continue;
+
+            m_flattenedNodes.emplace_back(&node);
+            m_parentIndices.emplace_back(InvalidIndex);
+        }
+
+        // Each level is made of the children of the previous one, in order
+        std::size_t levelBegin = 0;
+
+        while (levelBegin < m_flattenedNodes.size())
+        {
+            const std::size_t levelEnd = m_flattenedNodes.size();
+            m_levelOffsets.emplace_back(levelBegin);
+
+            for (std::size_t nodeIndex = levelBegin; nodeIndex < levelEnd; ++nodeIndex)
+            {
+                for (TransformNode* child : m_flattenedNodes[nodeIndex]->getChildren())
+                {
+                    assert("Error: A transform node cannot have more than one parent." && child->getParentCount() == 1);
+
+                    m_flattenedNodes.emplace_back(child);
+                    m_parentIndices.emplace_back(nodeIndex);
+                }
+            }
+
+            levelBegin = levelEnd;
+        }
+
+        m_levelOffsets.emplace_back(m_flattenedNodes.size());
+
+        assert("Error: Every transform node must be reachable from a root." && m_flattenedNodes.size() == m_graph.getNodeCount());
+
+        m_updatedNodes.assign(m_flattenedNodes.size(), 0);
+        m_isHierarchyDirty = false;
+    }
+
+    void TransformGraph::updateRange(std::size_t beginIndex, std::size_t endIndex) noexcept
+    {
+        for (std::size_t nodeIndex = beginIndex; nodeIndex < endIndex; ++nodeIndex)
+        {
+            TransformNode& node = *m_flattenedNodes[nodeIndex];
+            const std::size_t parentIndex = m_parentIndices[nodeIndex];
+            const bool isParentUpdated = (parentIndex != InvalidIndex && m_updatedNodes[parentIndex]);
+
+            if (!node.m_isDirty && !isParentUpdated)
+            {
+                m_updatedNodes[nodeIndex] = false;
+                continue;
+            }
+
+            if (node.m_isDirty)
+                node.m_localMatrix = Simd::composeTrs(node.m_position, node.m_rotation, node.m_scale);
+
+            node.m_worldMatrix = (parentIndex == InvalidIndex ? node.m_localMatrix
+                                                              : Simd::multiply(m_flattenedNodes[parentIndex]->m_worldMatrix, node.m_localMatrix));
+            ++node.m_worldMatrixVersion;
+            node.m_isDirty = false;
+            m_updatedNodes[nodeIndex] = true;
+        }
+    }
+
+} // namespace Rei
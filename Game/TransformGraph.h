@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Graph.h"
+#include "Matrix.h"
+#include "Quaternion.h"
+#include "Vector.h"
+
+namespace Rei
+{
+
+    class ThreadPool;
+    class TransformGraph;
+
+    /// Node of a transform hierarchy, holding a transformation relative to its parent node.
+    /// Its world matrix is only recomputed by its graph if its local transformation or any of its ancestors' has changed since the last update.
+    /// \note A transform node can have at most one parent; its hierarchy must be modified through TransformGraph::setParent().
+    class TransformNode final : public GraphNode<TransformNode>
+    {
+        friend TransformGraph;
+
+    public:
+        explicit TransformNode(const Vec3f& position = Vec3f(), const Quaternionf& rotation = Quaternionf::identity(), const Vec3f& scale = Vec3f(1.f)) noexcept
+            : m_position{ position }, m_rotation{ rotation }, m_scale{ scale } {}
+
+        const Vec3f& getPosition() const noexcept { return m_position; }
+        const Quaternionf& getRotation() const noexcept { return m_rotation; }
+        const Vec3f& getScale() const noexcept { return m_scale; }
+        /// Gets the transformation relative to the parent node, as of the last graph update.
+        const Mat4f& getLocalMatrix() const noexcept { return m_localMatrix; }
+        /// Gets the transformation relative to the world, as of the last graph update.
+        const Mat4f& getWorldMatrix() const noexcept { return m_worldMatrix; }
+        /// Checks if the local transformation has changed since the last graph update.
+        bool isDirty() const noexcept { return m_isDirty; }
+        /// Gets the number of times the world matrix has been recomputed, allowing to detect its changes without comparing matrices.
+        uint32_t getWorldMatrixVersion() const noexcept { return m_worldMatrixVersion; }
+        /// Gets the parent node, if any.
+        /// \return Pointer to the parent node, nullptr if the node is a root.
+        TransformNode* getParentNode() const noexcept { return (isRoot() ? nullptr : m_parents.front()); }
+
+        void setPosition(const Vec3f& position) noexcept
+        {
+            m_position = position;
+            m_isDirty = true;
+        }
+
+        void setRotation(const Quaternionf& rotation) noexcept
+        {
+            m_rotation = rotation;
+            m_isDirty = true;
+        }
+
+        void setScale(const Vec3f& scale) noexcept
+        {
+            m_scale = scale;
+            m_isDirty = true;
+        }
+
+        /// Moves the node relatively to its parent.
+        /// \param displacement Displacement to be added to the current position.
+        void translate(const Vec3f& displacement) noexcept { setPosition(m_position + displacement); }
+        /// Rotates the node relatively to its parent; the given rotation is applied after the current one.
+        /// \param rotation Rotation to be applied; must be normalized.
+        void rotate(const Quaternionf& rotation) noexcept { setRotation((rotation * m_rotation).normalize()); }
+
+    private:
+        Vec3f m_position{};
+        Quaternionf m_rotation = Quaternionf::identity();
+        Vec3f m_scale = Vec3f(1.f);
+        Mat4f m_localMatrix = Mat4f::identity();
+        Mat4f m_worldMatrix = Mat4f::identity();
+        uint32_t m_worldMatrixVersion = 0;
+        bool m_isDirty = true;
+    };
+
+    /// Hierarchy of transform nodes, whose world matrices are propagated from the roots down to the leaves.
+    /// The hierarchy is flattened in breadth-first order, an array per depth level; the nodes of a level only depend on the previous ones,
+    ///   allowing each level to be updated in parallel.
+    /// \note The nodes are held by a Graph rather than inherited from one, so that they can only be added & removed through the functions
+    ///   keeping the hierarchy up to date.
+    class TransformGraph
+    {
+    public:
+        /// Default constructor.
+        TransformGraph() = default;
+        /// Creates a graph while preallocating the given amount of nodes.
+        /// \param nodeCount Amount of nodes to reserve.
+        explicit TransformGraph(std::size_t nodeCount) : m_graph(nodeCount) {}
+
+        std::size_t getNodeCount() const noexcept { return m_graph.getNodeCount(); }
+        const TransformNode& getNode(std::size_t index) const noexcept { return m_graph.getNode(index); }
+        TransformNode& getNode(std::size_t index) noexcept { return m_graph.getNode(index); }
+        /// Gets the number of depth levels of the hierarchy, as of the last update.
+        std::size_t getLevelCount() const noexcept { return (m_levelOffsets.empty() ? 0 : m_levelOffsets.size() - 1); }
+
+        /// Adds a root node into the graph.
+        /// \tparam Args Types of the arguments to be forwarded to the node's constructor.
+        /// \param args Arguments to be forwarded to the node's constructor.
+        /// \return Reference to the newly added node.
+        template <typename... Args>
+        TransformNode& addNode(Args&&... args)
+        {
+            m_isHierarchyDirty = true;
+            return m_graph.addNode(std::forward<Args>(args)...);
+        }
+        /// Removes a node from the graph; its children become roots.
+        /// \param node Node to be removed.
+        void removeNode(TransformNode& node);
+        /// Attaches a node to a new parent, detaching it from its current one if any.
+        /// \param node Node to be attached.
+        /// \param parent New parent of the node; the node becomes a root if nullptr.
+        void setParent(TransformNode& node, TransformNode* parent);
+        /// Marks the hierarchy as modified, forcing it to be flattened again on the next update.
+        /// Only required if nodes have been linked directly through GraphNode's functions.
+        void invalidateHierarchy() noexcept { m_isHierarchyDirty = true; }
+        /// Recomputes the matrices of the nodes whose local transformation or any of whose ancestors' has changed.
+        /// \param threadPool Thread pool on which to update the largest levels in parallel; if nullptr, everything is updated on the calling thread.
+        void update(ThreadPool* threadPool = nullptr);
+
+    private:
+        static constexpr std::size_t InvalidIndex = std::numeric_limits<std::size_t>::max();
+        /// Minimum number of nodes of a level to be updated by a single job.
+        static constexpr std::size_t ParallelGrainSize = 128;
+
+        void flatten();
+        void updateRange(std::size_t beginIndex, std::size_t endIndex) noexcept;
+
+        Graph<TransformNode> m_graph{};
+        /// Nodes in breadth-first order, the roots coming first.
+        std::vector<TransformNode*> m_flattenedNodes{};
+        /// Index of each flattened node's parent, InvalidIndex for roots.
+        std::vector<std::size_t> m_parentIndices{};
+        /// Index of the first flattened node of each depth level, followed by the number of nodes.
+        std::vector<std::size_t> m_levelOffsets{};
+        /// Whether each flattened node's world matrix has been recomputed during the current update; bytes are used so that they can be written concurrently.
+        std::vector<uint8_t> m_updatedNodes{};
+        bool m_isHierarchyDirty = true;
+    };
+
+} // namespace Rei
@@ -0,0 +1,17 @@
+#include "TransformSystem.h"
+
+namespace Rei
+{
+
+    bool TransformSystem::update([[maybe_unused]] const FrameTimeInfo& timeInfo)
+    {
+        m_graph.update(m_threadPool);
+        return true;
+    }
+
+    void TransformSystem::destroy()
+    {
+        m_graph = TransformGraph();
+    }
+
+} // namespace Rei
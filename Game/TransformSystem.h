@@ -0,0 +1,29 @@
+#pragma once
+
+#include "System.h"
+#include "TransformGraph.h"
+
+namespace Rei
+{
+
+    /// System owning a world's transform hierarchy, whose world matrices are recomputed on each update.
+    /// \note As it declares no component accesses, it is never updated concurrently with another system, & conflicting systems are updated in the order of
+    ///   SystemTypes (see TypeRegistry.h), not in the order they were added to the world. Systems reading world matrices in the same frame must thus come
+    ///   after it in SystemTypes.
+    class TransformSystem final : public System
+    {
+    public:
+        TransformSystem() = default;
+
+        const TransformGraph& getGraph() const noexcept { return m_graph; }
+        TransformGraph& getGraph() noexcept { return m_graph; }
+
+        bool update(const FrameTimeInfo& timeInfo) override;
+
+        void destroy() override;
+
+    private:
+        TransformGraph m_graph{};
+    };
+
+} // namespace Rei
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace Rei
+{
+
+    /// Compile-time list of types.
+    /// \tparam Ts Types of the list.
+    template <typename... Ts>
+    struct TypeList
+    {
+        static constexpr std::size_t Size = sizeof...(Ts);
+    };
+
+    namespace Detail
+    {
+
+        template <typename T, typename... Ts>
+        constexpr std::size_t findTypeIndex() noexcept
+        {
+            // A last element is added so that the array is never empty
+            constexpr bool matches[] = { std::is_same_v<T, Ts>..., false };
+
+            for (std::size_t typeIndex = 0; typeIndex < sizeof...(Ts); ++typeIndex)
+            {
+                if (matches[typeIndex])
+                    return typeIndex;
+            }
+
+            return sizeof...(Ts);
+        }
+
+        template <typename... Ts>
+        constexpr bool hasUniqueTypes() noexcept
+        {
+            constexpr std::size_t firstIndices[] = { findTypeIndex<Ts, Ts...>()..., 0 };
+
+            for (std::size_t typeIndex = 0; typeIndex < sizeof...(Ts); ++typeIndex)
+            {
+                if (firstIndices[typeIndex] != typeIndex)
+                    return false;
+            }
+
+            return true;
+        }
+
+    } // namespace Detail
+
+    /// Gives the index of a type within a type list, or the list's size if it isn't part of it.
+    /// \note Types are compared as is; they may be incomplete.
+    template <typename T, typename ListT>
+    struct TypeListIndex;
+
+    template <typename T, typename... Ts>
+    struct TypeListIndex<T, TypeList<Ts...>> : std::integral_constant<std::size_t, Detail::findTypeIndex<T, Ts...>()> {};
+
+    template <typename T, typename ListT>
+    constexpr std::size_t TypeListIndex_v = TypeListIndex<T, ListT>::value;
+
+    template <typename T, typename ListT>
+    constexpr bool TypeListContains_v = (TypeListIndex_v<T, ListT> < ListT::Size);
+
+    /// Checks that no type appears more than once in a type list.
+    template <typename ListT>
+    struct HasUniqueTypes;
+
+    template <typename... Ts>
+    struct HasUniqueTypes<TypeList<Ts...>> : std::bool_constant<Detail::hasUniqueTypes<Ts...>()> {};
+
+    template <typename ListT>
+    constexpr bool HasUniqueTypes_v = HasUniqueTypes<ListT>::value;
+
+} // namespace Rei
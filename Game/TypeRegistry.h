@@ -0,0 +1,38 @@
+#pragma once
+
+#include "TypeList.h"
+
+namespace Rei
+{
+
+    // Every component & system type must be declared here, and listed below; types may stay incomplete, so that this header includes no other.
+    class Bounds;
+    class BroadphaseSystem;
+    class Hitbox;
+    class HitDetectionSystem;
+    class MeshRenderer;
+    class NetworkSystem;
+    class RenderSystem;
+    class TransformSystem;
+
+    /// All the component types, whose index in this list is their identifier.
+    /// \note Identifiers must be the same across all builds (client & server alike), as they are used in masks & serialized data.
+    ///   New types must thus always be appended, never inserted nor reordered.
+    using ComponentTypes = TypeList<MeshRenderer, Hitbox, Bounds>;
+
+    /// All the system types, whose index in this list is their identifier.
+    /// \note Conflicting systems are updated in the order of their identifier, whatever the order they were added to a world in. A system reading what another
+    ///   one writes must thus come after it; in particular, systems reading transforms' world matrices (like RenderSystem) must come after TransformSystem.
+    ///   System identifiers are never serialized, so that types may be inserted anywhere this order requires.
+    using SystemTypes = TypeList<TransformSystem, RenderSystem, NetworkSystem, HitDetectionSystem, BroadphaseSystem>;
+
+    /// Component types whose state is part of the world snapshots sent over the network & recorded in replays; each must also be listed in
+    ///   ComponentTypes & be serializable (see Serialization.h), & its header must be included in WorldSnapshot.cpp.
+    /// \note Like the others, this list must be identical across builds; new types must always be appended.
+    using SerializableComponentTypes = TypeList<>;
+
+    static_assert(HasUniqueTypes_v<ComponentTypes>, "Error: A component type is registered more than once.");
+    static_assert(HasUniqueTypes_v<SystemTypes>, "Error: A system type is registered more than once.");
+    static_assert(HasUniqueTypes_v<SerializableComponentTypes>, "Error: A serializable component type is registered more than once.");
+
+} // namespace Rei
@@ -0,0 +1,457 @@
+#include "UdpSocket.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <array>
+
+#if defined(_WIN32)
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <mstcpip.h>
+#include <ws2tcpip.h>
+
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace Rei
+{
+
+    namespace
+    {
+
+        sockaddr_in toSocketAddress(const NetworkAddress& address) noexcept
+        {
+            sockaddr_in socketAddress {};
+            socketAddress.sin_family      = AF_INET;
+            socketAddress.sin_addr.s_addr = htonl(address.host);
+            socketAddress.sin_port        = htons(address.port);
+
+            return socketAddress;
+        }
+
+        NetworkAddress fromSocketAddress(const sockaddr_in& socketAddress) noexcept
+        {
+            return NetworkAddress{ ntohl(socketAddress.sin_addr.s_addr), ntohs(socketAddress.sin_port) };
+        }
+
+        // A big enough receive buffer lets the kernel hold the packets arriving while the I/O thread is busy
+        constexpr int SocketBufferSize = 1 << 20;
+
+    } // namespace
+
+#if defined(_WIN32)
+
+    /// Receive posted on the completion port, along with the packet being received into.
+    struct UdpSocket::PendingReceive
+    {
+        OVERLAPPED overlapped{};
+        WSABUF buffer{};
+        sockaddr_in address{};
+        INT addressSize = sizeof(sockaddr_in);
+        DWORD flags = 0;
+        Packet* packet{};
+        bool isPending = false;
+    };
+
+    namespace
+    {
+
+        /// Number of receives kept posted at all times; each holds a packet of the pool.
+        constexpr std::size_t PendingReceiveCount = 64;
+
+    } // namespace
+
+    bool UdpSocket::open(uint16_t port, PacketPool& receivePool)
+    {
+        close();
+
+        WSADATA wsaData {};
+
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+        {
+            Logger::error("[UdpSocket] Failed to initialize WinSock.");
+            return false;
+        }
+
+        const SOCKET socketHandle = WSASocketW(AF_INET, SOCK_DGRAM, IPPROTO_UDP, nullptr, 0, WSA_FLAG_OVERLAPPED);
+
+        if (socketHandle == INVALID_SOCKET)
+        {
+            Logger::error("[UdpSocket] Failed to create the socket (error " + std::to_string(WSAGetLastError()) + ").");
+            WSACleanup();
+            return false;
+        }
+
+        m_handle = static_cast<uintptr_t>(socketHandle);
+        m_receivePool = &receivePool;
+        m_isOpen = true;
+
+        // Sending to a closed port makes the next receive fail with WSAECONNRESET, which must not disrupt the other connections
+        BOOL reportConnectionReset = FALSE;
+        DWORD returnedSize = 0;
+        WSAIoctl(socketHandle, SIO_UDP_CONNRESET, &reportConnectionReset, sizeof(reportConnectionReset), nullptr, 0, &returnedSize, nullptr, nullptr);
+
+        u_long isNonBlocking = 1;
+        ioctlsocket(socketHandle, FIONBIO, &isNonBlocking);
+        setsockopt(socketHandle, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&SocketBufferSize), sizeof(SocketBufferSize));
+        setsockopt(socketHandle, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&SocketBufferSize), sizeof(SocketBufferSize));
+
+        sockaddr_in address = toSocketAddress(NetworkAddress{ INADDR_ANY, port });
+        INT addressSize = sizeof(address);
+
+        if (bind(socketHandle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR
+         || getsockname(socketHandle, reinterpret_cast<sockaddr*>(&address), &addressSize) == SOCKET_ERROR)
+        {
+            Logger::error("[UdpSocket] Failed to bind the socket to port " + std::to_string(port) + " (error " + std::to_string(WSAGetLastError()) + ").");
+            close();
+            return false;
+        }
+
+        m_port = ntohs(address.sin_port);
+        m_completionPort = CreateIoCompletionPort(reinterpret_cast<HANDLE>(socketHandle), nullptr, 0, 1);
+
+        if (m_completionPort == nullptr)
+        {
+            Logger::error("[UdpSocket] Failed to create the I/O completion port.");
+            close();
+            return false;
+        }
+
+        m_pendingReceives.resize(PendingReceiveCount);
+
+        for (std::unique_ptr<PendingReceive>& pendingReceive : m_pendingReceives)
+        {
+            pendingReceive = std::make_unique<PendingReceive>();
+            postReceive(*pendingReceive);
+        }
+
+        return true;
+    }
+
+    void UdpSocket::close()
+    {
+        if (!m_isOpen)
+            return;
+
+        closesocket(static_cast<SOCKET>(m_handle));
+
+        // Closing the socket cancels the pending receives, whose completions must still be dequeued before their packets can be released
+        if (m_completionPort)
+        {
+            std::array<OVERLAPPED_ENTRY, MaxBatchSize> entries {};
+
+            while (std::any_of(m_pendingReceives.cbegin(), m_pendingReceives.cend(), [](const auto& receive) { return receive->isPending; }))
+            {
+                ULONG entryCount = 0;
+
+                if (!GetQueuedCompletionStatusEx(m_completionPort, entries.data(), static_cast<ULONG>(entries.size()), &entryCount, 1000, FALSE))
+                    break;
+
+                for (ULONG entryIndex = 0; entryIndex < entryCount; ++entryIndex)
+                    CONTAINING_RECORD(entries[entryIndex].lpOverlapped, PendingReceive, overlapped)->isPending = false;
+            }
+
+            CloseHandle(m_completionPort);
+            m_completionPort = nullptr;
+        }
+
+        for (const std::unique_ptr<PendingReceive>& pendingReceive : m_pendingReceives)
+        {
+            // A receive which could not be dequeued may still be written into by the system, & its packet is thus leaked rather than reused
+            if (pendingReceive->packet && !pendingReceive->isPending)
+                m_receivePool->release(*pendingReceive->packet);
+        }
+
+        m_pendingReceives.clear();
+        WSACleanup();
+
+        m_handle = 0;
+        m_port = 0;
+        m_isOpen = false;
+    }
+
+    std::size_t UdpSocket::receive(Packet** packets, std::size_t maxCount, int timeoutMs)
+    {
+        const SOCKET socketHandle = static_cast<SOCKET>(m_handle);
+
+        // Receives which could not be posted for lack of free packets are retried
+        for (const std::unique_ptr<PendingReceive>& pendingReceive : m_pendingReceives)
+        {
+            if (!pendingReceive->isPending)
+                postReceive(*pendingReceive);
+        }
+
+        std::array<OVERLAPPED_ENTRY, MaxBatchSize> entries {};
+        ULONG entryCount = 0;
+
+        if (!GetQueuedCompletionStatusEx(m_completionPort, entries.data(), static_cast<ULONG>(std::min(maxCount, MaxBatchSize)), &entryCount, static_cast<DWORD>(timeoutMs), FALSE))
+            return 0;
+
+        std::size_t packetCount = 0;
+
+        for (ULONG entryIndex = 0; entryIndex < entryCount; ++entryIndex)
+        {
+            PendingReceive& pendingReceive = *CONTAINING_RECORD(entries[entryIndex].lpOverlapped, PendingReceive, overlapped);
+            pendingReceive.isPending = false;
+
+            DWORD receivedSize = 0;
+            DWORD flags = 0;
+
+            // Failed or truncated receives are dropped, their packet being reused for the next receive
+            if (WSAGetOverlappedResult(socketHandle, &pendingReceive.overlapped, &receivedSize, FALSE, &flags))
+            {
+                pendingReceive.packet->size    = receivedSize;
+                pendingReceive.packet->address = fromSocketAddress(pendingReceive.address);
+                packets[packetCount++] = pendingReceive.packet;
+                pendingReceive.packet = nullptr;
+            }
+
+            postReceive(pendingReceive);
+        }
+
+        return packetCount;
+    }
+
+    std::size_t UdpSocket::send(Packet* const* packets, std::size_t count)
+    {
+        const SOCKET socketHandle = static_cast<SOCKET>(m_handle);
+        std::size_t sentCount = 0;
+
+        // WinSock has no batched send for UDP; the sends being non-blocking, they are only as many copies into the socket's buffer
+        for (std::size_t packetIndex = 0; packetIndex < count; ++packetIndex)
+        {
+            const Packet& packet = *packets[packetIndex];
+            const sockaddr_in address = toSocketAddress(packet.address);
+
+            WSABUF buffer {};
+            buffer.buf = reinterpret_cast<CHAR*>(const_cast<uint8_t*>(packet.data.data()));
+            buffer.len = packet.size;
+
+            DWORD sentSize = 0;
+
+            if (WSASendTo(socketHandle, &buffer, 1, &sentSize, 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address), nullptr, nullptr) == 0)
+                ++sentCount;
+        }
+
+        return sentCount;
+    }
+
+    bool UdpSocket::postReceive(PendingReceive& pendingReceive)
+    {
+        if (pendingReceive.packet == nullptr)
+        {
+            pendingReceive.packet = m_receivePool->acquire();
+
+            if (pendingReceive.packet == nullptr)
+                return false;
+        }
+
+        pendingReceive.overlapped  = OVERLAPPED{};
+        pendingReceive.buffer.buf  = reinterpret_cast<CHAR*>(pendingReceive.packet->data.data());
+        pendingReceive.buffer.len  = static_cast<ULONG>(Packet::MaxSize);
+        pendingReceive.addressSize = sizeof(pendingReceive.address);
+        pendingReceive.flags       = 0;
+
+        const int result = WSARecvFrom(static_cast<SOCKET>(m_handle), &pendingReceive.buffer, 1, nullptr, &pendingReceive.flags,
+                                       reinterpret_cast<sockaddr*>(&pendingReceive.address), &pendingReceive.addressSize, &pendingReceive.overlapped, nullptr);
+
+        // Even receives completing immediately are queued on the completion port
+        pendingReceive.isPending = (result == 0 || WSAGetLastError() == WSA_IO_PENDING);
+        return pendingReceive.isPending;
+    }
+
+#else
+
+    bool UdpSocket::open(uint16_t port, PacketPool& receivePool)
+    {
+        close();
+
+        const int socketHandle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+        if (socketHandle < 0)
+        {
+            Logger::error("[UdpSocket] Failed to create the socket (error " + std::to_string(errno) + ").");
+            return false;
+        }
+
+        m_handle = static_cast<uintptr_t>(socketHandle);
+        m_receivePool = &receivePool;
+        m_isOpen = true;
+
+        fcntl(socketHandle, F_SETFL, fcntl(socketHandle, F_GETFL, 0) | O_NONBLOCK);
+        setsockopt(socketHandle, SOL_SOCKET, SO_RCVBUF, &SocketBufferSize, sizeof(SocketBufferSize));
+        setsockopt(socketHandle, SOL_SOCKET, SO_SNDBUF, &SocketBufferSize, sizeof(SocketBufferSize));
+
+        sockaddr_in address = toSocketAddress(NetworkAddress{ INADDR_ANY, port });
+        socklen_t addressSize = sizeof(address);
+
+        if (bind(socketHandle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+         || getsockname(socketHandle, reinterpret_cast<sockaddr*>(&address), &addressSize) != 0)
+        {
+            Logger::error("[UdpSocket] Failed to bind the socket to port " + std::to_string(port) + " (error " + std::to_string(errno) + ").");
+            close();
+            return false;
+        }
+
+        m_port = ntohs(address.sin_port);
+        return true;
+    }
+
+    void UdpSocket::close()
+    {
+        if (!m_isOpen)
+            return;
+
+        ::close(static_cast<int>(m_handle));
+
+        m_handle = 0;
+        m_port = 0;
+        m_isOpen = false;
+    }
+
+    std::size_t UdpSocket::receive(Packet** packets, std::size_t maxCount, int timeoutMs)
+    {
+        const int socketHandle = static_cast<int>(m_handle);
+
+        pollfd pollDescriptor { socketHandle, POLLIN, 0 };
+
+        if (poll(&pollDescriptor, 1, timeoutMs) <= 0)
+            return 0;
+
+        // Packets are taken from the pool beforehand, for the data to be received directly into them
+        std::size_t acquiredCount = 0;
+
+        for (; acquiredCount < std::min(maxCount, MaxBatchSize); ++acquiredCount)
+        {
+            packets[acquiredCount] = m_receivePool->acquire();
+
+            if (packets[acquiredCount] == nullptr)
+                break;
+        }
+
+        std::size_t packetCount = 0;
+
+#if defined(__linux__)
+        std::array<mmsghdr, MaxBatchSize> messages {};
+        std::array<iovec, MaxBatchSize> buffers {};
+        std::array<sockaddr_in, MaxBatchSize> addresses {};
+
+        for (std::size_t packetIndex = 0; packetIndex < acquiredCount; ++packetIndex)
+        {
+            buffers[packetIndex] = iovec{ packets[packetIndex]->data.data(), Packet::MaxSize };
+
+            msghdr& header     = messages[packetIndex].msg_hdr;
+            header.msg_name    = &addresses[packetIndex];
+            header.msg_namelen = sizeof(sockaddr_in);
+            header.msg_iov     = &buffers[packetIndex];
+            header.msg_iovlen  = 1;
+        }
+
+        const int messageCount = recvmmsg(socketHandle, messages.data(), static_cast<unsigned int>(acquiredCount), MSG_DONTWAIT, nullptr);
+
+        for (int messageIndex = 0; messageIndex < messageCount; ++messageIndex)
+        {
+            // Truncated datagrams cannot be valid, & are dropped
+            if (messages[messageIndex].msg_hdr.msg_flags & MSG_TRUNC)
+                continue;
+
+            Packet& packet = *packets[messageIndex];
+            packet.size    = messages[messageIndex].msg_len;
+            packet.address = fromSocketAddress(addresses[messageIndex]);
+            std::swap(packets[packetCount++], packets[messageIndex]);
+        }
+#else
+        for (std::size_t packetIndex = 0; packetIndex < acquiredCount; ++packetIndex)
+        {
+            sockaddr_in address {};
+            socklen_t addressSize = sizeof(address);
+            Packet& packet = *packets[packetIndex];
+
+            const ssize_t receivedSize = recvfrom(socketHandle, packet.data.data(), Packet::MaxSize, MSG_DONTWAIT, reinterpret_cast<sockaddr*>(&address), &addressSize);
+
+            if (receivedSize < 0)
+                break;
+
+            packet.size    = static_cast<uint32_t>(receivedSize);
+            packet.address = fromSocketAddress(address);
+            std::swap(packets[packetCount++], packets[packetIndex]);
+        }
+#endif
+
+        for (std::size_t packetIndex = packetCount; packetIndex < acquiredCount; ++packetIndex)
+            m_receivePool->release(*packets[packetIndex]);
+
+        return packetCount;
+    }
+
+    std::size_t UdpSocket::send(Packet* const* packets, std::size_t count)
+    {
+        const int socketHandle = static_cast<int>(m_handle);
+        std::size_t sentCount = 0;
+
+#if defined(__linux__)
+        std::array<mmsghdr, MaxBatchSize> messages {};
+        std::array<iovec, MaxBatchSize> buffers {};
+        std::array<sockaddr_in, MaxBatchSize> addresses {};
+
+        for (std::size_t batchBegin = 0; batchBegin < count; batchBegin += MaxBatchSize)
+        {
+            const std::size_t batchSize = std::min(count - batchBegin, MaxBatchSize);
+
+            for (std::size_t packetIndex = 0; packetIndex < batchSize; ++packetIndex)
+            {
+                Packet& packet = *packets[batchBegin + packetIndex];
+
+                addresses[packetIndex] = toSocketAddress(packet.address);
+                buffers[packetIndex]   = iovec{ packet.data.data(), packet.size };
+
+                msghdr& header     = messages[packetIndex].msg_hdr;
+                header             = msghdr{};
+                header.msg_name    = &addresses[packetIndex];
+                header.msg_namelen = sizeof(sockaddr_in);
+                header.msg_iov     = &buffers[packetIndex];
+                header.msg_iovlen  = 1;
+            }
+
+            const int messageCount = sendmmsg(socketHandle, messages.data(), static_cast<unsigned int>(batchSize), MSG_DONTWAIT);
+
+            if (messageCount <= 0)
+                break;
+
+            sentCount += static_cast<std::size_t>(messageCount);
+        }
+#else
+        for (std::size_t packetIndex = 0; packetIndex < count; ++packetIndex)
+        {
+            const Packet& packet = *packets[packetIndex];
+            const sockaddr_in address = toSocketAddress(packet.address);
+
+            if (sendto(socketHandle, packet.data.data(), packet.size, MSG_DONTWAIT, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) >= 0)
+                ++sentCount;
+        }
+#endif
+
+        return sentCount;
+    }
+
+#endif
+
+    UdpSocket::~UdpSocket()
+    {
+        close();
+    }
+
+} // namespace Rei
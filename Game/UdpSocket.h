@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Packet.h"
+
+namespace Rei
+{
+
+    /// Non-blocking UDP socket receiving & sending packets by batches, directly into & from pooled packet buffers.
+    /// On Windows, receives are kept posted on an I/O completion port, each into its own packet, & their completions are dequeued together;
+    ///   elsewhere, batches are received & sent with single recvmmsg() & sendmmsg() calls where available.
+    /// \note Receiving must only be done by a single thread at a time, which may be different from the sending one.
+    class UdpSocket
+    {
+    public:
+        /// Maximum number of packets received or sent by a single system call.
+        static constexpr std::size_t MaxBatchSize = 64;
+
+        UdpSocket() = default;
+        UdpSocket(const UdpSocket&) = delete;
+        UdpSocket(UdpSocket&&) noexcept = delete;
+
+        bool isOpen() const noexcept { return m_isOpen; }
+        /// Gets the local port the socket is bound to, which is useful if it has been opened on any free port.
+        uint16_t getPort() const noexcept { return m_port; }
+
+        /// Opens the socket, bound to the given local port on all interfaces.
+        /// \param port Port to be bound to; if 0, any free port is picked.
+        /// \param receivePool Pool to take the packets to receive into from; must outlive the socket, or at least its closing.
+        /// \return True if the socket has been opened, false otherwise.
+        bool open(uint16_t port, PacketPool& receivePool);
+        /// Closes the socket, releasing the packets it holds back into the receive pool.
+        void close();
+        /// Waits for incoming packets, & receives as many as are available.
+        /// \param packets Array to be filled with the received packets, which must each be released to the receive pool once processed.
+        /// \param maxCount Maximum number of packets to be received; at most MaxBatchSize are received at once.
+        /// \param timeoutMs Time to wait for a packet to arrive if none is available, in milliseconds.
+        /// \return Number of received packets.
+        std::size_t receive(Packet** packets, std::size_t maxCount, int timeoutMs);
+        /// Sends packets to their respective addresses.
+        /// \note Packets which cannot be sent right away (for instance because the socket's buffer is full) are dropped, as UDP does anyway.
+        /// \param packets Packets to be sent; they are left untouched, & kept owned by the caller.
+        /// \param count Number of packets to be sent.
+        /// \return Number of packets sent.
+        std::size_t send(Packet* const* packets, std::size_t count);
+
+        UdpSocket& operator=(const UdpSocket&) = delete;
+        UdpSocket& operator=(UdpSocket&&) noexcept = delete;
+
+        ~UdpSocket();
+
+    private:
+        struct PendingReceive;
+
+        uintptr_t m_handle{};
+        bool m_isOpen = false;
+        uint16_t m_port = 0;
+        PacketPool* m_receivePool{};
+#if defined(_WIN32)
+        /// Posts a receive into the pending receive's packet, acquiring a new one if it has none.
+        /// \return True if the receive has been posted, false otherwise.
+        bool postReceive(PendingReceive& pendingReceive);
+
+        void* m_completionPort{};
+        std::vector<std::unique_ptr<PendingReceive>> m_pendingReceives{};
+#endif
+    };
+
+} // namespace Rei
@@ -1,8 +1,14 @@
 #pragma once
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include <cmath>
 #include <cstdint>
+#include <functional>
 #include <ostream>
+#include <type_traits>
+
+#include "FloatUtils.h"
 
 namespace Rei {
 
@@ -12,6 +18,14 @@ namespace Rei {
     template <typename T, std::size_t Size>
     std::ostream& operator<<(std::ostream& stream, const Vector<T, Size>& vec);
 
+    namespace Detail {
+
+        /// Vectors exactly filling a 128-bit SIMD register (such as Vec4f) are aligned on 16 bytes, so that they can be loaded with aligned instructions.
+        template <typename T, std::size_t Size>
+        constexpr std::size_t VectorAlignment = (sizeof(T) * Size == 16 ? 16 : alignof(std::array<T, Size>));
+
+    } // namespace Detail
+
     /// Vector class, representing a mathematical vector, with generic type and size.
     /// \tparam T Type of the vector's data.
     /// \tparam Size Vector's size.
@@ -229,7 +243,7 @@ namespace Rei {
         friend std::ostream& operator<< <>(std::ostream& stream, const Vector& vec);
 
     private:
-        std::array<T, Size> m_data{};
+        alignas(Detail::VectorAlignment<T, Size>) std::array<T, Size> m_data{};
     };
 
     /// Element-wise value-vector addition operator (of the form val + vec).
@@ -0,0 +1,129 @@
+#include "VectorSimd.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace Rei::Simd {
+
+    // Each kernel processes as many vectors as possible with the widest available registers (8 with AVX, 4 with SSE),
+    //  then handles the remaining ones with scalar operations.
+
+    void computeDots(const ConstVec3fSoaView& vecs1, const ConstVec3fSoaView& vecs2, float* results) noexcept {
+        assert("Error: The second vectors must be at least as many as the first ones." && vecs2.count >= vecs1.count);
+
+        std::size_t vecIndex = 0;
+
+#if defined(REI_SIMD_AVX)
+        for (; vecIndex + 8 <= vecs1.count; vecIndex += 8) {
+            const __m256 dots = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(vecs1.x + vecIndex), _mm256_loadu_ps(vecs2.x + vecIndex)),
+                                                            _mm256_mul_ps(_mm256_loadu_ps(vecs1.y + vecIndex), _mm256_loadu_ps(vecs2.y + vecIndex))),
+                                              _mm256_mul_ps(_mm256_loadu_ps(vecs1.z + vecIndex), _mm256_loadu_ps(vecs2.z + vecIndex)));
+            _mm256_storeu_ps(results + vecIndex, dots);
+        }
+#endif
+
+#if defined(REI_SIMD_SSE2)
+        for (; vecIndex + 4 <= vecs1.count; vecIndex += 4) {
+            const __m128 dots = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vecs1.x + vecIndex), _mm_loadu_ps(vecs2.x + vecIndex)),
+                                                      _mm_mul_ps(_mm_loadu_ps(vecs1.y + vecIndex), _mm_loadu_ps(vecs2.y + vecIndex))),
+                                           _mm_mul_ps(_mm_loadu_ps(vecs1.z + vecIndex), _mm_loadu_ps(vecs2.z + vecIndex)));
+            _mm_storeu_ps(results + vecIndex, dots);
+        }
+#endif
+
+        for (; vecIndex < vecs1.count; ++vecIndex)
+            results[vecIndex] = vecs1.x[vecIndex] * vecs2.x[vecIndex] + vecs1.y[vecIndex] * vecs2.y[vecIndex] + vecs1.z[vecIndex] * vecs2.z[vecIndex];
+    }
+
+    void normalize(const Vec3fSoaView& vecs) noexcept {
+        std::size_t vecIndex = 0;
+
+#if defined(REI_SIMD_AVX)
+        for (; vecIndex + 8 <= vecs.count; vecIndex += 8) {
+            const __m256 x = _mm256_loadu_ps(vecs.x + vecIndex);
+            const __m256 y = _mm256_loadu_ps(vecs.y + vecIndex);
+            const __m256 z = _mm256_loadu_ps(vecs.z + vecIndex);
+
+            const __m256 sqLengths = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+            // Vectors of length 0 are divided by 1 instead, leaving them unchanged
+            const __m256 isZero = _mm256_cmp_ps(sqLengths, _mm256_setzero_ps(), _CMP_EQ_OQ);
+            const __m256 lengths = _mm256_blendv_ps(_mm256_sqrt_ps(sqLengths), _mm256_set1_ps(1.f), isZero);
+
+            _mm256_storeu_ps(vecs.x + vecIndex, _mm256_div_ps(x, lengths));
+            _mm256_storeu_ps(vecs.y + vecIndex, _mm256_div_ps(y, lengths));
+            _mm256_storeu_ps(vecs.z + vecIndex, _mm256_div_ps(z, lengths));
+        }
+#endif
+
+#if defined(REI_SIMD_SSE2)
+        for (; vecIndex + 4 <= vecs.count; vecIndex += 4) {
+            const __m128 x = _mm_loadu_ps(vecs.x + vecIndex);
+            const __m128 y = _mm_loadu_ps(vecs.y + vecIndex);
+            const __m128 z = _mm_loadu_ps(vecs.z + vecIndex);
+
+            const __m128 sqLengths = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+            const __m128 isZero = _mm_cmpeq_ps(sqLengths, _mm_setzero_ps());
+            const __m128 lengths = _mm_or_ps(_mm_andnot_ps(isZero, _mm_sqrt_ps(sqLengths)), _mm_and_ps(isZero, _mm_set1_ps(1.f)));
+
+            _mm_storeu_ps(vecs.x + vecIndex, _mm_div_ps(x, lengths));
+            _mm_storeu_ps(vecs.y + vecIndex, _mm_div_ps(y, lengths));
+            _mm_storeu_ps(vecs.z + vecIndex, _mm_div_ps(z, lengths));
+        }
+#endif
+
+        for (; vecIndex < vecs.count; ++vecIndex) {
+            const float sqLength = vecs.x[vecIndex] * vecs.x[vecIndex] + vecs.y[vecIndex] * vecs.y[vecIndex] + vecs.z[vecIndex] * vecs.z[vecIndex];
+
+            if (sqLength == 0.f)
+                continue;
+
+            const float length = std::sqrt(sqLength);
+            vecs.x[vecIndex] /= length;
+            vecs.y[vecIndex] /= length;
+            vecs.z[vecIndex] /= length;
+        }
+    }
+
+    void lerp(const ConstVec3fSoaView& vecs1, const ConstVec3fSoaView& vecs2, float coeff, const Vec3fSoaView& results) noexcept {
+        assert("Error: The second vectors must be at least as many as the first ones." && vecs2.count >= vecs1.count);
+        assert("Error: The resulting vectors must be at least as many as the first ones." && results.count >= vecs1.count);
+        assert("Error: The interpolation coefficient must be between 0 & 1." && (coeff >= 0.f && coeff <= 1.f));
+
+        std::size_t vecIndex = 0;
+
+#if defined(REI_SIMD_AVX)
+        const __m256 coeffs8 = _mm256_set1_ps(coeff);
+        const auto lerp8 = [&coeffs8](const float* values1, const float* values2, float* lerpedValues) {
+            const __m256 data1 = _mm256_loadu_ps(values1);
+            _mm256_storeu_ps(lerpedValues, _mm256_add_ps(data1, _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(values2), data1), coeffs8)));
+        };
+
+        for (; vecIndex + 8 <= vecs1.count; vecIndex += 8) {
+            lerp8(vecs1.x + vecIndex, vecs2.x + vecIndex, results.x + vecIndex);
+            lerp8(vecs1.y + vecIndex, vecs2.y + vecIndex, results.y + vecIndex);
+            lerp8(vecs1.z + vecIndex, vecs2.z + vecIndex, results.z + vecIndex);
+        }
+#endif
+
+#if defined(REI_SIMD_SSE2)
+        const __m128 coeffs4 = _mm_set1_ps(coeff);
+        const auto lerp4 = [&coeffs4](const float* values1, const float* values2, float* lerpedValues) {
+            const __m128 data1 = _mm_loadu_ps(values1);
+            _mm_storeu_ps(lerpedValues, _mm_add_ps(data1, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(values2), data1), coeffs4)));
+        };
+
+        for (; vecIndex + 4 <= vecs1.count; vecIndex += 4) {
+            lerp4(vecs1.x + vecIndex, vecs2.x + vecIndex, results.x + vecIndex);
+            lerp4(vecs1.y + vecIndex, vecs2.y + vecIndex, results.y + vecIndex);
+            lerp4(vecs1.z + vecIndex, vecs2.z + vecIndex, results.z + vecIndex);
+        }
+#endif
+
+        for (; vecIndex < vecs1.count; ++vecIndex) {
+            results.x[vecIndex] = vecs1.x[vecIndex] + (vecs2.x[vecIndex] - vecs1.x[vecIndex]) * coeff;
+            results.y[vecIndex] = vecs1.y[vecIndex] + (vecs2.y[vecIndex] - vecs1.y[vecIndex]) * coeff;
+            results.z[vecIndex] = vecs1.z[vecIndex] + (vecs2.z[vecIndex] - vecs1.z[vecIndex]) * coeff;
+        }
+    }
+
+} // namespace Rei::Simd
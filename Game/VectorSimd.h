@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "Simd.h"
+#include "Vector.h"
+
+namespace Rei {
+
+    /// Non-owning view over 3D vectors stored as a structure of arrays, each component being contiguous in memory.
+    /// \tparam T Type of the vectors' data; may be const-qualified for read-only views.
+    template <typename T>
+    struct Vec3SoaView {
+        /// Conversion operator to a read-only view.
+        template <typename ConstT = const T, typename = std::enable_if_t<!std::is_const_v<T>, ConstT>>
+        constexpr operator Vec3SoaView<ConstT>() const noexcept { return Vec3SoaView<ConstT>{ x, y, z, count }; }
+
+        T* x{};
+        T* y{};
+        T* z{};
+        std::size_t count{};
+    };
+
+    using Vec3fSoaView = Vec3SoaView<float>;
+    using ConstVec3fSoaView = Vec3SoaView<const float>;
+
+    /// SIMD implementations of the most frequent single-precision vector operations, which fall back to Vector's scalar ones when no SIMD instruction set is available.
+    /// \note Unlike Vector's member functions, these are not usable at compile time.
+    namespace Simd {
+
+#if defined(REI_SIMD_SSE2)
+        /// Loads a vector into a SIMD register; Vec4f is always 16-byte aligned.
+        inline __m128 load(const Vec4f& vec) noexcept { return _mm_load_ps(vec.getDataPtr()); }
+        /// Loads a vector into a SIMD register, padding it with a W component of 0.
+        inline __m128 load(const Vec3f& vec) noexcept { return _mm_setr_ps(vec.x(), vec.y(), vec.z(), 0.f); }
+
+        inline Vec4f toVec4f(__m128 data) noexcept {
+            Vec4f vec;
+            _mm_store_ps(vec.getDataPtr(), data);
+            return vec;
+        }
+
+        inline Vec3f toVec3f(__m128 data) noexcept {
+            alignas(16) float values[4];
+            _mm_store_ps(values, data);
+            return Vec3f(values[0], values[1], values[2]);
+        }
+
+        /// Computes the dot product of two registers, broadcast into all their elements.
+        inline __m128 dot(__m128 data1, __m128 data2) noexcept {
+#if defined(REI_SIMD_SSE41)
+            return _mm_dp_ps(data1, data2, 0xFF);
+#else
+            const __m128 products = _mm_mul_ps(data1, data2);
+            const __m128 pairSums = _mm_add_ps(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_add_ps(pairSums, _mm_shuffle_ps(pairSums, pairSums, _MM_SHUFFLE(1, 0, 3, 2)));
+#endif
+        }
+
+        /// Normalizes a register, leaving it unchanged if its length is 0.
+        inline __m128 normalize(__m128 data) noexcept {
+            const __m128 sqLength = dot(data, data);
+            const __m128 isNonZero = _mm_cmpneq_ps(sqLength, _mm_setzero_ps());
+            const __m128 normalized = _mm_div_ps(data, _mm_sqrt_ps(sqLength));
+
+            return _mm_or_ps(_mm_and_ps(isNonZero, normalized), _mm_andnot_ps(isNonZero, data));
+        }
+#endif
+
+        inline float dot(const Vec4f& vec1, const Vec4f& vec2) noexcept {
+#if defined(REI_SIMD_SSE2)
+            return _mm_cvtss_f32(dot(load(vec1), load(vec2)));
+#else
+            return vec1.dot(vec2);
+#endif
+        }
+
+        inline float dot(const Vec3f& vec1, const Vec3f& vec2) noexcept {
+#if defined(REI_SIMD_SSE2)
+            return _mm_cvtss_f32(dot(load(vec1), load(vec2)));
+#else
+            return vec1.dot(vec2);
+#endif
+        }
+
+        inline Vec3f cross(const Vec3f& vec1, const Vec3f& vec2) noexcept {
+#if defined(REI_SIMD_SSE2)
+            const __m128 data1 = load(vec1);
+            const __m128 data2 = load(vec2);
+
+            // (y1, z1, x1) * (z2, x2, y2) - (z1, x1, y1) * (y2, z2, x2)
+            const __m128 data1Yzx = _mm_shuffle_ps(data1, data1, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 data2Yzx = _mm_shuffle_ps(data2, data2, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 result = _mm_sub_ps(_mm_mul_ps(data1, data2Yzx), _mm_mul_ps(data1Yzx, data2));
+
+            return toVec3f(_mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 0, 2, 1)));
+#else
+            return vec1.cross(vec2);
+#endif
+        }
+
+        inline Vec4f normalize(const Vec4f& vec) noexcept {
+#if defined(REI_SIMD_SSE2)
+            return toVec4f(normalize(load(vec)));
+#else
+            return vec.normalize();
+#endif
+        }
+
+        inline Vec3f normalize(const Vec3f& vec) noexcept {
+#if defined(REI_SIMD_SSE2)
+            return toVec3f(normalize(load(vec)));
+#else
+            return vec.normalize();
+#endif
+        }
+
+        inline Vec4f lerp(const Vec4f& vec1, const Vec4f& vec2, float coeff) noexcept {
+#if defined(REI_SIMD_SSE2)
+            const __m128 data1 = load(vec1);
+            return toVec4f(_mm_add_ps(data1, _mm_mul_ps(_mm_sub_ps(load(vec2), data1), _mm_set1_ps(coeff))));
+#else
+            return vec1.lerp(vec2, coeff);
+#endif
+        }
+
+        inline Vec3f lerp(const Vec3f& vec1, const Vec3f& vec2, float coeff) noexcept {
+#if defined(REI_SIMD_SSE2)
+            const __m128 data1 = load(vec1);
+            return toVec3f(_mm_add_ps(data1, _mm_mul_ps(_mm_sub_ps(load(vec2), data1), _mm_set1_ps(coeff))));
+#else
+            return vec1.lerp(vec2, coeff);
+#endif
+        }
+
+        /// Computes the dot products of two sets of vectors, pair by pair.
+        /// \param vecs1 First vectors.
+        /// \param vecs2 Second vectors; must be at least as many as the first ones.
+        /// \param results Array to store the dot products into; must hold at least as many values as there are vectors.
+        void computeDots(const ConstVec3fSoaView& vecs1, const ConstVec3fSoaView& vecs2, float* results) noexcept;
+        /// Normalizes vectors in place; vectors of length 0 are left unchanged.
+        /// \param vecs Vectors to be normalized.
+        void normalize(const Vec3fSoaView& vecs) noexcept;
+        /// Computes the linear interpolations between two sets of vectors, pair by pair.
+        /// \param vecs1 First vectors, returned with a coefficient of 0.
+        /// \param vecs2 Second vectors, returned with a coefficient of 1; must be at least as many as the first ones.
+        /// \param coeff Interpolation coefficient, between 0 & 1.
+        /// \param results Interpolated vectors; may be the same arrays as either of the inputs, & must be at least as many as the first ones.
+        void lerp(const ConstVec3fSoaView& vecs1, const ConstVec3fSoaView& vecs2, float coeff, const Vec3fSoaView& results) noexcept;
+
+    } // namespace Simd
+
+} // namespace Rei
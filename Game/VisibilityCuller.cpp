@@ -0,0 +1,287 @@
+#include "VisibilityCuller.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "MatrixSimd.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+
+namespace Rei
+{
+
+    Frustum Frustum::fromViewProjection(const Mat4f& viewProjection) noexcept
+    {
+        // Each clip-space bound, for instance -w <= x, gives a world-space plane from the matrix's rows (Gribb & Hartmann)
+        const Vec4f row0 = viewProjection.recoverRow(0);
+        const Vec4f row1 = viewProjection.recoverRow(1);
+        const Vec4f row2 = viewProjection.recoverRow(2);
+        const Vec4f row3 = viewProjection.recoverRow(3);
+
+        Frustum frustum;
+        frustum.planes = { row3 + row0, row3 - row0, row3 + row1, row3 - row1, row2, row3 - row2 };
+
+        // Normalizing the planes makes their equations give actual distances, which can be compared to the radii
+        for (Vec4f& plane : frustum.planes)
+        {
+            const float normalLength = Vec3f(plane.x(), plane.y(), plane.z()).computeLength();
+
+            if (normalLength > 0.f)
+                plane /= normalLength;
+        }
+
+        return frustum;
+    }
+
+    void Frustum::computeVisibility(const ConstVec3fSoaView& centers, const float* radii, uint8_t* results) const noexcept
+    {
+        std::size_t sphereIndex = 0;
+
+        // A sphere is visible unless it is entirely behind any of the planes: a * x + b * y + c * z + d + r >= 0 for all of them
+#if defined(REI_SIMD_AVX)
+        for (; sphereIndex + 8 <= centers.count; sphereIndex += 8)
+        {
+            const __m256 x      = _mm256_loadu_ps(centers.x + sphereIndex);
+            const __m256 y      = _mm256_loadu_ps(centers.y + sphereIndex);
+            const __m256 z      = _mm256_loadu_ps(centers.z + sphereIndex);
+            const __m256 radius = _mm256_loadu_ps(radii + sphereIndex);
+            __m256 visibility   = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+            for (const Vec4f& plane : planes)
+            {
+                const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x()), x), _mm256_mul_ps(_mm256_set1_ps(plane.y()), y)),
+                                                      _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.z()), z), _mm256_set1_ps(plane.w())));
+                visibility = _mm256_and_ps(visibility, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+            }
+
+            const int visibilityMask = _mm256_movemask_ps(visibility);
+
+            for (std::size_t laneIndex = 0; laneIndex < 8; ++laneIndex)
+                results[sphereIndex + laneIndex] = static_cast<uint8_t>((visibilityMask >> laneIndex) & 1);
+        }
+#endif
+
+#if defined(REI_SIMD_SSE2)
+        for (; sphereIndex + 4 <= centers.count; sphereIndex += 4)
+        {
+            const __m128 x      = _mm_loadu_ps(centers.x + sphereIndex);
+            const __m128 y      = _mm_loadu_ps(centers.y + sphereIndex);
+            const __m128 z      = _mm_loadu_ps(centers.z + sphereIndex);
+            const __m128 radius = _mm_loadu_ps(radii + sphereIndex);
+            __m128 visibility   = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+            for (const Vec4f& plane : planes)
+            {
+                const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x()), x), _mm_mul_ps(_mm_set1_ps(plane.y()), y)),
+                                                   _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z()), z), _mm_set1_ps(plane.w())));
+                visibility = _mm_and_ps(visibility, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+            }
+
+            const int visibilityMask = _mm_movemask_ps(visibility);
+
+            for (std::size_t laneIndex = 0; laneIndex < 4; ++laneIndex)
+                results[sphereIndex + laneIndex] = static_cast<uint8_t>((visibilityMask >> laneIndex) & 1);
+        }
+#endif
+
+        for (; sphereIndex < centers.count; ++sphereIndex)
+        {
+            bool isVisible = true;
+
+            for (const Vec4f& plane : planes)
+            {
+                const float distance = plane.x() * centers.x[sphereIndex] + plane.y() * centers.y[sphereIndex] + plane.z() * centers.z[sphereIndex] + plane.w();
+                isVisible &= (distance + radii[sphereIndex] >= 0.f);
+            }
+
+            results[sphereIndex] = static_cast<uint8_t>(isVisible);
+        }
+    }
+
+    void HiZBuffer::build(const float* depths, uint32_t width, uint32_t height, const Mat4f& viewProjection)
+    {
+        assert("Error: The depth buffer must not be empty." && width > 0 && height > 0);
+
+        m_viewProjection = viewProjection;
+        m_levels.clear();
+
+        Level& firstLevel = m_levels.emplace_back();
+        firstLevel.width  = width;
+        firstLevel.height = height;
+        firstLevel.depths.assign(depths, depths + static_cast<std::size_t>(width) * height);
+
+        while (m_levels.back().width > 1 || m_levels.back().height > 1)
+        {
+            const Level& prevLevel = m_levels.back();
+
+            Level level;
+            // Rounding the size up makes the last texel of an odd row or column only cover one texel of the previous level
+            level.width  = (prevLevel.width + 1) / 2;
+            level.height = (prevLevel.height + 1) / 2;
+            level.depths.resize(static_cast<std::size_t>(level.width) * level.height);
+
+            for (uint32_t heightIndex = 0; heightIndex < level.height; ++heightIndex)
+            {
+                const uint32_t prevHeightIndex1 = heightIndex * 2;
+                const uint32_t prevHeightIndex2 = std::min(prevHeightIndex1 + 1, prevLevel.height - 1);
+
+                for (uint32_t widthIndex = 0; widthIndex < level.width; ++widthIndex)
+                {
+                    const uint32_t prevWidthIndex1 = widthIndex * 2;
+                    const uint32_t prevWidthIndex2 = std::min(prevWidthIndex1 + 1, prevLevel.width - 1);
+
+                    const std::size_t prevRow1 = static_cast<std::size_t>(prevHeightIndex1) * prevLevel.width;
+                    const std::size_t prevRow2 = static_cast<std::size_t>(prevHeightIndex2) * prevLevel.width;
+
+                    level.depths[static_cast<std::size_t>(heightIndex) * level.width + widthIndex] =
+                        std::max(std::max(prevLevel.depths[prevRow1 + prevWidthIndex1], prevLevel.depths[prevRow1 + prevWidthIndex2]),
+                                 std::max(prevLevel.depths[prevRow2 + prevWidthIndex1], prevLevel.depths[prevRow2 + prevWidthIndex2]));
+                }
+            }
+
+            m_levels.emplace_back(std::move(level));
+        }
+    }
+
+    bool HiZBuffer::isOccluded(const Vec3f& center, float radius) const noexcept
+    {
+        if (m_levels.empty() || !std::isfinite(radius))
+            return false;
+
+        // The sphere's screen-space bounds & nearest depth are those of its bounding box, which is conservative
+        float minX = 1.f;
+        float maxX = -1.f;
+        float minY = 1.f;
+        float maxY = -1.f;
+        float minDepth = 1.f;
+
+        for (uint8_t cornerIndex = 0; cornerIndex < 8; ++cornerIndex)
+        {
+            const Vec4f corner(center.x() + ((cornerIndex & 1) ? radius : -radius),
+                               center.y() + ((cornerIndex & 2) ? radius : -radius),
+                               center.z() + ((cornerIndex & 4) ? radius : -radius),
+                               1.f);
+            const Vec4f clipCorner = Simd::multiply(m_viewProjection, corner);
+
+            // A box crossing the camera plane cannot be projected; it is then considered visible
+            if (clipCorner.w() <= 0.f)
+                return false;
+
+            const float invW = 1.f / clipCorner.w();
+            minX     = std::min(minX, clipCorner.x() * invW);
+            maxX     = std::max(maxX, clipCorner.x() * invW);
+            minY     = std::min(minY, clipCorner.y() * invW);
+            maxY     = std::max(maxY, clipCorner.y() * invW);
+            minDepth = std::min(minDepth, clipCorner.z() * invW);
+        }
+
+        if (minDepth < 0.f || minX > 1.f || maxX < -1.f || minY > 1.f || maxY < -1.f)
+            return false;
+
+        // Converting the NDC bounds into texels of the first level, the texture's Y axis pointing downward
+        const Level& firstLevel = m_levels.front();
+        const auto recoverTexel = [](float coord, uint32_t size)
+        {
+            return std::min(static_cast<uint32_t>(std::clamp(coord, 0.f, 1.f) * static_cast<float>(size)), size - 1);
+        };
+
+        uint32_t minWidthIndex  = recoverTexel(minX * 0.5f + 0.5f, firstLevel.width);
+        uint32_t maxWidthIndex  = recoverTexel(maxX * 0.5f + 0.5f, firstLevel.width);
+        uint32_t minHeightIndex = recoverTexel(0.5f - maxY * 0.5f, firstLevel.height);
+        uint32_t maxHeightIndex = recoverTexel(0.5f - minY * 0.5f, firstLevel.height);
+
+        // Going up the levels until the bounds cover at most 2x2 texels, each texel of a level covering 2x2 texels of the previous one
+        std::size_t levelIndex = 0;
+
+        while (levelIndex + 1 < m_levels.size() && (maxWidthIndex - minWidthIndex > 1 || maxHeightIndex - minHeightIndex > 1))
+        {
+            minWidthIndex  /= 2;
+            maxWidthIndex  /= 2;
+            minHeightIndex /= 2;
+            maxHeightIndex /= 2;
+            ++levelIndex;
+        }
+
+        const Level& level = m_levels[levelIndex];
+        float maxDepth = 0.f;
+
+        for (uint32_t heightIndex = minHeightIndex; heightIndex <= maxHeightIndex; ++heightIndex)
+        {
+            for (uint32_t widthIndex = minWidthIndex; widthIndex <= maxWidthIndex; ++widthIndex)
+                maxDepth = std::max(maxDepth, level.depths[static_cast<std::size_t>(heightIndex) * level.width + widthIndex]);
+        }
+
+        return (minDepth > maxDepth);
+    }
+
+    void VisibilityCuller::reserve(std::size_t boundCount)
+    {
+        m_centersX.reserve(boundCount);
+        m_centersY.reserve(boundCount);
+        m_centersZ.reserve(boundCount);
+        m_radii.reserve(boundCount);
+        m_visibility.reserve(boundCount);
+        m_visibleIndices.reserve(boundCount);
+    }
+
+    uint32_t VisibilityCuller::addBoundingSphere(const Vec3f& center, float radius)
+    {
+        m_centersX.emplace_back(center.x());
+        m_centersY.emplace_back(center.y());
+        m_centersZ.emplace_back(center.z());
+        m_radii.emplace_back(radius);
+
+        return static_cast<uint32_t>(m_radii.size() - 1);
+    }
+
+    std::size_t VisibilityCuller::cull(const Mat4f& viewProjection, ThreadPool* threadPool)
+    {
+        const Frustum frustum = Frustum::fromViewProjection(viewProjection);
+        const bool isOcclusionEnabled = (m_hiZBuffer != nullptr && !m_hiZBuffer->isEmpty());
+
+        m_visibility.resize(m_radii.size());
+
+        const auto cullRange = [this, &frustum, isOcclusionEnabled](std::size_t beginIndex, std::size_t endIndex)
+        {
+            const ConstVec3fSoaView centers{ m_centersX.data() + beginIndex, m_centersY.data() + beginIndex, m_centersZ.data() + beginIndex, endIndex - beginIndex };
+            frustum.computeVisibility(centers, m_radii.data() + beginIndex, m_visibility.data() + beginIndex);
+
+            if (!isOcclusionEnabled)
+                return;
+
+            // Only the spheres inside the frustum, usually a small part of them, need the more expensive occlusion test
+            for (std::size_t sphereIndex = beginIndex; sphereIndex < endIndex; ++sphereIndex)
+            {
+                if (m_visibility[sphereIndex] && m_hiZBuffer->isOccluded(Vec3f(m_centersX[sphereIndex], m_centersY[sphereIndex], m_centersZ[sphereIndex]), m_radii[sphereIndex]))
+                    m_visibility[sphereIndex] = 0;
+            }
+        };
+
+        if (threadPool == nullptr || m_radii.size() <= ParallelGrainSize)
+            cullRange(0, m_radii.size());
+        else
+            threadPool->parallelFor(m_radii.size(), ParallelGrainSize, cullRange);
+
+        m_visibleIndices.clear();
+
+        for (std::size_t sphereIndex = 0; sphereIndex < m_visibility.size(); ++sphereIndex)
+        {
+            if (m_visibility[sphereIndex])
+                m_visibleIndices.emplace_back(static_cast<uint32_t>(sphereIndex));
+        }
+
+        return m_visibleIndices.size();
+    }
+
+    void VisibilityCuller::clear() noexcept
+    {
+        m_centersX.clear();
+        m_centersY.clear();
+        m_centersZ.clear();
+        m_radii.clear();
+        m_visibility.clear();
+        m_visibleIndices.clear();
+    }
+
+} // namespace Rei
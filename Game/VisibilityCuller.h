@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Matrix.h"
+#include "Vector.h"
+#include "VectorSimd.h"
+
+namespace Rei
+{
+    class ThreadPool;
+
+    /// View frustum, made of six planes whose normals point inward.
+    struct Frustum
+    {
+        /// Planes' normalized equations (a, b, c, d), a point p being inside a plane if a * p.x + b * p.y + c * p.z + d >= 0.
+        /// Ordered as left, right, bottom, top, near & far.
+        std::array<Vec4f, 6> planes{};
+
+        /// Extracts the frustum planes from a view-projection matrix, with a clip-space depth between 0 & 1 (as with Direct3D).
+        /// \param viewProjection Matrix transforming world-space positions into clip space.
+        /// \return Frustum in world space.
+        static Frustum fromViewProjection(const Mat4f& viewProjection) noexcept;
+
+        /// Checks which spheres intersect or are inside the frustum.
+        /// \param centers World-space centers of the spheres.
+        /// \param radii Radii of the spheres; an infinite radius is always considered visible.
+        /// \param results Visibility of each sphere, 1 if visible & 0 otherwise; must hold at least centers.count elements.
+        void computeVisibility(const ConstVec3fSoaView& centers, const float* radii, uint8_t* results) const noexcept;
+    };
+
+    /// Hierarchical depth buffer, each level holding the farthest depth of 2x2 texels of the previous one.
+    /// Built from the depth buffer of the previous frame, read back from the geometry pass's FrameBuffer, it allows rejecting objects hidden
+    ///   behind those drawn in that frame; as the depths lag by a frame, objects appearing from behind an occluder may pop in a frame late.
+    class HiZBuffer
+    {
+    public:
+        bool isEmpty() const noexcept { return m_levels.empty(); }
+        std::size_t getLevelCount() const noexcept { return m_levels.size(); }
+        const Mat4f& getViewProjection() const noexcept { return m_viewProjection; }
+
+        /// Builds the pyramid from a full-resolution depth buffer, with depths between 0 (near) & 1 (far).
+        /// \param depths Depth values, stored row by row from the top-left texel.
+        /// \param width Width of the depth buffer.
+        /// \param height Height of the depth buffer.
+        /// \param viewProjection View-projection matrix the depth buffer was rendered with.
+        void build(const float* depths, uint32_t width, uint32_t height, const Mat4f& viewProjection);
+        /// Checks if a sphere is entirely hidden behind the depths of the buffer; always false if the buffer is empty.
+        /// \param center World-space center of the sphere.
+        /// \param radius Radius of the sphere.
+        /// \return True if the sphere is occluded, false if it may be visible.
+        bool isOccluded(const Vec3f& center, float radius) const noexcept;
+        void clear() noexcept { m_levels.clear(); }
+
+    private:
+        struct Level
+        {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            std::vector<float> depths{};
+        };
+
+        std::vector<Level> m_levels{};
+        Mat4f m_viewProjection = Mat4f::identity();
+    };
+
+    /// Visibility stage, keeping the bounding spheres to be tested in SoA form & finding which ones are visible.
+    /// Spheres are first tested against the view frustum, several at a time; those inside are then optionally tested against a hierarchical depth buffer.
+    class VisibilityCuller
+    {
+    public:
+        std::size_t getBoundCount() const noexcept { return m_radii.size(); }
+        /// Gets the indices of the visible spheres as of the last culling, in the order they have been added.
+        const std::vector<uint32_t>& getVisibleIndices() const noexcept { return m_visibleIndices; }
+
+        /// Sets the depth buffer used to test the spheres for occlusion.
+        /// \param hiZBuffer Hierarchical depth buffer, which must outlive the culler; may be nullptr to only do frustum culling.
+        void setHiZBuffer(const HiZBuffer* hiZBuffer) noexcept { m_hiZBuffer = hiZBuffer; }
+        void reserve(std::size_t boundCount);
+        /// Adds a bounding sphere to be tested.
+        /// \param center World-space center of the sphere.
+        /// \param radius Radius of the sphere; if infinite, the sphere is never culled.
+        /// \return Index of the sphere.
+        uint32_t addBoundingSphere(const Vec3f& center, float radius);
+        /// Finds the visible spheres among those added.
+        /// \param viewProjection Current view-projection matrix.
+        /// \param threadPool Thread pool on which to split the tests; if nullptr, everything is tested on the calling thread.
+        /// \return Number of visible spheres.
+        std::size_t cull(const Mat4f& viewProjection, ThreadPool* threadPool = nullptr);
+        void clear() noexcept;
+
+    private:
+        static constexpr std::size_t ParallelGrainSize = 1024;
+
+        std::vector<float> m_centersX{};
+        std::vector<float> m_centersY{};
+        std::vector<float> m_centersZ{};
+        std::vector<float> m_radii{};
+        std::vector<uint8_t> m_visibility{};
+        std::vector<uint32_t> m_visibleIndices{};
+        const HiZBuffer* m_hiZBuffer{};
+    };
+
+} // namespace Rei
@@ -1,30 +1,104 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
 #include <stdexcept>
+#include <tuple>
 
+#include "CommandBuffer.h"
 #include "Entity.h"
+#include "EntityQuery.h"
+#include "FrameTimer.h"
+#include "MemoryArena.h"
+#include "ObjectPool.h"
+#include "Profiler.h"
 #include "System.h"
+#include "SystemScheduler.h"
 
 namespace Rei
 {
 
 
-    struct FrameTimeInfo;
+    class ThreadPool;
     class World;
     using WorldPtr = std::unique_ptr<World>;
 
     class World
     {
+        friend class Entity;
+
     public:
-        World() = default;
-        explicit World(std::size_t entityCount) { m_entities.reserve(entityCount); }
+        World() : m_commandBuffers(1) {}
+        explicit World(std::size_t entityCount) : World()
+        {
+            m_entities.reserve(entityCount);
+            m_entitySlots.reserve(entityCount);
+            m_entityPool.reserve(entityCount);
+        }
         World(const World&) = delete;
-        World(World&&) noexcept = default;
+        World(World&&) noexcept = delete;
+
+        /// Maximum number of entities a world can hold, which bounds the indices of the entities it creates or replicates.
+        static constexpr uint32_t MaxEntityCount = 1u << 20;
 
         const std::vector<SystemPtr>& getSystems() const { return m_systems; }
-        const std::vector<EntityPtr>& getEntities() const { return m_entities; }
+        /// Gets all the entities, the enabled ones coming first as of the last refresh.
+        const std::vector<Entity*>& getEntities() const { return m_entities; }
+        /// Gets the number of entities leading getEntities() which were enabled at the last refresh, to iterate over them only.
+        std::size_t getEnabledEntityCount() const noexcept { return m_enabledEntityCount; }
+        const ComponentStorage& getComponentStorage() const { return m_componentStorage; }
+        const SystemScheduler& getScheduler() const { return m_scheduler; }
+        ThreadPool* getThreadPool() const { return m_threadPool; }
+        /// Gets the arena holding the data sharing the world's lifetime, which is released at once when the world is destroyed.
+        MemoryArena& getArena() { return m_arena; }
+
+        /// Sets the thread pool on which the systems not conflicting with each other are updated concurrently.
+        /// \note Systems which didn't declare the components they read & write are never updated concurrently with any other.
+        /// \param threadPool Thread pool to update the systems on; if null, all systems are updated sequentially.
+        void setThreadPool(ThreadPool* threadPool)
+        {
+            // The commands recorded so far are applied, since their buffers may be discarded with the previous pool
+            applyCommands();
+
+            m_threadPool = threadPool;
+            m_commandBuffers.resize((threadPool ? threadPool->getThreadCount() : 0) + 1);
+
+            for (const SystemPtr& system : m_systems)
+            {
+                if (system)
+                    system->m_threadPool = threadPool;
+            }
+        }
 
   
+        /// Gets the command buffer associated with the calling thread, whose commands are applied at the next synchronization point.
+        /// \note Only the thread pool's workers & a single other thread (usually the main one) may record commands concurrently.
+        /// \return Command buffer of the calling thread.
+        CommandBuffer& getCommandBuffer()
+        {
+            return m_commandBuffers[(m_threadPool ? m_threadPool->getCurrentThreadIndex() : 0)];
+        }
+
+        /// Applies all the commands recorded in the command buffers, in the order of the threads then of their recording.
+        /// Entities are destroyed last, so that no command can refer to an entity destroyed by another buffer.
+        /// \note This is called automatically before & after the systems are updated.
+        void applyCommands()
+        {
+            REI_PROFILE_ZONE("World::applyCommands");
+
+            for (std::size_t bufferIndex = 0; bufferIndex < m_commandBuffers.size(); ++bufferIndex)
+                m_commandBuffers[bufferIndex].apply(*this, m_destroyedEntities);
+
+            // An entity destroyed several times is only removed once, its handle being invalidated afterward
+            for (const EntityHandle& entityHandle : m_destroyedEntities)
+                removeEntity(entityHandle);
+
+            m_destroyedEntities.clear();
+        }
+
         template <typename SysT, typename... Args>
         SysT& addSystem(Args&&... args)
         {
@@ -36,7 +110,16 @@ namespace Rei
                 m_systems.resize(systemId + 1);
 
             m_systems[systemId] = std::make_unique<SysT>(std::forward<Args>(args)...);
+            m_systems[systemId]->m_threadPool = m_threadPool;
+            m_systems[systemId]->m_world = this;
+            m_systems[systemId]->m_name = System::recoverTypeName<SysT>();
             m_activeSystems.setBit(systemId);
+            m_fixedStepSystems.setBit(systemId, m_systems[systemId]->isFixedStep());
+            m_isScheduleDirty = true;
+
+            // The new system has yet to be linked to the existing entities
+            for (Entity* entity : m_entities)
+                m_dirtyEntities.insert(*entity);
 
             return static_cast<SysT&>(*m_systems[systemId]);
         }
@@ -67,21 +150,96 @@ namespace Rei
             return const_cast<SysT&>(static_cast<const World*>(this)->getSystem<SysT>());
         }
 
+        /// Gets the durations of the last updates of a system, which are measured on every frame.
+        /// \tparam SysT Type of the system.
+        /// \return Timing statistics of the system, in milliseconds; empty if the system has never been updated.
+        template <typename SysT>
+        const TimingStatistics& getSystemTimings() const noexcept
+        {
+            const std::size_t systemId = System::getId<SysT>();
+            return (m_fixedStepSystems[systemId] ? m_fixedStepScheduler : m_scheduler).getTimings(systemId);
+        }
+
+        /// Gets the durations of the last updates of the whole world, including the application of the commands & the refresh of the entities.
+        const TimingStatistics& getUpdateTimings() const noexcept { return m_updateTimings; }
+
         template <typename SysT>
         void removeSystem()
         {
             static_assert(std::is_base_of_v<System, SysT>, "Error: The removed system must be derived from System.");
 
-            if (hasSystem<SysT>())
-                m_systems[System::getId<SysT>()].reset();
+            if (!hasSystem<SysT>())
+                return;
+
+            const std::size_t systemId = System::getId<SysT>();
+
+            m_systems[systemId].reset();
+            m_activeSystems.setBit(systemId, false);
+            (m_fixedStepSystems[systemId] ? m_fixedStepScheduler : m_scheduler).clearTimings(systemId);
+            m_fixedStepSystems.setBit(systemId, false);
+            m_isScheduleDirty = true;
         }
 
+        /// Creates an entity.
+        /// \note This must not be called while the systems are updated; CommandBuffer::spawnEntity() must be used instead.
+        /// \param enabled True if the entity must be created enabled, false otherwise.
+        /// \return Reference to the newly created entity.
         Entity& addEntity(bool enabled = true)
         {
-            m_entities.emplace_back(Entity::create(m_maxEntityIndex++, enabled));
-            m_activeEntityCount += enabled;
+            uint32_t entityIndex{};
+
+            // Indices of destroyed entities are reused, so that the memory indexed by them stays bounded
+            if (!m_freeEntityIndices.empty())
+            {
+                entityIndex = m_freeEntityIndices.back();
+                takeFreeEntityIndex(entityIndex);
+            }
+            else
+            {
+                if (m_entitySlots.size() >= MaxEntityCount)
+                    throw std::length_error("Error: The world cannot hold more entities");
 
-            return *m_entities.back();
+                entityIndex = static_cast<uint32_t>(m_entitySlots.size());
+                m_entitySlots.emplace_back();
+            }
+
+            return createEntity(entityIndex, enabled);
+        }
+
+        /// Creates an entity having the given handle, as replicated from another world (for instance the server's, or a replay's).
+        /// \note This must not be called while the systems are updated.
+        /// \note The entity currently having the handle's index, if any, is destroyed; the handle's generation is taken as-is, & handles to previous
+        ///   entities of that index may thus become valid again. This must then only be used on worlds whose entities all come from the same source.
+        /// \param entityHandle Handle of the entity to be created; its index must be lower than MaxEntityCount.
+        /// \param enabled True if the entity must be created enabled, false otherwise.
+        /// \return Reference to the newly created entity.
+        Entity& addEntity(const EntityHandle& entityHandle, bool enabled = true)
+        {
+            // Also rejects null handles, whose index is the highest possible
+            if (entityHandle.index >= MaxEntityCount)
+                throw std::out_of_range("Error: The index of the entity to be created exceeds the maximum entity count");
+
+            if (entityHandle.index < m_entitySlots.size())
+            {
+                const std::size_t entityPosition = m_entitySlots[entityHandle.index].entityPosition;
+
+                if (entityPosition != EntitySlot::InvalidPosition)
+                    removeEntity(*m_entities[entityPosition]);
+            }
+            else
+            {
+                const std::size_t firstSkippedIndex = m_entitySlots.size();
+                m_entitySlots.resize(entityHandle.index + 1);
+
+                // The indices skipped to reach the requested one become free, to be used by the next entities
+                for (std::size_t entityIndex = firstSkippedIndex; entityIndex <= entityHandle.index; ++entityIndex)
+                    releaseEntityIndex(static_cast<uint32_t>(entityIndex));
+            }
+
+            takeFreeEntityIndex(entityHandle.index);
+            m_entitySlots[entityHandle.index].generation = entityHandle.generation;
+
+            return createEntity(entityHandle.index, enabled);
         }
 
         template <typename CompT, typename... Args>
@@ -102,70 +260,184 @@ namespace Rei
             return entity;
         }
 
+        /// Gets the persistent query of all the enabled entities holding the given components.
+        /// The query is created on first use, then kept up to date as entities change; the returned reference remains valid for the world's lifetime.
+        /// \tparam CompsTs Types of the components the entities must hold.
+        /// \return Query of the matching entities, which can be iterated over without allocating.
         template <typename... CompsTs>
-        std::vector<Entity*> recoverEntitiesWithComponents()
+        const EntityQuery& recoverEntitiesWithComponents()
         {
             static_assert((std::is_base_of_v<Component, CompsTs> && ...), "Error: The components to query the entity with must all be derived from Component.");
 
-            std::vector<Entity*> entities;
+            const std::size_t queryId = getQueryId<CompsTs...>();
+
+            if (queryId < m_queriesByType.size() && m_queriesByType[queryId])
+                return *m_queriesByType[queryId];
+
+            ComponentMask components;
+            (components.setBit(Component::getId<CompsTs>()), ...);
 
-            for (const EntityPtr& entity : m_entities)
+            if (queryId >= m_queriesByType.size())
+                m_queriesByType.resize(queryId + 1);
+
+            m_queriesByType[queryId] = &findOrCreateQuery(components);
+            return *m_queriesByType[queryId];
+        }
+
+        /// Calls a function on every enabled entity holding all the given components, iterating directly over the packed component arrays.
+        /// \note No entity or component must be added or removed from within the function.
+        /// \tparam CompsTs Types of the components the entities must hold.
+        /// \tparam FuncT Type of the function to be called.
+        /// \param func Function to be called, taking a reference to the entity followed by references to each requested component.
+        template <typename... CompsTs, typename FuncT>
+        void forEach(FuncT&& func)
+        {
+            static_assert((std::is_base_of_v<Component, CompsTs> && ...), "Error: The components to iterate over must all be derived from Component.");
+
+            ComponentMask components;
+            (components.setBit(Component::getId<CompsTs>()), ...);
+
+            m_componentStorage.forEachArchetype(components, [&func](Archetype& archetype)
             {
-                if ((entity->hasComponent<CompsTs>() && ...))
-                    entities.emplace_back(entity.get());
-            }
+                const std::vector<Entity*>& entities = archetype.getEntities();
+                const auto columns = std::forward_as_tuple(archetype.getColumn<CompsTs>()...);
 
-            return entities;
+                for (std::size_t row = 0; row < entities.size(); ++row)
+                {
+                    if (entities[row]->isEnabled())
+                        func(*entities[row], std::get<std::vector<CompsTs>&>(columns)[row]...);
+                }
+            });
         }
 
+        /// Destroys an entity & all its components.
+        /// \note This must not be called while the systems are updated; CommandBuffer::destroyEntity() must be used instead.
+        /// \param entity Entity to be destroyed.
         void removeEntity(const Entity& entity)
         {
-            auto iter = std::find_if(m_entities.begin(), m_entities.end(), [&entity](const EntityPtr& entityPtr) { return (&entity == entityPtr.get()); });
-
-            if (iter == m_entities.end())
+            if (recoverEntity(entity.getHandle()) != &entity)
                 throw std::invalid_argument("Error: The entity isn't owned by this world");
 
             for (const SystemPtr& system : m_systems)
-                system->unlinkEntity(*iter);
+            {
+                if (system && system->containsEntity(entity))
+                    system->unlinkEntity(entity);
+            }
+
+            for (const EntityQueryPtr& query : m_queries)
+                query->removeEntity(entity);
+
+            m_dirtyEntities.erase(entity);
+            m_componentStorage.removeEntity(entity);
+
+            const uint32_t entityIndex = static_cast<uint32_t>(entity.getId());
+            EntitySlot& slot = m_entitySlots[entityIndex];
+
+            // The removed entity is moved to the end, the last enabled one first taking its place if it lies among them
+            if (slot.entityPosition < m_enabledEntityCount)
+                swapEntities(slot.entityPosition, --m_enabledEntityCount);
+
+            swapEntities(slot.entityPosition, m_entities.size() - 1);
+
+            m_entityPool.destroy(*m_entities.back());
+            m_entities.pop_back();
+
+            slot.entityPosition = EntitySlot::InvalidPosition;
+            ++slot.generation;
+            releaseEntityIndex(entityIndex);
+        }
 
-            m_entities.erase(iter);
+        /// Destroys the entity referred to by the given handle, if it still exists.
+        /// \note This must not be called while the systems are updated; CommandBuffer::destroyEntity() must be used instead.
+        /// \param entityHandle Handle of the entity to be destroyed.
+        /// \return True if the entity has been destroyed, false if the handle was already invalid.
+        bool removeEntity(const EntityHandle& entityHandle)
+        {
+            const Entity* entity = recoverEntity(entityHandle);
+
+            if (entity == nullptr)
+                return false;
+
+            removeEntity(*entity);
+            return true;
+        }
+
+        /// Checks if a handle refers to an entity which still exists in this world.
+        /// \param entityHandle Handle to be checked.
+        /// \return True if the entity exists, false if it has been destroyed or the handle is null.
+        bool isValid(const EntityHandle& entityHandle) const noexcept
+        {
+            return (entityHandle.index < m_entitySlots.size()
+                 && m_entitySlots[entityHandle.index].generation == entityHandle.generation
+                 && m_entitySlots[entityHandle.index].entityPosition != EntitySlot::InvalidPosition);
+        }
+
+        /// Gets the entity referred to by a handle, in constant time.
+        /// \param entityHandle Handle of the entity to be fetched.
+        /// \return Pointer to the entity if it still exists, nullptr otherwise.
+        const Entity* recoverEntity(const EntityHandle& entityHandle) const noexcept
+        {
+            return (isValid(entityHandle) ? m_entities[m_entitySlots[entityHandle.index].entityPosition] : nullptr);
+        }
+
+        Entity* recoverEntity(const EntityHandle& entityHandle) noexcept
+        {
+            return const_cast<Entity*>(static_cast<const World*>(this)->recoverEntity(entityHandle));
         }
 
         bool update(const FrameTimeInfo& timeInfo)
         {
-            // ZoneScopedN("World::update");
+            REI_PROFILE_ZONE("World::update");
+
+            const int64_t beginTime = Profiler::recoverTime();
 
+            applyCommands();
             refresh();
 
-            for (std::size_t systemIndex = 0; systemIndex < m_systems.size(); ++systemIndex)
+            // Fixed-step systems catch up on the simulated time first, the variable-step ones then being updated once with the latest state
+            if (timeInfo.substepCount > 0 && !(m_activeSystems & m_fixedStepSystems).isEmpty())
             {
-                if (!m_activeSystems[systemIndex])
-                    continue;
+                FrameTimeInfo stepTimeInfo = timeInfo;
+                stepTimeInfo.deltaTime    = timeInfo.substepTime;
+                stepTimeInfo.substepCount = 1;
 
-                const bool isSystemActive = m_systems[systemIndex]->update(timeInfo);
+                for (int stepIndex = 0; stepIndex < timeInfo.substepCount; ++stepIndex)
+                {
+                    // Changes recorded during a step must be visible to the next one
+                    if (stepIndex > 0)
+                    {
+                        applyCommands();
+                        refresh();
+                    }
 
-                if (!isSystemActive)
-                    m_activeSystems.setBit(systemIndex, false);
+                    rebuildSchedules();
+                    deactivateSystems(m_fixedStepScheduler.run(stepTimeInfo, m_threadPool));
+                }
             }
 
+            rebuildSchedules();
+            deactivateSystems(m_scheduler.run(timeInfo, m_threadPool));
+
+            // Structural changes recorded by the systems are applied at once, to be taken into account by the next refresh
+            applyCommands();
+
+            m_updateTimings.addSample(static_cast<float>(Profiler::recoverTime() - beginTime) / 1'000'000.f);
+
             return !m_activeSystems.isEmpty();
         }
 
+        /// Updates the systems' linked entities, only considering the entities which changed since the last refresh.
+        /// An entity is linked to a system if it is enabled & holds any of the system's accepted components, and unlinked otherwise.
         void refresh()
         {
-            // ZoneScopedN("World::refresh");
+            REI_PROFILE_ZONE("World::refresh");
 
-            if (m_entities.empty())
+            if (m_dirtyEntities.isEmpty())
                 return;
 
-            sortEntities();
-
-            for (std::size_t entityIndex = 0; entityIndex < m_activeEntityCount; ++entityIndex)
+            for (Entity* entity : m_dirtyEntities)
             {
-                const EntityPtr& entity = m_entities[entityIndex];
-
-                if (!entity->isEnabled())
-                    continue;
+                partitionEntity(*entity);
 
                 for (std::size_t systemIndex = 0; systemIndex < m_systems.size(); ++systemIndex)
                 {
@@ -174,29 +446,37 @@ namespace Rei
                     if (system == nullptr || !m_activeSystems[systemIndex])
                         continue;
 
-                    const Bitset matchingComponents = system->getAcceptedComponents() & entity->getEnabledComponents();
+                    const bool isMatching = (entity->isEnabled() && system->getAcceptedComponents().intersects(entity->getEnabledComponents()));
 
                     if (!system->containsEntity(*entity))
                     {
-                        if (!matchingComponents.isEmpty())
-                            system->linkEntity(entity);
+                        if (isMatching)
+                            system->linkEntity(*entity);
                     }
                     else
                     {
-                        if (matchingComponents.isEmpty())
-                            system->unlinkEntity(entity);
+                        if (!isMatching)
+                            system->unlinkEntity(*entity);
                     }
                 }
             }
+
+            m_dirtyEntities.clear();
         }
 
         void destroy()
         {
-            // ZoneScopedN("World::destroy");
+            REI_PROFILE_ZONE("World::destroy");
 
-            m_entities.clear();
-            m_activeEntityCount = 0;
-            m_maxEntityIndex = 0;
+            // Entity sets must be emptied while their entities are still alive
+            m_dirtyEntities.clear();
+
+            for (CommandBuffer& commandBuffer : m_commandBuffers)
+                commandBuffer.clear();
+
+            // Queries may still be referenced by the user, so they are only emptied
+            for (const EntityQueryPtr& query : m_queries)
+                query->clear();
 
             for (const SystemPtr& system : m_systems)
             {
@@ -204,54 +484,184 @@ namespace Rei
                     system->m_entities.clear();
             }
 
+            // Indices are released rather than reset, so that handles to the destroyed entities can never refer to new ones
+            for (std::size_t entityIndex = 0; entityIndex < m_entitySlots.size(); ++entityIndex)
+            {
+                EntitySlot& slot = m_entitySlots[entityIndex];
+
+                if (slot.entityPosition == EntitySlot::InvalidPosition)
+                    continue;
+
+                slot.entityPosition = EntitySlot::InvalidPosition;
+                ++slot.generation;
+                releaseEntityIndex(static_cast<uint32_t>(entityIndex));
+            }
+
+            // The pool keeps its memory, to be reused by the entities of the next map
+            for (Entity* entity : m_entities)
+                m_entityPool.destroy(*entity);
+
+            m_entities.clear();
+            m_enabledEntityCount = 0;
+
+            m_componentStorage.clear();
+
             m_systems.clear();
             m_activeSystems.clear();
+            m_isScheduleDirty = true;
+
+            // Released last, as the systems may have referenced data allocated in it
+            m_arena.release();
         }
 
         World& operator=(const World&) = delete;
-        World& operator=(World&&) noexcept = default;
+        World& operator=(World&&) noexcept = delete;
 
         ~World() { destroy(); }
 
     private:
+        /// Location of an entity within the world, indexed by entity index.
+        struct EntitySlot
+        {
+            static constexpr std::size_t InvalidPosition = std::numeric_limits<std::size_t>::max();
+            static constexpr uint32_t InvalidFreePosition = std::numeric_limits<uint32_t>::max();
+
+            std::size_t entityPosition = InvalidPosition; // Position in the entity list, or InvalidPosition if the index is free
+            uint32_t generation = 0; // Incremented each time an entity having this index is destroyed
+            uint32_t freePosition = InvalidFreePosition; // Position in the free index list, or InvalidFreePosition if the index is used
+        };
 
-        void sortEntities()
+        /// Marks an entity index as free, to be reused by a later entity.
+        void releaseEntityIndex(uint32_t entityIndex)
         {
-            // ZoneScopedN("World::sortEntities");
+            m_entitySlots[entityIndex].freePosition = static_cast<uint32_t>(m_freeEntityIndices.size());
+            m_freeEntityIndices.emplace_back(entityIndex);
+        }
 
-            auto firstEntity = m_entities.begin();
-            auto lastEntity = m_entities.end() - 1;
+        /// Removes an index from the free ones in constant time, the last free index taking its place.
+        void takeFreeEntityIndex(uint32_t entityIndex)
+        {
+            EntitySlot& slot = m_entitySlots[entityIndex];
+            assert("Error: The entity index to be taken must be free." && slot.freePosition != EntitySlot::InvalidFreePosition);
 
-            while (firstEntity != lastEntity)
-            {
-                if ((*firstEntity)->isEnabled())
-                {
-                    ++firstEntity;
-                    continue;
-                }
+            const uint32_t lastFreeIndex = m_freeEntityIndices.back();
+            m_freeEntityIndices[slot.freePosition] = lastFreeIndex;
+            m_entitySlots[lastFreeIndex].freePosition = slot.freePosition;
+            m_freeEntityIndices.pop_back();
 
-                while (firstEntity != lastEntity && (*lastEntity == nullptr || !(*lastEntity)->isEnabled()))
-                {
-                    --lastEntity;
-                }
+            slot.freePosition = EntitySlot::InvalidFreePosition;
+        }
 
-                if (firstEntity == lastEntity)
-                {
-                    break;
-                }
+        /// Creates an entity at the given index, which must be free.
+        Entity& createEntity(uint32_t entityIndex, bool enabled)
+        {
+            EntitySlot& slot = m_entitySlots[entityIndex];
+            slot.entityPosition = m_entities.size();
+
+            Entity& entity = *m_entities.emplace_back(&m_entityPool.create(entityIndex, *this, enabled, slot.generation));
+            m_componentStorage.addEntity(entity);
+
+            onEntityChanged(entity);
+
+            return entity;
+        }
+
+        template <typename... CompsTs>
+        static std::size_t getQueryId()
+        {
+            static const std::size_t id = s_maxQueryId.fetch_add(1, std::memory_order_relaxed);
+            return id;
+        }
 
-                std::swap(*firstEntity, *lastEntity);
-                --lastEntity;
+        EntityQuery& findOrCreateQuery(const ComponentMask& components)
+        {
+            for (const EntityQueryPtr& query : m_queries)
+            {
+                if (query->getComponents() == components)
+                    return *query;
             }
 
-            m_activeEntityCount = static_cast<std::size_t>(std::distance(m_entities.begin(), lastEntity) + 1);
+            EntityQuery& query = *m_queries.emplace_back(std::make_unique<EntityQuery>(components));
+
+            for (Entity* entity : m_entities)
+                query.refreshEntity(*entity);
+
+            return query;
+        }
+
+        void onEntityChanged(Entity& entity)
+        {
+            for (const EntityQueryPtr& query : m_queries)
+                query->refreshEntity(entity);
+
+            m_dirtyEntities.insert(entity);
+        }
+
+        /// Rebuilds the schedules of both the fixed-step & variable-step systems if any system has been added, removed or deactivated.
+        void rebuildSchedules()
+        {
+            if (!m_isScheduleDirty)
+                return;
+
+            m_scheduler.build(m_systems, m_activeSystems & ~m_fixedStepSystems);
+            m_fixedStepScheduler.build(m_systems, m_activeSystems & m_fixedStepSystems);
+            m_isScheduleDirty = false;
+        }
+
+        void deactivateSystems(const SystemMask& deactivatedSystems)
+        {
+            if (deactivatedSystems.isEmpty())
+                return;
+
+            m_activeSystems &= ~deactivatedSystems;
+            m_isScheduleDirty = true;
+        }
+
+        /// Moves an entity to the enabled or disabled part of the entity list, if it isn't already in the one matching its state.
+        void partitionEntity(const Entity& entity)
+        {
+            const std::size_t entityPosition = m_entitySlots[entity.getId()].entityPosition;
+
+            if (entity.isEnabled() && entityPosition >= m_enabledEntityCount)
+                swapEntities(entityPosition, m_enabledEntityCount++);
+            else if (!entity.isEnabled() && entityPosition < m_enabledEntityCount)
+                swapEntities(entityPosition, --m_enabledEntityCount);
+        }
+
+        void swapEntities(std::size_t firstPosition, std::size_t secondPosition) noexcept
+        {
+            std::swap(m_entities[firstPosition], m_entities[secondPosition]);
+            m_entitySlots[m_entities[firstPosition]->getId()].entityPosition = firstPosition;
+            m_entitySlots[m_entities[secondPosition]->getId()].entityPosition = secondPosition;
         }
 
         std::vector<SystemPtr> m_systems{};
-        Bitset m_activeSystems{};
+        SystemMask m_activeSystems{};
+        SystemMask m_fixedStepSystems{};
+        SystemScheduler m_scheduler{}; // Variable-step systems
+        SystemScheduler m_fixedStepScheduler{};
+        bool m_isScheduleDirty = true;
+        TimingStatistics m_updateTimings{};
+        ThreadPool* m_threadPool{};
+
+        ObjectPool<Entity> m_entityPool{};
+        std::vector<Entity*> m_entities{};
+        ComponentStorage m_componentStorage{};
+        std::vector<EntitySlot> m_entitySlots{};
+        std::vector<uint32_t> m_freeEntityIndices{}; // Indices of the free slots, each knowing its position in this list
+        std::size_t m_enabledEntityCount = 0; // Number of entities leading the entity list, which were enabled at the last refresh
+
+        EntitySet m_dirtyEntities{}; // Entities whose components or enabled state changed since the last refresh
+
+        std::vector<CommandBuffer> m_commandBuffers{}; // One per thread of the pool, plus a last one for any other thread; indexed by thread index
+        std::vector<EntityHandle> m_destroyedEntities{};
+
+        std::vector<EntityQueryPtr> m_queries{};
+        std::vector<EntityQuery*> m_queriesByType{}; // Indexed by query type ID, as given by getQueryId()
+
+        MemoryArena m_arena{};
 
-        std::vector<EntityPtr> m_entities{};
-        std::size_t m_activeEntityCount = 0;
-        std::size_t m_maxEntityIndex = 0;
+        // Worlds may be updated concurrently, & thus create their first query of a given type at the same time
+        static inline std::atomic<std::size_t> s_maxQueryId = 0;
     };
 }
\ No newline at end of file
@@ -0,0 +1,602 @@
+#include "WorldSnapshot.h"
+#include "Profiler.h"
+#include "Serialization.h"
+#include "World.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace Rei
+{
+
+    namespace
+    {
+
+        constexpr uint32_t SnapshotMagic = 0x504E5352; // "RSNP"
+        constexpr uint8_t SnapshotVersion = 1;
+        constexpr uint8_t DeltaFlag = 1;
+        constexpr std::size_t HeaderSize = sizeof(SnapshotMagic) + sizeof(SnapshotVersion) + sizeof(DeltaFlag) + 2 * sizeof(uint32_t);
+
+        // The components of an encoded entity are given by a mask indexed by their position in SerializableComponentTypes
+        constexpr std::size_t ComponentMaskSize = (SerializableComponentTypes::Size + 7) / 8;
+
+        /// Type-erased operations on a serializable component type.
+        struct ComponentSerializer
+        {
+            std::size_t compId{};
+            uint32_t size{}; // Serialized size of a component, in bytes
+            std::vector<uint32_t> fieldSizes{};
+            /// Writes the packed fields of all the components of the archetype's column, one component after the other.
+            void (*writeColumn)(const Archetype& archetype, uint8_t* data){};
+            /// Reads packed fields into an entity's component, adding it if the entity doesn't have one yet.
+            void (*readComponent)(Entity& entity, const uint8_t* data){};
+            void (*removeComponent)(Entity& entity){};
+        };
+
+        template <typename CompT>
+        ComponentSerializer createSerializer()
+        {
+            static_assert(IsSerializable_v<CompT>, "Error: A component registered as serializable has no serialize() function.");
+            static_assert(std::is_default_constructible_v<CompT>, "Error: A serializable component must be default constructible, to be created on restore.");
+
+            FieldLayout layout;
+            CompT().serialize(layout);
+
+            ComponentSerializer serializer;
+            serializer.compId     = Component::getId<CompT>();
+            serializer.size       = layout.getSize();
+            serializer.fieldSizes = layout.getFieldSizes();
+
+            serializer.writeColumn = [](const Archetype& archetype, uint8_t* data)
+            {
+                // A single writer is used for the whole column, each component's fields directly following the previous one's
+                FieldWriter writer(data);
+
+                // The function visits the fields both for reading & writing, & cannot be const; the writer only reads them
+                for (const CompT& component : archetype.getColumn<CompT>())
+                    const_cast<CompT&>(component).serialize(writer);
+            };
+
+            serializer.readComponent = [](Entity& entity, const uint8_t* data)
+            {
+                CompT& component = (entity.hasComponent<CompT>() ? entity.getComponentUnchecked<CompT>() : entity.addComponent<CompT>());
+
+                FieldReader reader(data);
+                component.serialize(reader);
+            };
+
+            serializer.removeComponent = [](Entity& entity) { entity.removeComponent<CompT>(); };
+
+            return serializer;
+        }
+
+        template <typename... CompTs>
+        std::vector<ComponentSerializer> createSerializers(TypeList<CompTs...>)
+        {
+            return std::vector<ComponentSerializer>{ createSerializer<CompTs>()... };
+        }
+
+        /// Gets the serializers of all the serializable components, in the order of SerializableComponentTypes.
+        const std::vector<ComponentSerializer>& getSerializers()
+        {
+            static const std::vector<ComponentSerializer> serializers = createSerializers(SerializableComponentTypes{});
+            return serializers;
+        }
+
+        bool isZero(const uint8_t* data, std::size_t size) noexcept
+        {
+            return std::all_of(data, data + size, [](uint8_t byte) { return (byte == 0); });
+        }
+
+        /// Writes the fields of a component which differ from a previous state, preceded by a mask of the written fields.
+        /// \param previousData Fields of the component in the baseline; if null, every field is compared against zero.
+        void writeFields(std::vector<uint8_t>& buffer, const ComponentSerializer& serializer, const uint8_t* data, const uint8_t* previousData)
+        {
+            const std::size_t maskOffset = buffer.size();
+            buffer.resize(maskOffset + (serializer.fieldSizes.size() + 7) / 8);
+
+            ByteWriter writer(buffer);
+            std::size_t fieldOffset = 0;
+
+            for (std::size_t fieldIndex = 0; fieldIndex < serializer.fieldSizes.size(); ++fieldIndex)
+            {
+                const std::size_t fieldSize = serializer.fieldSizes[fieldIndex];
+                const bool hasChanged = (previousData ? std::memcmp(data + fieldOffset, previousData + fieldOffset, fieldSize) != 0
+                                                      : !isZero(data + fieldOffset, fieldSize));
+
+                if (hasChanged)
+                {
+                    buffer[maskOffset + fieldIndex / 8] |= static_cast<uint8_t>(1u << (fieldIndex % 8));
+                    writer.writeBytes(data + fieldOffset, fieldSize);
+                }
+
+                fieldOffset += fieldSize;
+            }
+        }
+
+        /// Reads fields written by writeFields(), starting from the previous state of the component.
+        /// \param previousData Fields of the component in the baseline; if null, the fields which have not been written are set to zero.
+        void readFields(ByteReader& reader, const ComponentSerializer& serializer, const uint8_t* previousData, uint8_t* data)
+        {
+            if (previousData)
+                std::memcpy(data, previousData, serializer.size);
+            else
+                std::fill_n(data, serializer.size, uint8_t{ 0 });
+
+            const uint8_t* fieldMask = reader.skipBytes((serializer.fieldSizes.size() + 7) / 8);
+
+            if (fieldMask == nullptr)
+                return;
+
+            std::size_t fieldOffset = 0;
+
+            for (std::size_t fieldIndex = 0; fieldIndex < serializer.fieldSizes.size(); ++fieldIndex)
+            {
+                const std::size_t fieldSize = serializer.fieldSizes[fieldIndex];
+
+                if (fieldMask[fieldIndex / 8] & (1u << (fieldIndex % 8)))
+                    reader.readBytes(data + fieldOffset, fieldSize);
+
+                fieldOffset += fieldSize;
+            }
+        }
+
+        /// Checks if two entities hold the exact same serialized state.
+        bool areIdentical(const WorldSnapshot& firstSnapshot, const WorldSnapshot::EntityRecord& firstEntity,
+                          const WorldSnapshot& secondSnapshot, const WorldSnapshot::EntityRecord& secondEntity)
+        {
+            if (firstEntity.handle != secondEntity.handle || firstEntity.enabled != secondEntity.enabled || firstEntity.components != secondEntity.components)
+                return false;
+
+            for (const ComponentSerializer& serializer : getSerializers())
+            {
+                const uint8_t* firstData = firstSnapshot.getComponentData(firstEntity, serializer.compId);
+
+                if (firstData && std::memcmp(firstData, secondSnapshot.getComponentData(secondEntity, serializer.compId), serializer.size) != 0)
+                    return false;
+            }
+
+            return true;
+        }
+
+        /// Gets the snapshot full snapshots are encoded against.
+        const WorldSnapshot& getEmptySnapshot()
+        {
+            static const WorldSnapshot emptySnapshot;
+            return emptySnapshot;
+        }
+
+        void patchCount(std::vector<uint8_t>& buffer, std::size_t offset, uint32_t count) noexcept
+        {
+            std::memcpy(buffer.data() + offset, &count, sizeof(count));
+        }
+
+    } // namespace
+
+    bool WorldSnapshot::decodeHeader(const uint8_t* data, std::size_t size, Header& header) noexcept
+    {
+        ByteReader reader(data, size);
+
+        uint32_t magic {};
+        uint8_t version {};
+        uint8_t flags {};
+
+        reader.read(magic);
+        reader.read(version);
+        reader.read(flags);
+        reader.read(header.tick);
+        reader.read(header.baselineTick);
+
+        header.isDelta = (flags & DeltaFlag);
+
+        return (!reader.hasFailed() && magic == SnapshotMagic && version == SnapshotVersion);
+    }
+
+    const WorldSnapshot::EntityRecord* WorldSnapshot::findEntity(uint32_t entityIndex) const noexcept
+    {
+        const auto entityIt = std::lower_bound(m_entities.cbegin(), m_entities.cend(), entityIndex, [](const EntityRecord& entity, uint32_t index)
+        {
+            return (entity.handle.index < index);
+        });
+
+        return (entityIt != m_entities.cend() && entityIt->handle.index == entityIndex ? &*entityIt : nullptr);
+    }
+
+    const uint8_t* WorldSnapshot::getComponentData(const EntityRecord& entity, std::size_t compId) const noexcept
+    {
+        if (!entity.components[compId])
+            return nullptr;
+
+        std::size_t componentIndex = entity.firstComponent;
+
+        for (const ComponentSerializer& serializer : getSerializers())
+        {
+            if (serializer.compId == compId)
+                break;
+
+            componentIndex += entity.components[serializer.compId];
+        }
+
+        return m_data.data() + m_componentOffsets[componentIndex];
+    }
+
+    void WorldSnapshot::capture(const World& world, uint32_t tick)
+    {
+        REI_PROFILE_ZONE("WorldSnapshot::capture");
+
+        clear();
+        m_tick = tick;
+        m_entities.reserve(world.getEntities().size());
+
+        for (const ArchetypePtr& archetype : world.getComponentStorage().getArchetypes())
+        {
+            if (archetype->isEmpty())
+                continue;
+
+            ComponentMask components;
+            std::size_t componentCount = 0;
+
+            for (const ComponentSerializer& serializer : getSerializers())
+            {
+                if (archetype->hasColumn(serializer.compId))
+                {
+                    components.setBit(serializer.compId);
+                    ++componentCount;
+                }
+            }
+
+            const std::size_t firstComponent = m_componentOffsets.size();
+
+            for (std::size_t row = 0; row < archetype->getEntityCount(); ++row)
+            {
+                const Entity& entity = *archetype->getEntities()[row];
+                m_entities.emplace_back(EntityRecord{ entity.getHandle(), entity.isEnabled(), components, static_cast<uint32_t>(firstComponent + row * componentCount) });
+            }
+
+            m_componentOffsets.resize(firstComponent + archetype->getEntityCount() * componentCount);
+
+            // Each column is copied at once, its entities' offsets being interleaved with those of the other columns
+            std::size_t componentIndex = 0;
+
+            for (const ComponentSerializer& serializer : getSerializers())
+            {
+                if (!archetype->hasColumn(serializer.compId))
+                    continue;
+
+                const std::size_t columnOffset = m_data.size();
+                m_data.resize(columnOffset + archetype->getEntityCount() * serializer.size);
+                serializer.writeColumn(*archetype, m_data.data() + columnOffset);
+
+                for (std::size_t row = 0; row < archetype->getEntityCount(); ++row)
+                    m_componentOffsets[firstComponent + row * componentCount + componentIndex] = static_cast<uint32_t>(columnOffset + row * serializer.size);
+
+                ++componentIndex;
+            }
+        }
+
+        std::sort(m_entities.begin(), m_entities.end(), [](const EntityRecord& firstEntity, const EntityRecord& secondEntity)
+        {
+            return (firstEntity.handle.index < secondEntity.handle.index);
+        });
+    }
+
+    void WorldSnapshot::restore(World& world) const
+    {
+        REI_PROFILE_ZONE("WorldSnapshot::restore");
+
+        std::vector<EntityHandle> removedEntities;
+
+        for (const Entity* entity : world.getEntities())
+        {
+            const EntityRecord* record = findEntity(static_cast<uint32_t>(entity->getId()));
+
+            if (record == nullptr || record->handle != entity->getHandle())
+                removedEntities.emplace_back(entity->getHandle());
+        }
+
+        for (const EntityHandle& entityHandle : removedEntities)
+            world.removeEntity(entityHandle);
+
+        for (const EntityRecord& record : m_entities)
+        {
+            Entity* entity = world.recoverEntity(record.handle);
+
+            if (entity == nullptr)
+                entity = &world.addEntity(record.handle, record.enabled);
+            else
+                entity->enable(record.enabled);
+
+            std::size_t componentIndex = record.firstComponent;
+
+            for (const ComponentSerializer& serializer : getSerializers())
+            {
+                if (record.components[serializer.compId])
+                    serializer.readComponent(*entity, m_data.data() + m_componentOffsets[componentIndex++]);
+                else
+                    serializer.removeComponent(*entity);
+            }
+        }
+    }
+
+    void WorldSnapshot::encode(std::vector<uint8_t>& buffer) const
+    {
+        // A full snapshot is a delta against nothing, in which only the non-zero fields are written
+        encode(getEmptySnapshot(), false, buffer);
+    }
+
+    void WorldSnapshot::encodeDelta(const WorldSnapshot& baseline, std::vector<uint8_t>& buffer) const
+    {
+        encode(baseline, true, buffer);
+    }
+
+    bool WorldSnapshot::decode(const uint8_t* data, std::size_t size, const WorldSnapshot* baseline)
+    {
+        REI_PROFILE_ZONE("WorldSnapshot::decode");
+
+        Header header;
+
+        if (!decodeHeader(data, size, header) || (header.isDelta && (baseline == nullptr || baseline->m_tick != header.baselineTick)))
+        {
+            clear();
+            return false;
+        }
+
+        if (!header.isDelta)
+            baseline = &getEmptySnapshot();
+
+        // The snapshot is rebuilt from scratch, & thus cannot be its own baseline
+        if (baseline == this)
+        {
+            const WorldSnapshot baselineCopy = *this;
+            return decode(data, size, &baselineCopy);
+        }
+
+        if (!decodeEntities(data + HeaderSize, size - HeaderSize, *baseline))
+        {
+            clear();
+            return false;
+        }
+
+        m_tick = header.tick;
+        return true;
+    }
+
+    void WorldSnapshot::clear() noexcept
+    {
+        m_tick = 0;
+        m_entities.clear();
+        m_componentOffsets.clear();
+        m_data.clear();
+    }
+
+    void WorldSnapshot::encode(const WorldSnapshot& baseline, bool isDelta, std::vector<uint8_t>& buffer) const
+    {
+        REI_PROFILE_ZONE("WorldSnapshot::encode");
+
+        ByteWriter writer(buffer);
+        writer.write(SnapshotMagic);
+        writer.write(SnapshotVersion);
+        writer.write(static_cast<uint8_t>(isDelta ? DeltaFlag : 0));
+        writer.write(m_tick);
+        writer.write(baseline.m_tick);
+
+        // Entities of the baseline which no longer exist; those whose index has been reused by another entity are simply replaced.
+        //   Both lists being sorted by index, they can be walked along in a single pass
+        const std::size_t removedCountOffset = writer.getSize();
+        writer.write(uint32_t{ 0 });
+
+        uint32_t removedCount = 0;
+        uint32_t nextIndex = 0;
+        std::size_t entityIndex = 0;
+
+        for (const EntityRecord& baselineEntity : baseline.m_entities)
+        {
+            while (entityIndex < m_entities.size() && m_entities[entityIndex].handle.index < baselineEntity.handle.index)
+                ++entityIndex;
+
+            if (entityIndex < m_entities.size() && m_entities[entityIndex].handle.index == baselineEntity.handle.index)
+                continue;
+
+            // Indices are written as the difference with the one following the previous index, which mostly fit in a single byte
+            writer.writeVarUint(baselineEntity.handle.index - nextIndex);
+            nextIndex = baselineEntity.handle.index + 1;
+            ++removedCount;
+        }
+
+        patchCount(buffer, removedCountOffset, removedCount);
+
+        const std::size_t entityCountOffset = writer.getSize();
+        writer.write(uint32_t{ 0 });
+
+        uint32_t entityCount = 0;
+        nextIndex = 0;
+        std::size_t baselineIndex = 0;
+
+        for (const EntityRecord& entity : m_entities)
+        {
+            while (baselineIndex < baseline.m_entities.size() && baseline.m_entities[baselineIndex].handle.index < entity.handle.index)
+                ++baselineIndex;
+
+            // An entity can only be compared against the same entity, & not another having had the same index
+            const EntityRecord* baselineEntity = nullptr;
+
+            if (baselineIndex < baseline.m_entities.size() && baseline.m_entities[baselineIndex].handle == entity.handle)
+                baselineEntity = &baseline.m_entities[baselineIndex];
+
+            if (baselineEntity && areIdentical(*this, entity, baseline, *baselineEntity))
+                continue;
+
+            writer.writeVarUint(entity.handle.index - nextIndex);
+            writer.writeVarUint(entity.handle.generation);
+            writer.write(static_cast<uint8_t>(entity.enabled));
+            nextIndex = entity.handle.index + 1;
+
+            std::array<uint8_t, ComponentMaskSize> componentMask {};
+            const std::vector<ComponentSerializer>& serializers = getSerializers();
+
+            for (std::size_t serializerIndex = 0; serializerIndex < serializers.size(); ++serializerIndex)
+            {
+                if (entity.components[serializers[serializerIndex].compId])
+                    componentMask[serializerIndex / 8] |= static_cast<uint8_t>(1u << (serializerIndex % 8));
+            }
+
+            for (const uint8_t maskByte : componentMask)
+                writer.write(maskByte);
+
+            for (const ComponentSerializer& serializer : serializers)
+            {
+                const uint8_t* componentData = getComponentData(entity, serializer.compId);
+
+                if (componentData == nullptr)
+                    continue;
+
+                const uint8_t* previousData = (baselineEntity ? baseline.getComponentData(*baselineEntity, serializer.compId) : nullptr);
+                writeFields(buffer, serializer, componentData, previousData);
+            }
+
+            ++entityCount;
+        }
+
+        patchCount(buffer, entityCountOffset, entityCount);
+    }
+
+    bool WorldSnapshot::decodeEntities(const uint8_t* data, std::size_t size, const WorldSnapshot& baseline)
+    {
+        clear();
+
+        const std::vector<ComponentSerializer>& serializers = getSerializers();
+        ByteReader reader(data, size);
+
+        uint32_t removedCount {};
+        reader.read(removedCount);
+
+        // Each index taking at least a byte, this prevents corrupted counts from allocating huge amounts of memory
+        if (removedCount > reader.getRemainingSize())
+            return false;
+
+        std::vector<uint32_t> removedIndices(removedCount);
+        uint64_t nextIndex = 0;
+
+        for (uint32_t& removedIndex : removedIndices)
+        {
+            uint64_t indexDelta {};
+            reader.readVarUint(indexDelta);
+
+            if (indexDelta >= World::MaxEntityCount - nextIndex)
+                return false;
+
+            removedIndex = static_cast<uint32_t>(nextIndex + indexDelta);
+            nextIndex = removedIndex + 1;
+        }
+
+        uint32_t entityCount {};
+        reader.read(entityCount);
+
+        if (entityCount > reader.getRemainingSize())
+            return false;
+
+        m_entities.reserve(baseline.m_entities.size() + entityCount);
+
+        std::size_t baselineIndex = 0;
+        std::size_t removedIndex = 0;
+
+        const auto addRecord = [this](const EntityHandle& handle, bool enabled, const ComponentMask& components)
+        {
+            m_entities.emplace_back(EntityRecord{ handle, enabled, components, static_cast<uint32_t>(m_componentOffsets.size()) });
+        };
+
+        // Copies the unchanged entities of the baseline which lie before the given index, skipping the removed ones
+        const auto copyBaselineEntities = [&](uint64_t endIndex)
+        {
+            for (; baselineIndex < baseline.m_entities.size() && baseline.m_entities[baselineIndex].handle.index < endIndex; ++baselineIndex)
+            {
+                const EntityRecord& baselineEntity = baseline.m_entities[baselineIndex];
+
+                while (removedIndex < removedIndices.size() && removedIndices[removedIndex] < baselineEntity.handle.index)
+                    ++removedIndex;
+
+                if (removedIndex < removedIndices.size() && removedIndices[removedIndex] == baselineEntity.handle.index)
+                    continue;
+
+                addRecord(baselineEntity.handle, baselineEntity.enabled, baselineEntity.components);
+
+                for (const ComponentSerializer& serializer : serializers)
+                {
+                    const uint8_t* componentData = baseline.getComponentData(baselineEntity, serializer.compId);
+
+                    if (componentData == nullptr)
+                        continue;
+
+                    m_componentOffsets.emplace_back(static_cast<uint32_t>(m_data.size()));
+                    m_data.insert(m_data.end(), componentData, componentData + serializer.size);
+                }
+            }
+        };
+
+        nextIndex = 0;
+
+        for (uint32_t entityIndex = 0; entityIndex < entityCount && !reader.hasFailed(); ++entityIndex)
+        {
+            uint64_t indexDelta {};
+            uint64_t generation {};
+            uint8_t enabled {};
+            std::array<uint8_t, ComponentMaskSize> componentMask {};
+
+            reader.readVarUint(indexDelta);
+            reader.readVarUint(generation);
+            reader.read(enabled);
+
+            for (uint8_t& maskByte : componentMask)
+                reader.read(maskByte);
+
+            // Indices a world cannot hold are rejected, as restoring them would make it allocate slots up to them
+            if (reader.hasFailed() || indexDelta >= World::MaxEntityCount - nextIndex || generation > std::numeric_limits<uint32_t>::max())
+                return false;
+
+            const EntityHandle handle{ static_cast<uint32_t>(nextIndex + indexDelta), static_cast<uint32_t>(generation) };
+            nextIndex = handle.index + 1;
+
+            copyBaselineEntities(handle.index);
+
+            // The entity replaces the baseline's one of the same index, if any, whose state is only reused if it is the same entity
+            const EntityRecord* baselineEntity = nullptr;
+
+            if (baselineIndex < baseline.m_entities.size() && baseline.m_entities[baselineIndex].handle.index == handle.index)
+            {
+                if (baseline.m_entities[baselineIndex].handle == handle)
+                    baselineEntity = &baseline.m_entities[baselineIndex];
+
+                ++baselineIndex;
+            }
+
+            ComponentMask components;
+
+            for (std::size_t serializerIndex = 0; serializerIndex < serializers.size(); ++serializerIndex)
+            {
+                if (componentMask[serializerIndex / 8] & (1u << (serializerIndex % 8)))
+                    components.setBit(serializers[serializerIndex].compId);
+            }
+
+            addRecord(handle, (enabled != 0), components);
+
+            for (const ComponentSerializer& serializer : serializers)
+            {
+                if (!components[serializer.compId])
+                    continue;
+
+                const uint8_t* previousData = (baselineEntity ? baseline.getComponentData(*baselineEntity, serializer.compId) : nullptr);
+                const std::size_t componentOffset = m_data.size();
+
+                m_componentOffsets.emplace_back(static_cast<uint32_t>(componentOffset));
+                m_data.resize(componentOffset + serializer.size);
+                readFields(reader, serializer, previousData, m_data.data() + componentOffset);
+            }
+        }
+
+        copyBaselineEntities(std::numeric_limits<uint64_t>::max());
+
+        return (!reader.hasFailed() && reader.getRemainingSize() == 0);
+    }
+
+} // namespace Rei
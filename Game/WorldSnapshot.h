@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Component.h"
+#include "Entity.h"
+
+namespace Rei
+{
+    class World;
+
+    /// State of a world's entities & of their serializable components at a given tick, used to replicate a world over the network or to record it.
+    /// A snapshot can be encoded either entirely, or as a delta against a baseline snapshot the receiver already has (usually the last one it
+    ///   acknowledged): only the entities which changed since are then written, & for each of their components only the fields whose value differs.
+    /// \note Only the components listed in SerializableComponentTypes are captured, their columns being copied at once; the others are left
+    ///   untouched when restoring a snapshot into a world.
+    class WorldSnapshot
+    {
+    public:
+        /// Entity of a snapshot, along with where its components' data lie.
+        struct EntityRecord
+        {
+            EntityHandle handle{};
+            bool enabled = true;
+            ComponentMask components{}; // Serializable components only
+            uint32_t firstComponent = 0; // Index of the entity's first component offset, the others following in the order of SerializableComponentTypes
+        };
+
+        /// Information leading encoded data, which can be recovered without decoding the rest.
+        struct Header
+        {
+            uint32_t tick = 0;
+            /// Tick of the snapshot the data has been encoded against, if it is a delta.
+            uint32_t baselineTick = 0;
+            bool isDelta = false;
+        };
+
+        uint32_t getTick() const noexcept { return m_tick; }
+        /// Gets the snapshot's entities, sorted by index.
+        const std::vector<EntityRecord>& getEntities() const noexcept { return m_entities; }
+        std::size_t getEntityCount() const noexcept { return m_entities.size(); }
+        bool isEmpty() const noexcept { return m_entities.empty(); }
+
+        /// Recovers the header of encoded data, for instance to find the baseline it must be decoded against.
+        /// \param data Encoded data.
+        /// \param size Size of the data, in bytes.
+        /// \param header Header to be filled.
+        /// \return True if the header is valid, false otherwise.
+        static bool decodeHeader(const uint8_t* data, std::size_t size, Header& header) noexcept;
+
+        /// Finds an entity of the snapshot, in logarithmic time.
+        /// \param entityIndex Index of the entity to be found.
+        /// \return Pointer to the entity's record, or nullptr if the snapshot holds no entity of that index.
+        const EntityRecord* findEntity(uint32_t entityIndex) const noexcept;
+        /// Gets the serialized data of one of an entity's components.
+        /// \tparam CompT Type of the component; must be serializable.
+        /// \param entity Entity to get the component of.
+        /// \return Pointer to the packed fields of the component, or nullptr if the entity doesn't hold one of this type.
+        template <typename CompT>
+        const uint8_t* getComponentData(const EntityRecord& entity) const noexcept { return getComponentData(entity, Component::getId<CompT>()); }
+        const uint8_t* getComponentData(const EntityRecord& entity, std::size_t compId) const noexcept;
+
+        /// Captures the state of a world.
+        /// \param world World to capture the entities of.
+        /// \param tick Tick the snapshot is taken at.
+        void capture(const World& world, uint32_t tick);
+        /// Makes a world's entities match those of the snapshot, creating, destroying & updating them along with their serializable components.
+        /// \note This must not be called while the world's systems are updated.
+        /// \param world World to restore the snapshot into.
+        void restore(World& world) const;
+        /// Encodes the whole snapshot.
+        /// \param buffer Buffer to append the encoded data to.
+        void encode(std::vector<uint8_t>& buffer) const;
+        /// Encodes only the differences between the snapshot & a baseline.
+        /// \param baseline Snapshot the receiver already has, which it will have to give to decode().
+        /// \param buffer Buffer to append the encoded data to.
+        void encodeDelta(const WorldSnapshot& baseline, std::vector<uint8_t>& buffer) const;
+        /// Decodes encoded data, replacing the snapshot's content.
+        /// \param data Encoded data, as given by encode() or encodeDelta().
+        /// \param size Size of the data, in bytes.
+        /// \param baseline Snapshot the data has been encoded against; required if it is a delta, ignored otherwise.
+        /// \return True if the data has been decoded, false if it is invalid or has been encoded against another baseline; the snapshot is then empty.
+        bool decode(const uint8_t* data, std::size_t size, const WorldSnapshot* baseline = nullptr);
+        void clear() noexcept;
+
+    private:
+        void encode(const WorldSnapshot& baseline, bool isDelta, std::vector<uint8_t>& buffer) const;
+        bool decodeEntities(const uint8_t* data, std::size_t size, const WorldSnapshot& baseline);
+
+        uint32_t m_tick = 0;
+        std::vector<EntityRecord> m_entities{}; // Sorted by entity index
+        std::vector<uint32_t> m_componentOffsets{}; // Offsets of each entity's components in the data
+        std::vector<uint8_t> m_data{};
+    };
+
+} // namespace Rei